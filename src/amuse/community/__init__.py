@@ -18,6 +18,7 @@ from amuse.support.literature import LiteratureReferencesMixIn
 from amuse.rfi.core import CodeInterface
 from amuse.rfi.core import CodeWithDataDirectories
 from amuse.rfi.core import legacy_function,remote_function
+from amuse.rfi.core import parallel_legacy_function
 from amuse.rfi.core import LegacyFunctionSpecification
 from amuse.rfi.core import is_mpd_running
 
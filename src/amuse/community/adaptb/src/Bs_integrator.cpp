@@ -1,5 +1,9 @@
 #include "Bs_integrator.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
+
 /////////////////////////////////////////
 // Constructors
 /////////////////////////////////////////
@@ -7,16 +11,19 @@ Bs_integrator::Bs_integrator() {
   epsilon = "1e-6";
   n_max = 64;
   k_max = 64;
+  n_converged = 0;
 }
 Bs_integrator::Bs_integrator(mpreal e) {
   epsilon = e;
   n_max = 64;
   k_max = 64;
+  n_converged = 0;
 }
 Bs_integrator::Bs_integrator(mpreal e, int n, int k) {
   epsilon = e;
   n_max = n;
   k_max = k;
+  n_converged = 0;
 }
 /////////////////////////////////////////
 // Set
@@ -71,43 +78,65 @@ void Bs_integrator::integrate(Cluster &cluster, mpreal &dt) {
     dt = timestep;
   }
 }
+// Number of leapfrog steps of the m-th sequence: 1, 2, 4, 6, ...
+static inline int steps_in_sequence(int m) {
+  return m == 0 ? 1 : 2*m;
+}
+// Integrate the sequences cl.size() .. m_end-1 from cluster.  They are
+// independent of each other, so with more than one OpenMP thread they
+// run concurrently, longest first.
+void Bs_integrator::integrate_sequences(Cluster &cluster, mpreal &dt, vector<Cluster> &cl, int m_end) {
+  int m_begin = cl.size();
+  cl.resize(m_end, cluster);
+  mp_prec_t prec = mpreal::get_default_prec();
+  #pragma omp parallel if(m_end-m_begin > 1)
+  {
+    // MPFR keeps the default precision per thread
+    mpreal::set_default_prec(prec);
+    #pragma omp for schedule(dynamic, 1)
+    for(int m=m_end-1; m>=m_begin; m--) {
+      int n = steps_in_sequence(m);
+      mpreal h = dt/n;
+      for(int i=0; i<n; i++) cl[m].leapfrog( h );
+    }
+  }
+}
 void Bs_integrator::step(Cluster &cluster, mpreal dt) {
-  flag = 1;
+  flag = 0;
 
-  int n;
+  int m = 0, m_max = max(2, n_max/2+2);
   vector<mpreal> h;
   vector<Cluster> cl;
   Cluster cl_exp0 = cluster;
   Cluster cl_exp = cluster;
 
-  // n=1
-  n=1;
-  h.push_back( dt/n );
-  cl.push_back( cluster );
-  cl[0].leapfrog( h[0] );
-  cl_exp0 = cl[0];
-
-  // n=2
-  n=2;
-  h.push_back( dt/n );
-  cl.push_back( cluster );
-  for(int i=0; i<n; i++) cl[1].leapfrog( h[1] );
-  extrapol( cl_exp, h, cl );
-  
-  flag = error_control(cl_exp0, cl_exp);
+  int n_threads = 1;
+  #ifdef _OPENMP
+  if(!omp_in_parallel()) n_threads = omp_get_max_threads();
+  #endif // _OPENMP
+
+  // The sequences n=1, 2, 4, ... are extrapolated in turn until the
+  // result converges.  With several threads they are integrated in
+  // batches ahead of the extrapolation: first as many as the previous
+  // step needed, then one per thread.
+  while(flag == 0 && m < m_max) {
+    int batch = (m == 0) ? 2 : 1;
+    if(n_threads > 1) batch = (m == 0) ? max(2, n_converged) : n_threads;
+    integrate_sequences(cluster, dt, cl, min(m_max, m+batch));
+
+    for(; flag == 0 && m < (int)cl.size(); m++) {
+      h.push_back( dt/steps_in_sequence(m) );
+      if(m == 0) {
+        cl_exp0 = cl[0];
+        continue;
+      }
+      if(m > 1) cl_exp0 = cl_exp;
+      extrapol( cl_exp, h, cl );
 
-  if(flag == 0) {
-    while(flag == 0 && n <= n_max) {
-      n += 2;
-      h.push_back( dt/n );
-      cl.push_back( cluster );
-      for(int i=0; i<n; i++) cl[n/2].leapfrog( h[n/2] );
-      cl_exp0 = cl_exp;
-      extrapol( cl_exp, h, cl );   
-
-      flag = error_control(cl_exp0, cl_exp);   
-    }    
+      flag = error_control(cl_exp0, cl_exp);
+    }
   }
+  if(flag == 1) n_converged = m;
 
   cluster = cl_exp;
 }
@@ -10,6 +10,9 @@ class Bs_integrator
   int k_max; 
  
   int flag;
+  int n_converged;  // sequences needed by the last converged step
+
+  void integrate_sequences(Cluster &cluster, mpreal &dt, vector<Cluster> &cl, int m_end);
 
   public:
 
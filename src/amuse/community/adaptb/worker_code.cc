@@ -0,0 +1,2084 @@
+
+#ifndef NOMPI
+    #include <mpi.h>
+#endif
+#include <iostream>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#ifdef WIN32
+	#include <winsock2.h>
+#else
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <netdb.h>
+	#include <unistd.h>
+	#include <netinet/tcp.h>
+  #include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+#if _POSIX_VERSION >= 1
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 1
+#endif
+	#include <signal.h>
+#endif
+
+#include "worker_code.h"
+#include "stopcond.h"
+
+static bool NEEDS_MPI = true;
+
+static int MAX_INTS_IN = 2;
+static int MAX_INTS_OUT = 3;
+static int MAX_LONGS_IN = 0;
+static int MAX_LONGS_OUT = 0;
+static int MAX_FLOATS_IN = 0;
+static int MAX_FLOATS_OUT = 0;
+static int MAX_DOUBLES_IN = 8;
+static int MAX_DOUBLES_OUT = 8;
+static int MAX_BOOLEANS_IN = 1;
+static int MAX_BOOLEANS_OUT = 1;
+static int MAX_STRINGS_IN = 8;
+static int MAX_STRINGS_OUT = 1;
+
+
+static int ERROR_FLAG = 256;
+static int SHARED_MEMORY_FLAG = 16777216;
+static int HEADER_SIZE = 11; //integers
+
+static int HEADER_FLAGS = 0;
+static int HEADER_CALL_ID = 1;
+static int HEADER_FUNCTION_ID = 2;
+static int HEADER_CALL_COUNT = 3;
+static int HEADER_INTEGER_COUNT = 4;
+static int HEADER_LONG_COUNT = 5;
+static int HEADER_FLOAT_COUNT = 6;
+static int HEADER_DOUBLE_COUNT = 7;
+static int HEADER_BOOLEAN_COUNT = 8;
+static int HEADER_STRING_COUNT = 9;
+static int HEADER_UNITS_COUNT = 10;
+
+/* function id of a message with several calls, see handle_batch */
+static int BATCH_FUNCTION_ID = -2;
+static int BATCH_HEADER_SIZE = 8; //integers
+
+static bool TRUE_BYTE = 1;
+static bool FALSE_BYTE = 0;
+
+static bool mpiIntercom = false;
+
+static int socketfd = 0;
+
+/* memory shared with the python side, when a message has the
+   SHARED_MEMORY_FLAG set the header is send over the socket and the
+   arrays are stored in the segment (requests in the first half, 
+   replies in the second half) */
+static char * shared_memory = 0;
+static size_t shared_memory_size = 0;
+static size_t shared_memory_offset = 0;
+
+static int * header_in;
+static int * header_out;
+
+static int * ints_in;
+static int * ints_out;
+
+static long long int * longs_in;
+static long long int * longs_out;
+
+static float * floats_in;
+static float * floats_out;
+
+static double * doubles_in;
+static double * doubles_out;
+
+static bool * booleans_in;
+static bool * booleans_out;
+
+/* sizes of strings */
+static int * string_sizes_in;
+static int * string_sizes_out;
+
+/* pointers to input and output strings (contents not stored here) */
+static char * * strings_in;
+static char * * strings_out;
+
+/* actual string data */
+static char * characters_in = 0;
+static char * characters_out = 0;
+
+
+static int polling_interval = 0;
+#ifndef NOMPI
+#define MAX_COMMUNICATORS 2048
+static char portname_buffer[MPI_MAX_PORT_NAME+1];
+static MPI_Comm communicators[MAX_COMMUNICATORS];
+static int lastid = -1;
+static int activeid = -1;
+static int id_to_activate = -1;
+#else
+static const char * empty_string = "";
+#endif
+
+int internal__get_message_polling_interval(int * outval)
+{
+    *outval = polling_interval;
+    
+    return 0;
+}
+
+int internal__set_message_polling_interval(int inval)
+{
+    polling_interval = inval;
+    
+    return 0;
+}
+int internal__open_port(char ** output)
+{
+#ifndef NOMPI
+    MPI_Open_port(MPI_INFO_NULL, portname_buffer);
+    *output = portname_buffer;
+#else
+    *output = (char *) empty_string;
+#endif
+    return 0;
+}
+int internal__accept_on_port(char * port_identifier, int * comm_identifier)
+{
+#ifndef NOMPI
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    lastid++;
+    if(lastid >= MAX_COMMUNICATORS) {
+        lastid--;
+        return -1;
+    }
+    if(rank == 0){
+        MPI_Comm merged;
+        MPI_Comm communicator;
+        MPI_Comm_accept(port_identifier, MPI_INFO_NULL, 0,  MPI_COMM_SELF, &communicator);
+        MPI_Intercomm_merge(communicator, 0, &merged);
+        MPI_Intercomm_create(MPI_COMM_WORLD,0,merged, 1, 65, &communicators[lastid]);
+        MPI_Comm_free(&merged);
+        MPI_Comm_free(&communicator);
+    } else {
+        MPI_Intercomm_create(MPI_COMM_WORLD,0, MPI_COMM_NULL, 1, 65, &communicators[lastid]);
+    }
+    *comm_identifier = lastid;
+#else
+    *comm_identifier = -1;
+#endif
+    return 0;
+}
+
+
+int internal__connect_to_port(char * port_identifier, int * comm_identifier)
+{
+#ifndef NOMPI
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    lastid++;
+    if(lastid >= MAX_COMMUNICATORS) {
+        lastid--;
+        return -1;
+    }
+    if(rank == 0){
+        MPI_Comm merged;
+        MPI_Comm communicator;
+        MPI_Comm_connect(port_identifier, MPI_INFO_NULL, 0,  MPI_COMM_SELF, &communicator);
+        MPI_Intercomm_merge(communicator, 1, &merged);
+        MPI_Intercomm_create(MPI_COMM_WORLD, 0, merged, 0, 65, &communicators[lastid]);
+        MPI_Comm_free(&merged);
+        MPI_Comm_free(&communicator);
+    } else {
+        MPI_Intercomm_create(MPI_COMM_WORLD, 0, MPI_COMM_NULL, 1, 65, &communicators[lastid]);
+    }
+    *comm_identifier = lastid;
+#else
+    *comm_identifier = -1;
+#endif
+    return 0;
+}
+
+int internal__activate_communicator(int comm_identifier){
+#ifndef NOMPI
+    if(comm_identifier < 0 || comm_identifier > lastid) {
+        return -1;
+    }
+    id_to_activate = comm_identifier;
+#endif
+    return 0;
+}
+
+int internal__become_code(int number_of_workers, char * modulename, char * classname)
+{
+    return 0;
+}
+
+
+
+#ifndef NOMPI
+#include <unistd.h>
+
+int mpi_recv_header(MPI_Comm & parent)
+{
+    MPI_Request header_request;
+    MPI_Status request_status;
+   
+    MPI_Irecv(header_in, HEADER_SIZE, MPI_INT, 0, 989, parent, &header_request);
+        
+    if(polling_interval > 0)
+    {
+        int is_finished = 0;
+        MPI_Test(&header_request, &is_finished, &request_status);
+        while(!is_finished) {
+            usleep(polling_interval);
+            MPI_Test(&header_request, &is_finished, &request_status);
+        }
+        MPI_Wait(&header_request, &request_status);
+    } else {
+        MPI_Wait(&header_request, &request_status);
+    }
+    return 0;
+}
+#endif
+
+
+bool handle_batch();
+
+bool handle_call() {
+  int call_count = header_in[HEADER_CALL_COUNT];
+  
+  if (header_in[HEADER_FUNCTION_ID] == BATCH_FUNCTION_ID) {
+    return handle_batch();
+  }
+  
+  switch(header_in[HEADER_FUNCTION_ID]) {
+    case 0:
+      return false;
+      break;
+    case 20284990:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_mass(
+          ints_in[i] ,
+          &doubles_out[i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 20920053:
+      ints_out[0] = commit_particles();
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 37921492:
+      ints_out[0] = set_stopping_condition_timeout_parameter(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 44188957:
+      ints_out[0] = get_time(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 104547857:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = set_mass(
+          ints_in[i] ,
+          doubles_in[i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 107212404:
+      ints_out[0] = get_stopping_condition_maximum_density_parameter(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 120233917:
+      ints_out[0] = set_stopping_condition_out_of_box_use_center_of_mass_parameter(
+        booleans_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 128926247:
+      ints_out[0] = get_index_of_first_particle(
+        &ints_out[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 130250582:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = new_particle_string(
+          &ints_out[( 1 * call_count) + i] ,
+          strings_in[i] ,
+          strings_in[( 1 * call_count) + i] ,
+          strings_in[( 2 * call_count) + i] ,
+          strings_in[( 3 * call_count) + i] ,
+          strings_in[( 4 * call_count) + i] ,
+          strings_in[( 5 * call_count) + i] ,
+          strings_in[( 6 * call_count) + i] ,
+          strings_in[( 7 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 146223729:
+      ints_out[0] = get_stopping_condition_out_of_box_use_center_of_mass_parameter(
+        &booleans_out[0]
+      );
+      header_out[HEADER_BOOLEAN_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 159095171:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = enable_stopping_condition(
+          ints_in[i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 165576638:
+      ints_out[0] = get_max_cpu_time(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 205426934:
+      ints_out[0] = get_total_radius(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 205548127:
+      ints_out[0] = get_stopping_condition_maximum_internal_energy_parameter(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 219539042:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_number_of_stopping_conditions_set(
+          &ints_out[( 1 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 271440754:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = is_stopping_condition_set(
+          ints_in[i] ,
+          &ints_out[( 1 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 279708994:
+      ints_out[0] = get_bs_tolerance_string(
+        &strings_out[0]
+      );
+      header_out[HEADER_STRING_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 293741213:
+      ints_out[0] = set_bs_tolerance_string(
+        strings_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 383112453:
+      ints_out[0] = internal__connect_to_port(
+        strings_in[0] ,
+        &ints_out[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 384567015:
+      ints_out[0] = get_total_mass(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 416721977:
+      ints_out[0] = evolve_model(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 468878647:
+      ints_out[0] = set_word_length(
+        ints_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 497565320:
+      ints_out[0] = set_adaptb_output_directory(
+        strings_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 508605261:
+      ints_out[0] = set_stopping_condition_out_of_box_parameter(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 542058817:
+      ints_out[0] = set_eps2(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 580779672:
+      ints_out[0] = get_adaptb_output_directory(
+        &strings_out[0]
+      );
+      header_out[HEADER_STRING_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 632979349:
+      ints_out[0] = set_stopping_condition_number_of_steps_parameter(
+        ints_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 639951605:
+      ints_out[0] = get_stopping_condition_timeout_parameter(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 653682513:
+      ints_out[0] = get_begin_time(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 658631024:
+      ints_out[0] = get_eps2(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 662348285:
+      ints_out[0] = get_stopping_condition_minimum_internal_energy_parameter(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 678380482:
+      ints_out[0] = get_index_of_next_particle(
+        ints_in[0] ,
+        &ints_out[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 705921253:
+      ints_out[0] = get_word_length(
+        &ints_out[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 727361823:
+      ints_out[0] = internal__set_message_polling_interval(
+        ints_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 728786188:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = delete_particle(
+          ints_in[i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 733749514:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = is_stopping_condition_enabled(
+          ints_in[i] ,
+          &ints_out[( 1 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 835969050:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_potential(
+          ints_in[i] ,
+          &doubles_out[i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 887125873:
+      ints_out[0] = synchronize_model();
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 914340343:
+      ints_out[0] = get_dt_print(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 919768251:
+      ints_out[0] = internal__get_message_polling_interval(
+        &ints_out[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 929181341:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = set_state(
+          ints_in[i] ,
+          doubles_in[i] ,
+          doubles_in[( 1 * call_count) + i] ,
+          doubles_in[( 2 * call_count) + i] ,
+          doubles_in[( 3 * call_count) + i] ,
+          doubles_in[( 4 * call_count) + i] ,
+          doubles_in[( 5 * call_count) + i] ,
+          doubles_in[( 6 * call_count) + i] ,
+          doubles_in[( 7 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 953558780:
+      ints_out[0] = get_stopping_condition_minimum_density_parameter(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 962686836:
+      ints_out[0] = set_dt_print(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 967950880:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_state(
+          ints_in[i] ,
+          &doubles_out[i] ,
+          &doubles_out[( 1 * call_count) + i] ,
+          &doubles_out[( 2 * call_count) + i] ,
+          &doubles_out[( 3 * call_count) + i] ,
+          &doubles_out[( 4 * call_count) + i] ,
+          &doubles_out[( 5 * call_count) + i] ,
+          &doubles_out[( 6 * call_count) + i] ,
+          &doubles_out[( 7 * call_count) + i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 8 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1002966437:
+      ints_out[0] = set_max_cpu_time(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1024680297:
+      ints_out[0] = get_time_step(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1050085724:
+      ints_out[0] = recommit_particles();
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1071152125:
+      ints_out[0] = get_kinetic_energy(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1082457792:
+      ints_out[0] = get_number_of_particles(
+        &ints_out[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 1098838617:
+      ints_out[0] = get_stopping_condition_number_of_steps_parameter(
+        &ints_out[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 1137702459:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = disable_stopping_condition(
+          ints_in[i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1141845630:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = new_particle_float64(
+          &ints_out[( 1 * call_count) + i] ,
+          doubles_in[i] ,
+          doubles_in[( 1 * call_count) + i] ,
+          doubles_in[( 2 * call_count) + i] ,
+          doubles_in[( 3 * call_count) + i] ,
+          doubles_in[( 4 * call_count) + i] ,
+          doubles_in[( 5 * call_count) + i] ,
+          doubles_in[( 6 * call_count) + i] ,
+          doubles_in[( 7 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 1219458067:
+      ints_out[0] = set_bs_tolerance_float64(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1221190952:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = set_acceleration(
+          ints_in[i] ,
+          doubles_in[i] ,
+          doubles_in[( 1 * call_count) + i] ,
+          doubles_in[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1231060790:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_center_of_mass_position(
+          &doubles_out[i] ,
+          &doubles_out[( 1 * call_count) + i] ,
+          &doubles_out[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 3 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1315680918:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_center_of_mass_velocity(
+          &doubles_out[i] ,
+          &doubles_out[( 1 * call_count) + i] ,
+          &doubles_out[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 3 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1317242279:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_radius(
+          ints_in[i] ,
+          &doubles_out[i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1393481104:
+      ints_out[0] = set_stopping_condition_minimum_internal_energy_parameter(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1508430886:
+      ints_out[0] = set_begin_time(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1513820140:
+      ints_out[0] = internal__become_code(
+        ints_in[0] ,
+        strings_in[0] ,
+        strings_in[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1544727346:
+      ints_out[0] = set_stopping_condition_minimum_density_parameter(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1589810545:
+      ints_out[0] = get_bs_tolerance_float64(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1623630901:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = set_radius(
+          ints_in[i] ,
+          doubles_in[i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1625942852:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = has_stopping_condition(
+          ints_in[i] ,
+          &ints_out[( 1 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 1644113439:
+      ints_out[0] = cleanup_code();
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1655137210:
+      ints_out[0] = set_stopping_condition_maximum_density_parameter(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1706735752:
+      ints_out[0] = internal__activate_communicator(
+        ints_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1744145122:
+      ints_out[0] = recommit_parameters();
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1768994498:
+      ints_out[0] = initialize_code();
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1829880540:
+      ints_out[0] = internal__open_port(
+        &strings_out[0]
+      );
+      header_out[HEADER_STRING_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1852958273:
+      ints_out[0] = get_potential_energy(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1891926464:
+      ints_out[0] = internal__accept_on_port(
+        strings_in[0] ,
+        &ints_out[1]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 1892689129:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_velocity(
+          ints_in[i] ,
+          &doubles_out[i] ,
+          &doubles_out[( 1 * call_count) + i] ,
+          &doubles_out[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 3 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 1937183958:
+      ints_out[0] = get_stopping_condition_out_of_box_parameter(
+        &doubles_out[0]
+      );
+      header_out[HEADER_DOUBLE_COUNT] = 1 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 2010900811:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_position(
+          ints_in[i] ,
+          &doubles_out[i] ,
+          &doubles_out[( 1 * call_count) + i] ,
+          &doubles_out[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 3 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 2016681522:
+      ints_out[0] = set_stopping_condition_maximum_internal_energy_parameter(
+        doubles_in[0]
+      );
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 2026192840:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = set_position(
+          ints_in[i] ,
+          doubles_in[i] ,
+          doubles_in[( 1 * call_count) + i] ,
+          doubles_in[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 2046699524:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_stopping_condition_info(
+          ints_in[i] ,
+          &ints_out[( 1 * call_count) + i] ,
+          &ints_out[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 3 * call_count;
+      break;
+    
+    case 2061473599:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_acceleration(
+          ints_in[i] ,
+          &doubles_out[i] ,
+          &doubles_out[( 1 * call_count) + i] ,
+          &doubles_out[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_DOUBLE_COUNT] = 3 * call_count;
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 2069478464:
+      ints_out[0] = commit_parameters();
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    case 2129795713:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = get_stopping_condition_particle_index(
+          ints_in[i] ,
+          ints_in[( 1 * call_count) + i] ,
+          &ints_out[( 1 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 2 * call_count;
+      break;
+    
+    case 2144268908:
+      for (int i = 0 ; i < call_count; i++){
+        ints_out[i] = set_velocity(
+          ints_in[i] ,
+          doubles_in[i] ,
+          doubles_in[( 1 * call_count) + i] ,
+          doubles_in[( 2 * call_count) + i]
+        );
+      }
+      header_out[HEADER_INTEGER_COUNT] = 1 * call_count;
+      break;
+    
+    default:
+      header_out[HEADER_FLAGS] = header_out[HEADER_FLAGS] | ERROR_FLAG;
+      strings_out[0] = new char[100];
+      sprintf(strings_out[0], "unknown function id: %d\n", header_in[HEADER_FUNCTION_ID]);
+      fprintf(stderr, "unknown function id: %d\n", header_in[HEADER_FUNCTION_ID]);
+      header_out[HEADER_STRING_COUNT] = 1;
+  }
+  return true;
+}
+
+/* a batch contains several calls in one message, the call count of
+   the message is the sum of the call counts of all calls. the integer
+   array starts with the number of calls followed by a header for every
+   call (function id, call count and the number of integers, longs,
+   floats, doubles, booleans and strings), the arguments of the calls
+   follow in order. the reply has the same layout, the calls after a
+   call that failed are not handled */
+bool handle_batch() {
+  int function_id = header_in[HEADER_FUNCTION_ID];
+  int call_count = header_in[HEADER_CALL_COUNT];
+  int number_of_calls = ints_in[0];
+  int * call_headers = ints_in + 1;
+  int * reply_headers = ints_out + 1;
+  int totals[6] = {1 + number_of_calls * BATCH_HEADER_SIZE, 0, 0, 0, 0, 0};
+  int number_of_replies = 0;
+  bool result = true;
+  
+  int * ints_in_start = ints_in;
+  int * ints_out_start = ints_out;
+  long long int * longs_in_start = longs_in;
+  long long int * longs_out_start = longs_out;
+  float * floats_in_start = floats_in;
+  float * floats_out_start = floats_out;
+  double * doubles_in_start = doubles_in;
+  double * doubles_out_start = doubles_out;
+  bool * booleans_in_start = booleans_in;
+  bool * booleans_out_start = booleans_out;
+  char ** strings_in_start = strings_in;
+  char ** strings_out_start = strings_out;
+  
+  ints_in += totals[0];
+  ints_out += totals[0];
+  
+  for (int i = 0; i < number_of_calls; i++) {
+    int * call_header = call_headers + i * BATCH_HEADER_SIZE;
+    int * reply_header = reply_headers + i * BATCH_HEADER_SIZE;
+    
+    if (call_header[0] == BATCH_FUNCTION_ID) {
+      fprintf(stderr, "a batch cannot contain another batch\n");
+      header_out[HEADER_FLAGS] = header_out[HEADER_FLAGS] | ERROR_FLAG;
+      break;
+    }
+    
+    header_in[HEADER_FUNCTION_ID] = call_header[0];
+    header_in[HEADER_CALL_COUNT] = call_header[1];
+    header_out[HEADER_INTEGER_COUNT] = 0;
+    header_out[HEADER_LONG_COUNT] = 0;
+    header_out[HEADER_FLOAT_COUNT] = 0;
+    header_out[HEADER_DOUBLE_COUNT] = 0;
+    header_out[HEADER_BOOLEAN_COUNT] = 0;
+    header_out[HEADER_STRING_COUNT] = 0;
+    
+    result = handle_call();
+    
+    reply_header[0] = call_header[0];
+    reply_header[1] = call_header[1];
+    reply_header[2] = header_out[HEADER_INTEGER_COUNT];
+    reply_header[3] = header_out[HEADER_LONG_COUNT];
+    reply_header[4] = header_out[HEADER_FLOAT_COUNT];
+    reply_header[5] = header_out[HEADER_DOUBLE_COUNT];
+    reply_header[6] = header_out[HEADER_BOOLEAN_COUNT];
+    reply_header[7] = header_out[HEADER_STRING_COUNT];
+    number_of_replies++;
+    
+    ints_in += call_header[2];
+    longs_in += call_header[3];
+    floats_in += call_header[4];
+    doubles_in += call_header[5];
+    booleans_in += call_header[6];
+    strings_in += call_header[7];
+    
+    ints_out += reply_header[2];
+    longs_out += reply_header[3];
+    floats_out += reply_header[4];
+    doubles_out += reply_header[5];
+    booleans_out += reply_header[6];
+    strings_out += reply_header[7];
+    
+    for (int j = 0; j < 6; j++) {
+      totals[j] += reply_header[j + 2];
+    }
+    
+    if (!result || (header_out[HEADER_FLAGS] & ERROR_FLAG)) {
+      break;
+    }
+  }
+  
+  ints_in = ints_in_start;
+  ints_out = ints_out_start;
+  longs_in = longs_in_start;
+  longs_out = longs_out_start;
+  floats_in = floats_in_start;
+  floats_out = floats_out_start;
+  doubles_in = doubles_in_start;
+  doubles_out = doubles_out_start;
+  booleans_in = booleans_in_start;
+  booleans_out = booleans_out_start;
+  strings_in = strings_in_start;
+  strings_out = strings_out_start;
+  
+  ints_out[0] = number_of_replies;
+  
+  header_in[HEADER_FUNCTION_ID] = function_id;
+  header_in[HEADER_CALL_COUNT] = call_count;
+  header_out[HEADER_INTEGER_COUNT] = totals[0];
+  header_out[HEADER_LONG_COUNT] = totals[1];
+  header_out[HEADER_FLOAT_COUNT] = totals[2];
+  header_out[HEADER_DOUBLE_COUNT] = totals[3];
+  header_out[HEADER_BOOLEAN_COUNT] = totals[4];
+  header_out[HEADER_STRING_COUNT] = totals[5];
+  
+  return result;
+}
+
+void onexit_mpi(void) {
+#ifndef NOMPI
+    int flag = 0;
+    MPI_Finalized(&flag);
+    
+    if(!flag) {
+        MPI_Comm parent;
+        MPI_Comm_get_parent(&parent);
+        
+        int rank = 0;
+        
+        MPI_Comm_rank(parent, &rank);
+        
+        header_out[HEADER_FLAGS] = ERROR_FLAG;
+
+        header_out[HEADER_CALL_ID] = 0;
+        header_out[HEADER_FUNCTION_ID] = 0;
+        header_out[HEADER_CALL_COUNT] = 0;
+        header_out[HEADER_INTEGER_COUNT] = 0;
+        header_out[HEADER_LONG_COUNT] = 0;
+        header_out[HEADER_FLOAT_COUNT] = 0;
+        header_out[HEADER_DOUBLE_COUNT] = 0;
+        header_out[HEADER_BOOLEAN_COUNT] = 0;
+        header_out[HEADER_STRING_COUNT] = 0;
+        header_out[HEADER_UNITS_COUNT] = 0;
+
+        MPI_Send(header_out, HEADER_SIZE, MPI_INT, 0, 999, parent);
+        
+        for(int i = 0; i < lastid + 1; i++) {
+            MPI_Comm_disconnect(&communicators[i]);
+        }
+        
+        MPI_Finalize();
+    }
+#endif
+}
+
+void onexit_sockets(void) {
+#ifdef WIN32
+	closesocket(socketfd);
+#else
+	close(socketfd);
+	if (shared_memory) {
+		munmap(shared_memory, shared_memory_size);
+		shared_memory = 0;
+	}
+#endif
+}
+
+void send_array_sockets(void *buffer, int length, int file_descriptor, int rank) {
+    int total_written = 0;
+    int bytes_written;
+
+    if (rank != 0) {
+        return;
+    }
+    //fprintf(stderr, "number of bytes to write: %d\n", length);
+    while (total_written < length) {
+    
+#ifdef WIN32
+        bytes_written = send(file_descriptor, ((char *) buffer) + total_written,
+                        length - total_written, 0);
+#else
+        bytes_written = write(file_descriptor, ((char *) buffer) + total_written,
+                        length - total_written);
+#endif
+
+
+        if (bytes_written == -1) {
+            perror("could not write data");
+            exit(1);
+        }
+
+        total_written = total_written + bytes_written;
+    }
+}
+
+void receive_array_sockets(void *buffer, int length, int file_descriptor, int rank) {
+    int total_read = 0;
+    int bytes_read;
+
+    if (rank != 0) {
+        return;
+    }
+
+    while (total_read < length) {
+    
+#ifdef WIN32
+        bytes_read = recv(file_descriptor, ((char *) buffer) + total_read,
+                        length - total_read, 0);
+#else
+        bytes_read = read(file_descriptor, ((char *) buffer) + total_read,
+                        length - total_read);
+#endif
+
+        if (bytes_read == -1) {
+            perror("could not read data");
+            exit(1);
+        }
+
+        total_read = total_read + bytes_read;
+    }
+}
+
+void open_shared_memory(char * filename) {
+#ifdef WIN32
+    fprintf(stderr, "shared memory channel not supported on windows\n");
+    exit(1);
+#else
+    struct stat file_info;
+    int file_descriptor = open(filename, O_RDWR);
+
+    if (file_descriptor == -1 || fstat(file_descriptor, &file_info) == -1) {
+        perror("could not open shared memory");
+        exit(1);
+    }
+
+    shared_memory_size = file_info.st_size;
+    shared_memory = (char *) mmap(0, shared_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+
+    if (shared_memory == MAP_FAILED) {
+        perror("could not map shared memory");
+        exit(1);
+    }
+#endif
+}
+
+/* arrays in the shared memory start on an 8 byte boundary */
+size_t shared_memory_align(size_t offset) {
+    return (offset + 7) & ~((size_t) 7);
+}
+
+void receive_array(void *buffer, int length, int rank) {
+    if (rank != 0) {
+        return;
+    }
+
+    if (header_in[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+        memcpy(buffer, shared_memory + shared_memory_offset, length);
+        shared_memory_offset = shared_memory_align(shared_memory_offset + length);
+    } else {
+        receive_array_sockets(buffer, length, socketfd, rank);
+    }
+}
+
+void send_array(void *buffer, int length, int rank) {
+    if (rank != 0) {
+        return;
+    }
+
+    if (header_out[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+        memcpy(shared_memory + shared_memory_offset, buffer, length);
+        shared_memory_offset = shared_memory_align(shared_memory_offset + length);
+    } else {
+        send_array_sockets(buffer, length, socketfd, rank);
+    }
+}
+
+bool reply_fits_in_shared_memory() {
+    size_t total = 0;
+
+    if (!shared_memory) {
+        return false;
+    }
+
+    total += shared_memory_align(header_out[HEADER_INTEGER_COUNT] * sizeof(int));
+    total += shared_memory_align(header_out[HEADER_LONG_COUNT] * sizeof(long long int));
+    total += shared_memory_align(header_out[HEADER_FLOAT_COUNT] * sizeof(float));
+    total += shared_memory_align(header_out[HEADER_DOUBLE_COUNT] * sizeof(double));
+    total += shared_memory_align(header_out[HEADER_BOOLEAN_COUNT] * sizeof(bool));
+    total += shared_memory_align(header_out[HEADER_STRING_COUNT] * sizeof(int));
+    for (int i = 0; i < header_out[HEADER_STRING_COUNT]; i++) {
+        total += strlen(strings_out[i]) + 1;
+    }
+
+    return total <= shared_memory_size / 2;
+}
+
+/* all argument arrays are stored in one block of memory, each array
+   starts on a cache line. blocks of 2MB or more are mapped so that
+   the kernel can back them with huge pages */
+static char * arena = 0;
+static size_t arena_size = 0;
+static bool arena_is_mapped = false;
+
+size_t arena_align(size_t size) {
+    return (size + 63) & ~((size_t) 63);
+}
+
+void * arena_array(size_t * offset, size_t size) {
+    void * result = arena + *offset;
+    *offset += arena_align(size);
+    return result;
+}
+
+void new_arrays(int max_call_count) {
+  /* room for the headers of a batch */
+  int max_ints_in = MAX_INTS_IN + BATCH_HEADER_SIZE + 1;
+  int max_ints_out = MAX_INTS_OUT + BATCH_HEADER_SIZE + 1;
+  /* room for the error message of an unknown function */
+  int max_strings_out = MAX_STRINGS_OUT > 0 ? MAX_STRINGS_OUT : 1;
+  size_t offset = 0;
+  
+  arena_size = 0;
+  arena_size += arena_align(max_call_count * max_ints_in * sizeof(int));
+  arena_size += arena_align(max_call_count * max_ints_out * sizeof(int));
+  arena_size += arena_align(max_call_count * MAX_LONGS_IN * sizeof(long long int));
+  arena_size += arena_align(max_call_count * MAX_LONGS_OUT * sizeof(long long int));
+  arena_size += arena_align(max_call_count * MAX_FLOATS_IN * sizeof(float));
+  arena_size += arena_align(max_call_count * MAX_FLOATS_OUT * sizeof(float));
+  arena_size += arena_align(max_call_count * MAX_DOUBLES_IN * sizeof(double));
+  arena_size += arena_align(max_call_count * MAX_DOUBLES_OUT * sizeof(double));
+  arena_size += arena_align(max_call_count * MAX_BOOLEANS_IN * sizeof(bool));
+  arena_size += arena_align(max_call_count * MAX_BOOLEANS_OUT * sizeof(bool));
+  arena_size += arena_align(max_call_count * MAX_STRINGS_IN * sizeof(int));
+  arena_size += arena_align(max_call_count * max_strings_out * sizeof(int));
+  arena_size += arena_align(max_call_count * MAX_STRINGS_IN * sizeof(char *));
+  arena_size += arena_align(max_call_count * max_strings_out * sizeof(char *));
+  
+  arena = 0;
+  arena_is_mapped = false;
+#if !defined(WIN32) && defined(MAP_ANONYMOUS)
+  if (arena_size >= 2097152) {
+    void * block = mmap(0, arena_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+      madvise(block, arena_size, MADV_HUGEPAGE);
+#endif
+      arena = (char *) block;
+      arena_is_mapped = true;
+    }
+  }
+#endif
+  if (!arena) {
+    arena = (char *) malloc(arena_size > 0 ? arena_size : 1);
+    if (!arena) {
+      fprintf(stderr, "could not allocate %lu bytes for the arguments\n", (unsigned long) arena_size);
+      exit(1);
+    }
+  }
+  
+  ints_in = (int *) arena_array(&offset, max_call_count * max_ints_in * sizeof(int));
+  ints_out = (int *) arena_array(&offset, max_call_count * max_ints_out * sizeof(int));
+
+  longs_in = (long long int *) arena_array(&offset, max_call_count * MAX_LONGS_IN * sizeof(long long int));
+  longs_out = (long long int *) arena_array(&offset, max_call_count * MAX_LONGS_OUT * sizeof(long long int));
+
+  floats_in = (float *) arena_array(&offset, max_call_count * MAX_FLOATS_IN * sizeof(float));
+  floats_out = (float *) arena_array(&offset, max_call_count * MAX_FLOATS_OUT * sizeof(float));
+
+  doubles_in = (double *) arena_array(&offset, max_call_count * MAX_DOUBLES_IN * sizeof(double));
+  doubles_out = (double *) arena_array(&offset, max_call_count * MAX_DOUBLES_OUT * sizeof(double));
+  
+  booleans_in = (bool *) arena_array(&offset, max_call_count * MAX_BOOLEANS_IN * sizeof(bool));
+  booleans_out = (bool *) arena_array(&offset, max_call_count * MAX_BOOLEANS_OUT * sizeof(bool));
+  
+  string_sizes_in = (int *) arena_array(&offset, max_call_count * MAX_STRINGS_IN * sizeof(int));
+  string_sizes_out = (int *) arena_array(&offset, max_call_count * max_strings_out * sizeof(int));
+
+  strings_in = (char **) arena_array(&offset, max_call_count * MAX_STRINGS_IN * sizeof(char *));
+  strings_out = (char **) arena_array(&offset, max_call_count * max_strings_out * sizeof(char *));
+}
+
+void delete_arrays() {
+#if !defined(WIN32) && defined(MAP_ANONYMOUS)
+  if (arena_is_mapped) {
+    munmap(arena, arena_size);
+  } else {
+    free(arena);
+  }
+#else
+  free(arena);
+#endif
+  arena = 0;
+  arena_size = 0;
+}
+
+/* grows max_call_count geometrically, so that alternating small and
+   large calls do not reallocate the arrays every time */
+int grow_arrays(int call_count, int max_call_count) {
+  int new_max_call_count = 2 * max_call_count;
+  
+  if (new_max_call_count < call_count) {
+    new_max_call_count = call_count;
+  }
+  
+  delete_arrays();
+  new_arrays(new_max_call_count);
+  
+  return new_max_call_count;
+}
+
+/* the string data is kept between calls and only grows */
+static size_t characters_in_size = 0;
+static size_t characters_out_size = 0;
+
+void reserve_characters(char ** buffer, size_t * size, size_t needed) {
+  if (needed <= *size) {
+    return;
+  }
+  
+  size_t new_size = 2 * (*size);
+  if (new_size < needed) {
+    new_size = needed;
+  }
+  
+  free(*buffer);
+  *buffer = (char *) malloc(new_size);
+  if (!*buffer) {
+    fprintf(stderr, "could not allocate %lu bytes for the strings\n", (unsigned long) new_size);
+    exit(1);
+  }
+  *size = new_size;
+}
+
+char * receive_characters(int total_string_size, int rank) {
+  if (rank == 0 && (header_in[HEADER_FLAGS] & SHARED_MEMORY_FLAG)) {
+    /* strings are used in place */
+    char * result = shared_memory + shared_memory_offset;
+    shared_memory_offset = shared_memory_align(shared_memory_offset + total_string_size);
+    return result;
+  }
+  
+  reserve_characters(&characters_in, &characters_in_size, total_string_size);
+  receive_array(characters_in, total_string_size, rank);
+  return characters_in;
+}
+
+/* sets the string sizes of the output strings and returns the total
+   number of bytes needed to store them, including the zero bytes */
+size_t compute_string_sizes_out() {
+  size_t total = 0;
+  
+  for (int i = 0; i < header_out[HEADER_STRING_COUNT]; i++) {
+    string_sizes_out[i] = strlen(strings_out[i]);
+    total += string_sizes_out[i] + 1;
+  }
+  
+  return total;
+}
+
+void pack_strings_out(char * buffer) {
+  size_t offset = 0;
+  
+  for (int i = 0; i < header_out[HEADER_STRING_COUNT]; i++) {
+    memcpy(buffer + offset, strings_out[i], string_sizes_out[i] + 1);
+    offset += string_sizes_out[i] + 1;
+  }
+}
+
+void send_strings(int rank) {
+  size_t total = compute_string_sizes_out();
+
+  send_array(string_sizes_out, header_out[HEADER_STRING_COUNT] * sizeof(int), rank);
+  
+  if (header_out[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+    /* pack directly in the shared memory */
+    pack_strings_out(shared_memory + shared_memory_offset);
+    shared_memory_offset = shared_memory_align(shared_memory_offset + total);
+  } else {
+    reserve_characters(&characters_out, &characters_out_size, total);
+    pack_strings_out(characters_out);
+    send_array_sockets(characters_out, total, socketfd, rank);
+  }
+}
+
+#if !defined(NOMPI) && _POSIX_VERSION >= 1
+void abort_mpi_on_signal(int signo)
+{
+    MPI_Comm parent;
+    MPI_Request req;
+    MPI_Comm_get_parent(&parent);
+
+    header_out[HEADER_FLAGS] = ERROR_FLAG;
+    header_out[HEADER_CALL_ID] = 0;
+    header_out[HEADER_FUNCTION_ID] = 0;
+    header_out[HEADER_CALL_COUNT] = 0;
+    header_out[HEADER_INTEGER_COUNT] = 0;
+    header_out[HEADER_LONG_COUNT] = 0;
+    header_out[HEADER_FLOAT_COUNT] = 0;
+    header_out[HEADER_DOUBLE_COUNT] = 0;
+    header_out[HEADER_BOOLEAN_COUNT] = 0;
+    header_out[HEADER_STRING_COUNT] = 0;
+    header_out[HEADER_UNITS_COUNT] = 0;
+
+    MPI_Isend(header_out, HEADER_SIZE, MPI_INT, 0, 999, parent, &req);
+
+    MPI_Comm_disconnect(&parent);
+    MPI_Abort(MPI_COMM_WORLD, -1);
+}
+#endif
+
+void run_mpi(int argc, char *argv[]) {
+#ifndef NOMPI
+  int provided;
+  int rank = 0;
+  
+  mpiIntercom = true;
+
+  //fprintf(stderr, "C worker: running in mpi mode\n");
+  
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+#if _POSIX_VERSION >= 1
+  if (provided == MPI_THREAD_MULTIPLE) {
+    int abort_signals[] = {
+        SIGABRT, SIGBUS, SIGILL, SIGINT, SIGQUIT, SIGSEGV, SIGTERM
+    };
+    struct sigaction handler;
+    handler.sa_handler = abort_mpi_on_signal;
+    sigemptyset(&handler.sa_mask);
+    handler.sa_flags = 0;
+
+    for (int i = 0; i < (sizeof abort_signals) / (sizeof abort_signals[0]); i++) {
+        int result = sigaction(abort_signals[i], &handler, NULL);
+        if (result == -1) {
+            perror("Error installing signal handler");
+            exit(EXIT_FAILURE);
+        }
+    }
+  }
+#endif
+  MPI_Comm parent;
+  MPI_Comm_get_parent(&communicators[0]);
+  lastid += 1;
+  activeid = 0;
+  parent = communicators[activeid];
+  MPI_Comm_rank(parent, &rank);
+  atexit(onexit_mpi);
+  
+  bool must_run_loop = true;
+  
+  int max_call_count = 10;
+  
+  header_in = new int[HEADER_SIZE];
+  header_out = new int[HEADER_SIZE];
+
+  new_arrays(max_call_count);  
+
+  while(must_run_loop) {
+    //fprintf(stderr, "receiving header\n");
+    if(id_to_activate >= 0 && id_to_activate != activeid){
+        activeid = id_to_activate;
+        id_to_activate = -1;
+        parent = communicators[activeid];
+        MPI_Comm_rank(parent, &rank);
+    }
+    
+    mpi_recv_header(parent);
+    
+    //fprintf(stderr, "C worker code: got header %d %d %d %d %d %d %d %d %d %d\n", header_in[0], header_in[1], header_in[2], header_in[3], header_in[4], header_in[5], header_in[6], header_in[7], header_in[8], header_in[9]);
+    
+    int call_count = header_in[HEADER_CALL_COUNT];
+
+    if (call_count > max_call_count) {
+      max_call_count = grow_arrays(call_count, max_call_count);
+    }
+    
+    if(header_in[HEADER_INTEGER_COUNT] > 0) {
+      MPI_Bcast(ints_in, header_in[HEADER_INTEGER_COUNT] , MPI_INT, 0, parent);
+    }
+    
+    if(header_in[HEADER_LONG_COUNT] > 0) {
+      MPI_Bcast(longs_in, header_in[HEADER_LONG_COUNT], MPI_LONG_LONG_INT, 0, parent);
+    }
+    
+    if(header_in[HEADER_FLOAT_COUNT] > 0) {
+      MPI_Bcast(floats_in, header_in[HEADER_FLOAT_COUNT], MPI_FLOAT, 0, parent);
+    }
+    
+    if(header_in[HEADER_DOUBLE_COUNT] > 0) {
+      MPI_Bcast(doubles_in, header_in[HEADER_DOUBLE_COUNT], MPI_DOUBLE, 0, parent);
+    }
+    
+    if(header_in[HEADER_BOOLEAN_COUNT] > 0) {
+      MPI_Bcast(booleans_in, header_in[HEADER_BOOLEAN_COUNT], MPI_C_BOOL, 0, parent);
+    }
+    
+    if(header_in[HEADER_STRING_COUNT] > 0) {
+      MPI_Bcast(string_sizes_in, header_in[HEADER_STRING_COUNT], MPI_INTEGER, 0, parent);
+      
+      int total_string_size = 0;
+      for (int i = 0; i < header_in[HEADER_STRING_COUNT];i++) {
+        total_string_size += string_sizes_in[i] + 1;
+      }
+      
+      reserve_characters(&characters_in, &characters_in_size, total_string_size);
+      MPI_Bcast(characters_in, total_string_size, MPI_CHARACTER, 0, parent);
+
+      int offset = 0;
+      for (int i = 0 ; i <  header_in[HEADER_STRING_COUNT];i++) {
+          strings_in[i] = characters_in + offset;
+          offset += string_sizes_in[i] + 1;
+      } 
+    }
+
+    header_out[HEADER_FLAGS] = 0;
+    header_out[HEADER_CALL_ID] = header_in[HEADER_CALL_ID];
+    header_out[HEADER_FUNCTION_ID] = header_in[HEADER_FUNCTION_ID];
+    header_out[HEADER_CALL_COUNT] = call_count;
+    header_out[HEADER_INTEGER_COUNT] = 0;
+    header_out[HEADER_LONG_COUNT] = 0;
+    header_out[HEADER_FLOAT_COUNT] = 0;
+    header_out[HEADER_DOUBLE_COUNT] = 0;
+    header_out[HEADER_BOOLEAN_COUNT] = 0;
+    header_out[HEADER_STRING_COUNT] = 0;
+    header_out[HEADER_UNITS_COUNT] = 0;
+
+    //fprintf(stderr, "c worker mpi: handling call\n");
+    
+    must_run_loop = handle_call();
+    
+    //fprintf(stderr, "c worker mpi: call handled\n");
+    
+    MPI_Barrier(MPI_COMM_WORLD);
+    
+    if(rank == 0) {
+      MPI_Send(header_out, HEADER_SIZE, MPI_INT, 0, 999, parent);
+      
+      if(header_out[HEADER_INTEGER_COUNT] > 0) {
+        MPI_Send(ints_out, header_out[HEADER_INTEGER_COUNT], MPI_INT, 0, 999, parent);
+      }
+      if(header_out[HEADER_LONG_COUNT] > 0) {
+        MPI_Send(longs_out, header_out[HEADER_LONG_COUNT], MPI_LONG_LONG_INT, 0, 999, parent);
+      }
+      if(header_out[HEADER_FLOAT_COUNT] > 0) {
+        MPI_Send(floats_out, header_out[HEADER_FLOAT_COUNT], MPI_FLOAT, 0, 999, parent);
+      }
+      if(header_out[HEADER_DOUBLE_COUNT] > 0) {
+        MPI_Send(doubles_out, header_out[HEADER_DOUBLE_COUNT], MPI_DOUBLE, 0, 999, parent);
+      }
+      if(header_out[HEADER_BOOLEAN_COUNT] > 0) {
+        MPI_Send(booleans_out, header_out[HEADER_BOOLEAN_COUNT], MPI_C_BOOL, 0, 999, parent);
+      }
+      if(header_out[HEADER_STRING_COUNT] > 0) {
+        size_t total = compute_string_sizes_out();
+        
+        reserve_characters(&characters_out, &characters_out_size, total);
+        pack_strings_out(characters_out);
+        
+        MPI_Send(string_sizes_out, header_out[HEADER_STRING_COUNT], MPI_INTEGER, 0, 999, parent);
+        MPI_Send(characters_out, total, MPI_BYTE, 0, 999, parent);
+      }
+    
+    }
+    //fprintf(stderr, "call done\n");
+  }
+  delete_arrays();
+  free(characters_in);
+  free(characters_out);
+  
+    for(int i = 0; i < lastid + 1; i++) {
+        MPI_Comm_disconnect(&communicators[i]);
+    }
+    
+    MPI_Finalize();
+  //fprintf(stderr, "mpi finalized\n");
+#else
+  fprintf(stderr, "mpi support not compiled into worker\n");
+  exit(1);
+#endif
+}
+
+void run_sockets_mpi(int argc, char *argv[], int port, char *host, char *shared_memory_filename) {
+#ifndef NOMPI
+ bool must_run_loop = true;
+  int max_call_count = 10;
+  struct sockaddr_in serv_addr;
+  struct hostent *server;
+  int on = 1;
+  int provided = 0;
+  int rank = -1;
+  
+  mpiIntercom = false;
+
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  
+  if (rank == 0) {  
+    //fprintf(stderr, "C worker: running in sockets+mpi mode\n");
+  
+    if (shared_memory_filename) {
+      open_shared_memory(shared_memory_filename);
+    }
+   
+    socketfd = socket(AF_INET, SOCK_STREAM, 0);
+    
+    if (socketfd < 0) {
+      perror("ERROR opening socket");
+      //fprintf(stderr, "cannot open socket\n");
+      exit(1);
+    }
+
+    //turn on no-delay option in tcp for huge speed improvement
+    setsockopt (socketfd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof (on));
+    
+    server = gethostbyname(host);
+    
+    memset((char *) &serv_addr, '\0', sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    memcpy((char *) &serv_addr.sin_addr.s_addr, (char *) server->h_addr, server->h_length);
+    serv_addr.sin_port = htons(port);
+  
+    if (connect(socketfd, (struct sockaddr *) &serv_addr, sizeof(serv_addr)) < 0) {
+      fprintf(stderr, "cannot connect socket to host %s, port %d\n", host, port);
+      fprintf(stderr, "resolved IP address: %s\n",  inet_ntoa( * (struct in_addr *) server->h_addr));
+
+      perror("ERROR connecting socket");
+      //fprintf(stderr, "cannot connect socket\n");
+      exit(1);
+    }
+    
+    //fprintf(stderr, "sockets_mpi: finished initializing code\n");
+  
+    atexit(onexit_sockets);
+  
+  }
+  
+  header_in = new int[HEADER_SIZE];
+  header_out = new int[HEADER_SIZE];
+
+  new_arrays(max_call_count);  
+  
+  while(must_run_loop) {
+    //fprintf(stderr, "sockets_mpi: receiving header\n");
+    receive_array_sockets(header_in, HEADER_SIZE * sizeof(int), socketfd, rank);
+    shared_memory_offset = 0;
+    MPI_Bcast(header_in, HEADER_SIZE, MPI_INT, 0, MPI_COMM_WORLD);
+    
+    //fprintf(stderr, "C sockets_mpi worker code: got header %d %d %d %d %d %d %d %d %d %d\n", header_in[0], header_in[1], header_in[2], header_in[3], header_in[4], header_in[5], header_in[6], header_in[7], header_in[8], header_in[9]);
+    
+    int call_count = header_in[HEADER_CALL_COUNT];
+
+    if (call_count > max_call_count) {
+      max_call_count = grow_arrays(call_count, max_call_count);
+    }
+    
+    if (header_in[HEADER_INTEGER_COUNT] > 0) {
+      receive_array(ints_in, header_in[HEADER_INTEGER_COUNT] * sizeof(int), rank);
+      MPI_Bcast(ints_in, header_in[HEADER_INTEGER_COUNT], MPI_INTEGER, 0, MPI_COMM_WORLD);
+    }
+     
+    if (header_in[HEADER_LONG_COUNT] > 0) {
+      receive_array(longs_in, header_in[HEADER_LONG_COUNT] * sizeof(long long int), rank);
+      MPI_Bcast(longs_in, header_in[HEADER_LONG_COUNT], MPI_LONG_LONG_INT, 0, MPI_COMM_WORLD);
+    }
+    
+    if(header_in[HEADER_FLOAT_COUNT] > 0) {
+      receive_array(floats_in, header_in[HEADER_FLOAT_COUNT] * sizeof(float), rank);
+      MPI_Bcast(floats_in, header_in[HEADER_FLOAT_COUNT], MPI_FLOAT, 0, MPI_COMM_WORLD);
+    }
+    
+    if(header_in[HEADER_DOUBLE_COUNT] > 0) {
+      receive_array(doubles_in, header_in[HEADER_DOUBLE_COUNT] * sizeof(double), rank);
+      MPI_Bcast(doubles_in, header_in[HEADER_DOUBLE_COUNT], MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+    
+    if(header_in[HEADER_BOOLEAN_COUNT] > 0) {
+      receive_array(booleans_in, header_in[HEADER_BOOLEAN_COUNT] * sizeof(bool), rank);
+      MPI_Bcast(booleans_in, header_in[HEADER_BOOLEAN_COUNT], MPI_C_BOOL, 0, MPI_COMM_WORLD);
+    }
+    
+    if(header_in[HEADER_STRING_COUNT] > 0) {
+      receive_array(string_sizes_in, header_in[HEADER_STRING_COUNT] * sizeof(int), rank);
+      MPI_Bcast(string_sizes_in, header_in[HEADER_STRING_COUNT], MPI_INT, 0, MPI_COMM_WORLD);
+      
+      int total_string_size = 0;
+      for (int i = 0; i < header_in[HEADER_STRING_COUNT];i++) {
+        total_string_size += string_sizes_in[i] + 1;
+      }
+      
+      char * characters = receive_characters(total_string_size, rank);
+      MPI_Bcast(characters, total_string_size, MPI_CHARACTER, 0, MPI_COMM_WORLD);
+
+      int offset = 0;
+      for (int i = 0 ; i <  header_in[HEADER_STRING_COUNT];i++) {
+          strings_in[i] = characters + offset;
+          offset += string_sizes_in[i] + 1;
+      } 
+    }
+    
+    header_out[HEADER_FLAGS] = 0;
+    header_out[HEADER_CALL_ID] = header_in[HEADER_CALL_ID];
+    header_out[HEADER_FUNCTION_ID] = header_in[HEADER_FUNCTION_ID];
+    header_out[HEADER_CALL_COUNT] = call_count;
+    header_out[HEADER_INTEGER_COUNT] = 0;
+    header_out[HEADER_LONG_COUNT] = 0;
+    header_out[HEADER_FLOAT_COUNT] = 0;
+    header_out[HEADER_DOUBLE_COUNT] = 0;
+    header_out[HEADER_BOOLEAN_COUNT] = 0;
+    header_out[HEADER_STRING_COUNT] = 0;
+    header_out[HEADER_UNITS_COUNT] = 0;
+
+    //fprintf(stderr, "c worker sockets_mpi: handling call\n");
+    
+    must_run_loop = handle_call();
+    
+    //fprintf(stderr, "c worker sockets_mpi: call handled\n");
+    
+    MPI_Barrier(MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+
+      if (reply_fits_in_shared_memory()) {
+        header_out[HEADER_FLAGS] = header_out[HEADER_FLAGS] | SHARED_MEMORY_FLAG;
+        shared_memory_offset = shared_memory_size / 2;
+      } else {
+        send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
+      }
+          
+      if(header_out[HEADER_INTEGER_COUNT] > 0) {
+        send_array(ints_out, header_out[HEADER_INTEGER_COUNT] * sizeof(int), 0);
+      }
+          
+      if(header_out[HEADER_LONG_COUNT] > 0) {
+        send_array(longs_out, header_out[HEADER_LONG_COUNT] * sizeof(long long int), 0);
+      }
+          
+      if(header_out[HEADER_FLOAT_COUNT] > 0) {
+        send_array(floats_out, header_out[HEADER_FLOAT_COUNT] * sizeof(float), 0);
+      }
+          
+      if(header_out[HEADER_DOUBLE_COUNT] > 0) {
+        send_array(doubles_out, header_out[HEADER_DOUBLE_COUNT] * sizeof(double), 0);
+      }
+          
+      if(header_out[HEADER_BOOLEAN_COUNT] > 0) {
+        send_array(booleans_out, header_out[HEADER_BOOLEAN_COUNT] * sizeof(bool), 0);
+      }
+          
+      if(header_out[HEADER_STRING_COUNT] > 0) {
+        send_strings(0);
+      }
+      
+      if (header_out[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+        send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
+      }
+        
+      //fprintf(stderr, "sockets_mpicall done\n");
+    }
+  }
+  delete_arrays();
+  free(characters_in);
+  free(characters_out);
+  
+  if (rank == 0) {
+  
+#ifdef WIN32
+	closesocket(socketfd);
+#else
+	close(socketfd);
+#endif
+  }
+  
+  MPI_Finalize();
+  
+  //fprintf(stderr, "sockets_mpi done\n");
+#else
+  fprintf(stderr, "mpi support not compiled into worker\n");
+  exit(1);
+#endif
+}
+
+void run_sockets(int port, char *host, char *shared_memory_filename) {
+  bool must_run_loop = true;
+  int max_call_count = 10;
+  struct sockaddr_in serv_addr;
+  struct hostent *server;
+  int on = 1;
+
+#ifdef WIN32
+	WSADATA wsaData;
+	int iResult;
+
+	// Initialize Winsock
+	iResult = WSAStartup(MAKEWORD(2,2), &wsaData);
+	if (iResult != 0) {
+	printf("WSAStartup failed: %d\n", iResult);
+	exit(1);
+	}
+#endif
+  mpiIntercom = false;
+
+  //fprintf(stderr, "C worker: running in sockets mode\n");
+  
+  if (shared_memory_filename) {
+    open_shared_memory(shared_memory_filename);
+  }
+   
+  socketfd = socket(AF_INET, SOCK_STREAM, 0);
+    
+  if (socketfd < 0) {
+    fprintf(stderr, "cannot open socket\n");
+    exit(1);
+  }
+  
+  //turn on no-delay option in tcp for huge speed improvement
+  setsockopt (socketfd, IPPROTO_TCP, TCP_NODELAY, (const char *)&on, sizeof (on));
+    
+  server = gethostbyname(host);
+    
+  memset((char *) &serv_addr, '\0', sizeof(serv_addr));
+  serv_addr.sin_family = AF_INET;
+  memcpy((char *) &serv_addr.sin_addr.s_addr, (char *) server->h_addr, server->h_length);
+  serv_addr.sin_port = htons(port);
+  
+  if (connect(socketfd, (struct sockaddr *) &serv_addr, sizeof(serv_addr)) < 0) {
+    fprintf(stderr, "cannot connect socket to host %s, port %d\n", host, port);
+    fprintf(stderr, "resolved IP address: %s\n",  inet_ntoa( * (struct in_addr *) server->h_addr));
+
+    perror("ERROR connecting socket");
+    //fprintf(stderr, "cannot connect socket\n");
+    exit(1);
+  }
+    
+  //fprintf(stderr, "sockets: finished initializing code\n");
+  
+  atexit(onexit_sockets);
+  
+  header_in = new int[HEADER_SIZE];
+  header_out = new int[HEADER_SIZE];
+
+  new_arrays(max_call_count);  
+  
+  while(must_run_loop) {
+    //fprintf(stderr, "sockets: receiving header\n");
+    receive_array_sockets(header_in, HEADER_SIZE * sizeof(int), socketfd, 0);
+    shared_memory_offset = 0;
+    //fprintf(stderr, "C sockets worker code: got header %d %d %d %d %d %d %d %d %d %d\n", header_in[0], header_in[1], header_in[2], header_in[3], header_in[4], header_in[5], header_in[6], header_in[7], header_in[8], header_in[9]);
+    
+    int call_count = header_in[HEADER_CALL_COUNT];
+
+    if (call_count > max_call_count) {
+      max_call_count = grow_arrays(call_count, max_call_count);
+    }
+    
+    if (header_in[HEADER_INTEGER_COUNT] > 0) {
+      receive_array(ints_in, header_in[HEADER_INTEGER_COUNT] * sizeof(int), 0);
+    }
+     
+    if (header_in[HEADER_LONG_COUNT] > 0) {
+      receive_array(longs_in, header_in[HEADER_LONG_COUNT] * sizeof(long long int), 0);
+    }
+    
+    if(header_in[HEADER_FLOAT_COUNT] > 0) {
+      receive_array(floats_in, header_in[HEADER_FLOAT_COUNT] * sizeof(float), 0);
+    }
+    
+    if(header_in[HEADER_DOUBLE_COUNT] > 0) {
+      receive_array(doubles_in, header_in[HEADER_DOUBLE_COUNT] * sizeof(double), 0);
+    }
+    
+    if(header_in[HEADER_BOOLEAN_COUNT] > 0) {
+      receive_array(booleans_in, header_in[HEADER_BOOLEAN_COUNT] * sizeof(bool), 0);
+    }
+    
+    if(header_in[HEADER_STRING_COUNT] > 0) {
+      receive_array(string_sizes_in, header_in[HEADER_STRING_COUNT] * sizeof(int), 0);
+      
+      int total_string_size = 0;
+      for (int i = 0; i < header_in[HEADER_STRING_COUNT];i++) {
+        total_string_size += string_sizes_in[i] + 1;
+      }
+      
+      char * characters = receive_characters(total_string_size, 0);
+
+      int offset = 0;
+      for (int i = 0 ; i <  header_in[HEADER_STRING_COUNT];i++) {
+          strings_in[i] = characters + offset;
+          offset += string_sizes_in[i] + 1;
+      } 
+    }
+    
+    header_out[HEADER_FLAGS] = 0;
+    header_out[HEADER_CALL_ID] = header_in[HEADER_CALL_ID];
+    header_out[HEADER_FUNCTION_ID] = header_in[HEADER_FUNCTION_ID];
+    header_out[HEADER_CALL_COUNT] = call_count;
+    header_out[HEADER_INTEGER_COUNT] = 0;
+    header_out[HEADER_LONG_COUNT] = 0;
+    header_out[HEADER_FLOAT_COUNT] = 0;
+    header_out[HEADER_DOUBLE_COUNT] = 0;
+    header_out[HEADER_BOOLEAN_COUNT] = 0;
+    header_out[HEADER_STRING_COUNT] = 0;
+    header_out[HEADER_UNITS_COUNT] = 0;
+
+
+    //fprintf(stderr, "c worker sockets: handling call\n");
+    
+    must_run_loop = handle_call();
+    
+    //fprintf(stderr, "c worker sockets: call handled\n");
+
+    if (reply_fits_in_shared_memory()) {
+      header_out[HEADER_FLAGS] = header_out[HEADER_FLAGS] | SHARED_MEMORY_FLAG;
+      shared_memory_offset = shared_memory_size / 2;
+    } else {
+      send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
+    }
+      
+    if(header_out[HEADER_INTEGER_COUNT] > 0) {
+      send_array(ints_out, header_out[HEADER_INTEGER_COUNT] * sizeof(int), 0);
+    }
+      
+    if(header_out[HEADER_LONG_COUNT] > 0) {
+      send_array(longs_out, header_out[HEADER_LONG_COUNT] * sizeof(long long int), 0);
+    }
+      
+    if(header_out[HEADER_FLOAT_COUNT] > 0) {
+      send_array(floats_out, header_out[HEADER_FLOAT_COUNT] * sizeof(float), 0);
+    }
+      
+    if(header_out[HEADER_DOUBLE_COUNT] > 0) {
+      send_array(doubles_out, header_out[HEADER_DOUBLE_COUNT] * sizeof(double), 0);
+    }
+      
+    if(header_out[HEADER_BOOLEAN_COUNT] > 0) {
+        send_array(booleans_out, header_out[HEADER_BOOLEAN_COUNT] * sizeof(bool), 0);
+    }
+      
+    if(header_out[HEADER_STRING_COUNT] > 0) {
+      send_strings(0);
+    }
+    
+    if (header_out[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+      send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
+    }
+    //fprintf(stderr, "call done\n");
+  }
+  delete_arrays();
+  free(characters_in);
+  free(characters_out);
+  
+#ifdef WIN32
+	closesocket(socketfd);
+#else
+	close(socketfd);
+#endif
+  //fprintf(stderr, "sockets done\n");
+}
+ 
+int main(int argc, char *argv[]) {
+  int port;
+  bool use_mpi;
+  char *host;
+  char *shared_memory_filename = 0;
+  
+  //for(int i = 0 ; i < argc; i++) {
+  //  fprintf(stderr, "argument %d is %s\n", i, argv[i]);
+  //}
+
+  if (argc == 1) {
+    run_mpi(argc, argv);
+  } else if (argc == 4 || argc == 5) {
+    port = atoi(argv[1]);
+    host = argv[2];
+    
+    if (argc == 5) {
+      shared_memory_filename = argv[4];
+    }
+    
+    if (strcmp(argv[3], "true") == 0) {
+      use_mpi = true;
+    } else if (strcmp(argv[3], "false") == 0) {
+      use_mpi = false;
+    } else {
+      fprintf(stderr, "mpi enabled setting must be either 'true' or 'false', not %s\n", argv[2]);
+      fprintf(stderr, "usage: %s [PORT HOST MPI_ENABLED [SHARED_MEMORY_FILE]]\n", argv[0]);
+      exit(1);
+    }    
+    
+    if (use_mpi) {
+      run_sockets_mpi(argc, argv, port, host, shared_memory_filename);
+    } else {
+      run_sockets(port, host, shared_memory_filename);
+    }
+  } else {
+    fprintf(stderr, "%s need either 0, 4 or 5 arguments, not %d\n", argv[0], argc);
+    fprintf(stderr, "usage: %s [PORT HOST MPI_ENABLED [SHARED_MEMORY_FILE]]\n", argv[0]);
+    exit(1);
+  }
+
+  return 0;
+}   
+
+
@@ -0,0 +1,110 @@
+#include "stdbool.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int get_mass(int index_of_the_particle, double * mass);
+
+int commit_particles();
+
+int get_time(double * time);
+
+int set_mass(int index_of_the_particle, double mass);
+
+int get_index_of_first_particle(int * index_of_the_particle);
+
+int new_particle_string(int * identity_of_the_particle, char * mass, char * x, char * y, char * z, char * vx, char * vy, char * vz, char * radius);
+
+int get_max_cpu_time(double * max_cpu_time);
+
+int get_total_radius(double * radius);
+
+int get_bs_tolerance_string(char * * bs_tolerance);
+
+int set_bs_tolerance_string(char * bs_tolerance);
+
+int get_total_mass(double * mass);
+
+int evolve_model(double time);
+
+int set_word_length(int word_length);
+
+int set_adaptb_output_directory(char * adaptb_output_directory);
+
+int set_eps2(double epsilon_squared);
+
+int get_adaptb_output_directory(char * * adaptb_output_directory);
+
+int get_begin_time(double * time);
+
+int get_eps2(double * epsilon_squared);
+
+int get_index_of_next_particle(int index_of_the_particle, int * index_of_the_next_particle);
+
+int get_word_length(int * word_length);
+
+int delete_particle(int index_of_the_particle);
+
+int get_potential(int index_of_the_particle, double * potential);
+
+int synchronize_model();
+
+int get_dt_print(double * dt_print);
+
+int set_state(int index_of_the_particle, double mass, double x, double y, double z, double vx, double vy, double vz, double radius);
+
+int set_dt_print(double dt_print);
+
+int get_state(int index_of_the_particle, double * mass, double * x, double * y, double * z, double * vx, double * vy, double * vz, double * radius);
+
+int set_max_cpu_time(double max_cpu_time);
+
+int get_time_step(double * time_step);
+
+int recommit_particles();
+
+int get_kinetic_energy(double * kinetic_energy);
+
+int get_number_of_particles(int * number_of_particles);
+
+int new_particle_float64(int * identity_of_the_particle, double mass, double x, double y, double z, double vx, double vy, double vz, double radius);
+
+int set_bs_tolerance_float64(double bs_tolerance);
+
+int set_acceleration(int index_of_the_particle, double ax, double ay, double az);
+
+int get_center_of_mass_position(double * x, double * y, double * z);
+
+int get_center_of_mass_velocity(double * vx, double * vy, double * vz);
+
+int get_radius(int index_of_the_particle, double * radius);
+
+int set_begin_time(double time);
+
+int get_bs_tolerance_float64(double * bs_tolerance);
+
+int set_radius(int index_of_the_particle, double radius);
+
+int cleanup_code();
+
+int recommit_parameters();
+
+int initialize_code();
+
+int get_potential_energy(double * potential_energy);
+
+int get_velocity(int index_of_the_particle, double * vx, double * vy, double * vz);
+
+int get_position(int index_of_the_particle, double * x, double * y, double * z);
+
+int set_position(int index_of_the_particle, double x, double y, double z);
+
+int get_acceleration(int index_of_the_particle, double * ax, double * ay, double * az);
+
+int commit_parameters();
+
+int set_velocity(int index_of_the_particle, double vx, double vy, double vz);
+#ifdef __cplusplus
+}
+#endif
+
@@ -729,33 +729,40 @@ int get_potential_energy(double *potential_energy)
     return 0;
 }
 
-int get_gravity_at_point(double eps, double x, double y, double z,  double *forcex, double *forcey, double *forcez)
+int get_gravity_at_point(double *eps, double *x, double *y, double *z,  double *forcex, double *forcey, double *forcez, int n)
 {
-    vec p = 0;
-    p[0] = x;
-    p[1] = y;
-    p[2] = z;
-    
-    
-    vec acc = bhtcs.calculate_gravity_at_point(p, bhtcs.eps2_for_gravity, bhtcs.theta_for_tree * bhtcs.theta_for_tree);
+    vec * pos = new vec[n];
+    vec * acc = new vec[n];
+    real * phi = new real[n];
+    for(int i = 0; i < n; i++) {
+        pos[i] = vec(x[i], y[i], z[i]);
+    }
     
-    *forcex = acc[0];
-    *forcey = acc[1];
-    *forcez = acc[2];
+    bhtcs.calculate_gravity_at_points(n, pos, bhtcs.eps2_for_gravity, bhtcs.theta_for_tree * bhtcs.theta_for_tree, acc, phi);
     
+    for(int i = 0; i < n; i++) {
+        forcex[i] = acc[i][0];
+        forcey[i] = acc[i][1];
+        forcez[i] = acc[i][2];
+    }
+    delete [] pos;
+    delete [] acc;
+    delete [] phi;
     return 0;
 }
 
-int get_potential_at_point(double eps, double x, double y, double z, double * phi)
+int get_potential_at_point(double *eps, double *x, double *y, double *z, double * phi, int n)
 {
-    vec p = 0;
-    p[0] = x;
-    p[1] = y;
-    p[2] = z;
+    vec * pos = new vec[n];
+    vec * acc = new vec[n];
+    for(int i = 0; i < n; i++) {
+        pos[i] = vec(x[i], y[i], z[i]);
+    }
     
+    bhtcs.calculate_gravity_at_points(n, pos, bhtcs.eps2_for_gravity, bhtcs.theta_for_tree * bhtcs.theta_for_tree, acc, phi);
     
-    *phi  = bhtcs.calculate_potential_at_point(p, bhtcs.eps2_for_gravity, bhtcs.theta_for_tree * bhtcs.theta_for_tree);
-    //cerr << "phi : "<< *phi << endl;
+    delete [] pos;
+    delete [] acc;
     return 0;
 }
 
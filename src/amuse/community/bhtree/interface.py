@@ -1,7 +1,7 @@
 from amuse.community import *
 from amuse.community.interface.gd import GravitationalDynamicsInterface
 from amuse.community.interface.gd import GravitationalDynamics
-from amuse.community.interface.gd import SinglePointGravityFieldInterface
+from amuse.community.interface.gd import GravityFieldInterface
 from amuse.community.interface.gd import GravityFieldCode
 
 class BHTreeInterface(
@@ -9,12 +9,22 @@ class BHTreeInterface(
     LiteratureReferencesMixIn,
     GravitationalDynamicsInterface,
     StoppingConditionInterface,
-    SinglePointGravityFieldInterface):
+    GravityFieldInterface):
     """
         .. [#] Barnes, J., Hut, P., A Hierarchical O(N log N) force-calculation algorithm, *Nature*, **4**, 324 (1986)   
     """
     include_headers = ['interface.h', 'worker_code.h', 'stopcond.h']
     __so_module__ = 'bhtree_cython'
+
+    # the particle getters only read the particle data, the worker
+    # handles array calls to these functions in parallel
+    get_state = parallel_legacy_function(GravitationalDynamicsInterface.get_state)
+    get_mass = parallel_legacy_function(GravitationalDynamicsInterface.get_mass)
+    get_radius = parallel_legacy_function(GravitationalDynamicsInterface.get_radius)
+    get_position = parallel_legacy_function(GravitationalDynamicsInterface.get_position)
+    get_velocity = parallel_legacy_function(GravitationalDynamicsInterface.get_velocity)
+    get_acceleration = parallel_legacy_function(GravitationalDynamicsInterface.get_acceleration)
+    get_potential = parallel_legacy_function(GravitationalDynamicsInterface.get_potential)
     
     def __init__(self, convert_nbody = None, mode = 'cpu', **kwargs):
         CodeInterface.__init__(self, name_of_the_worker=self.name_of_the_worker(mode), **kwargs)
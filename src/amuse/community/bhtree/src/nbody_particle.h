@@ -172,6 +172,8 @@ class nbody_system
     // routines added by AVE (Mar 2010)
     vec calculate_gravity_at_point(vec pos, real eps2, real theta2);
     real calculate_potential_at_point(vec pos, real eps2, real theta2);
+    void calculate_gravity_at_points(int npoints, vec * pos, real eps2, real theta2,
+                                     vec * acc, real * phi);
 };
 
 #endif
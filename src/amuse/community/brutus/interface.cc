@@ -32,7 +32,7 @@ std::map<int, int> local_index_map;
 //string result_strings[10];
 
 Brutus *brutus = NULL;
-Cluster *cluster = NULL;
+Cluster<mpreal> *cluster = NULL;
 
 mpreal t_begin; //constructor sets to zero by default = "0";
 mpreal eta = "0.24";
@@ -63,7 +63,8 @@ int initialize_code() {
     mpreal::set_default_prec(numBits);
 
     brutus = new Brutus();
-    cluster = new Cluster();
+    brutus->set_numBits(numBits);
+    cluster = new Cluster<mpreal>();
 
     particle_id_counter = 0;
 
@@ -81,7 +82,7 @@ int initialize_code() {
 
 int new_particle_string(int *particle_identifier, char* mass,
         char* x, char* y, char* z, char* vx, char* vy, char* vz, char* radius) {
-    Star s;
+    Star<mpreal> s;
     s.m=mass;
     s.x[0]=x;
     s.x[1]=y;
@@ -101,7 +102,7 @@ int new_particle_string(int *particle_identifier, char* mass,
 int new_particle_float64(int *particle_identifier, double mass,
         double x, double y, double z, double vx, double vy, double vz, double radius) {
     DEBUG::DEB <<  "new_particle_float64  "<< "\n"; DEBUG::DEB.flush();
-    Star s;
+    Star<mpreal> s;
     s.m=mass;
     s.x[0]=x;
     s.x[1]=y;
@@ -242,6 +243,7 @@ odata << t << ": changing L from " << numBits << ", to " << mynumBits << endl;
 
     numBits = mynumBits;
     mpreal::set_default_prec(numBits);
+    brutus->set_numBits(numBits);
 //    numDigits = (int)abs(log10( pow("2.0", -numBits) )).toLong();
 //    brutus->set_numBits(numBits);
 
@@ -274,6 +276,20 @@ int get_word_length(int *mynumBits) {
     *mynumBits = numBits;
     return 0;
 }
+// Integrate in double-, triple- or quad-double arithmetic when the
+// word length fits, instead of mpreal
+int set_use_multi_prec(int use_multi_prec) {
+    brutus->set_use_multi_prec(use_multi_prec != 0);
+    return 0;
+}
+int get_use_multi_prec(int *use_multi_prec) {
+    *use_multi_prec = brutus->get_use_multi_prec() ? 1 : 0;
+    return 0;
+}
+int get_multi_prec_size(int *size) {
+    *size = brutus->get_multi_prec_size();
+    return 0;
+}
 
 int set_eps2(double eps2) {
     return 0;
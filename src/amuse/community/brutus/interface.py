@@ -178,6 +178,30 @@ class BrutusInterface(CodeInterface, GravitationalDynamicsInterface, LiteratureR
         function.result_type = 'int32'
         return function
 
+    ####
+    @legacy_function
+    def get_use_multi_prec():
+        function = LegacyFunctionSpecification()
+        function.addParameter('use_multi_prec', dtype='int32', direction=function.OUT)
+        function.result_type = 'int32'
+        return function
+    @legacy_function
+    def set_use_multi_prec():
+        function = LegacyFunctionSpecification()
+        function.addParameter('use_multi_prec', dtype='int32', direction=function.IN)
+        function.result_type = 'int32'
+        return function
+    @legacy_function
+    def get_multi_prec_size():
+        """
+        Number of doubles in the expansion used for the integration at
+        the current word length, or 0 if it runs in mpreal
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('size', dtype='int32', direction=function.OUT)
+        function.result_type = 'int32'
+        return function
+
     ####
     @legacy_function
     def get_eta_string():
@@ -506,6 +530,14 @@ class Brutus(GravitationalDynamics, GravityFieldCode):
             default_value = 72
         )
 
+        handler.add_boolean_parameter(
+            "get_use_multi_prec",
+            "set_use_multi_prec",
+            "use_multi_prec",
+            "Integrate in double-, triple- or quad-double arithmetic instead of mpreal when the word length fits (up to 208 bits)",
+            True
+        )
+
         handler.add_method_parameter(
             "get_eta",
             "set_eta",
@@ -563,6 +595,10 @@ class Brutus(GravitationalDynamics, GravityFieldCode):
         handler.add_method('INITIALIZED', 'set_word_length')
         handler.add_method('EDIT', 'set_word_length')
         handler.add_method('UPDATE', 'set_word_length')
+        handler.add_method('INITIALIZED', 'set_use_multi_prec')
+        handler.add_method('EDIT', 'set_use_multi_prec')
+        handler.add_method('UPDATE', 'set_use_multi_prec')
+        handler.add_method('RUN', 'set_use_multi_prec')
 
         handler.add_transition('RUN', 'UPDATE', 'new_particle_string', False)
         handler.add_transition('RUN', 'UPDATE', 'set_velocity_string', False)
@@ -8,6 +8,8 @@ Brutus::Brutus() {
 
   tolerance = "1e-6";
 //  numBits = 56;
+  numBits = mpreal::get_default_prec();
+  use_multi_prec = true;
   eta= new mpreal();
   *eta = get_eta(tolerance);
 
@@ -21,6 +23,8 @@ Brutus::Brutus(vector<mpreal> &data) {
 
   tolerance = "1e-6";
 //  numBits = 56;
+  numBits = mpreal::get_default_prec();
+  use_multi_prec = true;
   eta= new mpreal();
   *eta = get_eta(tolerance);
 
@@ -34,6 +38,8 @@ Brutus::Brutus(mpreal &t, vector<mpreal> &data, mpreal &tolerance) {
 
   this->tolerance = tolerance;
 //  numBits = get_numBits(tolerance);
+  numBits = mpreal::get_default_prec();
+  use_multi_prec = true;
   eta= new mpreal();
   *eta = get_eta(tolerance);
 
@@ -46,7 +52,8 @@ Brutus::Brutus(mpreal &t, vector<mpreal> &data, mpreal &tolerance, int &numBits)
   N = data.size()/arg_cnt;
 
   this->tolerance = tolerance;
-//  this->numBits = numBits;
+  this->numBits = numBits;
+  use_multi_prec = true;
   eta= new mpreal();
   *eta = get_eta(tolerance);
 
@@ -61,7 +68,7 @@ void Brutus::set_data(vector<mpreal> &data) {
 
 
 //Star::DEBUG <<"\n"; Star::DEBUG.flush();
-  Cluster c(data);
+  Cluster<mpreal> c(data);
   cl = c;
 }
 void Brutus::set_eta(mpreal p_eta) {
@@ -74,9 +81,12 @@ void Brutus::set_tolerance(mpreal &tolerance) {
   this->tolerance = tolerance;
   bs.set_tolerance(tolerance);
 }
-/*void Brutus::set_numBits(int &numBits) {
+void Brutus::set_numBits(int numBits) {
   this->numBits = numBits;
-}*/
+}
+void Brutus::set_use_multi_prec(bool use_multi_prec) {
+  this->use_multi_prec = use_multi_prec;
+}
 void Brutus::set_t_begin(mpreal &t_begin) {
 //DEBUG::DEB <<  "Brutus::set_t_begin(mpreal &t_begin)\n"; DEBUG::DEB.flush();
   this->t = t_begin;
@@ -107,9 +117,24 @@ mpreal Brutus::get_tolerance() {
 //DEBUG::DEB <<  "Brutus::get_tolerance()\n"; DEBUG::DEB.flush();
   return tolerance;
 }
-/*int Brutus::get_numBits() {
+int Brutus::get_numBits() {
   return numBits;
-}*/
+}
+bool Brutus::get_use_multi_prec() {
+  return use_multi_prec;
+}
+// Number of doubles in the smallest multi_prec expansion that holds
+// numBits mantissa bits, or 0 if the integration runs in mpreal.
+int Brutus::get_multi_prec_size() {
+#ifndef BRUTUS_MPREAL_ONLY
+  if(use_multi_prec) {
+    for(int K=2; K<=BRUTUS_MULTI_PREC_MAX; K++) {
+      if(numBits <= K*BRUTUS_MULTI_PREC_BITS) return K;
+    }
+  }
+#endif // BRUTUS_MPREAL_ONLY
+  return 0;
+}
 /*int Brutus::get_numBits(mpreal tolerance) {
   mpreal absloge = abs( log10(tolerance) );
   return 4*(int)absloge.toLong()+32;
@@ -140,32 +165,67 @@ mpreal Brutus::fit_slope(vector<mpreal> &x, vector<mpreal> &y) {
 */
 void Brutus::setup() {
 //DEBUG::DEB <<  "Brutus::setup()\n"; DEBUG::DEB.flush();
-  Cluster c(data);
+  Cluster<mpreal> c(data);
   c.eps2 = "0";
   cl = c;
 
-  Bulirsch_Stoer b(tolerance);
+  Bulirsch_Stoer<mpreal> b(tolerance);
   bs = b;
 
   *eta = get_eta(tolerance);
 }
 
-void Brutus::evolve(mpreal t_end) {
+template <class T>
+void Brutus::evolve(Cluster<T> &cl, Bulirsch_Stoer<T> &bs, T &t, T t_end, T eta) {
+  T dt;
   while (t<t_end) {
     cl.calcAcceleration_dt();
-    dt = *eta*cl.dt;
+    dt = eta*cl.dt;
 //DEBUG::DEB <<  "Brutus::evolve  "<< eta->toString() <<"\n"; DEBUG::DEB.flush();
     if(t+dt > t_end) dt = t_end-t;
 
     bool converged = bs.integrate(cl, dt);
 
     if(!converged) {
-      cerr << "Not converged at " << t << "!" << endl;
+      cerr << "Not converged at " << to_mpreal(t) << "!" << endl;
       exit(1);
     }
 
     t += dt;
   }
+}
+#ifndef BRUTUS_MPREAL_ONLY
+// Integrate a K-double copy of the cluster and copy the result back
+// into the mpreal particle set.
+template <int K>
+void Brutus::evolve_multi_prec(mpreal t_end) {
+  Cluster< multi_prec<K> > c(cl);
+  Bulirsch_Stoer< multi_prec<K> > b(from_mpreal< multi_prec<K> >(tolerance), bs.get_n_max(), bs.get_k_max());
+  multi_prec<K> tk = from_mpreal< multi_prec<K> >(t);
+
+  evolve(c, b, tk, from_mpreal< multi_prec<K> >(t_end), from_mpreal< multi_prec<K> >(*eta));
+
+  cl = Cluster<mpreal>(c);
+  t = to_mpreal(tk);
+}
+#endif // BRUTUS_MPREAL_ONLY
+
+void Brutus::evolve(mpreal t_end) {
+  switch(get_multi_prec_size()) {
+#ifndef BRUTUS_MPREAL_ONLY
+  case 2:
+    evolve_multi_prec<2>(t_end);
+    break;
+  case 3:
+    evolve_multi_prec<3>(t_end);
+    break;
+  case 4:
+    evolve_multi_prec<4>(t_end);
+    break;
+#endif // BRUTUS_MPREAL_ONLY
+  default:
+    evolve(cl, bs, t, t_end, *eta);
+  }
   this->data = cl.get_data();
 }
 
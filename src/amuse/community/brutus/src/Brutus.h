@@ -11,17 +11,23 @@ class Brutus {
   vector<mpreal> data;
 
   mpreal tolerance;
-//  int numBits;
+  int numBits;
+  bool use_multi_prec;
 
   mpreal *eta, dt;
   bool eta_was_set=false;
 
 //  Cluster cl;
-  Bulirsch_Stoer bs;
+  Bulirsch_Stoer<mpreal> bs;
+
+  template <class T>
+  void evolve(Cluster<T> &cl, Bulirsch_Stoer<T> &bs, T &t, T t_end, T eta);
+  template <int K>
+  void evolve_multi_prec(mpreal t_end);
 
   public:
 
-  Cluster cl;
+  Cluster<mpreal> cl;
 
   Brutus();
   Brutus(vector<mpreal> &data);
@@ -31,12 +37,15 @@ class Brutus {
   void set_data(vector<mpreal> &data);
   void set_eta(mpreal eta);
   void set_tolerance(mpreal &tolerance);
-//  void set_numBits(int &numBits);
+  void set_numBits(int numBits);
+  void set_use_multi_prec(bool use_multi_prec);
   void set_t_begin(mpreal &t_begin);
 
   mpreal get_eta(mpreal tolerance);
   mpreal get_tolerance();
-//  int get_numBits();
+  int get_numBits();
+  bool get_use_multi_prec();
+  int get_multi_prec_size();
 //  int get_numBits(mpreal tolerance);
 //  mpreal fit_slope(vector<mpreal> &x, vector<mpreal> &y);
 
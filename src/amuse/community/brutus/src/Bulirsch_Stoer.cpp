@@ -1,45 +1,63 @@
 #include "Bulirsch_Stoer.h"
 
-Bulirsch_Stoer::Bulirsch_Stoer() {
-  tolerance = "1e-6";
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
+
+template <class T>
+Bulirsch_Stoer<T>::Bulirsch_Stoer() {
+  tolerance = from_mpreal<T>("1e-6");
   n_max = 32;
   k_max = 128;
+  m_converged = 0;
 }
-Bulirsch_Stoer::Bulirsch_Stoer(mpreal tolerance) {
+template <class T>
+Bulirsch_Stoer<T>::Bulirsch_Stoer(T tolerance) {
   this->tolerance = tolerance;
   n_max = 32;
   k_max = 128;
+  m_converged = 0;
 }
-Bulirsch_Stoer::Bulirsch_Stoer(mpreal tolerance, int n_max, int k_max) {
+template <class T>
+Bulirsch_Stoer<T>::Bulirsch_Stoer(T tolerance, int n_max, int k_max) {
   this->tolerance = tolerance;
   this->n_max = n_max;
   this->k_max = k_max;
+  m_converged = 0;
 }
 
-void Bulirsch_Stoer::set_tolerance(mpreal tolerance) {
+template <class T>
+void Bulirsch_Stoer<T>::set_tolerance(T tolerance) {
   this->tolerance = tolerance;
 }
-void Bulirsch_Stoer::set_n_max(int n_max) {
+template <class T>
+void Bulirsch_Stoer<T>::set_n_max(int n_max) {
   this->n_max = n_max;
 }
-void Bulirsch_Stoer::set_k_max(int k_max) {
+template <class T>
+void Bulirsch_Stoer<T>::set_k_max(int k_max) {
   this->k_max = k_max;
+  m_converged = 0;
 }
 
-mpreal Bulirsch_Stoer::get_tolerance() {
+template <class T>
+T Bulirsch_Stoer<T>::get_tolerance() {
   return tolerance;
 }
-int Bulirsch_Stoer::get_n_max() {
+template <class T>
+int Bulirsch_Stoer<T>::get_n_max() {
   return n_max;
 }
-int Bulirsch_Stoer::get_k_max() {
+template <class T>
+int Bulirsch_Stoer<T>::get_k_max() {
   return k_max;
 }
 
-bool Bulirsch_Stoer::integrate(Cluster &cl, mpreal &dt) {
-  Cluster c0 = cl;
-  Cluster c  = cl;
-  mpreal timestep = dt;
+template <class T>
+bool Bulirsch_Stoer<T>::integrate(Cluster<T> &cl, T &dt) {
+  Cluster<T> c0 = cl;
+  Cluster<T> c  = cl;
+  T timestep = dt;
 //  DEBUG::DEB <<  "Bulirsch_Stoer::integrate  "<< tolerance <<"  " << timestep <<"\n"; DEBUG::DEB.flush();
   bool flag = step(c, timestep);
 
@@ -62,52 +80,77 @@ bool Bulirsch_Stoer::integrate(Cluster &cl, mpreal &dt) {
   #endif // use_additional_acc
   return flag;
 }
-bool Bulirsch_Stoer::step(Cluster &cl, mpreal &dt) {
-  bool flag;
-  int n;
-  vector<mpreal> h;
-  vector<Cluster> c;
-  Cluster cl_exp0 = cl;
-  Cluster cl_exp  = cl;
-
-  // n=1
-  n=1;
-  h.push_back( dt/n );
-  c.push_back( cl );
-  c[0].step( h[0] );
-  cl_exp0 = c[0];
-
-  // n=2
-  n=2;
-  h.push_back( dt/n );
-  c.push_back( cl );
-  for(int i=0; i<n; i++) c[1].step( h[1] );
-  extrapol( cl_exp, h, c );
-
-  flag = error_control(cl_exp0, cl_exp);
-
-  if(flag == false) {
-    while(flag == false && n <= n_max) {
-      n += 2;
-      h.push_back( dt/n );
-      c.push_back( cl );
-      for(int i=0; i<n; i++) c[n/2].step( h[n/2] );
-      cl_exp0 = cl_exp;
+// Number of substeps of the m-th midpoint sequence: 1, 2, 4, 6, ...
+static inline int substeps_in_sequence(int m) {
+  return m == 0 ? 1 : 2*m;
+}
+// Integrate the sequences c.size() .. m_end-1 from cl.  They are
+// independent of each other, so with more than one OpenMP thread they
+// run concurrently, longest first.
+template <class T>
+void Bulirsch_Stoer<T>::integrate_sequences(Cluster<T> &cl, T &dt, vector< Cluster<T> > &c, int m_end) {
+  int m_begin = c.size();
+  c.resize(m_end, cl);
+  mp_prec_t prec = mpreal::get_default_prec();
+  #pragma omp parallel if(m_end-m_begin > 1)
+  {
+    // MPFR keeps the default precision per thread
+    mpreal::set_default_prec(prec);
+    #pragma omp for schedule(dynamic, 1)
+    for(int m=m_end-1; m>=m_begin; m--) {
+      int n = substeps_in_sequence(m);
+      T h = dt/n;
+      for(int i=0; i<n; i++) c[m].step( h );
+    }
+  }
+}
+template <class T>
+bool Bulirsch_Stoer<T>::step(Cluster<T> &cl, T &dt) {
+  bool flag = false;
+  int m = 0, m_max = max(2, n_max/2+2);
+  vector<T> h;
+  vector< Cluster<T> > c;
+  Cluster<T> cl_exp0 = cl;
+  Cluster<T> cl_exp  = cl;
+
+  int n_threads = 1;
+  #ifdef _OPENMP
+  if(!omp_in_parallel()) n_threads = omp_get_max_threads();
+  #endif // _OPENMP
+
+  // The sequences n=1, 2, 4, ... are extrapolated in turn until the
+  // result converges, as in the serial scheme.  With several threads
+  // they are integrated in batches ahead of the extrapolation: first
+  // as many as the previous step needed, then one per thread.
+  while(flag == false && m < m_max) {
+    int batch = (m == 0) ? 2 : 1;
+    if(n_threads > 1) batch = (m == 0) ? max(2, m_converged) : n_threads;
+    integrate_sequences(cl, dt, c, min(m_max, m+batch));
+
+    for(; flag == false && m < (int)c.size(); m++) {
+      h.push_back( dt/substeps_in_sequence(m) );
+      if(m == 0) {
+        cl_exp0 = c[0];
+        continue;
+      }
+      if(m > 1) cl_exp0 = cl_exp;
       extrapol( cl_exp, h, c );
 
       flag = error_control(cl_exp0, cl_exp);
     }
   }
+  if(flag == true) m_converged = m;
 
   cl = cl_exp;
 
   return flag;
 }
-void Bulirsch_Stoer::extrapol(Cluster &cl_exp, vector<mpreal> &dt, vector<Cluster> &c) {
+template <class T>
+void Bulirsch_Stoer<T>::extrapol(Cluster<T> &cl_exp, vector<T> &dt, vector< Cluster<T> > &c) {
   int M = dt.size();
   int N = c[0].s.size();
 
-  vector<mpreal> x_sample(M), y_sample(M), z_sample(M), vx_sample(M), vy_sample(M), vz_sample(M);
+  vector<T> x_sample(M), y_sample(M), z_sample(M), vx_sample(M), vy_sample(M), vz_sample(M);
   for(int i=0; i<N; i++) {
     for(int j=0; j<M; j++) {
       x_sample[j]  = c[j].s[i].x[0];
@@ -117,15 +160,16 @@ void Bulirsch_Stoer::extrapol(Cluster &cl_exp, vector<mpreal> &dt, vector<Cluste
       vy_sample[j] = c[j].s[i].v[1];
       vz_sample[j] = c[j].s[i].v[2];
     }
-    cl_exp.s[i].x[0]  = extrapolate(dt, x_sample, "0.0");
-    cl_exp.s[i].x[1]  = extrapolate(dt, y_sample, "0.0");
-    cl_exp.s[i].x[2]  = extrapolate(dt, z_sample, "0.0");
-    cl_exp.s[i].v[0] = extrapolate(dt, vx_sample, "0.0");
-    cl_exp.s[i].v[1] = extrapolate(dt, vy_sample, "0.0");
-    cl_exp.s[i].v[2] = extrapolate(dt, vz_sample, "0.0");
+    cl_exp.s[i].x[0]  = extrapolate(dt, x_sample, T(0.0));
+    cl_exp.s[i].x[1]  = extrapolate(dt, y_sample, T(0.0));
+    cl_exp.s[i].x[2]  = extrapolate(dt, z_sample, T(0.0));
+    cl_exp.s[i].v[0] = extrapolate(dt, vx_sample, T(0.0));
+    cl_exp.s[i].v[1] = extrapolate(dt, vy_sample, T(0.0));
+    cl_exp.s[i].v[2] = extrapolate(dt, vz_sample, T(0.0));
   }
 }
-mpreal Bulirsch_Stoer::extrapolate(vector<mpreal> x, vector<mpreal> y, mpreal x0) {
+template <class T>
+T Bulirsch_Stoer<T>::extrapolate(vector<T> x, vector<T> y, T x0) {
   int N = x.size();
   if(N == 1) {
     return y[0];
@@ -139,7 +183,8 @@ mpreal Bulirsch_Stoer::extrapolate(vector<mpreal> x, vector<mpreal> y, mpreal x0
     return y[0];
   }
 }
-bool Bulirsch_Stoer::error_control(Cluster &c1, Cluster &c2) {
+template <class T>
+bool Bulirsch_Stoer<T>::error_control(Cluster<T> &c1, Cluster<T> &c2) {
   int N = c1.s.size();
   bool flag = true;
   for(int i=0; i<N; i++) {
@@ -172,4 +217,9 @@ bool Bulirsch_Stoer::error_control(Cluster &c1, Cluster &c2) {
   return flag;
 }
 
-
+template class Bulirsch_Stoer<mpreal>;
+#ifndef BRUTUS_MPREAL_ONLY
+template class Bulirsch_Stoer<multi_prec<2> >;
+template class Bulirsch_Stoer<multi_prec<3> >;
+template class Bulirsch_Stoer<multi_prec<4> >;
+#endif // BRUTUS_MPREAL_ONLY
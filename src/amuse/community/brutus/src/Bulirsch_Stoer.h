@@ -4,29 +4,33 @@
 #ifndef __Bulirsch_Stoer_h
 #define __Bulirsch_Stoer_h
 
+template <class T>
 class Bulirsch_Stoer {
-  mpreal tolerance;
+  T tolerance;
   int n_max, k_max;
+  int m_converged;  // sequences needed by the last converged step
+
+  void integrate_sequences(Cluster<T> &cl, T &dt, vector< Cluster<T> > &c, int m_end);
 
   public:
 
   Bulirsch_Stoer();
-  Bulirsch_Stoer(mpreal tolerance);
-  Bulirsch_Stoer(mpreal tolerance, int n_max, int k_max);
+  Bulirsch_Stoer(T tolerance);
+  Bulirsch_Stoer(T tolerance, int n_max, int k_max);
 
-  void set_tolerance(mpreal tolerance);
+  void set_tolerance(T tolerance);
   void set_n_max(int n_max);
   void set_k_max(int k_max);
 
-  mpreal get_tolerance();
+  T get_tolerance();
   int get_n_max();
   int get_k_max();
 
-  bool integrate(Cluster &cl, mpreal &dt);
-  bool step(Cluster &cl, mpreal &dt);
-  void extrapol(Cluster &cl_exp, vector<mpreal> &dt, vector<Cluster> &c);
-  mpreal extrapolate(vector<mpreal> x, vector<mpreal> y, mpreal x0);
-  bool error_control(Cluster &c1, Cluster &c2);
+  bool integrate(Cluster<T> &cl, T &dt);
+  bool step(Cluster<T> &cl, T &dt);
+  void extrapol(Cluster<T> &cl_exp, vector<T> &dt, vector< Cluster<T> > &c);
+  T extrapolate(vector<T> x, vector<T> y, T x0);
+  bool error_control(Cluster<T> &c1, Cluster<T> &c2);
 };
 
 #endif
@@ -1,74 +1,89 @@
 #include "Cluster.h"
 
-Cluster::Cluster(vector<double> data) {
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
+
+// Below this number of stars the forces are summed serially over the
+// pairs; above it, and outside other parallel regions, each OpenMP
+// thread sums the forces on its own stars.
+#define BRUTUS_PARALLEL_FORCE_N 16
+
+static bool use_parallel_force(int N) {
+#ifdef _OPENMP
+  return N >= BRUTUS_PARALLEL_FORCE_N && !omp_in_parallel() && omp_get_max_threads() > 1;
+#else
+  return false;
+#endif // _OPENMP
+}
+
+template <class T>
+Cluster<T>::Cluster(vector<double> data) {
   int N = data.size()/arg_cnt;
   s.resize(N);
-  mpreal m;
-  vector<mpreal> r(3), v(3);
+  T m;
+  vector<T> r(3), v(3);
   #ifdef use_additional_acc
-  vector<mpreal> a_step(3);
+  vector<T> a_step(3);
   #endif // use_additional_acc
   for(int i=0; i<N; i++) {
-    m    = (mpreal)data[i*arg_cnt+arg_m];
-    r[0] = (mpreal)data[i*arg_cnt+arg_r_0];
-    r[1] = (mpreal)data[i*arg_cnt+arg_r_1];
-    r[2] = (mpreal)data[i*arg_cnt+arg_r_2];
-    v[0] = (mpreal)data[i*arg_cnt+arg_v_0];
-    v[1] = (mpreal)data[i*arg_cnt+arg_v_1];
-    v[2] = (mpreal)data[i*arg_cnt+arg_v_2];
+    m    = (T)data[i*arg_cnt+arg_m];
+    r[0] = (T)data[i*arg_cnt+arg_r_0];
+    r[1] = (T)data[i*arg_cnt+arg_r_1];
+    r[2] = (T)data[i*arg_cnt+arg_r_2];
+    v[0] = (T)data[i*arg_cnt+arg_v_0];
+    v[1] = (T)data[i*arg_cnt+arg_v_1];
+    v[2] = (T)data[i*arg_cnt+arg_v_2];
     #ifdef use_additional_acc
-    a_step[0] = (mpreal)data[i*arg_cnt+arg_a_step_0];
-    a_step[1] = (mpreal)data[i*arg_cnt+arg_a_step_1];
-    a_step[2] = (mpreal)data[i*arg_cnt+arg_a_step_2];
-    s[i] = Star(m, r, v, a_step);
+    a_step[0] = (T)data[i*arg_cnt+arg_a_step_0];
+    a_step[1] = (T)data[i*arg_cnt+arg_a_step_1];
+    a_step[2] = (T)data[i*arg_cnt+arg_a_step_2];
+    s[i] = Star<T>(m, r, v, a_step);
     #else
-    s[i] = Star(m, r, v);
+    s[i] = Star<T>(m, r, v);
     #endif // use_additional_acc
   }
 //  this->time = 0;
 }
-Cluster::Cluster(vector<mpreal> data) {
+template <class T>
+Cluster<T>::Cluster(vector<mpreal> data) {
   int N = data.size()/arg_cnt;
   s.resize(N);
-  mpreal m;
-  vector<mpreal> r(3), v(3);
+  T m;
+  vector<T> r(3), v(3);
   #ifdef use_additional_acc
-  vector<mpreal> a_step(3);
+  vector<T> a_step(3);
   #endif // use_additional_acc
   for(int i=0; i<N; i++) {
-    m    = data[i*arg_cnt+arg_m];
-    r[0] = data[i*arg_cnt+arg_r_0];
-    r[1] = data[i*arg_cnt+arg_r_1];
-    r[2] = data[i*arg_cnt+arg_r_2];
-    v[0] = data[i*arg_cnt+arg_v_0];
-    v[1] = data[i*arg_cnt+arg_v_1];
-    v[2] = data[i*arg_cnt+arg_v_2];
+    convert(m,    data[i*arg_cnt+arg_m]);
+    convert(r[0], data[i*arg_cnt+arg_r_0]);
+    convert(r[1], data[i*arg_cnt+arg_r_1]);
+    convert(r[2], data[i*arg_cnt+arg_r_2]);
+    convert(v[0], data[i*arg_cnt+arg_v_0]);
+    convert(v[1], data[i*arg_cnt+arg_v_1]);
+    convert(v[2], data[i*arg_cnt+arg_v_2]);
     #ifdef use_additional_acc
-    a_step[0] = data[i*arg_cnt+arg_a_step_0];
-    a_step[1] = data[i*arg_cnt+arg_a_step_1];
-    a_step[2] = data[i*arg_cnt+arg_a_step_2];
-    s[i] = Star(m, r, v, a_step);
+    convert(a_step[0], data[i*arg_cnt+arg_a_step_0]);
+    convert(a_step[1], data[i*arg_cnt+arg_a_step_1]);
+    convert(a_step[2], data[i*arg_cnt+arg_a_step_2]);
+    s[i] = Star<T>(m, r, v, a_step);
     #else
-    s[i] = Star(m, r, v);
+    s[i] = Star<T>(m, r, v);
     #endif // use_additional_acc
   }
 //  this->time = 0;
 }
+template <class T>
+template <class U>
+Cluster<T>::Cluster(const Cluster<U> &cl) : Star<T>() {
+  s.reserve(cl.s.size());
+  for(size_t i=0; i<cl.s.size(); i++) s.push_back(Star<T>(cl.s[i]));
+  convert(eps2, cl.eps2);
+  convert(dt, cl.dt);
+}
 
-  mpreal dx; //constructor sets to zero by default = "0";
-  mpreal dy; //constructor sets to zero by default = "0";
-  mpreal dz; //constructor sets to zero by default = "0";
-  mpreal RdotR; //constructor sets to zero by default = "0";
-  mpreal apre; //constructor sets to zero by default = "0";
-  mpreal fm; //constructor sets to zero by default = "0";
-  mpreal daix; //constructor sets to zero by default = "0";
-  mpreal daiy; //constructor sets to zero by default = "0";
-  mpreal daiz; //constructor sets to zero by default = "0";
-  mpreal a2i; //constructor sets to zero by default = "0";
-  mpreal mydti; //constructor sets to zero by default = "0";
-
-
-void Cluster::calcAcceleration_dt() {
+template <class T>
+void Cluster<T>::calcAcceleration_dt() {
   int N = s.size();
   #ifdef use_additional_acc
      for(int i=0; i<N; i++) {
@@ -79,23 +94,17 @@ void Cluster::calcAcceleration_dt() {
      }
   #else
   for(int i=0; i<N; i++) {
-    s[i].a.assign(3, "0");
+    s[i].a.assign(3, T(0.0));
   }
   #endif // use_additional_acc
-  dt.setInf(+1); // = "1e100";
-/*
-  mpreal dx; //constructor sets to zero by default = "0";
-  mpreal dy; //constructor sets to zero by default = "0";
-  mpreal dz; //constructor sets to zero by default = "0";
-  mpreal RdotR; //constructor sets to zero by default = "0";
-  mpreal apre; //constructor sets to zero by default = "0";
-  mpreal fm; //constructor sets to zero by default = "0";
-  mpreal daix; //constructor sets to zero by default = "0";
-  mpreal daiy; //constructor sets to zero by default = "0";
-  mpreal daiz; //constructor sets to zero by default = "0";
-  mpreal a2i; //constructor sets to zero by default = "0";
-  mpreal mydti; //constructor sets to zero by default = "0";
-*/
+  set_infinity(dt); // = "1e100";
+  if(use_parallel_force(N)) {
+    calcAcceleration_parallel(true);
+    dt = fourth_root(dt);
+    return;
+  }
+
+  T dx, dy, dz, RdotR, apre, fm, daix, daiy, daiz, a2i, mydti;
   for(int i=0; i<N-1; i++) {
     for(int j=i+1; j<N; j++) {
 
@@ -103,7 +112,7 @@ void Cluster::calcAcceleration_dt() {
       dy = s[j].x[1]-s[i].x[1];
       dz = s[j].x[2]-s[i].x[2];
       RdotR = dx*dx + dy*dy + dz*dz + eps2;
-      apre = "1"/sqrt(RdotR*RdotR*RdotR);
+      apre = 1.0/sqrt(RdotR*RdotR*RdotR);
 
       fm = s[j].m*apre;
       daix = fm*dx;
@@ -137,9 +146,10 @@ void Cluster::calcAcceleration_dt() {
         }
      }
 */
-  dt = pow(dt, "0.25");
+  dt = fourth_root(dt);
 }
-void Cluster::calcAcceleration() {
+template <class T>
+void Cluster<T>::calcAcceleration() {
   int N = s.size();
   #ifdef use_additional_acc
      for(int i=0; i<N; i++) {
@@ -149,29 +159,22 @@ void Cluster::calcAcceleration() {
      }
   #else
   for(int i=0; i<N; i++) {
-    s[i].a.assign(3, "0");
+    s[i].a.assign(3, T(0.0));
   }
   #endif // use_additional_acc
-/*
-  mpreal dx; //constructor sets to zero by default = "0";
-  mpreal dy; //constructor sets to zero by default = "0";
-  mpreal dz; //constructor sets to zero by default = "0";
-  mpreal RdotR; //constructor sets to zero by default = "0";
-  mpreal apre; //constructor sets to zero by default = "0";
-  mpreal fm; //constructor sets to zero by default = "0";
-  mpreal daix; //constructor sets to zero by default = "0";
-  mpreal daiy; //constructor sets to zero by default = "0";
-  mpreal daiz; //constructor sets to zero by default = "0";
-  mpreal a2i; //constructor sets to zero by default = "0";
-  mpreal mydti; //constructor sets to zero by default = "0";
-*/
+  if(use_parallel_force(N)) {
+    calcAcceleration_parallel(false);
+    return;
+  }
+
+  T dx, dy, dz, RdotR, apre, fm, daix, daiy, daiz;
   for(int i=0; i<N-1; i++) {
     for(int j=i+1; j<N; j++) {
       dx = s[j].x[0]-s[i].x[0];
       dy = s[j].x[1]-s[i].x[1];
       dz = s[j].x[2]-s[i].x[2];
       RdotR = dx*dx + dy*dy + dz*dz + eps2;
-      apre = "1"/sqrt(RdotR*RdotR*RdotR);
+      apre = 1.0/sqrt(RdotR*RdotR*RdotR);
 
       fm = s[j].m*apre;
       daix = fm*dx;
@@ -192,24 +195,73 @@ void Cluster::calcAcceleration() {
   }
 }
 
-void Cluster::updatePositions(mpreal dt) {
+// Every star sums the forces of all others, in the same order as the
+// pairwise loops above (j < i first), so that the accelerations and the
+// timestep criterion do not depend on the number of threads; the
+// pair forces are computed twice.
+template <class T>
+void Cluster<T>::calcAcceleration_parallel(bool with_dt) {
+  int N = s.size();
+  mp_prec_t prec = mpreal::get_default_prec();
+  #pragma omp parallel
+  {
+    // MPFR keeps the default precision per thread
+    mpreal::set_default_prec(prec);
+    T dx, dy, dz, RdotR, apre, fm, daix, daiy, daiz, a2i, mydti, dt_min;
+    set_infinity(dt_min);
+    #pragma omp for schedule(dynamic, 1)
+    for(int i=0; i<N; i++) {
+      for(int j=0; j<N; j++) {
+        if(j == i) continue;
+        dx = s[j].x[0]-s[i].x[0];
+        dy = s[j].x[1]-s[i].x[1];
+        dz = s[j].x[2]-s[i].x[2];
+        RdotR = dx*dx + dy*dy + dz*dz + eps2;
+        apre = 1.0/sqrt(RdotR*RdotR*RdotR);
+
+        fm = s[j].m*apre;
+        daix = fm*dx;
+        daiy = fm*dy;
+        daiz = fm*dz;
+        s[i].a[0] += daix;
+        s[i].a[1] += daiy;
+        s[i].a[2] += daiz;
+
+        if(with_dt) {
+          a2i = daix*daix+daiy*daiy+daiz*daiz;
+          mydti = RdotR/a2i;
+          if(mydti < dt_min) dt_min = mydti;
+        }
+      }
+    }
+    if(with_dt) {
+      #pragma omp critical(brutus_dt_min)
+      if(dt_min < dt) dt = dt_min;
+    }
+  }
+}
+
+template <class T>
+void Cluster<T>::updatePositions(T dt) {
   int N = s.size();
   for(int i=0; i<N; i++) {
     s[i].a0 = s[i].a;
     for(int k = 0; k != 3; ++k)
-      s[i].x[k] += dt*s[i].v[k] + "0.5"*dt*dt*s[i].a0[k];
+      s[i].x[k] += dt*s[i].v[k] + 0.5*dt*dt*s[i].a0[k];
   }
 }
 
-void Cluster::updateVelocities(mpreal dt) {
+template <class T>
+void Cluster<T>::updateVelocities(T dt) {
   int N = s.size();
   for(int i=0; i<N; i++) {
     for(int k = 0; k != 3; ++k) {
-       s[i].v[k] += "0.5"*dt*(s[i].a0[k]+s[i].a[k]);
+       s[i].v[k] += 0.5*dt*(s[i].a0[k]+s[i].a[k]);
     }
   }
 }
-void Cluster::step(mpreal &dt) {
+template <class T>
+void Cluster<T>::step(T &dt) {
   updatePositions(dt);
   calcAcceleration();
   updateVelocities(dt);
@@ -254,31 +306,46 @@ vector<mpreal> Cluster::energies() {
   }
   return ddata;
 }*/
-vector<mpreal> Cluster::get_data() {
+template <class T>
+vector<mpreal> Cluster<T>::get_data() {
   vector<mpreal> ddata;
-  for (vector<Star>::iterator si = s.begin(); si != s.end(); ++si) {
-    ddata.push_back(si->m);
-    ddata.push_back(si->x[0]);
-    ddata.push_back(si->x[1]);
-    ddata.push_back(si->x[2]);
-    ddata.push_back(si->v[0]);
-    ddata.push_back(si->v[1]);
-    ddata.push_back(si->v[2]);
+  for (typename vector< Star<T> >::iterator si = s.begin(); si != s.end(); ++si) {
+    ddata.push_back(to_mpreal(si->m));
+    ddata.push_back(to_mpreal(si->x[0]));
+    ddata.push_back(to_mpreal(si->x[1]));
+    ddata.push_back(to_mpreal(si->x[2]));
+    ddata.push_back(to_mpreal(si->v[0]));
+    ddata.push_back(to_mpreal(si->v[1]));
+    ddata.push_back(to_mpreal(si->v[2]));
     #ifdef use_additional_acc
-    ddata.push_back(si->a_step[0]);
-    ddata.push_back(si->a_step[1]);
-    ddata.push_back(si->a_step[2]);
+    ddata.push_back(to_mpreal(si->a_step[0]));
+    ddata.push_back(to_mpreal(si->a_step[1]));
+    ddata.push_back(to_mpreal(si->a_step[2]));
     #endif // use_additional_acc
   }
   return ddata;
 }
 
 #ifdef use_additional_acc
-void Cluster::remove_step_Acceleration() {
+template <class T>
+void Cluster<T>::remove_step_Acceleration() {
   int N = s.size();
   for(int i=0; i<N; i++) {
     for(int j=0; j<3;j++)
-        s[i].a_step[j].setZero() ;
+        set_zero(s[i].a_step[j]);
   }
 }
 #endif // use_additional_acc
+
+template class Cluster<mpreal>;
+#ifndef BRUTUS_MPREAL_ONLY
+template class Cluster<multi_prec<2> >;
+template class Cluster<multi_prec<3> >;
+template class Cluster<multi_prec<4> >;
+template Cluster<multi_prec<2> >::Cluster(const Cluster<mpreal> &);
+template Cluster<multi_prec<3> >::Cluster(const Cluster<mpreal> &);
+template Cluster<multi_prec<4> >::Cluster(const Cluster<mpreal> &);
+template Cluster<mpreal>::Cluster(const Cluster<multi_prec<2> > &);
+template Cluster<mpreal>::Cluster(const Cluster<multi_prec<3> > &);
+template Cluster<mpreal>::Cluster(const Cluster<multi_prec<4> > &);
+#endif // BRUTUS_MPREAL_ONLY
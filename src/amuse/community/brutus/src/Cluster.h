@@ -27,38 +27,41 @@ enum{
     arg_cnt,
 };
 
-class Cluster : public Star {
+template <class T>
+class Cluster : public Star<T> {
   public:
 
-  vector<Star> s;
-  mpreal eps2;
-//  mpreal time, dt, dt_last;
-  mpreal  dt;
+  vector< Star<T> > s;
+  T eps2;
+//  T time, dt, dt_last;
+  T  dt;
 
-  Cluster() : Star() {}
+  Cluster() : Star<T>() {}
 
   Cluster(vector<double> data);
   Cluster(vector<mpreal> data);
+  template <class U> Cluster(const Cluster<U> &cl);
 
 //  vector<double> get_data_double();
   vector<mpreal> get_data();
 
   void calcAcceleration_dt();
   void calcAcceleration();
+  void calcAcceleration_parallel(bool with_dt);
   #ifdef use_additional_acc
   void remove_step_Acceleration();
   #endif // use_additional_acc
 
 
-  void updatePositions(mpreal dt);
-  void updateVelocities(mpreal dt);
+  void updatePositions(T dt);
+  void updateVelocities(T dt);
 
-  void step(mpreal &dt);
+  void step(T &dt);
 
-//  vector<mpreal> energies();
+//  vector<T> energies();
 
   friend ostream & operator << (ostream &so, Cluster &cl) {
-    for (vector<Star>::iterator si = cl.s.begin(); si != cl.s.end(); ++si) {
+    for (typename vector< Star<T> >::iterator si = cl.s.begin(); si != cl.s.end(); ++si) {
       so << *si;
     }
     return so;
@@ -0,0 +1,103 @@
+#include <limits>
+#include <string>
+
+#ifndef __Precision_h
+#define __Precision_h
+
+// Number types for the integrator.  Star, Cluster and Bulirsch_Stoer
+// are templated on the number type; besides MPFR's mpreal they are
+// instantiated for the fixed-size double-double, triple-double and
+// quad-double expansions of CAMPARY (multi_prec<K>, K doubles).  These
+// live on the stack, so the force loop does not touch the heap.  The
+// expansions are chosen when the requested word length fits (see
+// BRUTUS_MULTI_PREC_BITS); build with -DBRUTUS_MPREAL_ONLY to leave
+// them out.
+
+// multi_prec.h goes first: it calls sqrt(double), which would be
+// ambiguous once the mpfr namespace is pulled in.
+#ifndef BRUTUS_MPREAL_ONLY
+#include "multi_prec.h"
+#define BRUTUS_MULTI_PREC_MAX 4
+#endif // BRUTUS_MPREAL_ONLY
+
+#include "mpreal.h"
+using namespace mpfr;
+
+// Mantissa bits counted per double of an expansion; slightly below 53
+// since the CAMPARY operations are not correctly rounded.
+#define BRUTUS_MULTI_PREC_BITS 52
+
+inline void convert(mpreal &y, const mpreal &x) {
+  y = x;
+}
+inline double to_double(const mpreal &x) {
+  return x.toDouble();
+}
+inline void set_zero(mpreal &x) {
+  x.setZero();
+}
+inline void set_infinity(mpreal &x) {
+  x.setInf(+1);
+}
+inline mpreal fourth_root(const mpreal &x) {
+  return pow(x, "0.25");
+}
+
+#ifndef BRUTUS_MPREAL_ONLY
+// mpreal -> expansion: peel off one double at a time, each difference
+// is exact at the precision of x.
+template <int K>
+inline void convert(multi_prec<K> &y, const mpreal &x) {
+  double d[K];
+  mpreal r = x;
+  for(int k=0; k<K; k++) {
+    d[k] = r.toDouble();
+    r -= d[k];
+  }
+  y.setData(d);
+}
+template <int K>
+inline void convert(mpreal &y, const multi_prec<K> &x) {
+  y = x[0];
+  for(int k=1; k<K; k++) y += x[k];
+}
+template <int K>
+inline void convert(multi_prec<K> &y, const multi_prec<K> &x) {
+  y = x;
+}
+template <int K>
+inline double to_double(const multi_prec<K> &x) {
+  return x[0];
+}
+template <int K>
+inline void set_zero(multi_prec<K> &x) {
+  x = 0.0;
+}
+template <int K>
+inline void set_infinity(multi_prec<K> &x) {
+  x = std::numeric_limits<double>::infinity();
+}
+template <int K>
+inline multi_prec<K> fourth_root(const multi_prec<K> &x) {
+  return sqrt(sqrt(x));
+}
+template <int K>
+inline multi_prec<K> fabs(const multi_prec<K> &x) {
+  return abs(x);
+}
+#endif // BRUTUS_MPREAL_ONLY
+
+template <class T>
+inline T from_mpreal(const mpreal &x) {
+  T y;
+  convert(y, x);
+  return y;
+}
+template <class T>
+inline mpreal to_mpreal(const T &x) {
+  mpreal y;
+  convert(y, x);
+  return y;
+}
+
+#endif
@@ -1,28 +1,68 @@
 #include "Star.h"
 
-Star::Star() {
-  x.assign(3,"0");
-  v.assign(3,"0");
-  a.assign(3,"0");
-  a0.assign(3,"0");
+template <class T>
+Star<T>::Star() {
+  set_zero(m);
+  set_zero(r);
+  T zero;
+  set_zero(zero);
+  x.assign(3,zero);
+  v.assign(3,zero);
+  a.assign(3,zero);
+  a0.assign(3,zero);
 #ifdef use_additional_acc
-  a_step.assign(3,"0");;
+  a_step.assign(3,zero);
 #endif // use_additional_acc
 }
-Star::Star(mpreal m, vector<mpreal> x, vector<mpreal> v
+template <class T>
+Star<T>::Star(T m, vector<T> x, vector<T> v
 #ifdef use_additional_acc
-  , vector<mpreal> a_step
+  , vector<T> a_step
 #endif // use_additional_acc
 )
 {
   this->m = m;
+  set_zero(r);
   this->x = x;
   this->v = v;
+  T zero;
+  set_zero(zero);
   #ifdef use_additional_acc
   this->a_step = a_step;
-  a.assign(3, "0");
+  a.assign(3, zero);
+  #endif // use_additional_acc
+}
+template <class T, class U>
+static void convert(vector<T> &y, const vector<U> &x) {
+  y.resize(x.size());
+  for(size_t k=0; k<x.size(); k++) convert(y[k], x[k]);
+}
+// Copy between number types, e.g. from the mpreal particle set to a
+// quad-double working copy and back.
+template <class T>
+template <class U>
+Star<T>::Star(const Star<U> &si) {
+  id = si.id;
+  convert(m, si.m);
+  convert(r, si.r);
+  convert(x, si.x);
+  convert(v, si.v);
+  convert(a, si.a);
+  convert(a0, si.a0);
+  #ifdef use_additional_acc
+  convert(a_step, si.a_step);
   #endif // use_additional_acc
 }
 
-
-
+template class Star<mpreal>;
+#ifndef BRUTUS_MPREAL_ONLY
+template class Star<multi_prec<2> >;
+template class Star<multi_prec<3> >;
+template class Star<multi_prec<4> >;
+template Star<multi_prec<2> >::Star(const Star<mpreal> &);
+template Star<multi_prec<3> >::Star(const Star<mpreal> &);
+template Star<multi_prec<4> >::Star(const Star<mpreal> &);
+template Star<mpreal>::Star(const Star<multi_prec<2> > &);
+template Star<mpreal>::Star(const Star<multi_prec<3> > &);
+template Star<mpreal>::Star(const Star<multi_prec<4> > &);
+#endif // BRUTUS_MPREAL_ONLY
@@ -13,34 +13,35 @@ public:
 
 #include <vector>
 
-#include "mpreal.h"
-using namespace mpfr;
+#include "Precision.h"
 
 #ifndef __Star_h
 #define __Star_h
 
 #define use_additional_acc
 
+template <class T>
 class Star {
 public:
   size_t id;
-  mpreal m,r;
-  vector<mpreal> x;
-  vector<mpreal> v;
-  vector<mpreal> a, a0;
+  T m,r;
+  vector<T> x;
+  vector<T> v;
+  vector<T> a, a0;
   #ifdef use_additional_acc
-  vector<mpreal> a_step;
+  vector<T> a_step;
   #endif // use_additional_acc
   Star();
-  Star(mpreal m, vector<mpreal> x, vector<mpreal> v
+  Star(T m, vector<T> x, vector<T> v
     #ifdef use_additional_acc
-    , vector<mpreal> a_step
+    , vector<T> a_step
     #endif // use_additional_acc
   );
+  template <class U> Star(const Star<U> &si);
 
   friend ostream & operator << (ostream &so, const Star &si) {
-    so << si.m << " " << si.x[0] << " "<< si.x[1] << " "<< si.x[2] << " "
-                      << si.v[0] << " "<< si.v[1] << " "<< si.v[2] << endl;
+    so << to_mpreal(si.m) << " " << to_mpreal(si.x[0]) << " "<< to_mpreal(si.x[1]) << " "<< to_mpreal(si.x[2]) << " "
+                      << to_mpreal(si.v[0]) << " "<< to_mpreal(si.v[1]) << " "<< to_mpreal(si.v[2]) << endl;
     return so;
   }
 };
@@ -8,9 +8,6 @@ using namespace std;
 #include <numeric> 
 #include <cstdlib>
 
-#include "mpreal.h"
-using namespace mpfr;
-
 #include "Brutus.h"
 
 int main(int argc, char* argv[]) {
@@ -7,6 +7,7 @@
 #include <cmath>
 #include <vector>
 #include "worker_code.h"
+#include "tree_fastkick.h"
 
 #ifdef GPU
 #include "cuda_fastkick.h"
@@ -28,6 +29,7 @@ vector<double> m_all, x_all, y_all, z_all;
 // Control parameters:
 
 double eps2 = 0;
+double theta = 0; // Opening angle of the octree, 0 for exact direct summation
 
 
 int handle_result(int result){
@@ -95,6 +97,10 @@ int commit_particles() {
 #else
     int result = 0;
 #endif
+    tree_cleanup_code();
+    if (theta > 0 && result == 0) {
+        result = tree_commit_particles(m, x, y, z);
+    }
     cerr << "commit_particles done" << endl;
     return result;
 }
@@ -119,6 +125,17 @@ int set_eps2(double _epsilon_squared){
     eps2 = _epsilon_squared;
     return 0;
 }
+int get_theta_for_tree(double *_theta){
+    *_theta = theta;
+    return 0;
+}
+int set_theta_for_tree(double _theta){
+    if (_theta < 0) {
+        return -1;
+    }
+    theta = _theta;
+    return 0;
+}
 
 int cleanup_code() {
     m.clear();
@@ -129,6 +146,7 @@ int cleanup_code() {
     x_all.clear();
     y_all.clear();
     z_all.clear();
+    tree_cleanup_code();
 #ifdef GPU
     return handle_result(cuda_cleanup_code());
 #else
@@ -172,15 +190,31 @@ int set_mass(int *id, double * in, int length) {
     return 0;
 }
 
+// The octree is built in commit_particles, or on first use if the opening
+// angle is set after the particles were committed
+bool use_tree() {
+    if (theta <= 0) {
+        return false;
+    }
+    if (!tree_is_committed()) {
+        tree_commit_particles(m, x, y, z);
+    }
+    return true;
+}
+
 int local_get_potential_at_point(double *eps_in, double *x_in, double *y_in, double *z_in, 
         double *phi, int length){
+    if (use_tree()) {
+        return tree_get_potential_at_point(theta, eps2, eps_in, x_in, y_in, z_in, phi, length);
+    }
 #ifdef GPU
     int result = handle_result(cuda_get_potential_at_point(eps2, eps_in, x_in, y_in, z_in, phi, length));
 #else
     int result = 0;
-    double dx, dy, dz, r;
-    double dr2, eps2_total;
+#pragma omp parallel for
     for (int j = 0; j < length; j++) {
+        double dx, dy, dz, r;
+        double dr2, eps2_total;
         eps2_total = eps2 + eps_in[j]*eps_in[j];
         phi[j] = 0;
         for (int i = 0; i < n_local; i++) {
@@ -211,16 +245,20 @@ int get_potential_at_point(double *eps_in, double *x_in, double *y_in, double *z
     return result;
 }
 
-int get_gravity_at_point(double *eps_in, double *x_in, double *y_in, double *z_in, 
+int local_get_gravity_at_point(double *eps_in, double *x_in, double *y_in, double *z_in, 
         double *ax, double *ay, double *az, int length){
-    double dx, dy, dz, r2, tmp;
-    
+    if (use_tree()) {
+        return tree_get_gravity_at_point(theta, eps2, eps_in, x_in, y_in, z_in, ax, ay, az, length);
+    }
 #ifdef GPU
     cerr << "get_gravity_at_point: start cuda_get_gravity_at_point with " << length << " points and " << n_local << " particles." << endl;
     int result = handle_result(cuda_get_gravity_at_point(eps2, eps_in, x_in, y_in, z_in, ax, ay, az, length));
 #else
-    double dr2, eps2_total;
+    int result = 0;
+#pragma omp parallel for
     for (int j = 0; j < length; j++) {
+        double dx, dy, dz, r2, tmp;
+        double dr2, eps2_total;
         eps2_total = eps2 + eps_in[j]*eps_in[j];
         ax[j] = 0;
         ay[j] = 0;
@@ -240,7 +278,12 @@ int get_gravity_at_point(double *eps_in, double *x_in, double *y_in, double *z_i
         }
     }
 #endif
-    
+    return result;
+}
+
+int get_gravity_at_point(double *eps_in, double *x_in, double *y_in, double *z_in, 
+        double *ax, double *ay, double *az, int length){
+    int result = local_get_gravity_at_point(eps_in, x_in, y_in, z_in, ax, ay, az, length);
 #ifndef NOMPI
     if (mpi_rank) {
         MPI_Reduce(ax, NULL, length, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
@@ -252,12 +295,7 @@ int get_gravity_at_point(double *eps_in, double *x_in, double *y_in, double *z_i
         MPI_Reduce(MPI_IN_PLACE, az, length, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
     }
 #endif
-
-#ifdef GPU
     return result;
-#else
-    return 0;
-#endif
 }
 
 int get_potential_energy(double *potential_energy){
@@ -265,6 +303,9 @@ int get_potential_energy(double *potential_energy){
     int i;
     
     // First calculate local potential energy:
+    if (use_tree()) {
+        tree_get_potential_energy(theta, eps2, potential_energy);
+    } else {
 #ifdef GPU
     int result = handle_result(cuda_get_potential_energy(eps2, potential_energy));
     if (result < 0) return -1;
@@ -282,6 +323,7 @@ int get_potential_energy(double *potential_energy){
         }
     }
 #endif
+    }
 
 // Now calculate contributions to the potential energy from particles on other processes
 #ifndef NOMPI
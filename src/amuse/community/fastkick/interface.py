@@ -71,6 +71,34 @@ class FastKickInterface(CodeInterface, CommonCodeInterface, GravityFieldInterfac
         function.result_type = 'int32'
         return function
     
+    @legacy_function
+    def get_theta_for_tree():
+        """
+        Get theta, the opening angle of the octree. 0 means exact direct summation.
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('theta_for_tree', dtype='float64', direction=function.OUT,
+            description = "theta, the opening angle of the octree: 0 for direct summation, otherwise between 0 and 1")
+        function.result_type = 'int32'
+        return function
+
+    @legacy_function
+    def set_theta_for_tree():
+        """
+        Set theta, the opening angle of the octree. 0 means exact direct summation.
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('theta_for_tree', dtype='float64', direction=function.IN,
+            description = "theta, the opening angle of the octree: 0 for direct summation, otherwise between 0 and 1")
+        function.result_type = 'int32'
+        function.result_doc = """
+        0 - OK
+            the opening angle was set
+        -1 - ERROR
+            the opening angle is negative
+        """
+        return function
+    
     @legacy_function
     def get_potential_energy():
         function = LegacyFunctionSpecification()
@@ -238,6 +266,14 @@ class FastKick(CommonCode, GravityFieldCode):
             "smoothing parameter for gravity calculations", 
             default_value = 0.0 | nbody_system.length * nbody_system.length
         )
+        
+        handler.add_method_parameter(
+            "get_theta_for_tree",
+            "set_theta_for_tree", 
+            "opening_angle", 
+            "opening angle, theta, of the octree (CPU): between 0 and 1, 0 for exact direct summation",
+            default_value = 0.0
+        )
     
     def define_particle_sets(self, handler):
         handler.define_set('particles', 'index_of_the_particle')
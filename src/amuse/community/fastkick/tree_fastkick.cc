@@ -0,0 +1,293 @@
+#include <cmath>
+#include <algorithm>
+#include "tree_fastkick.h"
+
+// Barnes-Hut octree over the particles of this process. Cells that are far
+// enough away from a point are replaced by their monopole and quadrupole
+// moments, the particles in opened leaves are summed directly with the same
+// kernel as the exact mode.
+
+#define LEAF_SIZE 16        // a cell with more particles is split in octants
+#define MAX_DEPTH 40        // stop splitting (coincident particles)
+
+struct tree_node {
+    double mass;
+    double cmx, cmy, cmz;                   // centre of mass
+    double qxx, qyy, qzz, qxy, qxz, qyz;    // traceless quadrupole moment around the centre of mass
+    double size;                            // edge length of the cell
+    double delta;                           // distance between centre of mass and centre of the cell
+    int first, count;                       // particles in this cell, in tree order
+    int next;                               // first node after the subtree of this cell
+    bool leaf;
+};
+
+// Nodes are stored depth first: the first child of a cell directly follows it.
+static vector<tree_node> nodes;
+// Particles in tree order, so the particles of every cell are contiguous
+static vector<double> tm, tx, ty, tz;
+static vector<int> order, buffer;
+static bool committed = false;
+
+static void build_node(vector<double>& x, vector<double>& y, vector<double>& z,
+        int first, int count, double cx, double cy, double cz, double size, int depth) {
+    int index = nodes.size();
+    nodes.push_back(tree_node());
+    nodes[index].first = first;
+    nodes[index].count = count;
+    nodes[index].size = size;
+    nodes[index].leaf = (count <= LEAF_SIZE || depth >= MAX_DEPTH);
+
+    if (!nodes[index].leaf) {
+        // Counting sort of the particles over the octants
+        int start[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+        int octant;
+        for (int k = first; k < first + count; k++) {
+            int i = order[k];
+            octant = (x[i] > cx) + 2*(y[i] > cy) + 4*(z[i] > cz);
+            start[octant+1]++;
+        }
+        for (octant = 0; octant < 8; octant++) {
+            start[octant+1] += start[octant];
+        }
+        int fill[8];
+        copy(start, start + 8, fill);
+        for (int k = first; k < first + count; k++) {
+            int i = order[k];
+            octant = (x[i] > cx) + 2*(y[i] > cy) + 4*(z[i] > cz);
+            buffer[first + fill[octant]++] = i;
+        }
+        copy(buffer.begin() + first, buffer.begin() + first + count, order.begin() + first);
+
+        double quarter = 0.25 * size;
+        for (octant = 0; octant < 8; octant++) {
+            if (start[octant+1] > start[octant]) {
+                build_node(x, y, z, first + start[octant], start[octant+1] - start[octant],
+                    cx + ((octant & 1) ? quarter : -quarter),
+                    cy + ((octant & 2) ? quarter : -quarter),
+                    cz + ((octant & 4) ? quarter : -quarter),
+                    0.5 * size, depth + 1);
+            }
+        }
+    }
+    nodes[index].next = nodes.size();
+    nodes[index].cmx = cx;
+    nodes[index].cmy = cy;
+    nodes[index].cmz = cz;
+}
+
+static void compute_moments(tree_node& node) {
+    double mass = 0, cmx = 0, cmy = 0, cmz = 0;
+    int end = node.first + node.count;
+    for (int k = node.first; k < end; k++) {
+        mass += tm[k];
+        cmx += tm[k] * tx[k];
+        cmy += tm[k] * ty[k];
+        cmz += tm[k] * tz[k];
+    }
+    double cx = node.cmx, cy = node.cmy, cz = node.cmz;
+    if (mass > 0) {
+        node.cmx = cmx / mass;
+        node.cmy = cmy / mass;
+        node.cmz = cmz / mass;
+    }
+    node.mass = mass;
+    node.delta = sqrt((node.cmx-cx)*(node.cmx-cx) + (node.cmy-cy)*(node.cmy-cy) + (node.cmz-cz)*(node.cmz-cz));
+
+    node.qxx = node.qyy = node.qzz = node.qxy = node.qxz = node.qyz = 0;
+    for (int k = node.first; k < end; k++) {
+        double dx = tx[k] - node.cmx;
+        double dy = ty[k] - node.cmy;
+        double dz = tz[k] - node.cmz;
+        double dr2 = dx*dx + dy*dy + dz*dz;
+        node.qxx += tm[k] * (3*dx*dx - dr2);
+        node.qyy += tm[k] * (3*dy*dy - dr2);
+        node.qzz += tm[k] * (3*dz*dz - dr2);
+        node.qxy += tm[k] * 3*dx*dy;
+        node.qxz += tm[k] * 3*dx*dz;
+        node.qyz += tm[k] * 3*dy*dz;
+    }
+}
+
+int tree_commit_particles(vector<double>& m, vector<double>& x, vector<double>& y, vector<double>& z) {
+    int n = m.size();
+    nodes.clear();
+    committed = true;
+    if (n == 0) {
+        return 0;
+    }
+
+    double x_min = x[0], x_max = x[0], y_min = y[0], y_max = y[0], z_min = z[0], z_max = z[0];
+    for (int i = 1; i < n; i++) {
+        x_min = min(x_min, x[i]); x_max = max(x_max, x[i]);
+        y_min = min(y_min, y[i]); y_max = max(y_max, y[i]);
+        z_min = min(z_min, z[i]); z_max = max(z_max, z[i]);
+    }
+    double size = max(x_max - x_min, max(y_max - y_min, z_max - z_min));
+    size = (size > 0) ? 1.000001 * size : 1.0;
+
+    order.resize(n);
+    buffer.resize(n);
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    nodes.reserve(2 * (n / LEAF_SIZE + 1));
+    build_node(x, y, z, 0, n, 0.5*(x_min+x_max), 0.5*(y_min+y_max), 0.5*(z_min+z_max), size, 0);
+
+    tm.resize(n);
+    tx.resize(n);
+    ty.resize(n);
+    tz.resize(n);
+    for (int k = 0; k < n; k++) {
+        tm[k] = m[order[k]];
+        tx[k] = x[order[k]];
+        ty[k] = y[order[k]];
+        tz[k] = z[order[k]];
+    }
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int j = 0; j < (int) nodes.size(); j++) {
+        compute_moments(nodes[j]);
+    }
+    cerr << "tree_commit_particles: " << nodes.size() << " nodes for " << n << " particles" << endl;
+    return 0;
+}
+
+int tree_cleanup_code() {
+    nodes.clear();
+    tm.clear();
+    tx.clear();
+    ty.clear();
+    tz.clear();
+    order.clear();
+    buffer.clear();
+    committed = false;
+    return 0;
+}
+
+bool tree_is_committed() {
+    return committed;
+}
+
+// A cell is accepted if the point is farther than size/theta + delta from
+// its centre of mass (Barnes & Hut with the offset of the centre of mass)
+static inline bool accept(const tree_node& node, double inv_theta, double dr2) {
+    double r_open = node.size * inv_theta + node.delta;
+    return dr2 > r_open * r_open;
+}
+
+static double walk_potential(double inv_theta, double eps2_total, double px, double py, double pz) {
+    double phi = 0;
+    int j = 0, n_nodes = nodes.size();
+    while (j < n_nodes) {
+        const tree_node& node = nodes[j];
+        double dx = node.cmx - px;
+        double dy = node.cmy - py;
+        double dz = node.cmz - pz;
+        double dr2 = dx*dx + dy*dy + dz*dz;
+        if (accept(node, inv_theta, dr2)) {
+            double rinv2 = 1.0 / (dr2 + eps2_total);
+            double rinv = sqrt(rinv2);
+            double dqd = dx*(node.qxx*dx + node.qxy*dy + node.qxz*dz) +
+                         dy*(node.qxy*dx + node.qyy*dy + node.qyz*dz) +
+                         dz*(node.qxz*dx + node.qyz*dy + node.qzz*dz);
+            phi -= node.mass*rinv + 0.5*dqd*rinv*rinv2*rinv2;
+            j = node.next;
+        } else if (node.leaf) {
+            int end = node.first + node.count;
+            for (int i = node.first; i < end; i++) {
+                dx = tx[i] - px;
+                dy = ty[i] - py;
+                dz = tz[i] - pz;
+                dr2 = dx*dx + dy*dy + dz*dz;
+                if (dr2 > 0 && tm[i] > 0) {
+                    phi -= tm[i] / sqrt(dr2 + eps2_total);
+                }
+            }
+            j = node.next;
+        } else {
+            j++;
+        }
+    }
+    return phi;
+}
+
+static void walk_gravity(double inv_theta, double eps2_total, double px, double py, double pz,
+        double *ax, double *ay, double *az) {
+    double sx = 0, sy = 0, sz = 0;
+    int j = 0, n_nodes = nodes.size();
+    while (j < n_nodes) {
+        const tree_node& node = nodes[j];
+        double dx = node.cmx - px;
+        double dy = node.cmy - py;
+        double dz = node.cmz - pz;
+        double dr2 = dx*dx + dy*dy + dz*dz;
+        if (accept(node, inv_theta, dr2)) {
+            double rinv2 = 1.0 / (dr2 + eps2_total);
+            double rinv3 = rinv2 * sqrt(rinv2);
+            double rinv5 = rinv3 * rinv2;
+            double qdx = node.qxx*dx + node.qxy*dy + node.qxz*dz;
+            double qdy = node.qxy*dx + node.qyy*dy + node.qyz*dz;
+            double qdz = node.qxz*dx + node.qyz*dy + node.qzz*dz;
+            double tmp = node.mass*rinv3 + 2.5*(dx*qdx + dy*qdy + dz*qdz)*rinv5*rinv2;
+            sx += tmp*dx - qdx*rinv5;
+            sy += tmp*dy - qdy*rinv5;
+            sz += tmp*dz - qdz*rinv5;
+            j = node.next;
+        } else if (node.leaf) {
+            int end = node.first + node.count;
+            for (int i = node.first; i < end; i++) {
+                dx = tx[i] - px;
+                dy = ty[i] - py;
+                dz = tz[i] - pz;
+                dr2 = dx*dx + dy*dy + dz*dz;
+                if (dr2 > 0) {
+                    double r2 = dr2 + eps2_total;
+                    double tmp = tm[i] / (r2 * sqrt(r2));
+                    sx += tmp * dx;
+                    sy += tmp * dy;
+                    sz += tmp * dz;
+                }
+            }
+            j = node.next;
+        } else {
+            j++;
+        }
+    }
+    *ax = sx;
+    *ay = sy;
+    *az = sz;
+}
+
+int tree_get_potential_at_point(double theta, double eps2, double *eps, double *x, double *y, double *z, double *phi, int N) {
+    double inv_theta = 1.0 / theta;
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int j = 0; j < N; j++) {
+        phi[j] = walk_potential(inv_theta, eps2 + eps[j]*eps[j], x[j], y[j], z[j]);
+    }
+    return 0;
+}
+
+int tree_get_gravity_at_point(double theta, double eps2, double *eps, double *x, double *y, double *z, double *ax, double *ay, double *az, int N) {
+    double inv_theta = 1.0 / theta;
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int j = 0; j < N; j++) {
+        walk_gravity(inv_theta, eps2 + eps[j]*eps[j], x[j], y[j], z[j], ax+j, ay+j, az+j);
+    }
+    return 0;
+}
+
+int tree_get_potential_energy(double theta, double eps2, double *potential_energy) {
+    int n = tm.size();
+    double inv_theta = 1.0 / theta;
+    vector<double> phi(n);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int k = 0; k < n; k++) {
+        phi[k] = walk_potential(inv_theta, eps2, tx[k], ty[k], tz[k]);
+    }
+    // Summed in tree order, so the result does not depend on the number of threads
+    *potential_energy = 0;
+    for (int k = 0; k < n; k++) {
+        *potential_energy += 0.5 * tm[k] * phi[k];
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+int tree_commit_particles(vector<double>& m, vector<double>& x, vector<double>& y, vector<double>& z);
+int tree_cleanup_code();
+bool tree_is_committed();
+int tree_get_potential_at_point(double theta, double eps2, double *eps, double *x, double *y, double *z, double *phi, int N);
+int tree_get_gravity_at_point(double theta, double eps2, double *eps, double *x, double *y, double *z, double *ax, double *ay, double *az, int N);
+int tree_get_potential_energy(double theta, double eps2, double *potential_energy);
@@ -0,0 +1,42 @@
+#include "stdbool.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int get_mass(int * index_of_the_particle, double * mass, int npoints);
+
+int commit_particles();
+
+int get_theta_for_tree(double * theta_for_tree);
+
+int set_mass(int * index_of_the_particle, double * mass, int npoints);
+
+int get_potential_at_point(double * eps, double * x, double * y, double * z, double * phi, int npoints);
+
+int new_particle(int * index_of_the_particle, double * mass, double * x, double * y, double * z, int npoints);
+
+int set_eps2(double epsilon_squared);
+
+int set_theta_for_tree(double theta_for_tree);
+
+int get_eps2(double * epsilon_squared);
+
+int delete_particle(int * index_of_the_particle, int npoints);
+
+int recommit_particles();
+
+int cleanup_code();
+
+int recommit_parameters();
+
+int initialize_code();
+
+int get_potential_energy(double * potential_energy);
+
+int get_gravity_at_point(double * eps, double * x, double * y, double * z, double * ax, double * ay, double * az, int npoints);
+
+int commit_parameters();
+#ifdef __cplusplus
+}
+#endif
+
@@ -65,7 +65,7 @@ static void printArrayBin(const double *p){
 /***************************************************************/
 /******************* Unified random function *******************/
 /***************************************************************/
-void seed(){
+inline void seed(){
   srand(time(0));
 }
 template<typename T>
@@ -78,7 +78,7 @@ T unifRand_host(T a, T b){
 	return (b-a) * unifRand_host<T>() + a;
 }
 template<>
-int unifRand_host<int>(int a, int b){
+inline int unifRand_host<int>(int a, int b){
 	double aux = (double) rand() / (double)RAND_MAX;
 	aux *= (b-a);
   return (int)a + aux;
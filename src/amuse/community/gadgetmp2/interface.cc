@@ -2866,10 +2866,14 @@ int get_hydro_state_at_point(double x, double y, double z, double vx, double vy,
 }
 // Word-length, numBits in mantissa
 int set_word_length(int mynumBits) {
+#ifdef MULTI_PREC
+    // fixed at build time, only word lengths that fit are accepted
+    if (mynumBits > my_float::get_default_prec()) return -1;
+#endif
     numBits = mynumBits;
     size_t i;
     my_float::set_default_prec(numBits);
-    numDigits = (int)abs(log10( pow("2.0", -numBits) )).toLong();
+    numDigits = (int)abs(log10( pow((my_float)"2.0", -numBits) )).toLong();
     if (gadgetmp2::CommBuffer!= nullptr) gadgetmp2::allocate_commbuffers();
     if (gadgetmp2::P!=nullptr)
     {
@@ -1475,7 +1475,7 @@ class Gadgetmp2(GravitationalDynamics, GravityFieldCode):
             "get_word_length", 
             "set_word_length",
             "word_length", 
-            "The word length, or number of bits for the mantissa, used for the arbitrary precision calculations (#digits = log10(2**# bits) ", 
+            "The word length, or number of bits for the mantissa, used for the arbitrary precision calculations (#digits = log10(2**# bits), an upper limit fixed at build time with -DMULTI_PREC) ", 
             default_value = 53
         )
 
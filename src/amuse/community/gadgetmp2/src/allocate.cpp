@@ -40,7 +40,7 @@
 void gadgetmp2::allocate_commbuffers(void)
 {
     size_t bytes, i;
-    All.max_transfer_elements= (All.BufferSize * 1024 * 1024)/pmpreal::get_needed_mem_single()-1;
+    All.max_transfer_elements= (All.BufferSize * 1024 * 1024)/my_float_buff::get_needed_mem_single()-1;
 
     if (CommBuffer == nullptr)
         if(!(CommBuffer = malloc(bytes = All.BufferSize * 1024 * 1024)))
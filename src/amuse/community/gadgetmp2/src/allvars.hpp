@@ -36,10 +36,17 @@
 #include <gsl/gsl_rng.h>
 #include "tags.hpp"
 
+#ifdef MULTI_PREC
+#include "fixed_float.hpp" /* K=MULTI_PREC doubles, word length fixed at build time */
+typedef fixed_float<MULTI_PREC>  my_float;
+typedef fixed_float_buff<MULTI_PREC>  my_float_buff;
+inline my_float const_pi() { return my_float::pi(); }
+#else
 #include <pmpreal.h> //usage of debian packet libmpfrc++-dev
 using namespace mpfr;
 typedef mpreal  my_float;
 typedef pmpreal  my_float_buff;
+#endif // MULTI_PREC
 
 #define  GADGETVERSION   "2.0"   /*!< code version string */
 #ifndef TIMESTEP_LIMITER
@@ -868,6 +875,10 @@ public:
     static inline size_t gen_size()
     {
         prec = my_float_buff::get_default_prec();
+#ifdef MULTI_PREC
+        tot_size = sizeof(particle_data); /* trivially copyable, particles are sent as raw bytes */
+        return tot_size;
+#endif // MULTI_PREC
         size_t my_float_buff_size = my_float_buff::get_needed_mem_single(prec);
         size_t offset=0;
         Pos0_off = offset;
@@ -1507,6 +1518,9 @@ public:
 #endif
     inline void l_fill(struct particle_data in, size_t index=0)
     {
+#ifdef MULTI_PREC
+        memcpy((void*)((size_t)this + index * tot_size), (void*)&in, sizeof(particle_data));
+#else
         set_init_Pos0(in.Pos[0],index);
         set_init_Pos1(in.Pos[1],index);
         set_init_Pos2(in.Pos[2],index);
@@ -1538,11 +1552,15 @@ public:
         set_init_GravCost(in.GravCost,index);
 #ifdef PSEUDOSYMMETRIC
         set_init_AphysOld(in.AphysOld,index);
+#endif
 #endif
     }
     inline particle_data unpack_particle(size_t index=0)
     {
         particle_data retval;
+#ifdef MULTI_PREC
+        memcpy((void*)&retval, (void*)((size_t)this + index * tot_size), sizeof(particle_data));
+#else
         retval.Pos[0] = read_re_init_Pos0(index);
         retval.Pos[1] = read_re_init_Pos1(index);
         retval.Pos[2] = read_re_init_Pos2(index);
@@ -1574,6 +1592,7 @@ public:
         retval.GravCost = read_re_init_GravCost(index);
 #ifdef PSEUDOSYMMETRIC
         retval.AphysOld = read_re_init_AphysOld(index);
+#endif
 #endif
         return retval;
     }
@@ -1718,6 +1737,10 @@ public:
     static inline size_t gen_size()
     {
         prec = my_float_buff::get_default_prec();
+#ifdef MULTI_PREC
+        tot_size = sizeof(sph_particle_data); /* trivially copyable, particles are sent as raw bytes */
+        return tot_size;
+#endif // MULTI_PREC
         size_t my_float_buff_size = my_float_buff::get_needed_mem_single(prec);
         size_t offset=0;
         Entropy_off = offset;
@@ -2485,6 +2508,9 @@ public:
 #endif
     inline void l_fill(struct sph_particle_data in, size_t index=0)
     {
+#ifdef MULTI_PREC
+        memcpy((void*)((size_t)this + index * tot_size), (void*)&in, sizeof(sph_particle_data));
+#else
         set_init_Entropy(in.Entropy,index);
         set_init_Density(in.Density,index);
         set_init_Hsml(in.Hsml,index);
@@ -2515,11 +2541,15 @@ public:
 #ifdef MORRIS97VISC
         set_init_Alpha(in.Alpha,index);
         set_init_DAlphaDt(in.DAlphaDt,index);
+#endif
 #endif
     }
     inline sph_particle_data unpack_particle(size_t index=0)
     {
         sph_particle_data retval;
+#ifdef MULTI_PREC
+        memcpy((void*)&retval, (void*)((size_t)this + index * tot_size), sizeof(sph_particle_data));
+#else
         retval.Entropy = read_re_init_Entropy(index);
         retval.Density = read_re_init_Density(index);
         retval.Hsml = read_re_init_Hsml(index);
@@ -2550,6 +2580,7 @@ public:
 #ifdef MORRIS97VISC
         retval.GravAccel[2] = read_re_init_Alpha(index);
         retval.DAlphaDt = read_re_init_DAlphaDt(index);
+#endif
 #endif
         return retval;
     }
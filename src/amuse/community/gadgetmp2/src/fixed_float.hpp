@@ -0,0 +1,395 @@
+/* ################################################################################## */
+/* ###                                                                            ### */
+/* ###                                 Gadgetmp2                                  ### */
+/* ###                                                                            ### */
+/* ###   Fixed-length alternative to mpreal/pmpreal, selected at build time       ### */
+/* ###   with -DMULTI_PREC=K (see makefile_options)                               ### */
+/* ###                                                                            ### */
+/* ################################################################################## */
+/*! \file fixed_float.hpp
+ *  \brief K-double floating point type with the part of the mpreal interface used by Gadgetmp2.
+ *
+ *  fixed_float<K> stores an unevaluated sum of K doubles and does its
+ *  arithmetic with CAMPARY's multi_prec<K>, so values live in place,
+ *  without MPFR calls or heap-resident limbs. The type is trivially
+ *  copyable: particles and communication buffers holding it can be
+ *  copied and sent as raw bytes. The few transcendental functions the
+ *  code needs (pow, exp, log, ...) are evaluated through MPFR at the
+ *  equivalent precision.
+ *
+ *  fixed_float_buff<K> stands in for pmpreal. It has the same layout as
+ *  fixed_float<K>, so placing and re-organising buffers is a no-op.
+ */
+
+#ifndef FIXED_FLOAT_HPP
+#define FIXED_FLOAT_HPP
+
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+// multi_prec.h goes before mpreal.h: it calls sqrt(double), which becomes
+// ambiguous once the mpfr namespace is visible.
+#include "multi_prec.h"
+#include <mpreal.h>
+
+#define FIXED_FLOAT_BITS_PER_DOUBLE 52  /*!< mantissa bits counted per double, CAMPARY does not round correctly */
+
+template <int K>
+class fixed_float
+{
+protected:
+    double d[K];
+
+    typedef multi_prec<K> campary;
+    inline campary mp() const
+    {
+        return campary(d, K);
+    };
+    inline void set(const campary &x)
+    {
+        for(int k = 0; k < K; k++)
+            d[k] = x[k];
+    };
+    static inline fixed_float from(const campary &x)
+    {
+        fixed_float r;
+        r.set(x);
+        return r;
+    };
+    /*! value -> mpfr::mpreal with a few guard bits, for parsing, printing and transcendental functions */
+    inline mpfr::mpreal to_mpreal() const
+    {
+        mpfr::mpreal r(d[0], get_default_prec() + 16);
+        for(int k = 1; k < K; k++)
+            r += d[k];
+        return r;
+    };
+    /*! peel off one double at a time, each difference is exact */
+    inline void set(const mpfr::mpreal &x)
+    {
+        mpfr::mpreal r(x);
+        r.setPrecision(get_default_prec() + 16);
+        for(int k = 0; k < K; k++)
+        {
+            d[k] = r.toDouble();
+            r -= d[k];
+        }
+    };
+
+public:
+    fixed_float()
+    {
+        setZero();
+    };
+    fixed_float(double x)
+    {
+        setZero();
+        d[0] = x;
+    };
+    fixed_float(int x) : fixed_float((double)x) {};
+    fixed_float(unsigned int x) : fixed_float((double)x) {};
+    fixed_float(long x) : fixed_float((double)x) {};
+    fixed_float(unsigned long x) : fixed_float((double)x) {};
+    fixed_float(long long x) : fixed_float((double)x) {};
+    fixed_float(const char *s)
+    {
+        set(mpfr::mpreal(s, get_default_prec() + 16));
+    };
+    fixed_float(const std::string &s) : fixed_float(s.c_str()) {};
+    fixed_float(const mpfr::mpreal &x)
+    {
+        set(x);
+    };
+
+    /*! mpreal compatibility; the precision is fixed at build time */
+    static inline mpfr_prec_t get_default_prec()
+    {
+        return FIXED_FLOAT_BITS_PER_DOUBLE * K;
+    };
+    static inline void set_default_prec(mpfr_prec_t prec) {};
+    inline mpfr_prec_t getPrecision() const
+    {
+        return get_default_prec();
+    };
+    inline fixed_float& setPrecision(mpfr_prec_t prec)
+    {
+        return *this;
+    };
+    inline void set_prec(mpfr_prec_t prec) {};
+    inline fixed_float& setZero()
+    {
+        for(int k = 0; k < K; k++)
+            d[k] = 0.0;
+        return *this;
+    };
+
+    inline double toDouble() const
+    {
+        return d[0];
+    };
+    inline long toLong() const
+    {
+        return to_mpreal().toLong();
+    };
+    explicit inline operator double() const
+    {
+        return toDouble();
+    };
+    explicit inline operator long() const
+    {
+        return toLong();
+    };
+    explicit inline operator int() const
+    {
+        return int(toLong());
+    };
+    inline std::string toString() const
+    {
+        mpfr::mpreal r = to_mpreal();
+        r.setPrecision(get_default_prec());
+        return r.toString();
+    };
+    static inline fixed_float pi()
+    {
+        return fixed_float(mpfr::const_pi(get_default_prec() + 16));
+    };
+
+    inline fixed_float operator-() const
+    {
+        fixed_float r;
+        for(int k = 0; k < K; k++)
+            r.d[k] = -d[k];
+        return r;
+    };
+    inline fixed_float operator+() const
+    {
+        return *this;
+    };
+
+    inline fixed_float& operator+=(const fixed_float &x)
+    {
+        set(mp() + x.mp());
+        return *this;
+    };
+    inline fixed_float& operator-=(const fixed_float &x)
+    {
+        set(mp() - x.mp());
+        return *this;
+    };
+    inline fixed_float& operator*=(const fixed_float &x)
+    {
+        set(mp() * x.mp());
+        return *this;
+    };
+    inline fixed_float& operator/=(const fixed_float &x)
+    {
+        set(mp() / x.mp());
+        return *this;
+    };
+    inline fixed_float& operator+=(double x)
+    {
+        set(mp() + x);
+        return *this;
+    };
+    inline fixed_float& operator-=(double x)
+    {
+        set(mp() - x);
+        return *this;
+    };
+    inline fixed_float& operator*=(double x)
+    {
+        set(mp() * x);
+        return *this;
+    };
+    inline fixed_float& operator/=(double x)
+    {
+        set(mp() / x);
+        return *this;
+    };
+
+    friend inline fixed_float operator+(const fixed_float &a, const fixed_float &b)
+    {
+        return from(a.mp() + b.mp());
+    };
+    friend inline fixed_float operator-(const fixed_float &a, const fixed_float &b)
+    {
+        return from(a.mp() - b.mp());
+    };
+    friend inline fixed_float operator*(const fixed_float &a, const fixed_float &b)
+    {
+        return from(a.mp() * b.mp());
+    };
+    friend inline fixed_float operator/(const fixed_float &a, const fixed_float &b)
+    {
+        return from(a.mp() / b.mp());
+    };
+    friend inline fixed_float operator+(const fixed_float &a, double b)
+    {
+        return from(a.mp() + b);
+    };
+    friend inline fixed_float operator-(const fixed_float &a, double b)
+    {
+        return from(a.mp() - b);
+    };
+    friend inline fixed_float operator*(const fixed_float &a, double b)
+    {
+        return from(a.mp() * b);
+    };
+    friend inline fixed_float operator/(const fixed_float &a, double b)
+    {
+        return from(a.mp() / b);
+    };
+    friend inline fixed_float operator+(double a, const fixed_float &b)
+    {
+        return from(a + b.mp());
+    };
+    friend inline fixed_float operator-(double a, const fixed_float &b)
+    {
+        return from(a - b.mp());
+    };
+    friend inline fixed_float operator*(double a, const fixed_float &b)
+    {
+        return from(a * b.mp());
+    };
+    friend inline fixed_float operator/(double a, const fixed_float &b)
+    {
+        return from(a / b.mp());
+    };
+
+#define FIXED_FLOAT_COMPARISON(op) \
+    friend inline bool operator op(const fixed_float &a, const fixed_float &b) \
+    { \
+        return a.mp() op b.mp(); \
+    }; \
+    friend inline bool operator op(const fixed_float &a, double b) \
+    { \
+        return a.mp() op b; \
+    }; \
+    friend inline bool operator op(double a, const fixed_float &b) \
+    { \
+        return campary(a) op b.mp(); \
+    };
+    FIXED_FLOAT_COMPARISON(==)
+    FIXED_FLOAT_COMPARISON(!=)
+    FIXED_FLOAT_COMPARISON(<)
+    FIXED_FLOAT_COMPARISON(<=)
+    FIXED_FLOAT_COMPARISON(>)
+    FIXED_FLOAT_COMPARISON(>=)
+#undef FIXED_FLOAT_COMPARISON
+
+    friend inline fixed_float sqrt(const fixed_float &x)
+    {
+        if(x.d[0] <= 0.0)
+            return fixed_float(x.d[0] == 0.0 ? 0.0 : std::sqrt(x.d[0]));
+        return from(sqrt(x.mp()));
+    };
+    friend inline fixed_float fabs(const fixed_float &x)
+    {
+        return x.d[0] < 0.0 ? -x : x;
+    };
+    friend inline fixed_float abs(const fixed_float &x)
+    {
+        return fabs(x);
+    };
+    friend inline fixed_float pow(const fixed_float &x, const fixed_float &y)
+    {
+        return fixed_float(mpfr::pow(x.to_mpreal(), y.to_mpreal()));
+    };
+    friend inline fixed_float pow(const fixed_float &x, double y)
+    {
+        return fixed_float(mpfr::pow(x.to_mpreal(), mpfr::mpreal(y, get_default_prec() + 16)));
+    };
+    friend inline fixed_float exp(const fixed_float &x)
+    {
+        return fixed_float(mpfr::exp(x.to_mpreal()));
+    };
+    friend inline fixed_float log(const fixed_float &x)
+    {
+        return fixed_float(mpfr::log(x.to_mpreal()));
+    };
+    friend inline fixed_float log10(const fixed_float &x)
+    {
+        return fixed_float(mpfr::log10(x.to_mpreal()));
+    };
+    friend inline fixed_float erfc(const fixed_float &x)
+    {
+        return fixed_float(mpfr::erfc(x.to_mpreal()));
+    };
+    friend inline std::ostream& operator<<(std::ostream &os, const fixed_float &x)
+    {
+        return os << x.toString();
+    };
+};
+
+/*! Buffer element with the interface of pmpreal. The values need no
+ *  placement, so a buffer is a size_t count followed by the values. */
+template <int K>
+class fixed_float_buff : public fixed_float<K>
+{
+public:
+    inline fixed_float_buff& operator=(const fixed_float<K> &v)
+    {
+        fixed_float<K>::operator=(v);
+        return *this;
+    };
+
+    static inline size_t get_needed_mem_single(mpfr_prec_t prec = 0)
+    {
+        return sizeof(fixed_float_buff);
+    };
+    static inline size_t get_needed_mem(size_t size)
+    {
+        return size * sizeof(fixed_float_buff) + sizeof(size_t);
+    };
+    static inline void place_pmpreal(void* pointer, mpfr_prec_t prec = 0) {};
+    static inline void re_org_pmpreal(fixed_float_buff* p) {};
+    static inline fixed_float_buff* place_buffer(size_t size, void* buff_start, mpfr_prec_t prec = 0)
+    {
+        size_t* arr_size = (size_t*) buff_start;
+        *arr_size = size;
+        fixed_float_buff* retval = (fixed_float_buff*)(arr_size + 1);
+        for(size_t i = 0; i < size; i++)
+            retval[i].setZero();
+        return retval;
+    };
+    static inline fixed_float_buff* generate_buffer(size_t size)
+    {
+        return place_buffer(size, malloc(get_needed_mem(size)));
+    };
+    static inline void re_org_buff(fixed_float_buff* p) {};
+    static inline fixed_float_buff* re_org_transfer_buff(void* p)
+    {
+        return (fixed_float_buff*)((size_t)p + sizeof(size_t));
+    };
+    static inline size_t get_buff_size(fixed_float_buff* p)
+    {
+        return get_needed_mem(p->size());
+    };
+    static inline char* get_transfer_buff(fixed_float_buff* p)
+    {
+        return (char*)(((size_t*)p) - 1);
+    };
+    inline size_t size()
+    {
+        return *(((size_t*)this) - 1);
+    };
+    inline size_t get_transfer_buff_size()
+    {
+        return get_needed_mem(size());
+    };
+    inline char* get_transfer_buff()
+    {
+        return get_transfer_buff(this);
+    };
+    inline void* next_pointer()
+    {
+        return (void*)((size_t)this + size() * sizeof(fixed_float_buff));
+    };
+};
+
+static_assert(std::is_trivially_copyable<fixed_float<2> >::value, "fixed_float must be trivially copyable");
+static_assert(sizeof(fixed_float_buff<2>) == sizeof(fixed_float<2>), "fixed_float_buff must have the layout of fixed_float");
+
+#endif // FIXED_FLOAT_HPP
@@ -38,6 +38,10 @@
 #include <stopcond.h>
 #include <time.h>
 
+extern "C" {
+#include <simple_hash.h>
+}
+
 #ifndef NOMPI
 #include <amuse_mpi.h>
 static MPI_Comm WORLD;
@@ -81,6 +85,27 @@ static vector<vec>  pos, vel, acc, jerk;
 static vector<vec>  acc_reduced, jerk_reduced;
 static vector<real> potential_reduced;
 
+// Map from particle identifier to index in the vectors above, so
+// that the accessors do not have to search ident on every call.
+
+static struct simple_hash id_to_index;
+static bool id_to_index_initialized = false;
+
+static inline unsigned int get_index_of_id(int id)
+{
+    size_t index;
+    if (id < 0 || !id_to_index_initialized
+        || hash_lookup(&id_to_index, id, &index) != 0)
+        return ident.size();
+    return index;
+}
+
+static void reindex_from(unsigned int first)
+{
+    for (unsigned int i = first; i < ident.size(); i++)
+        hash_update(&id_to_index, ident[i], i);
+}
+
 // Control parameters:
 
 const real DT_PARAM = 0.03;
@@ -969,6 +994,7 @@ int cleanup_code()
     reset_stopping_conditions();
 
     ident.clear();
+    if (id_to_index_initialized) clear_hash(&id_to_index);
     vel.clear();
     pos.clear();
     mass.clear();
@@ -1034,6 +1060,12 @@ int new_particle(int *id, double _mass,
 
   new_element = max_identifier++;
 
+  if (!id_to_index_initialized) {
+      init_hash(&id_to_index, 128);
+      id_to_index_initialized = true;
+  }
+  hash_insert(&id_to_index, new_element, ident.size());
+
   ident.push_back(new_element);                // generally want to specify id
   mass.push_back(_mass);
   radius.push_back(_radius);
@@ -1056,10 +1088,11 @@ int delete_particle(int id)
         return 0;
     }
     
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
 
   if (i < ident.size())
     {
+      hash_delete(&id_to_index, id);
       ident.erase(ident.begin()+i);
       mass.erase(mass.begin()+i);
       radius.erase(radius.begin()+i);
@@ -1068,6 +1101,7 @@ int delete_particle(int id)
       acc.erase(acc.begin()+i);
       jerk.erase(jerk.begin()+i);
       potential.erase(potential.begin()+i);
+      reindex_from(i);               // keep the particle order
       return 0;
     }
   else
@@ -1080,7 +1114,7 @@ int delete_particle(int id)
 /*
 int remove_particle(int id)                // remove id from the dynamical system
 {
-    unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+    unsigned int i = get_index_of_id(id);
     if (i < ident.size()) {
         ident.erase(ident.begin()+i);
         mass.erase(mass.begin()+i);
@@ -1102,7 +1136,7 @@ int get_state(int id, double *_mass, double *x, double *y, double *z,
   if(mpi_rank) {return 0;}
   //*id_out = -1;
 
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
   
   if (i < (int) ident.size())
     {
@@ -1131,7 +1165,7 @@ int set_state(int id, double _mass, double x, double y, double z,
 //cello, proj1,
 {
   if(mpi_rank) {return 0;}
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
   
   if (i < ident.size())
     {
@@ -1152,7 +1186,7 @@ int get_mass(int id, double *_mass)
 //cello, proj1,
 {
     if(mpi_rank) {return 0;}
-    unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+    unsigned int i = get_index_of_id(id);
     if (i < ident.size())
       {
         *_mass = mass[i];
@@ -1167,7 +1201,7 @@ int get_mass(int id, double *_mass)
 int set_mass(int id, double _mass)
 {
     if(mpi_rank) {return 0;}
-    unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+    unsigned int i = get_index_of_id(id);
     if (i < ident.size())
       {
         mass[i] = _mass;
@@ -1179,7 +1213,7 @@ int set_mass(int id, double _mass)
 int get_radius(int id, double *_radius)
 {
     if(mpi_rank) {return 0;}
-    unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+    unsigned int i = get_index_of_id(id);
     //cerr << "hermite0: get_radius: "; PRC(id); PRL(i); cerr << flush;
     if (i < ident.size())
       {
@@ -1195,7 +1229,7 @@ int get_radius(int id, double *_radius)
 int set_radius(int id, double _radius)
 {
     if(mpi_rank) {return 0;}
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
   if (i < ident.size())
     {
       radius[i] = _radius;;
@@ -1210,7 +1244,7 @@ int set_radius(int id, double _radius)
 int get_position(int id, double *x, double *y, double *z)
 {
     if(mpi_rank) {return 0;}
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
   if (i < ident.size())
     {
       *x = pos[i][0];
@@ -1227,7 +1261,7 @@ int get_position(int id, double *x, double *y, double *z)
 int set_position(int id, double x, double y, double z)
 {
     if(mpi_rank) {return 0;}
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
   if (i < ident.size())
     {
       pos[i] = vec(x, y, z);
@@ -1241,7 +1275,7 @@ int set_position(int id, double x, double y, double z)
 
 int get_velocity(int id, double *vx, double *vy, double *vz)
 {
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
   if (i < ident.size())
     {
       *vx = vel[i][0];
@@ -1257,7 +1291,7 @@ int get_velocity(int id, double *vx, double *vy, double *vz)
 
 int set_velocity(int id, double vx, double vy, double vz)
 {
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
 
   if (i < ident.size())
     {
@@ -1273,7 +1307,7 @@ int set_velocity(int id, double vx, double vy, double vz)
 
 int get_acceleration(int id, double *ax, double *ay, double *az)
 {
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
   if (i < ident.size())
     {
       *ax = acc[i][0];
@@ -1289,7 +1323,7 @@ int get_acceleration(int id, double *ax, double *ay, double *az)
 
 int set_acceleration(int id, double ax, double ay, double az)
 {
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
   if (i < ident.size())
     {
       acc[i][0] = ax;
@@ -1450,7 +1484,7 @@ int get_potential_energy(double *value)
 int get_potential(int id,  double *value)
 {
 	if(mpi_rank) {return 0;}
-	unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+	unsigned int i = get_index_of_id(id);
 	if (i < ident.size())
 	  {
 		*value = potential[i];
@@ -1463,55 +1497,66 @@ int get_potential(int id,  double *value)
 	  }
 }
 
-int get_potential_at_point(double eps, double x, double y, double z, double *phi)
+int get_potential_at_point(double *eps, double *x, double *y, double *z, double *phi, int n)
 {
     if(mpi_rank)     { // calculate only on the root mpi process, not on others
         return 0;
     }
-    int n = ident.size();
-    double rx,ry,rz,r;
-    *phi = 0.0;
+    int nbodies = ident.size();
 
-    for (int i = 0; i< n; i++)
+#pragma omp parallel for
+    for (int j = 0; j < n; j++)
     {
-        rx = pos[i][0]-x;
-        ry = pos[i][1]-y;
-        rz = pos[i][2]-z;
-        r = sqrt(rx*rx+ry*ry+rz*rz + eps2);
-        *phi -= mass[i]/r;
+        double rx, ry, rz, r;
+        double p = 0.0;
+        for (int i = 0; i < nbodies; i++)
+        {
+            rx = pos[i][0]-x[j];
+            ry = pos[i][1]-y[j];
+            rz = pos[i][2]-z[j];
+            r = sqrt(rx*rx+ry*ry+rz*rz + eps2);
+            p -= mass[i]/r;
+        }
+        phi[j] = p;
     }
 
     return 0;
 }
 
 int get_gravity_at_point(
-    double eps, 
-    double x,double y, double z,
-    double *ax, double *ay, double *az
+    double *eps, 
+    double *x, double *y, double *z,
+    double *ax, double *ay, double *az,
+    int n
     )
 {
     if(mpi_rank)     { // calculate only on the root mpi process, not on others
         return 0;
     }
-    int n = ident.size();
-    double rx, ry, rz, r3, r2, r, F;
-
-    *ax = 0;
-    *ay = 0;
-    *az = 0;
+    int nbodies = ident.size();
 
-    for (int i = 0; i<n; i++)
+#pragma omp parallel for
+    for (int j = 0; j < n; j++)
     {
-        rx = pos[i][0]-x;
-        ry = pos[i][1]-y;
-        rz = pos[i][2]-z;
-        r2 = (rx*rx+ry*ry+rz*rz + eps*eps);
-        r = sqrt(r2);
-        r3 = r2*r;
-        F = mass[i]/r3;
-        *ax += F * rx;
-        *ay += F * ry;
-        *az += F * rz;
+        double rx, ry, rz, r3, r2, r, F;
+        double eps2_j = eps[j]*eps[j];
+        double sx = 0, sy = 0, sz = 0;
+        for (int i = 0; i < nbodies; i++)
+        {
+            rx = pos[i][0]-x[j];
+            ry = pos[i][1]-y[j];
+            rz = pos[i][2]-z[j];
+            r2 = (rx*rx+ry*ry+rz*rz + eps2_j);
+            r = sqrt(r2);
+            r3 = r2*r;
+            F = mass[i]/r3;
+            sx += F * rx;
+            sy += F * ry;
+            sz += F * rz;
+        }
+        ax[j] = sx;
+        ay[j] = sy;
+        az[j] = sz;
     }
 
     return 0;
@@ -1612,7 +1657,7 @@ int get_index_of_first_particle(int * index_of_first_particle)
 int get_index_of_next_particle(int id, int *index_of_the_next_particle)
 {
 
-  unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+  unsigned int i = get_index_of_id(id);
 
   if (i < ident.size()-1)
     {
@@ -1638,7 +1683,7 @@ int set_particle(int id, double _mass, double _radius, double x, double y, doubl
     if(mpi_rank)     { // calculate only on the root mpi process, not on others
         return 0;
     }
-    unsigned int i = find(ident.begin(), ident.end(), id) - ident.begin();
+    unsigned int i = get_index_of_id(id);
 
     if (i < ident.size())
       {
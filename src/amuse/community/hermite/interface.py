@@ -1,14 +1,14 @@
 from amuse.community import *
 from amuse.community.interface.gd import GravitationalDynamicsInterface
 from amuse.community.interface.gd import GravitationalDynamics
-from amuse.community.interface.gd import SinglePointGravityFieldInterface
+from amuse.community.interface.gd import GravityFieldInterface
 from amuse.community.interface.gd import GravityFieldCode
 
 class HermiteInterface(CodeInterface,
                        LiteratureReferencesMixIn,
                        GravitationalDynamicsInterface,
                        StoppingConditionInterface,
-                       SinglePointGravityFieldInterface):
+                       GravityFieldInterface):
     """
     N-body integration module with shared but variable time step
     (the same for all particles but its size changing in time),
@@ -20,6 +20,16 @@ class HermiteInterface(CodeInterface,
     include_headers = ['worker_code.h', 'stopcond.h']
     __so_module__ = 'hermite_cython'
 
+    # the particle getters only read the particle data, the worker
+    # handles array calls to these functions in parallel
+    get_state = parallel_legacy_function(GravitationalDynamicsInterface.get_state)
+    get_mass = parallel_legacy_function(GravitationalDynamicsInterface.get_mass)
+    get_radius = parallel_legacy_function(GravitationalDynamicsInterface.get_radius)
+    get_position = parallel_legacy_function(GravitationalDynamicsInterface.get_position)
+    get_velocity = parallel_legacy_function(GravitationalDynamicsInterface.get_velocity)
+    get_acceleration = parallel_legacy_function(GravitationalDynamicsInterface.get_acceleration)
+    get_potential = parallel_legacy_function(GravitationalDynamicsInterface.get_potential)
+
     def __init__(self, **options):
         CodeInterface.__init__(self, name_of_the_worker="hermite_worker",
                                  **options)
@@ -37,6 +37,8 @@ int initialize_code()
   mainsys.last=NULL;
   dt_param=.03; 
   eps2=0.;
+  opening_angle=0.;
+  tree_worklimit=TREEWORKLIMIT;
   inttype=8;
   t_now=0.;
   dtime=0.;
@@ -61,6 +63,8 @@ int cleanup_code()
     t_now=0.;
     dtime=0.;
     eps2=0.;
+    opening_angle=0.;
+    tree_worklimit=TREEWORKLIMIT;
     inttype=8;
     begin_time = 0;
     stop_code();
@@ -448,6 +452,32 @@ int get_eps2_parameter(double *e)
   return 0;
 }
 
+int set_opening_angle(double theta)
+{
+  if(theta<0) return -1;
+  opening_angle=theta;
+  return 0;
+}
+
+int get_opening_angle(double *theta)
+{
+  *theta=opening_angle;
+  return 0;
+}
+
+int set_tree_work_limit(long int n)
+{
+  if(n<0) return -1;
+  tree_worklimit=n;
+  return 0;
+}
+
+int get_tree_work_limit(long int *n)
+{
+  *n=tree_worklimit;
+  return 0;
+}
+
 int set_timestep_option(int ts)
 {
   return 0;
@@ -153,6 +153,34 @@ class HuaynoInterface(CodeInterface,
         function.result_type = 'i'
         return function
 
+    @legacy_function
+    def get_opening_angle():
+        function = LegacyFunctionSpecification()
+        function.addParameter('opening_angle', dtype='d', direction=function.OUT)
+        function.result_type = 'i'
+        return function
+
+    @legacy_function
+    def set_opening_angle():
+        function = LegacyFunctionSpecification()
+        function.addParameter('opening_angle', dtype='d', direction=function.IN)
+        function.result_type = 'i'
+        return function
+
+    @legacy_function
+    def get_tree_work_limit():
+        function = LegacyFunctionSpecification()
+        function.addParameter('tree_work_limit', dtype='int64', direction=function.OUT)
+        function.result_type = 'i'
+        return function
+
+    @legacy_function
+    def set_tree_work_limit():
+        function = LegacyFunctionSpecification()
+        function.addParameter('tree_work_limit', dtype='int64', direction=function.IN)
+        function.result_type = 'i'
+        return function
+
     def set_eps2(self, e):
         return self.set_eps2_parameter(e)
 
@@ -269,6 +297,22 @@ class Huayno(GravitationalDynamics,GravityFieldCode):
             default_value = 8
         )
 
+        handler.add_method_parameter(
+            "get_opening_angle",
+            "set_opening_angle",
+            "opening_angle",
+            "opening angle of the tree used for large kick and potential evaluations (0 means always direct summation)",
+            default_value = 0.0
+        )
+
+        handler.add_method_parameter(
+            "get_tree_work_limit",
+            "set_tree_work_limit",
+            "tree_work_limit",
+            "kicks and potentials of more than this number of pair interactions use the tree if opening_angle > 0",
+            default_value = 1000000
+        )
+
         handler.add_method_parameter(
             "get_begin_time",
             "set_begin_time",
@@ -331,6 +375,30 @@ class Huayno(GravitationalDynamics,GravityFieldCode):
             (handler.NO_UNIT, ),
             (handler.ERROR_CODE,)
         )
+
+        handler.add_method(
+            "get_opening_angle",
+            (),
+            (handler.NO_UNIT, handler.ERROR_CODE,)
+        )
+
+        handler.add_method(
+            "set_opening_angle",
+            (handler.NO_UNIT, ),
+            (handler.ERROR_CODE,)
+        )
+
+        handler.add_method(
+            "get_tree_work_limit",
+            (),
+            (handler.NO_UNIT, handler.ERROR_CODE,)
+        )
+
+        handler.add_method(
+            "set_tree_work_limit",
+            (handler.NO_UNIT, ),
+            (handler.ERROR_CODE,)
+        )
         self.stopping_conditions.define_methods(handler)
 
     def define_particle_sets(self, handler):
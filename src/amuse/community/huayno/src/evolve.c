@@ -12,6 +12,7 @@
 #include "evolve_kepler.h"
 #include "evolve_ok.h"
 #include "evolve_bs.h"
+#include "evolve_tree.h"
 
 #ifdef EVOLVE_OPENCL
 #include "evolve_cl.h"
@@ -323,46 +324,124 @@ void drift(int clevel,struct sys s, DOUBLE etime, DOUBLE dt)
   diag->taskdrift+=s.n;
 }
 
+/*
+ * The inner loops of kick, potential and timestep run over source particles
+ * packed in aligned double precision arrays, so that they vectorize. Only
+ * the sink particle update uses the (compensated) DOUBLE sums. The buffers
+ * are threadprivate because the CC integrators kick from concurrent tasks.
+ */
+
+#define JSOA_ALIGN 64
+
+struct jsoa
+{
+  UINT size;
+  FLOAT *mass;
+  FLOAT *pos[3];
+  FLOAT *vel[3];
+};
+
+static struct jsoa jbuffer = { 0, NULL, {NULL, NULL, NULL}, {NULL, NULL, NULL} };
+#pragma omp threadprivate(jbuffer)
+
+static FLOAT *jsoa_alloc(UINT n)
+{
+  void *p;
+  if(posix_memalign(&p, JSOA_ALIGN, n*sizeof(FLOAT)) != 0) ENDRUN("jsoa_alloc: memory allocation failed\n");
+  return (FLOAT *) p;
+}
+
+static struct jsoa *pack_sources(struct sys s, int with_vel)
+{
+  struct jsoa *j=&jbuffer;
+  UINT k,p;
+  if(s.n > j->size)
+  {
+    free(j->mass);
+    for(k=0;k<3;k++)
+    {
+      free(j->pos[k]);
+      free(j->vel[k]);
+    }
+    j->size=s.n+s.n/4+16;
+    j->mass=jsoa_alloc(j->size);
+    for(k=0;k<3;k++)
+    {
+      j->pos[k]=jsoa_alloc(j->size);
+      j->vel[k]=jsoa_alloc(j->size);
+    }
+  }
+  for(p=0;p<s.n;p++)
+  {
+    j->mass[p]=s.part[p].mass;
+    j->pos[0][p]=s.part[p].pos[0];
+    j->pos[1][p]=s.part[p].pos[1];
+    j->pos[2][p]=s.part[p].pos[2];
+  }
+  if(with_vel)
+  {
+    for(p=0;p<s.n;p++)
+    {
+      j->vel[0][p]=s.part[p].vel[0];
+      j->vel[1][p]=s.part[p].vel[1];
+      j->vel[2][p]=s.part[p].vel[2];
+    }
+  }
+  return j;
+}
+
+/* index of sink particle p in s, or s.n if it is not part of s */
+static inline UINT self_index(struct particle *p, struct sys s)
+{
+  return (p >= s.part && p < s.part+s.n) ? (UINT) (p-s.part) : s.n;
+}
+
 static void kick_cpu(struct sys s1, struct sys s2, DOUBLE dt)
 {
   UINT i,j;
-  FLOAT dx[3],dr3,dr2,dr,acci;
-  FLOAT acc[3];
+  FLOAT ax,ay,az,xi[3];
+  struct jsoa *js=pack_sources(s2,0);
+  const FLOAT *jm=js->mass,*jx=js->pos[0],*jy=js->pos[1],*jz=js->pos[2];
 
 #pragma omp parallel for if((ULONG) s1.n*s2.n>MPWORKLIMIT && !omp_in_parallel()) default(none) \
- private(i,j,dx,dr3,dr2,dr,acc,acci) \
- shared(dt,s1,s2,eps2)
+ private(i,j,ax,ay,az,xi) \
+ shared(dt,s1,s2,eps2,jm,jx,jy,jz)
   for(i=0;i<s1.n;i++)
   {
-    acc[0]=0.;
-    acc[1]=0.;
-    acc[2]=0.;
+    ax=0.;
+    ay=0.;
+    az=0.;
+    xi[0]=s1.part[i].pos[0];
+    xi[1]=s1.part[i].pos[1];
+    xi[2]=s1.part[i].pos[2];
+#pragma omp simd reduction(+:ax,ay,az)
     for(j=0;j<s2.n;j++)
     {
-//      if(s1.part+i==s2.part+j) continue; 
-      dx[0]=s1.part[i].pos[0]-s2.part[j].pos[0];
-      dx[1]=s1.part[i].pos[1]-s2.part[j].pos[1];
-      dx[2]=s1.part[i].pos[2]-s2.part[j].pos[2];
-      dr2=dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]+eps2;
-      if(dr2>0) 
-      {
-        dr=sqrt(dr2);
-        dr3=dr*dr2;
-        acci=s2.part[j].mass/dr3;
-
-        acc[0]-=dx[0]*acci;
-        acc[1]-=dx[1]*acci;
-        acc[2]-=dx[2]*acci;  
-      }
+      FLOAT dx=xi[0]-jx[j];
+      FLOAT dy=xi[1]-jy[j];
+      FLOAT dz=xi[2]-jz[j];
+      FLOAT dr2=dx*dx+dy*dy+dz*dz+eps2;
+      FLOAT dr=sqrt(dr2);
+      FLOAT acci=jm[j]/(dr*dr2);
+      acci=(dr2>0) ? acci : 0.;
+      ax-=dx*acci;
+      ay-=dy*acci;
+      az-=dz*acci;
     }
-    COMPSUMV(s1.part[i].vel[0],s1.part[i].vel_e[0],dt*acc[0]);
-    COMPSUMV(s1.part[i].vel[1],s1.part[i].vel_e[1],dt*acc[1]);
-    COMPSUMV(s1.part[i].vel[2],s1.part[i].vel_e[2],dt*acc[2]);
+    COMPSUMV(s1.part[i].vel[0],s1.part[i].vel_e[0],dt*ax);
+    COMPSUMV(s1.part[i].vel[1],s1.part[i].vel_e[1],dt*ay);
+    COMPSUMV(s1.part[i].vel[2],s1.part[i].vel_e[2],dt*az);
   }
 }
 
 void kick(int clevel,struct sys s1, struct sys s2, DOUBLE dt)
 {
+  ULONG count=(ULONG) s1.n*s2.n;
+  if(opening_angle>0 && count>tree_worklimit)
+  {
+    count=kick_tree(s1,s2,dt);
+  } else
+  {
 #ifdef EVOLVE_OPENCL
   if((ULONG) s1.n*s2.n>CLWORKLIMIT) 
   {
@@ -379,35 +458,39 @@ void kick(int clevel,struct sys s1, struct sys s2, DOUBLE dt)
 #else
   kick_cpu(s1,s2,dt);
 #endif  
+  }
   diag->kstep[clevel]++;
-  diag->kcount[clevel]+=(ULONG) s1.n*s2.n;
-  diag->taskkick+=(ULONG) s1.n*s2.n;
+  diag->kcount[clevel]+=count;
+  diag->taskkick+=count;
 }
 
 static void potential_cpu(struct sys s1,struct sys s2)
 {
-  UINT i,j;
-  FLOAT dx[3],dr2,dr;
-  FLOAT pot;
+  UINT i,j,jself;
+  FLOAT pot,xi[3];
+  struct jsoa *js=pack_sources(s2,0);
+  const FLOAT *jm=js->mass,*jx=js->pos[0],*jy=js->pos[1],*jz=js->pos[2];
 
 #pragma omp parallel for if((ULONG) s1.n*s2.n>MPWORKLIMIT && !omp_in_parallel()) default(none) \
- private(i,j,dx,dr2,dr,pot) \
- shared(s1,s2,eps2)
+ private(i,j,jself,pot,xi) \
+ shared(s1,s2,eps2,jm,jx,jy,jz)
   for(i=0;i<s1.n;i++)
   {
     pot=0;
+    jself=self_index(s1.part+i,s2);
+    xi[0]=s1.part[i].pos[0];
+    xi[1]=s1.part[i].pos[1];
+    xi[2]=s1.part[i].pos[2];
+#pragma omp simd reduction(+:pot)
     for(j=0;j<s2.n;j++)
     {
-      if(s1.part+i==s2.part+j) continue; 
-      dx[0]=s1.part[i].pos[0]-s2.part[j].pos[0];
-      dx[1]=s1.part[i].pos[1]-s2.part[j].pos[1];
-      dx[2]=s1.part[i].pos[2]-s2.part[j].pos[2];
-      dr2=dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]+eps2;
-      if(dr2>0) 
-      {
-        dr=sqrt(dr2);
-        pot-=s2.part[j].mass/dr;
-      }
+      FLOAT dx=xi[0]-jx[j];
+      FLOAT dy=xi[1]-jy[j];
+      FLOAT dz=xi[2]-jz[j];
+      FLOAT dr2=dx*dx+dy*dy+dz*dz+eps2;
+      FLOAT dr=sqrt(dr2);
+      FLOAT potj=jm[j]/dr;
+      pot-=(j!=jself && dr2>0) ? potj : 0.;
     }
     s1.part[i].pot+=pot;
   }
@@ -415,6 +498,11 @@ static void potential_cpu(struct sys s1,struct sys s2)
 
 void potential(struct sys s1, struct sys s2)
 {
+  if(opening_angle>0 && (ULONG) s1.n*s2.n>tree_worklimit)
+  {
+    potential_tree(s1,s2);
+    return;
+  }
 #ifdef EVOLVE_OPENCL
   if((ULONG) s1.n*s2.n>CLWORKLIMIT) 
   {
@@ -476,18 +564,61 @@ inline FLOAT timestep_ij(struct particle *i, struct particle *j,int dir) {
 
 static void timestep_cpu(struct sys s1, struct sys s2,int dir)
 {
-  UINT i,j;
-  FLOAT timestep,tau;
+  /* same criteria as timestep_ij, with the branches replaced by selects */
+  UINT i,j,jself;
+  FLOAT timestep,eta=dt_param;
+  FLOAT xi[3],vi[3],mi;
+  struct jsoa *js=pack_sources(s2,1);
+  const FLOAT *jm=js->mass,*jx=js->pos[0],*jy=js->pos[1],*jz=js->pos[2];
+  const FLOAT *jvx=js->vel[0],*jvy=js->vel[1],*jvz=js->vel[2];
+
 #pragma omp parallel for if((ULONG) s1.n*s2.n>MPWORKLIMIT && !omp_in_parallel()) default(none) \
- private(i,j,tau,timestep) copyin(dt_param) \
- shared(s1,s2,stdout,dir)
+ private(i,j,jself,timestep,xi,vi,mi) \
+ shared(s1,s2,dir,eps2,eta,jm,jx,jy,jz,jvx,jvy,jvz)
   for(i=0;i<s1.n;i++)
   {  
     timestep=HUGE_VAL;
+    jself=self_index(s1.part+i,s2);
+    mi=s1.part[i].mass;
+    xi[0]=s1.part[i].pos[0];
+    xi[1]=s1.part[i].pos[1];
+    xi[2]=s1.part[i].pos[2];
+    vi[0]=s1.part[i].vel[0];
+    vi[1]=s1.part[i].vel[1];
+    vi[2]=s1.part[i].vel[2];
+#pragma omp simd reduction(min:timestep)
     for(j=0;j<s2.n;j++)
     {
-      tau=timestep_ij(s1.part+i,s2.part+j,dir);
-      if(tau < timestep) timestep=tau;
+      FLOAT tau,t,dtau;
+      FLOAT dx=xi[0]-jx[j];
+      FLOAT dy=xi[1]-jy[j];
+      FLOAT dz=xi[2]-jz[j];
+      FLOAT dr2=dx*dx+dy*dy+dz*dz+eps2;
+      FLOAT mu=mi+jm[j];
+      FLOAT dr=sqrt(dr2);
+      FLOAT dr3=dr*dr2;
+      FLOAT dvx=vi[0]-jvx[j];
+      FLOAT dvy=vi[1]-jvy[j];
+      FLOAT dvz=vi[2]-jvz[j];
+      FLOAT vdotdr2=(dvx*dx+dvy*dy+dvz*dz)/dr2;
+      FLOAT dv2=dvx*dvx+dvy*dvy+dvz*dvz;
+      tau=HUGE_VAL;
+#ifdef RATIMESTEP
+      t=RARVRATIO*eta/((FLOAT) M_SQRT2)*sqrt(dr3/mu);
+      dtau=3/2.*dir*t*vdotdr2;
+      dtau=(dtau>1.) ? 1. : dtau;
+      t/=(1-dtau/2);
+      tau=(t<tau) ? t : tau;
+#endif
+#ifdef RVTIMESTEP
+      t=eta*dr/sqrt(dv2);
+      dtau=dir*t*vdotdr2*(1+mu/(dv2*dr));
+      dtau=(dtau>1.) ? 1. : dtau;
+      t/=(1-dtau/2);
+      tau=(dv2>0 && t<tau) ? t : tau;
+#endif
+      tau=(j!=jself && dr2>0 && mu>0) ? tau : HUGE_VAL;
+      timestep=(tau<timestep) ? tau : timestep;
     }
 //    if(timestep<s1.part[i].timestep) 
     s1.part[i].timestep=timestep;
@@ -13,6 +13,7 @@
 
 #define MPWORKLIMIT 1000
 #define CLWORKLIMIT 100000
+#define TREEWORKLIMIT 1000000
 
 #define MAXLEVEL  64
 
@@ -105,6 +106,9 @@ extern struct sys zerosys;
 extern int fixed_j;
 extern DOUBLE bs_target_error;
 
+extern FLOAT opening_angle;
+extern ULONG tree_worklimit;
+
 /* diagnostics */
 struct diagnostics {
   DOUBLE simtime;
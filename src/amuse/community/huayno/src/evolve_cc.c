@@ -31,15 +31,277 @@
 #define LOGSYSp_ID(SYS) for (UINT i = 0; i < (SYS)->n; i++) { printf("%u ", (SYS)->part[i].id); } printf("\n");
 #define LOGSYSC_ID(SYS) for (struct sys *_ci = &(SYS); !IS_ZEROSYS(_ci); _ci = _ci->next_cc) {printf("{"); for (UINT i = 0; i < _ci->n; i++) {printf("%u ", _ci->part[i].id); } printf("}\t");} printf("\n");
 
-void split_cc(int clevel,struct sys s, struct sys *c, struct sys *r, DOUBLE dt) {
+/*
+ * Grid-based connected component search. Two particles can only be connected
+ * (timestep_ij <= dt) if they are close in position (r <= R) or, because of
+ * the approach correction of the RV timestep, close in velocity (|dv| <= U).
+ * R and U follow from lower bounds on timestep_ij in terms of the largest
+ * pair mass and the largest relative speed in the system, so that candidate
+ * pairs found on a position grid with cells of size R and a velocity grid
+ * with cells of size U include every connected pair. Candidates are tested
+ * with timestep_ij as before, so the components are identical to those of
+ * the direct search.
+ */
+
+#define CC_GRID_NMIN   256              // use the direct search below this size
+#define CC_GRID_BITS   21               // bits per dimension in the cell key
+#define CC_GRID_MARGIN 1.001            // safety factor on R and U
+
+struct cc_cell
+{
+  unsigned long long key;
+  UINT index;
+};
+
+static int compare_cc_cells(const void *a, const void *b)
+{
+  unsigned long long ka = ((const struct cc_cell *) a)->key;
+  unsigned long long kb = ((const struct cc_cell *) b)->key;
+  return (ka > kb) - (ka < kb);
+}
+
+static UINT cc_find(UINT *parent, UINT i)
+{
+  while (parent[i] != i)
+  {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+static void cc_search_radii(struct sys s, DOUBLE dt, DOUBLE *R, DOUBLE *U)
+{
   /*
-   * split_cc: run a connected component search on sys s with threshold dt,
-   * creates a singly-linked list of connected components c and a rest system r
-   * c or r is set to zerosys if no connected components/rest is found
+   * cc_search_radii: return the position search radius R and velocity search
+   * radius U for threshold dt (see above). With M the largest pair mass and V
+   * the largest relative speed:
+   * RA: timestep >= tau/(1+3/4*tau*V/dr), tau=RARVRATIO*dt_param/sqrt(2)*sqrt(dr^3/M)
+   * RV: timestep <= dt requires dr <= 2*dt*(1+dt_param/2)*V/dt_param or |dv| <= dt*M/dr^2
+   */
+  DOUBLE mmax = 0, vmin[3], vmax[3], M, V;
+  for (int k = 0; k < 3; k++) { vmin[k] = s.part[0].vel[k]; vmax[k] = s.part[0].vel[k]; }
+  for (UINT i = 0; i < s.n; i++)
+  {
+    if (s.part[i].mass > mmax) mmax = s.part[i].mass;
+    for (int k = 0; k < 3; k++)
+    {
+      if (s.part[i].vel[k] < vmin[k]) vmin[k] = s.part[i].vel[k];
+      if (s.part[i].vel[k] > vmax[k]) vmax[k] = s.part[i].vel[k];
+    }
+  }
+  M = 2 * mmax;
+  V = sqrt((vmax[0]-vmin[0])*(vmax[0]-vmin[0]) + (vmax[1]-vmin[1])*(vmax[1]-vmin[1]) +
+           (vmax[2]-vmin[2])*(vmax[2]-vmin[2]));
+  *R = 0;
+  *U = 0;
+  if (M <= 0) return; // no pair has a finite timestep
+#ifdef RATIMESTEP
+  {
+    // largest x = sqrt(dr) with k*x^3 - 3/4*dt*k*V*x - dt <= 0
+    DOUBLE k = RARVRATIO * dt_param / M_SQRT2 / sqrt(M), xlo = 0, xhi = 1;
+    while (k*xhi*xhi*xhi - 0.75*dt*k*V*xhi - dt <= 0) xhi *= 2;
+    for (int iter = 0; iter < 64; iter++)
+    {
+      DOUBLE x = (xlo + xhi) / 2;
+      if (k*x*x*x - 0.75*dt*k*V*x - dt <= 0) xlo = x; else xhi = x;
+    }
+    *R = xhi * xhi;
+  }
+#endif
+#ifdef RVTIMESTEP
+  {
+    DOUBLE Rv = 2 * dt * (1 + dt_param/2) * V / dt_param;
+    if (Rv > *R) *R = Rv;
+    *U = (*R > 0) ? dt * M / (*R * *R) : HUGE_VAL;
+  }
+#endif
+  *R *= CC_GRID_MARGIN;
+  *U *= CC_GRID_MARGIN;
+}
+
+static void cc_grid_link(int clevel, struct sys s, int use_vel, DOUBLE h, DOUBLE R, DOUBLE U,
+                         DOUBLE dt, int dir, UINT *parent, struct cc_cell *cells)
+{
+  /*
+   * cc_grid_link: join the components of all connected candidate pairs in
+   * neighbouring cells of size h of the position (use_vel=0) or velocity
+   * (use_vel=1) grid
+   */
+  const unsigned long long cmax = (1ULL << CC_GRID_BITS) - 1;
+  DOUBLE xmin[3], xmax[3], extent = 0;
+  for (int k = 0; k < 3; k++)
+  {
+    xmin[k] = xmax[k] = use_vel ? s.part[0].vel[k] : s.part[0].pos[k];
+  }
+  for (UINT i = 0; i < s.n; i++)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      DOUBLE x = use_vel ? s.part[i].vel[k] : s.part[i].pos[k];
+      if (x < xmin[k]) xmin[k] = x;
+      if (x > xmax[k]) xmax[k] = x;
+    }
+  }
+  for (int k = 0; k < 3; k++) if (xmax[k] - xmin[k] > extent) extent = xmax[k] - xmin[k];
+  // larger cells are still conservative
+  if (!(h > 0) || extent / h >= (DOUBLE) cmax) h = extent / (cmax - 1);
+  if (!(h > 0)) h = 1;
+
+  for (UINT i = 0; i < s.n; i++)
+  {
+    unsigned long long key = 0;
+    for (int k = 0; k < 3; k++)
+    {
+      DOUBLE x = use_vel ? s.part[i].vel[k] : s.part[i].pos[k];
+      unsigned long long c = (unsigned long long) ((x - xmin[k]) / h);
+      if (c > cmax) c = cmax;
+      key = (key << CC_GRID_BITS) | c;
+    }
+    cells[i].key = key;
+    cells[i].index = i;
+  }
+  qsort(cells, s.n, sizeof(struct cc_cell), compare_cc_cells);
+
+  for (UINT ic = 0; ic < s.n; ic++)
+  {
+    UINT i = cells[ic].index;
+    long long c[3];
+    c[0] = (cells[ic].key >> (2*CC_GRID_BITS)) & cmax;
+    c[1] = (cells[ic].key >> CC_GRID_BITS) & cmax;
+    c[2] = cells[ic].key & cmax;
+    for (int d = 0; d < 27; d++)
+    {
+      long long nc[3] = {c[0] + d/9 - 1, c[1] + (d/3)%3 - 1, c[2] + d%3 - 1};
+      if (nc[0] < 0 || nc[1] < 0 || nc[2] < 0 ||
+          nc[0] > (long long) cmax || nc[1] > (long long) cmax || nc[2] > (long long) cmax) continue;
+      unsigned long long key = ((unsigned long long) nc[0] << (2*CC_GRID_BITS)) |
+                               ((unsigned long long) nc[1] << CC_GRID_BITS) | (unsigned long long) nc[2];
+      // first cell entry with this key
+      UINT lo = 0, hi = s.n;
+      while (lo < hi)
+      {
+        UINT mid = lo + (hi - lo) / 2;
+        if (cells[mid].key < key) lo = mid + 1; else hi = mid;
+      }
+      for (UINT jc = lo; jc < s.n && cells[jc].key == key; jc++)
+      {
+        UINT j = cells[jc].index;
+        if (j <= i) continue;
+        UINT ri = cc_find(parent, i), rj = cc_find(parent, j);
+        if (ri == rj) continue;
+        DOUBLE dr2 = 0, dv2 = 0;
+        for (int k = 0; k < 3; k++)
+        {
+          DOUBLE dx = s.part[i].pos[k] - s.part[j].pos[k];
+          DOUBLE dv = s.part[i].vel[k] - s.part[j].vel[k];
+          dr2 += dx*dx;
+          dv2 += dv*dv;
+        }
+        if (dr2 > R*R && dv2 > U*U) continue;
+        diag->tcount[clevel]++;
+        if ((DOUBLE) timestep_ij(s.part+i, s.part+j, dir) <= dt)
+        {
+          if (ri < rj) parent[rj] = ri; else parent[ri] = rj;
+        }
+      }
+    }
+  }
+}
+
+static void split_cc_grid(int clevel, struct sys s, struct sys *c, struct sys *r, DOUBLE dt)
+{
+  /*
+   * split_cc_grid: same components as split_cc_direct, with the candidate
+   * pairs taken from the position and velocity grids. The components are
+   * stored in order of their first particle, followed by the rest system;
+   * the particle order within each is preserved.
+   */
+  int dir=SIGN(dt);
+  dt=fabs(dt);
+  DOUBLE R, U;
+  UINT *parent = (UINT*) malloc(s.n * sizeof(UINT));
+  UINT *size = (UINT*) malloc(s.n * sizeof(UINT));
+  UINT *start = (UINT*) malloc(s.n * sizeof(UINT));
+  struct cc_cell *cells = (struct cc_cell*) malloc(s.n * sizeof(struct cc_cell));
+  struct particle *sorted = (struct particle*) malloc(s.n * sizeof(struct particle));
+  if (parent == NULL || size == NULL || start == NULL || cells == NULL || sorted == NULL)
+  {
+    ENDRUN("split_cc_grid: memory allocation failed\n");
+  }
+  for (UINT i = 0; i < s.n; i++) { parent[i] = i; size[i] = 0; }
+
+  cc_search_radii(s, dt, &R, &U);
+  if (R > 0) cc_grid_link(clevel, s, 0, R, R, U, dt, dir, parent, cells);
+  if (U > 0) cc_grid_link(clevel, s, 1, U, R, U, dt, dir, parent, cells);
+
+  // the root of each component is its lowest index
+  for (UINT i = 0; i < s.n; i++)
+  {
+    parent[i] = cc_find(parent, i);
+    size[parent[i]]++;
+  }
+  UINT ncc = 0;
+  for (UINT i = 0; i < s.n; i++) if (parent[i] == i && size[i] > 1) ncc += size[i];
+  UINT comp_next = 0, rest_next = ncc;
+  for (UINT i = 0; i < s.n; i++)
+  {
+    if (parent[i] != i) continue;
+    if (size[i] > 1)
+    {
+      start[i] = comp_next;
+      comp_next += size[i];
+    }
+    else
+    {
+      start[i] = rest_next++;
+    }
+  }
+  for (UINT i = 0; i < s.n; i++) sorted[start[parent[i]]++] = s.part[i];
+  for (UINT i = 0; i < s.n; i++) s.part[i] = sorted[i];
+
+  // create the connected components
+  struct sys *c_next;
+  c_next = c;
+  *c_next = zerosys;
+  comp_next = 0;
+  for (UINT i = 0; i < s.n; i++)
+  {
+    if (parent[i] != i || size[i] < 2) continue;
+    c_next->n = size[i];
+    c_next->part = &( s.part[ comp_next ]);
+    c_next->last = &( s.part[ comp_next + size[i] - 1 ]);
+    c_next->next_cc = (struct sys*) malloc( sizeof(struct sys) );
+    c_next = c_next->next_cc;
+    *c_next = zerosys;
+    comp_next += size[i];
+  }
+  // create the rest system
+  r->n = s.n - ncc;
+  if (r->n > 0)
+  {
+    r->part = &( s.part[ncc] );
+    r->last = s.last;
+  }
+  else
+  {
+    r->part = NULL;
+    r->last = NULL;
+  }
+  free(sorted);
+  free(cells);
+  free(start);
+  free(size);
+  free(parent);
+}
+
+static void split_cc_direct(int clevel,struct sys s, struct sys *c, struct sys *r, DOUBLE dt) {
+  /*
+   * split_cc_direct: depth-first connected component search testing all
+   * pairs of the stack top and unvisited particles
    */
   int dir=SIGN(dt);
   dt=fabs(dt);
-  diag->tstep[clevel]++; // not directly comparable to corresponding SF-split statistics
   struct sys *c_next;
   c_next = c;
   *c_next = zerosys;
@@ -125,6 +387,23 @@ void split_cc(int clevel,struct sys s, struct sys *c, struct sys *r, DOUBLE dt)
   //LOG("split_cc: rest system size: %d\n", r->n);
 }
 
+void split_cc(int clevel,struct sys s, struct sys *c, struct sys *r, DOUBLE dt) {
+  /*
+   * split_cc: run a connected component search on sys s with threshold dt,
+   * creates a singly-linked list of connected components c and a rest system r
+   * c or r is set to zerosys if no connected components/rest is found
+   */
+  diag->tstep[clevel]++; // not directly comparable to corresponding SF-split statistics
+  if (s.n < CC_GRID_NMIN)
+  {
+    split_cc_direct(clevel, s, c, r, dt);
+  }
+  else
+  {
+    split_cc_grid(clevel, s, c, r, dt);
+  }
+}
+
 void split_cc_verify(int clevel,struct sys s, struct sys *c, struct sys *r) {
   /*
    * split_cc_verify: explicit verification if connected components c and rest system r form a correct
@@ -0,0 +1,295 @@
+/*
+ * Barnes-Hut evaluation of the kick and potential of sys s2 on sys s1. kick()
+ * and potential() use it instead of the direct sum when opening_angle > 0 and
+ * s1.n*s2.n > tree_worklimit, so only the large (slow) interactions of the
+ * outer split levels are approximated.
+ *
+ * The octree is rebuilt over s2 on every call. Nodes are stored depth first
+ * with the index of the node following their subtree, so the walk needs no
+ * stack. A node is accepted (monopole) if the sink is further from its center
+ * of mass than size/opening_angle plus the offset of the center of mass from
+ * the node center; rejected leaves are summed directly.
+ */
+
+#include <tgmath.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "evolve.h"
+#include "evolve_tree.h"
+
+FLOAT opening_angle=0.;
+ULONG tree_worklimit=TREEWORKLIMIT;
+
+struct tnode
+{
+  FLOAT mass;
+  FLOAT com[3];
+  FLOAT rcrit2;
+  UINT first,n; /* particles first...first+n-1 in tree order */
+  UINT skip;    /* node following the subtree */
+  int leaf;
+};
+
+struct tree
+{
+  UINT nnodes,maxnodes,size;
+  struct tnode *node;
+  UINT *order; /* index in s2 of the particles in tree order */
+  UINT *tmp;
+  FLOAT *mass,*pos[3]; /* s2 order while building, tree order after */
+  FLOAT *smass,*spos[3];
+};
+
+/* tree buffers are threadprivate, as the CC integrators kick from concurrent tasks */
+static struct tree tbuffer;
+#pragma omp threadprivate(tbuffer)
+
+static void *tree_alloc(void *p, size_t size)
+{
+  p=realloc(p,size);
+  if(p==NULL) ENDRUN("tree_alloc: memory allocation failed\n");
+  return p;
+}
+
+static UINT new_node(struct tree *t)
+{
+  if(t->nnodes==t->maxnodes)
+  {
+    t->maxnodes=2*t->maxnodes+64;
+    t->node=(struct tnode *) tree_alloc(t->node,t->maxnodes*sizeof(struct tnode));
+  }
+  return t->nnodes++;
+}
+
+#define OCTANT(t,j,c) (((t)->pos[0][j]>(c)[0]) | ((t)->pos[1][j]>(c)[1])<<1 | ((t)->pos[2][j]>(c)[2])<<2)
+
+static void build_node(struct tree *t, UINT first, UINT n, FLOAT center[3], FLOAT half, int depth)
+{
+  UINT inode=new_node(t),p,k,count[8],start[8];
+  FLOAT mass=0.,com[3]={0.,0.,0.},delta2=0.,rcrit;
+  struct tnode *node;
+
+  for(p=first;p<first+n;p++)
+  {
+    UINT j=t->order[p];
+    mass+=t->mass[j];
+    for(k=0;k<3;k++) com[k]+=t->mass[j]*t->pos[k][j];
+  }
+  for(k=0;k<3;k++)
+  {
+    com[k]=(mass>0) ? com[k]/mass : center[k];
+    delta2+=(com[k]-center[k])*(com[k]-center[k]);
+  }
+  rcrit=2*half/opening_angle+sqrt(delta2);
+
+  node=t->node+inode;
+  node->mass=mass;
+  for(k=0;k<3;k++) node->com[k]=com[k];
+  node->rcrit2=rcrit*rcrit;
+  node->first=first;
+  node->n=n;
+  node->leaf=(n<=TREE_LEAFSIZE || depth>=TREE_MAXDEPTH);
+
+  if(!node->leaf)
+  {
+    /* sort the particles by octant */
+    for(k=0;k<8;k++) count[k]=0;
+    for(p=first;p<first+n;p++)
+    {
+      UINT j=t->order[p];
+      t->tmp[p]=j;
+      count[OCTANT(t,j,center)]++;
+    }
+    start[0]=first;
+    for(k=1;k<8;k++) start[k]=start[k-1]+count[k-1];
+    for(p=first;p<first+n;p++)
+    {
+      UINT j=t->tmp[p];
+      t->order[start[OCTANT(t,j,center)]++]=j;
+    }
+    for(k=0;k<8;k++)
+    {
+      if(count[k]==0) continue;
+      FLOAT ccenter[3];
+      ccenter[0]=center[0]+((k&1) ? half/2 : -half/2);
+      ccenter[1]=center[1]+((k&2) ? half/2 : -half/2);
+      ccenter[2]=center[2]+((k&4) ? half/2 : -half/2);
+      build_node(t,start[k]-count[k],count[k],ccenter,half/2,depth+1);
+    }
+  }
+  t->node[inode].skip=t->nnodes;
+}
+
+static struct tree *build_tree(struct sys s)
+{
+  struct tree *t=&tbuffer;
+  UINT p,k;
+  FLOAT xmin[3],xmax[3],center[3],half=0.;
+
+  if(s.n>t->size)
+  {
+    t->size=s.n+s.n/4+16;
+    t->order=(UINT *) tree_alloc(t->order,t->size*sizeof(UINT));
+    t->tmp=(UINT *) tree_alloc(t->tmp,t->size*sizeof(UINT));
+    t->mass=(FLOAT *) tree_alloc(t->mass,t->size*sizeof(FLOAT));
+    t->smass=(FLOAT *) tree_alloc(t->smass,t->size*sizeof(FLOAT));
+    for(k=0;k<3;k++)
+    {
+      t->pos[k]=(FLOAT *) tree_alloc(t->pos[k],t->size*sizeof(FLOAT));
+      t->spos[k]=(FLOAT *) tree_alloc(t->spos[k],t->size*sizeof(FLOAT));
+    }
+  }
+  for(p=0;p<s.n;p++)
+  {
+    t->order[p]=p;
+    t->mass[p]=s.part[p].mass;
+    for(k=0;k<3;k++) t->pos[k][p]=s.part[p].pos[k];
+  }
+  for(k=0;k<3;k++)
+  {
+    xmin[k]=xmax[k]=t->pos[k][0];
+    for(p=1;p<s.n;p++)
+    {
+      if(t->pos[k][p]<xmin[k]) xmin[k]=t->pos[k][p];
+      if(t->pos[k][p]>xmax[k]) xmax[k]=t->pos[k][p];
+    }
+    center[k]=(xmin[k]+xmax[k])/2;
+    if((xmax[k]-xmin[k])/2>half) half=(xmax[k]-xmin[k])/2;
+  }
+  half=(half>0) ? 1.0001*half : 1.;
+
+  t->nnodes=0;
+  build_node(t,0,s.n,center,half,0);
+
+  for(p=0;p<s.n;p++)
+  {
+    UINT j=t->order[p];
+    t->smass[p]=t->mass[j];
+    for(k=0;k<3;k++) t->spos[k][p]=t->pos[k][j];
+  }
+  return t;
+}
+
+ULONG kick_tree(struct sys s1, struct sys s2, DOUBLE dt)
+{
+  UINT i;
+  ULONG count=0;
+  struct tree *t;
+  if(s2.n==0) return 0;
+  t=build_tree(s2);
+
+#pragma omp parallel for if((ULONG) s1.n*s2.n>MPWORKLIMIT && !omp_in_parallel()) default(none) \
+ private(i) shared(dt,s1,t,eps2) reduction(+:count)
+  for(i=0;i<s1.n;i++)
+  {
+    FLOAT ax=0.,ay=0.,az=0.,xi[3];
+    const FLOAT *jm=t->smass,*jx=t->spos[0],*jy=t->spos[1],*jz=t->spos[2];
+    UINT inode=0;
+    xi[0]=s1.part[i].pos[0];
+    xi[1]=s1.part[i].pos[1];
+    xi[2]=s1.part[i].pos[2];
+    while(inode<t->nnodes)
+    {
+      const struct tnode *node=t->node+inode;
+      FLOAT dx=xi[0]-node->com[0];
+      FLOAT dy=xi[1]-node->com[1];
+      FLOAT dz=xi[2]-node->com[2];
+      FLOAT dr2=dx*dx+dy*dy+dz*dz;
+      if(dr2>node->rcrit2)
+      {
+        FLOAT dr,acci;
+        dr2+=eps2;
+        dr=sqrt(dr2);
+        acci=node->mass/(dr*dr2);
+        ax-=dx*acci;
+        ay-=dy*acci;
+        az-=dz*acci;
+        count++;
+        inode=node->skip;
+      } else if(node->leaf)
+      {
+        UINT j;
+#pragma omp simd reduction(+:ax,ay,az)
+        for(j=node->first;j<node->first+node->n;j++)
+        {
+          FLOAT dx=xi[0]-jx[j];
+          FLOAT dy=xi[1]-jy[j];
+          FLOAT dz=xi[2]-jz[j];
+          FLOAT dr2=dx*dx+dy*dy+dz*dz+eps2;
+          FLOAT dr=sqrt(dr2);
+          FLOAT acci=jm[j]/(dr*dr2);
+          acci=(dr2>0) ? acci : 0.;
+          ax-=dx*acci;
+          ay-=dy*acci;
+          az-=dz*acci;
+        }
+        count+=node->n;
+        inode=node->skip;
+      } else
+      {
+        inode++;
+      }
+    }
+    COMPSUMV(s1.part[i].vel[0],s1.part[i].vel_e[0],dt*ax);
+    COMPSUMV(s1.part[i].vel[1],s1.part[i].vel_e[1],dt*ay);
+    COMPSUMV(s1.part[i].vel[2],s1.part[i].vel_e[2],dt*az);
+  }
+  return count;
+}
+
+void potential_tree(struct sys s1, struct sys s2)
+{
+  UINT i;
+  struct tree *t;
+  if(s2.n==0) return;
+  t=build_tree(s2);
+
+#pragma omp parallel for if((ULONG) s1.n*s2.n>MPWORKLIMIT && !omp_in_parallel()) default(none) \
+ private(i) shared(s1,s2,t,eps2)
+  for(i=0;i<s1.n;i++)
+  {
+    FLOAT pot=0.,xi[3];
+    const FLOAT *jm=t->smass,*jx=t->spos[0],*jy=t->spos[1],*jz=t->spos[2];
+    const UINT *order=t->order;
+    UINT inode=0,jself;
+    jself=(s1.part+i>=s2.part && s1.part+i<s2.part+s2.n) ? (UINT) (s1.part+i-s2.part) : s2.n;
+    xi[0]=s1.part[i].pos[0];
+    xi[1]=s1.part[i].pos[1];
+    xi[2]=s1.part[i].pos[2];
+    while(inode<t->nnodes)
+    {
+      const struct tnode *node=t->node+inode;
+      FLOAT dx=xi[0]-node->com[0];
+      FLOAT dy=xi[1]-node->com[1];
+      FLOAT dz=xi[2]-node->com[2];
+      FLOAT dr2=dx*dx+dy*dy+dz*dz;
+      if(dr2>node->rcrit2)
+      {
+        pot-=node->mass/sqrt(dr2+eps2);
+        inode=node->skip;
+      } else if(node->leaf)
+      {
+        UINT j;
+#pragma omp simd reduction(+:pot)
+        for(j=node->first;j<node->first+node->n;j++)
+        {
+          FLOAT dx=xi[0]-jx[j];
+          FLOAT dy=xi[1]-jy[j];
+          FLOAT dz=xi[2]-jz[j];
+          FLOAT dr2=dx*dx+dy*dy+dz*dz+eps2;
+          FLOAT dr=sqrt(dr2);
+          FLOAT potj=jm[j]/dr;
+          pot-=(order[j]!=jself && dr2>0) ? potj : 0.;
+        }
+        inode=node->skip;
+      } else
+      {
+        inode++;
+      }
+    }
+    s1.part[i].pot+=pot;
+  }
+}
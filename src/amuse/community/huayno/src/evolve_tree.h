@@ -0,0 +1,5 @@
+#define TREE_LEAFSIZE  8
+#define TREE_MAXDEPTH  48
+
+ULONG kick_tree(struct sys s1, struct sys s2, DOUBLE dt);
+void potential_tree(struct sys s1, struct sys s2);
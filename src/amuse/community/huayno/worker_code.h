@@ -0,0 +1,162 @@
+#include "stdbool.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int get_mass(int index_of_the_particle, double * mass);
+
+int commit_particles();
+
+int set_stopping_condition_timeout_parameter(double value);
+
+int get_time(double * time);
+
+int set_mass(int index_of_the_particle, double mass);
+
+int get_stopping_condition_maximum_density_parameter(double * value);
+
+int set_eps2_parameter(double eps2);
+
+int set_stopping_condition_out_of_box_use_center_of_mass_parameter(bool value);
+
+int get_index_of_first_particle(int * index_of_the_particle);
+
+int get_stopping_condition_out_of_box_use_center_of_mass_parameter(bool * value);
+
+int enable_stopping_condition(int type);
+
+int get_total_radius(double * radius);
+
+int get_stopping_condition_maximum_internal_energy_parameter(double * value);
+
+int get_potential_at_point(double * eps, double * x, double * y, double * z, double * phi, int npoints);
+
+int get_number_of_stopping_conditions_set(int * result);
+
+int is_stopping_condition_set(int type, int * result);
+
+int new_particle(int * index_of_the_particle, double mass, double x, double y, double z, double vx, double vy, double vz, double radius);
+
+int set_timestep(double timestep);
+
+int get_total_mass(double * mass);
+
+int evolve_model(double time_end);
+
+int get_timestep(double * timestep);
+
+int set_opening_angle(double opening_angle);
+
+int set_stopping_condition_out_of_box_parameter(double value);
+
+int get_eps2_parameter(double * eps2);
+
+int set_stopping_condition_number_of_steps_parameter(int value);
+
+int get_stopping_condition_timeout_parameter(double * value);
+
+int get_begin_time(double * time);
+
+int get_stopping_condition_minimum_internal_energy_parameter(double * value);
+
+int set_tree_work_limit(long long int tree_work_limit);
+
+int get_index_of_next_particle(int index_of_the_particle, int * index_of_the_next_particle);
+
+int delete_particle(int index_of_the_particle);
+
+int is_stopping_condition_enabled(int type, int * result);
+
+int get_tree_work_limit(long long int * tree_work_limit);
+
+int set_inttype_parameter(int inttype);
+
+int get_potential(int index_of_the_particle, double * potential);
+
+int synchronize_model();
+
+int set_state(int index_of_the_particle, double mass, double x, double y, double z, double vx, double vy, double vz, double radius);
+
+int get_stopping_condition_minimum_density_parameter(double * value);
+
+int get_state(int index_of_the_particle, double * mass, double * x, double * y, double * z, double * vx, double * vy, double * vz, double * radius);
+
+int get_time_step(double * time_step);
+
+int recommit_particles();
+
+int get_kinetic_energy(double * kinetic_energy);
+
+int set_timestep_parameter(double time_param);
+
+int get_number_of_particles(int * number_of_particles);
+
+int get_stopping_condition_number_of_steps_parameter(int * value);
+
+int disable_stopping_condition(int type);
+
+int get_evolve_statistics(long long int * ttot, long long int * ktot, long long int * dtot, long long int * tstot, long long int * kstot, long long int * dstot);
+
+int set_acceleration(int index_of_the_particle, double ax, double ay, double az);
+
+int get_center_of_mass_position(double * x, double * y, double * z);
+
+int get_timestep_parameter(double * time_param);
+
+int get_center_of_mass_velocity(double * vx, double * vy, double * vz);
+
+int get_radius(int index_of_the_particle, double * radius);
+
+int set_stopping_condition_minimum_internal_energy_parameter(double value);
+
+int set_begin_time(double time);
+
+int set_stopping_condition_minimum_density_parameter(double value);
+
+int get_verbosity_parameter(int * verbosity);
+
+int set_verbosity_parameter(int verbosity);
+
+int set_radius(int index_of_the_particle, double radius);
+
+int has_stopping_condition(int type, int * result);
+
+int cleanup_code();
+
+int set_stopping_condition_maximum_density_parameter(double value);
+
+int recommit_parameters();
+
+int initialize_code();
+
+int get_potential_energy(double * potential_energy);
+
+int get_gravity_at_point(double * eps, double * x, double * y, double * z, double * ax, double * ay, double * az, int npoints);
+
+int get_velocity(int index_of_the_particle, double * vx, double * vy, double * vz);
+
+int get_stopping_condition_out_of_box_parameter(double * value);
+
+int get_inttype_parameter(int * inttype);
+
+int get_position(int index_of_the_particle, double * x, double * y, double * z);
+
+int set_stopping_condition_maximum_internal_energy_parameter(double value);
+
+int get_opening_angle(double * opening_angle);
+
+int set_position(int index_of_the_particle, double x, double y, double z);
+
+int get_stopping_condition_info(int index, int * type, int * number_of_particles);
+
+int get_acceleration(int index_of_the_particle, double * ax, double * ay, double * az);
+
+int commit_parameters();
+
+int get_stopping_condition_particle_index(int index, int index_of_the_column, int * index_of_particle);
+
+int set_velocity(int index_of_the_particle, double vx, double vy, double vz);
+#ifdef __cplusplus
+}
+#endif
+
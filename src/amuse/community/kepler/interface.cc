@@ -1,6 +1,7 @@
 #include "stdinc.h"
 #include "kepler.h"
 #include "interface.h"
+#include "universal_kepler.h"
 
 static kepler *k;
 
@@ -445,3 +446,43 @@ int make_binary_scattering(real m, real ecc,
 
     return 0;
 }
+
+// Array functions: propagate many independent orbits in one call,
+// without touching the global kepler structure.  See
+// universal_kepler.cc.  The input and output arrays are separate
+// buffers in the worker, so they are passed on as they are.
+
+int propagate_orbits(double * mass,
+		     double * x, double * y, double * z,
+		     double * vx, double * vy, double * vz,
+		     double * dt,
+		     double * x1, double * y1, double * z1,
+		     double * vx1, double * vy1, double * vz1,
+		     int n)
+{
+    int *status = new int[n];
+    universal_propagate(n, mass, x, y, z, vx, vy, vz, dt,
+			x1, y1, z1, vx1, vy1, vz1, status);
+    int result = 0;
+    for (int i = 0; i < n; i++)
+	if (status[i] < result) result = status[i];
+    delete [] status;
+    return result;
+}
+
+int propagate_orbits_from_elements(double * mass, double * semi,
+				   double * ecc, double * mean_anomaly,
+				   double * dt,
+				   double * x1, double * y1, double * z1,
+				   double * vx1, double * vy1, double * vz1,
+				   int n)
+{
+    int *status = new int[n];
+    universal_propagate_elements(n, mass, semi, ecc, mean_anomaly, dt,
+				 x1, y1, z1, vx1, vy1, vz1, status);
+    int result = 0;
+    for (int i = 0; i < n; i++)
+	if (status[i] < result) result = status[i];
+    delete [] status;
+    return result;
+}
@@ -0,0 +1,82 @@
+#include "stdbool.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int transform_to_time(double time);
+
+int get_time(double * time);
+
+int set_periastron(double peri);
+
+int get_separation_vector(double * x, double * y, double * z);
+
+int return_to_apastron();
+
+int get_total_mass(double * mass);
+
+int get_angles(double * true_anomaly, double * mean_anomaly);
+
+int return_to_radius(double radius);
+
+int get_integrals(double * energy, double * angular_momentum);
+
+int get_apastron(double * apo);
+
+int advance_to_radius(double radius);
+
+int return_to_periastron();
+
+int get_velocity_vector(double * vx, double * vy, double * vz);
+
+int propagate_orbits(double * mass, double * x, double * y, double * z, double * vx, double * vy, double * vz, double * dt, double * x1, double * y1, double * z1, double * vx1, double * vy1, double * vz1, int n);
+
+int get_transverse_unit_vector(double * vx, double * vy, double * vz);
+
+int set_transverse_unit_vector(double vx, double vy, double vz);
+
+int set_random(int seed);
+
+int advance_to_periastron();
+
+int initialize_from_elements(double mass, double semi, double ecc, double mean_anomaly, double time, double periastron, int random_orientation);
+
+int get_period(double * period);
+
+int make_binary_scattering(double m, double ecc, double M, double v_inf, double impact_parameter, double gamma, int planar, double * time, double * m1, double * m2, double * m3, double * x1, double * x2, double * x3, double * y1, double * y2, double * y3, double * z1, double * z2, double * z3, double * vx1, double * vx2, double * vx3, double * vy1, double * vy2, double * vy3, double * vz1, double * vz2, double * vz3);
+
+int cleanup_code();
+
+int get_random(int * seed);
+
+int get_separation(double * r);
+
+int get_longitudinal_unit_vector(double * vx, double * vy, double * vz);
+
+int recommit_parameters();
+
+int advance_to_apastron();
+
+int initialize_code();
+
+int print_all();
+
+int get_periastron(double * peri);
+
+int get_elements(double * semi, double * ecc);
+
+int set_normal_unit_vector(double vx, double vy, double vz);
+
+int initialize_from_dyn(double mass, double x, double y, double z, double vx, double vy, double vz, double time);
+
+int propagate_orbits_from_elements(double * mass, double * semi, double * ecc, double * mean_anomaly, double * dt, double * x, double * y, double * z, double * vx, double * vy, double * vz, int n);
+
+int commit_parameters();
+
+int set_longitudinal_unit_vector(double vx, double vy, double vz);
+
+int get_normal_unit_vector(double * vx, double * vy, double * vz);
+#ifdef __cplusplus
+}
+#endif
+
@@ -649,6 +649,83 @@ class KeplerInterface(CodeInterface,
             problem"""
         return function
 
+    @legacy_function
+    def propagate_orbits():
+        """
+        Advance many independent orbits, given the total mass and the
+        relative position and velocity of each, by their own time
+        steps dt in one call.  The global kepler orbit is not used or
+        changed.
+        """
+        function = LegacyFunctionSpecification()
+        function.must_handle_array = True
+        function.addParameter('mass', dtype='float64', direction=function.IN,
+                              unit = nbody_system.mass)
+        for x in ['x', 'y', 'z']:
+            function.addParameter(x, dtype='float64', direction=function.IN,
+                                  unit = nbody_system.length)
+        for x in ['vx', 'vy', 'vz']:
+            function.addParameter(x, dtype='float64', direction=function.IN,
+                                  unit = nbody_system.speed)
+        function.addParameter('dt', dtype='float64', direction=function.IN,
+                              unit = nbody_system.time)
+        for x in ['x1', 'y1', 'z1']:
+            function.addParameter(x, dtype='float64', direction=function.OUT,
+                                  unit = nbody_system.length)
+        for x in ['vx1', 'vy1', 'vz1']:
+            function.addParameter(x, dtype='float64', direction=function.OUT,
+                                  unit = nbody_system.speed)
+        function.addParameter('n', dtype='int32', direction=function.LENGTH)
+        function.result_type = 'int32'
+        function.result_doc = """
+         0 - OK
+            all orbits propagated
+        -1 - ERROR
+            the Kepler equation did not converge for some orbits
+        -2 - ERROR
+            some orbits have mass <= 0 (these are left unchanged)"""
+        return function
+
+    @legacy_function
+    def propagate_orbits_from_elements():
+        """
+        Advance many independent orbits, given by their total mass,
+        semi-major axis, eccentricity and mean anomaly, by time dt
+        and return the relative positions and velocities.  The orbits
+        are in the x-y plane with the periastron along the x axis;
+        only the magnitude of the semi-major axis is used, and ecc > 1
+        means an unbound orbit.
+        """
+        function = LegacyFunctionSpecification()
+        function.must_handle_array = True
+        function.addParameter('mass', dtype='float64', direction=function.IN,
+                              unit = nbody_system.mass)
+        function.addParameter('semi', dtype='float64', direction=function.IN,
+                              unit = nbody_system.length)
+        function.addParameter('ecc', dtype='float64', direction=function.IN,
+                              unit = NO_UNIT)
+        function.addParameter('mean_anomaly', dtype='float64',
+                              direction=function.IN, unit = NO_UNIT)
+        function.addParameter('dt', dtype='float64', direction=function.IN,
+                              unit = nbody_system.time)
+        for x in ['x', 'y', 'z']:
+            function.addParameter(x, dtype='float64', direction=function.OUT,
+                                  unit = nbody_system.length)
+        for x in ['vx', 'vy', 'vz']:
+            function.addParameter(x, dtype='float64', direction=function.OUT,
+                                  unit = nbody_system.speed)
+        function.addParameter('n', dtype='int32', direction=function.LENGTH)
+        function.result_type = 'int32'
+        function.result_doc = """
+         0 - OK
+            all orbits propagated
+        -1 - ERROR
+            the Kepler equation did not converge for some orbits
+        -2 - ERROR
+            some orbits have mass <= 0, semi = 0 or ecc = 1
+            (their output is zero)"""
+        return function
+
 class Kepler(CommonCode):
     
     __interface__ = KeplerInterface
@@ -718,7 +795,9 @@ class Kepler(CommonCode):
             'print_all',
             'set_random',
             'get_random',
-            'make_binary_scattering']:
+            'make_binary_scattering',
+            'propagate_orbits',
+            'propagate_orbits_from_elements']:
             handler.add_method('!UNINITIALIZED!END', method_name)
         
 
@@ -0,0 +1,372 @@
+// universal_kepler.cc: propagation of many independent two-body orbits
+//			in universal variables.  See universal_kepler.h.
+//
+// The formulation follows the universal Kepler solver of huayno: with
+// mu = total mass, alpha = v0^2 - 2 mu / r0 (twice the specific
+// energy) and z = alpha s^2, the universal Kepler equation is
+//
+//	dt = r0 s + (r0.v0) S2(s) + (mu + alpha r0) S3(s),
+//
+// with S_k(s) = s^k c_k(z) and c_k the Stumpff functions, which is
+// solved for s with the Laguerre method.  To let the compiler evaluate
+// a whole block of orbits in SIMD lanes, the Stumpff functions are
+// computed without branches on the sign or size of z: z is reduced by
+// masked quarterings, c2 and c3 are summed as power series, and the
+// quarterings are undone with the duplication formulae
+//
+//	c2(4z) = c1(z)^2 / 2,	c3(4z) = (c2(z) + c0(z) c3(z)) / 4,
+//
+// where c0 = 1 + z c2 and c1 = 1 + z c3.  Converged orbits are masked
+// out of the iteration rather than branched around.  Masks and counts
+// in the block loops are kept as doubles, so that every loop works on
+// a single vector width.
+
+#include  <math.h>
+#include  <stdlib.h>
+#include  "universal_kepler.h"
+
+#define STUMPFF_ZMAX	0.1	// |z| below which the series are used
+#define STUMPFF_NQUART	28	// enough for |z| < 0.1 * 4^28 ~ 7e15
+
+// Stumpff functions c2 and c3 for a block of arguments.  Every pass
+// is a simple loop over the block; the number of quartering passes is
+// that of the largest |z| in the block.
+
+static void stumpff_block(int nb, const double *z, double *c2, double *c3)
+{
+    double zr[UNIVERSAL_BLOCK];
+    double nq[UNIVERSAL_BLOCK];
+
+#pragma omp simd
+    for (int j = 0; j < nb; j++) {
+	zr[j] = z[j];
+	nq[j] = 0;
+    }
+
+    int nquart = 0;
+    double nbig = nb;
+    while (nbig > 0 && nquart < STUMPFF_NQUART) {
+	nbig = 0;
+#pragma omp simd reduction(+:nbig)
+	for (int j = 0; j < nb; j++) {
+	    double big = fabs(zr[j]) > STUMPFF_ZMAX;
+	    zr[j] = big ? 0.25 * zr[j] : zr[j];
+	    nq[j] += big;
+	    nbig += big;
+	}
+	nquart += (nbig > 0);
+    }
+
+#pragma omp simd
+    for (int j = 0; j < nb; j++) {
+	double x = zr[j];
+	c2[j] = ((((((((x / 306 + 1) * x / 240 + 1) * x / 182 + 1)
+		     * x / 132 + 1) * x / 90 + 1) * x / 56 + 1)
+		  * x / 30 + 1) * x / 12 + 1) / 2;
+	c3[j] = ((((((((x / 342 + 1) * x / 272 + 1) * x / 210 + 1)
+		     * x / 156 + 1) * x / 110 + 1) * x / 72 + 1)
+		  * x / 42 + 1) * x / 20 + 1) / 6;
+    }
+
+    // Undo the quarterings.
+
+    for (int i = 0; i < nquart; i++) {
+#pragma omp simd
+	for (int j = 0; j < nb; j++) {
+	    bool up = i < nq[j];
+	    double x = zr[j];
+	    double c0 = 1 + x * c2[j];
+	    double c1 = 1 + x * c3[j];
+	    double c2n = 0.5 * c1 * c1;
+	    double c3n = 0.25 * (c2[j] + c0 * c3[j]);
+	    c2[j] = up ? c2n : c2[j];
+	    c3[j] = up ? c3n : c3[j];
+	    zr[j] = up ? 4 * x : x;
+	}
+    }
+}
+
+// Advance a block of nb <= UNIVERSAL_BLOCK orbits.  All loops run over
+// the whole block.  Returns the number of orbits that did not
+// converge; conv[j] is set to 1 for those that did.
+
+static int propagate_block(int nb, const double *mass,
+			   const double *x, const double *y, const double *z,
+			   const double *vx, const double *vy, const double *vz,
+			   const double *dt,
+			   double *x1, double *y1, double *z1,
+			   double *vx1, double *vy1, double *vz1,
+			   int *conv)
+{
+    double r0[UNIVERSAL_BLOCK], r0v0[UNIVERSAL_BLOCK];
+    double alpha[UNIVERSAL_BLOCK], beta[UNIVERSAL_BLOCK];
+    double t[UNIVERSAL_BLOCK], s[UNIVERSAL_BLOCK];
+    double zeta[UNIVERSAL_BLOCK], c2[UNIVERSAL_BLOCK], c3[UNIVERSAL_BLOCK];
+    double done[UNIVERSAL_BLOCK];
+
+    // Initial guesses.  The first is for strongly hyperbolic orbits
+    // (Bate et al. 1971, eq. 4.5.11); otherwise the step is reduced
+    // modulo the period for bound orbits.  Orbits with r0 = 0 or
+    // dt = 0 are finished from the start, with s = 0.
+
+#pragma omp simd
+    for (int j = 0; j < nb; j++) {
+	double m = mass[j];
+	double rr = x[j]*x[j] + y[j]*y[j] + z[j]*z[j];
+	double r = sqrt(rr);
+	double rv = x[j]*vx[j] + y[j]*vy[j] + z[j]*vz[j];
+	double vv = vx[j]*vx[j] + vy[j]*vy[j] + vz[j]*vz[j];
+	double u = sqrt(2 * m / r);
+	double v = sqrt(vv);
+	double a = (v - u) * (v + u);
+	double abs_a = fabs(a);
+	double sqrt_a = sqrt(abs_a);
+	double tj = dt[j];
+
+	double ss = 2 * a * fabs(tj / (rv + (m + a * r) / sqrt_a));
+	double s_hyp = copysign(1.0, tj) * log(ss) / sqrt_a;
+
+	double period = 2 * M_PI * m / (abs_a * sqrt_a);
+	double ratio = tj / period;
+	double t_red = (ratio - trunc(ratio)) * period;
+	t_red = (a < 0) ? t_red : tj;
+	double s01 = t_red / r;
+	double s_ell = (fabs(a * s01 * s01) < 1) ? s01 : t_red * abs_a / m;
+
+	bool hyp = ss > 1;
+	bool trivial = !(rr > 0) || tj == 0;
+
+	r0[j] = r;
+	r0v0[j] = rv;
+	alpha[j] = a;
+	beta[j] = m + a * r;
+	t[j] = hyp ? tj : t_red;
+	s[j] = trivial ? 0 : (hyp ? s_hyp : s_ell);
+	done[j] = trivial ? 1 : 0;
+    }
+
+    // Masked Laguerre iteration, until all orbits in the block have
+    // converged.
+
+    const int order = 5;
+    double nactive = nb;
+    for (int iter = 0; iter < UNIVERSAL_MAXITER && nactive > 0; iter++) {
+
+#pragma omp simd
+	for (int j = 0; j < nb; j++)
+	    zeta[j] = alpha[j] * s[j] * s[j];
+	stumpff_block(nb, zeta, c2, c3);
+
+	nactive = 0;
+#pragma omp simd reduction(+:nactive)
+	for (int j = 0; j < nb; j++) {
+	    double sj = s[j];
+	    double s2 = sj * sj;
+	    double S0 = 1 + zeta[j] * c2[j];
+	    double S1 = sj * (1 + zeta[j] * c3[j]);
+	    double S2 = s2 * c2[j];
+	    double S3 = s2 * sj * c3[j];
+
+	    double f = r0[j] * sj + r0v0[j] * S2 + beta[j] * S3 - t[j];
+	    double df = r0[j] + r0v0[j] * S1 + beta[j] * S2;
+	    double ddf = r0v0[j] * S0 + beta[j] * S1;
+
+	    double b = df * df - f * ddf;
+	    double h = df + copysign(1.0, df)
+				* sqrt(fabs((order - 1) * (order * b - df * df)));
+	    double delta = -order * f / h;
+	    delta = (fabs(delta) > fabs(sj))
+			? copysign(0.5 * fabs(sj), delta) : delta;
+	    double sn = sj + delta;
+
+	    bool conv_j = 2 * fabs(sn - sj) <= UNIVERSAL_TOLERANCE * fabs(sn + sj);
+	    s[j] = (done[j] > 0) ? sj : sn;
+	    done[j] = conv_j ? 1 : done[j];
+	    nactive += 1 - done[j];
+	}
+    }
+
+    // Lagrange coefficients.  The derivatives with respect to s are
+    // divided by ds/dt = r.
+
+#pragma omp simd
+    for (int j = 0; j < nb; j++)
+	zeta[j] = alpha[j] * s[j] * s[j];
+    stumpff_block(nb, zeta, c2, c3);
+
+#pragma omp simd
+    for (int j = 0; j < nb; j++) {
+	double sj = s[j];
+	double s2 = sj * sj;
+	double S0 = 1 + zeta[j] * c2[j];
+	double S1 = sj * (1 + zeta[j] * c3[j]);
+	double S2 = s2 * c2[j];
+	double m = mass[j];
+	double r = r0[j];
+
+	double lf = 1 - m * S2 / r;
+	double lg = r * S1 + r0v0[j] * S2;
+	double ldf = -m * S1 / r;
+	double ldg = r * S0 + r0v0[j] * S1;
+	double r1 = lf * ldg - lg * ldf;
+	ldf /= r1;
+	ldg /= r1;
+
+	bool keep = sj == 0;
+	lf = keep ? 1 : lf;
+	lg = keep ? 0 : lg;
+	ldf = keep ? 0 : ldf;
+	ldg = keep ? 1 : ldg;
+
+	double xj = x[j], yj = y[j], zj = z[j];
+	double vxj = vx[j], vyj = vy[j], vzj = vz[j];
+	x1[j] = xj * lf + vxj * lg;
+	y1[j] = yj * lf + vyj * lg;
+	z1[j] = zj * lf + vzj * lg;
+	vx1[j] = xj * ldf + vxj * ldg;
+	vy1[j] = yj * ldf + vyj * ldg;
+	vz1[j] = zj * ldf + vzj * ldg;
+    }
+
+    int nfail = 0;
+    for (int j = 0; j < nb; j++) {
+	conv[j] = done[j] > 0;
+	nfail += !conv[j];
+    }
+    return nfail;
+}
+
+// Retry a single orbit that failed in its block by taking two half
+// steps, recursively.  Returns 0 on success.
+
+static int propagate_split(double mass,
+			   double *pos, double *vel, double dt, int depth)
+{
+    if (depth > UNIVERSAL_MAXSPLIT) return -1;
+
+    for (int half = 0; half < 2; half++) {
+	double h = 0.5 * dt;
+	int conv;
+	double p[3] = {pos[0], pos[1], pos[2]};
+	double v[3] = {vel[0], vel[1], vel[2]};
+	if (propagate_block(1, &mass, p, p+1, p+2, v, v+1, v+2, &h,
+			    pos, pos+1, pos+2, vel, vel+1, vel+2, &conv) > 0) {
+	    for (int k = 0; k < 3; k++) {
+		pos[k] = p[k];
+		vel[k] = v[k];
+	    }
+	    if (propagate_split(mass, pos, vel, h, depth+1) != 0) return -1;
+	}
+    }
+    return 0;
+}
+
+int universal_propagate(int n, const double *mass,
+			const double *x, const double *y, const double *z,
+			const double *vx, const double *vy, const double *vz,
+			const double *dt,
+			double *x1, double *y1, double *z1,
+			double *vx1, double *vy1, double *vz1,
+			int *status)
+{
+    int nblocks = (n + UNIVERSAL_BLOCK - 1) / UNIVERSAL_BLOCK;
+    int nbad = 0;
+
+#pragma omp parallel for schedule(dynamic) reduction(+:nbad) if(nblocks > 1)
+    for (int ib = 0; ib < nblocks; ib++) {
+	int first = ib * UNIVERSAL_BLOCK;
+	int nb = (n - first < UNIVERSAL_BLOCK) ? n - first : UNIVERSAL_BLOCK;
+
+	// Copy the block, so that the output may alias the input and
+	// unphysical orbits can be passed over safely.
+
+	double m[UNIVERSAL_BLOCK], t[UNIVERSAL_BLOCK];
+	double px[UNIVERSAL_BLOCK], py[UNIVERSAL_BLOCK], pz[UNIVERSAL_BLOCK];
+	double qx[UNIVERSAL_BLOCK], qy[UNIVERSAL_BLOCK], qz[UNIVERSAL_BLOCK];
+	int valid[UNIVERSAL_BLOCK], conv[UNIVERSAL_BLOCK];
+	for (int j = 0; j < nb; j++) {
+	    int i = first + j;
+	    valid[j] = mass[i] > 0;
+	    m[j] = valid[j] ? mass[i] : 1;
+	    t[j] = valid[j] ? dt[i] : 0;
+	    px[j] = x[i];  py[j] = y[i];  pz[j] = z[i];
+	    qx[j] = vx[i]; qy[j] = vy[i]; qz[j] = vz[i];
+	}
+
+	int nfail = propagate_block(nb, m, px, py, pz, qx, qy, qz, t,
+				    x1+first, y1+first, z1+first,
+				    vx1+first, vy1+first, vz1+first, conv);
+
+	for (int j = 0; j < nb; j++) {
+	    int i = first + j;
+	    int st = valid[j] ? 0 : -2;
+	    if (nfail > 0 && !conv[j]) {
+		double pos[3] = {px[j], py[j], pz[j]};
+		double vel[3] = {qx[j], qy[j], qz[j]};
+		st = propagate_split(m[j], pos, vel, t[j], 1);
+		x1[i] = pos[0];  y1[i] = pos[1];  z1[i] = pos[2];
+		vx1[i] = vel[0]; vy1[i] = vel[1]; vz1[i] = vel[2];
+	    }
+	    if (status) status[i] = st;
+	    nbad += (st != 0);
+	}
+    }
+
+    return nbad;
+}
+
+int universal_propagate_elements(int n, const double *mass,
+				 const double *semi, const double *ecc,
+				 const double *mean_anomaly, const double *dt,
+				 double *x1, double *y1, double *z1,
+				 double *vx1, double *vy1, double *vz1,
+				 int *status)
+{
+    // Start every orbit at periastron, and advance it by the time
+    // since periastron passage plus dt.
+
+    double *m = new double[n];
+    double *t = new double[n];
+    double *zero = new double[n];
+    double *px = new double[n];
+    double *vy = new double[n];
+    bool *valid = new bool[n];
+
+#pragma omp parallel for simd if(n > UNIVERSAL_BLOCK)
+    for (int i = 0; i < n; i++) {
+	double a = fabs(semi[i]);
+	double e = ecc[i];
+	valid[i] = mass[i] > 0 && a > 0 && e >= 0 && e != 1;
+	double mi = valid[i] ? mass[i] : 1;
+	a = valid[i] ? a : 1;
+	e = valid[i] ? e : 0;
+	double q = a * fabs(1 - e);
+	double mean_motion = sqrt(mi / (a * a * a));
+
+	m[i] = mi;
+	t[i] = valid[i] ? mean_anomaly[i] / mean_motion + dt[i] : 0;
+	zero[i] = 0;
+	px[i] = q;
+	vy[i] = sqrt(mi * (1 + e) / q);
+    }
+
+    int nbad = universal_propagate(n, m, px, zero, zero, zero, vy, zero, t,
+				   x1, y1, z1, vx1, vy1, vz1, status);
+
+    for (int i = 0; i < n; i++)
+	if (!valid[i]) {
+	    x1[i] = y1[i] = z1[i] = 0;
+	    vx1[i] = vy1[i] = vz1[i] = 0;
+	    if (status) status[i] = -2;
+	    nbad++;
+	}
+
+    delete [] m;
+    delete [] t;
+    delete [] zero;
+    delete [] px;
+    delete [] vy;
+    delete [] valid;
+
+    return nbad;
+}
@@ -0,0 +1,51 @@
+// universal_kepler.h: propagation of many independent two-body orbits
+//		       in universal variables.
+//
+// Unlike the kepler class, which keeps the full description of a
+// single orbit, these functions only advance relative positions and
+// velocities (G = 1, rel_pos = r_2 - r_1, mass = total mass), so that
+// large numbers of orbits can be advanced in one call.  The arrays
+// are processed in blocks of UNIVERSAL_BLOCK orbits; the Kepler
+// equation is solved for all orbits of a block at once with a masked
+// Laguerre iteration, and the blocks are distributed over OpenMP
+// threads.
+
+#ifndef  UNIVERSAL_KEPLER_H
+#  define  UNIVERSAL_KEPLER_H
+
+#define UNIVERSAL_BLOCK		64	// orbits per block (SIMD batch)
+#define UNIVERSAL_MAXITER	64	// Laguerre iterations per block
+#define UNIVERSAL_MAXSPLIT	16	// step halvings for failed orbits
+#define UNIVERSAL_TOLERANCE	1.e-14
+
+// Advance n orbits from (x, y, z, vx, vy, vz) by dt.  The new state
+// goes to (x1, y1, z1, vx1, vy1, vz1), which may alias the input
+// arrays.  Orbits with mass <= 0 are left unchanged and flagged in
+// status (if not NULL) with -2; orbits whose Kepler equation did not
+// converge, even after splitting the step, are flagged with -1.
+// Returns the number of orbits with nonzero status.
+
+int universal_propagate(int n, const double *mass,
+			const double *x, const double *y, const double *z,
+			const double *vx, const double *vy, const double *vz,
+			const double *dt,
+			double *x1, double *y1, double *z1,
+			double *vx1, double *vy1, double *vz1,
+			int *status = NULL);
+
+// Same, starting from the elements (semi-major axis, eccentricity and
+// mean anomaly at t = 0) of orbits in the standard orientation: the
+// orbit in the x-y plane, periastron along the x axis and angular
+// momentum along z.  As in kepler::initialize_from_shape_and_phase,
+// the eccentricity decides whether the orbit is bound and only the
+// magnitude of semi is used.  Linear and parabolic orbits (ecc = 1)
+// and semi = 0 are flagged with -2.
+
+int universal_propagate_elements(int n, const double *mass,
+				 const double *semi, const double *ecc,
+				 const double *mean_anomaly, const double *dt,
+				 double *x1, double *y1, double *z1,
+				 double *vx1, double *vy1, double *vz1,
+				 int *status = NULL);
+
+#endif
@@ -2,6 +2,7 @@
 #include "src/mmas2/src/eos/eos.h"
 #include "worker_code.h"
 #include <map>
+#include <vector>
 #include <gsl/gsl_errno.h>
 
 using namespace std;
@@ -19,7 +20,7 @@ map<long long, mmas*> results;
 map<long long, usm*> usm_models;
 long long hashtable_up_to_date_for_particle_with_index = -1;
 
-bool error_occurred = false;
+thread_local bool error_occurred = false;
 gsl_error_handler_t * previous_error_handler;
 void amuse_error_handler (const char * reason, const char * file, int line, int gsl_errno) {
     gsl_stream_printf ("ERROR", file, line, reason);
@@ -103,20 +104,12 @@ int read_usm(int *index_of_the_particle, char *usm_file){
     return 0;
 }
 
-int add_shell(int index_of_the_particle, double d_mass, double cumul_mass, 
+bool add_shell_to_model(usm *model, double d_mass, double cumul_mass, 
         double radius, double density, double pressure, 
         double temperature, double luminosity, double molecular_weight, double H1, double He4, 
         double C12, double N14, double O16, double Ne20, double Mg24, 
         double Si28, double Fe56){
     mass_shell shell;
-    map<long long, usm*>::iterator it = usm_models.find(index_of_the_particle);
-    
-    if (it == usm_models.end())
-        return -3;
-    
-    if (hashtable_up_to_date_for_particle_with_index == index_of_the_particle)
-        hashtable_up_to_date_for_particle_with_index = -1;
-    
     shell.dm = d_mass;
     shell.mass = cumul_mass;
     shell.radius = radius;
@@ -136,10 +129,65 @@ int add_shell(int index_of_the_particle, double d_mass, double cumul_mass,
     shell.composition.Si28 = Si28;
     shell.composition.Fe56 = Fe56;
     
-    if (it->second->get_num_shells() && shell.mass <= it->second->get_last_shell().mass)
+    if (model->get_num_shells() && shell.mass <= model->get_last_shell().mass)
+        return false;
+    model->add_shell(shell);
+    return true;
+}
+
+int add_shell(int index_of_the_particle, double d_mass, double cumul_mass, 
+        double radius, double density, double pressure, 
+        double temperature, double luminosity, double molecular_weight, double H1, double He4, 
+        double C12, double N14, double O16, double Ne20, double Mg24, 
+        double Si28, double Fe56){
+    map<long long, usm*>::iterator it = usm_models.find(index_of_the_particle);
+    
+    if (it == usm_models.end())
+        return -3;
+    
+    if (hashtable_up_to_date_for_particle_with_index == index_of_the_particle)
+        hashtable_up_to_date_for_particle_with_index = -1;
+    
+    if (!add_shell_to_model(it->second, d_mass, cumul_mass, radius, density, pressure, 
+            temperature, luminosity, molecular_weight, H1, He4, C12, N14, O16, Ne20, 
+            Mg24, Si28, Fe56))
         cerr << "Warning: shell ignored, because cumulative mass does not increase" << endl;
-    else
-        it->second->add_shell(shell);
+    return 0;
+}
+
+// Add all shells of one or more models in one call. The shells of a
+// model must be consecutive and ordered from the center outwards. No
+// shells are added if any of the particles is unknown.
+int add_shells(int *index_of_the_particle, double *d_mass, double *cumul_mass, 
+        double *radius, double *density, double *pressure, 
+        double *temperature, double *luminosity, double *molecular_weight, double *H1, double *He4, 
+        double *C12, double *N14, double *O16, double *Ne20, double *Mg24, 
+        double *Si28, double *Fe56, int number_of_shells){
+    vector<usm*> models(number_of_shells);
+    for (int i = 0; i < number_of_shells; i++) {
+        if (i > 0 && index_of_the_particle[i] == index_of_the_particle[i-1]) {
+            models[i] = models[i-1];
+            continue;
+        }
+        map<long long, usm*>::iterator it = usm_models.find(index_of_the_particle[i]);
+        if (it == usm_models.end())
+            return -3;
+        models[i] = it->second;
+        if (hashtable_up_to_date_for_particle_with_index == index_of_the_particle[i])
+            hashtable_up_to_date_for_particle_with_index = -1;
+    }
+    
+    int number_of_ignored_shells = 0;
+    for (int i = 0; i < number_of_shells; i++) {
+        if (!add_shell_to_model(models[i], d_mass[i], cumul_mass[i], radius[i], 
+                density[i], pressure[i], temperature[i], luminosity[i], 
+                molecular_weight[i], H1[i], He4[i], C12[i], N14[i], O16[i], 
+                Ne20[i], Mg24[i], Si28[i], Fe56[i]))
+            number_of_ignored_shells++;
+    }
+    if (number_of_ignored_shells)
+        cerr << "Warning: " << number_of_ignored_shells << 
+            " shells ignored, because cumulative mass does not increase" << endl;
     return 0;
 }
 
@@ -199,9 +247,34 @@ int get_mass(int index_of_the_particle, double *mass){
     return 0;
 }
 
-int merge_two_stars(int *id_product, int id_primary, int id_secondary) {
+// Merge two (hashed) models. Only the parent models are touched, so
+// pairs without stars in common can be merged in concurrent threads.
+mmas * merge_models(usm *primary, usm *secondary) {
     float r_p   = 0.0;
     float v_inf = 0.0;
+    mmas *mmams = new mmas(*primary, *secondary, r_p, v_inf);
+    
+    mmams->merge_stars_consistently(target_n_shells, flag_do_shock_heating);
+    if (dump_mixed) {
+        mmams->mixing_product(target_n_shells_mixing);
+        mmams->get_mixed_product().star_mass = mmams->get_product().star_mass;
+    }
+    return mmams;
+}
+
+void store_merge_product(mmas *mmams, int *id_product) {
+    results.insert(results.end(), std::pair<long long, mmas*>(particle_id_counter, mmams));
+    if (!dump_mixed) {
+        usm_models.insert(usm_models.end(), std::pair<long long, usm*>(particle_id_counter, &(mmams->get_product())));
+    } else {
+        usm_models.insert(usm_models.end(), std::pair<long long, usm*>(particle_id_counter, &(mmams->get_mixed_product())));
+    }
+    *id_product = particle_id_counter;
+    number_of_particles++;
+    particle_id_counter++;
+}
+
+int merge_two_stars(int *id_product, int id_primary, int id_secondary) {
     map<long long, usm*>::iterator it_primary = usm_models.find(id_primary);
     map<long long, usm*>::iterator it_secondary = usm_models.find(id_secondary);
     
@@ -211,20 +284,54 @@ int merge_two_stars(int *id_product, int id_primary, int id_secondary) {
     it_primary->second->build_hashtable();
     it_secondary->second->build_hashtable();
     
-    mmas *mmams = new mmas(*it_primary->second, *it_secondary->second, r_p, v_inf);
-    results.insert(results.end(), std::pair<long long, mmas*>(particle_id_counter, mmams));
+    store_merge_product(merge_models(it_primary->second, it_secondary->second), id_product);
+    return 0;
+}
+
+// Merge a list of pairs in one call. The products are numbered in the
+// order of the pairs, as with successive merge_two_stars calls. No
+// pairs are merged if any of the particles is unknown.
+int merge_many(int *id_product, int *id_primary, int *id_secondary, int number_of_pairs) {
+    vector<usm*> primaries(number_of_pairs), secondaries(number_of_pairs);
+    map<usm*, int> number_of_uses;
+    for (int i = 0; i < number_of_pairs; i++) {
+        map<long long, usm*>::iterator it_primary = usm_models.find(id_primary[i]);
+        map<long long, usm*>::iterator it_secondary = usm_models.find(id_secondary[i]);
+        if (it_primary == usm_models.end() || it_secondary == usm_models.end())
+            return -3;
+        primaries[i] = it_primary->second;
+        secondaries[i] = it_secondary->second;
+        number_of_uses[primaries[i]]++;
+        number_of_uses[secondaries[i]]++;
+    }
+    for (map<usm*, int>::iterator it = number_of_uses.begin(); it != number_of_uses.end(); it++)
+        it->first->build_hashtable();
     
-    mmams->merge_stars_consistently(target_n_shells, flag_do_shock_heating);
-    if (!dump_mixed) {
-        usm_models.insert(usm_models.end(), std::pair<long long, usm*>(particle_id_counter, &(mmams->get_product())));
-    } else {
-        mmams->mixing_product(target_n_shells_mixing);
-        mmams->get_mixed_product().star_mass = mmams->get_product().star_mass;
-        usm_models.insert(usm_models.end(), std::pair<long long, usm*>(particle_id_counter, &(mmams->get_mixed_product())));
+    // Merging updates the parent models, so a star that takes part in
+    // several pairs must not be merged concurrently; those pairs are
+    // done one at a time after the others.
+    vector<int> independent, shared;
+    for (int i = 0; i < number_of_pairs; i++) {
+        if (number_of_uses[primaries[i]] == 1 && number_of_uses[secondaries[i]] == 1)
+            independent.push_back(i);
+        else
+            shared.push_back(i);
     }
-    *id_product = particle_id_counter;
-    number_of_particles++;
-    particle_id_counter++;
+    
+    vector<mmas*> products(number_of_pairs);
+    int number_of_independent_pairs = independent.size();
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int k = 0; k < number_of_independent_pairs; k++) {
+        int i = independent[k];
+        products[i] = merge_models(primaries[i], secondaries[i]);
+    }
+    for (size_t k = 0; k < shared.size(); k++) {
+        int i = shared[k];
+        products[i] = merge_models(primaries[i], secondaries[i]);
+    }
+    
+    for (int i = 0; i < number_of_pairs; i++)
+        store_merge_product(products[i], &id_product[i]);
     return 0;
 }
 
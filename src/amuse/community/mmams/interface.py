@@ -95,6 +95,42 @@ class MMAMSInterface(CodeInterface, CommonCodeInterface, LiteratureReferencesMix
             specified particle was not found"""
         return function
     
+    @legacy_function
+    def add_shells():
+        """
+        Add new shells to existing particles in the stellar collision code, 
+        in one call. The shells of a particle must be consecutive and ordered 
+        from the center outwards.
+        """
+        function = LegacyFunctionSpecification()
+        function.must_handle_array = True
+        function.addParameter('index_of_the_particle', dtype='int32', direction=function.IN)
+        function.addParameter('d_mass', dtype='float64', direction=function.IN, description = "The mass of the current shell of this particle")
+        function.addParameter('cumul_mass', dtype='float64', direction=function.IN, description = "The cumulative mass from the center to the current shell of this particle")
+        function.addParameter('radius', dtype='float64', direction=function.IN, description = "The radius of this shell")
+        function.addParameter('density', dtype='float64', direction=function.IN, description = "The density of this shell")
+        function.addParameter('pressure', dtype='float64', direction=function.IN, description = "The pressure of this shell")
+        function.addParameter('temperature', dtype='float64', direction=function.IN, description = "The temperature of this shell")
+        function.addParameter('luminosity', dtype='float64', direction=function.IN, description = "The luminosity of this shell")
+        function.addParameter('molecular_weight', dtype='float64', direction=function.IN, description = "The molecular_weight of this shell")
+        function.addParameter('H1', dtype='float64', direction=function.IN, description = "The H1 fraction of this shell")
+        function.addParameter('He4', dtype='float64', direction=function.IN, description = "The He4 fraction of this shell")
+        function.addParameter('C12', dtype='float64', direction=function.IN, description = "The C12 fraction of this shell")
+        function.addParameter('N14', dtype='float64', direction=function.IN, description = "The N14 fraction of this shell")
+        function.addParameter('O16', dtype='float64', direction=function.IN, description = "The O16 fraction of this shell")
+        function.addParameter('Ne20', dtype='float64', direction=function.IN, description = "The Ne20 fraction of this shell")
+        function.addParameter('Mg24', dtype='float64', direction=function.IN, description = "The Mg24 fraction of this shell")
+        function.addParameter('Si28', dtype='float64', direction=function.IN, description = "The Si28 fraction of this shell")
+        function.addParameter('Fe56', dtype='float64', direction=function.IN, description = "The Fe56 fraction of this shell")
+        function.addParameter('number_of_shells', dtype='int32', direction=function.LENGTH)
+        function.result_type = 'int32'
+        function.result_doc = """
+         0 - OK
+            new shells were added to the specified particles
+        -3 - ERROR
+            a specified particle was not found, no shells were added"""
+        return function
+    
     @legacy_function
     def get_number_of_particles():
         function = LegacyFunctionSpecification()
@@ -176,6 +212,27 @@ class MMAMSInterface(CodeInterface, CommonCodeInterface, LiteratureReferencesMix
         function.result_type = 'int32'
         return function
     
+    @legacy_function
+    def merge_many():
+        """
+        Merge a list of pairs of previously defined particles, in one call. 
+        Pairs without stars in common are merged in parallel (OpenMP) threads. 
+        Returns the indices to the new stellar models, in the order of the pairs.
+        """
+        function = LegacyFunctionSpecification()
+        function.must_handle_array = True
+        function.addParameter('index_of_the_product', dtype='int32', direction=function.OUT)
+        function.addParameter('index_of_the_primary', dtype='int32', direction=function.IN)
+        function.addParameter('index_of_the_secondary', dtype='int32', direction=function.IN)
+        function.addParameter('number_of_pairs', dtype='int32', direction=function.LENGTH)
+        function.result_type = 'int32'
+        function.result_doc = """
+         0 - OK
+            the pairs were merged
+        -3 - ERROR
+            a specified particle was not found, no pairs were merged"""
+        return function
+    
     @legacy_function
     def set_dump_mixed_flag():
         """Set the dump_mixed flag: specifies whether the returned products must be mixed first."""
@@ -324,6 +381,13 @@ class MMAMS(CommonCode):
                 handler.NO_UNIT, handler.NO_UNIT, handler.NO_UNIT, handler.NO_UNIT, handler.NO_UNIT),
             (handler.ERROR_CODE,)
         )
+        handler.add_method(
+            "add_shells",
+            (handler.INDEX, units.MSun, units.MSun, units.RSun, units.g / units.cm**3, units.barye, 
+                units.K, units.LSun, units.amu, handler.NO_UNIT, handler.NO_UNIT, handler.NO_UNIT, handler.NO_UNIT, 
+                handler.NO_UNIT, handler.NO_UNIT, handler.NO_UNIT, handler.NO_UNIT, handler.NO_UNIT),
+            (handler.ERROR_CODE,)
+        )
         handler.add_method(
             "get_stellar_model_element",
             (handler.INDEX, handler.INDEX,),
@@ -347,6 +411,11 @@ class MMAMS(CommonCode):
             (handler.INDEX, handler.INDEX,),
             (handler.INDEX, handler.ERROR_CODE,)
         )
+        handler.add_method(
+            "merge_many",
+            (handler.INDEX, handler.INDEX,),
+            (handler.INDEX, handler.ERROR_CODE,)
+        )
         
         handler.add_method("get_target_n_shells_mixing", (), (handler.NO_UNIT, handler.ERROR_CODE,)) 
         handler.add_method("set_target_n_shells_mixing", (handler.NO_UNIT, ), (handler.ERROR_CODE,)) 
@@ -379,6 +448,7 @@ class MMAMS(CommonCode):
             handler.add_getter(particle_set_name, 'get_number_of_zones')
             handler.add_getter(particle_set_name, 'get_mass')
             handler.add_method(particle_set_name, 'add_shell') 
+            handler.add_method(particle_set_name, 'add_shells') 
             handler.add_method(particle_set_name, 'get_stellar_model', 'get_internal_structure') 
     
     
@@ -412,7 +482,7 @@ class MMAMS(CommonCode):
     def merge_stars(self, primary, secondary):
         indices_of_primaries = [self._key_to_index_in_code(particle.key) for particle in primary]
         indices_of_secondaries = [self._key_to_index_in_code(particle.key) for particle in secondary]
-        result = self.merge_two_stars(
+        result = self.merge_many(
             indices_of_primaries, 
             indices_of_secondaries
         )
@@ -487,7 +557,7 @@ class MMAMS(CommonCode):
         pressure_profile    = particle.get_pressure_profile(number_of_zones = number_of_zones)
         mu_profile          = particle.get_mu_profile(number_of_zones = number_of_zones)
         composition_profile = particle.get_chemical_abundance_profiles(number_of_zones = number_of_zones)
-        new.add_shell(mass_profile, cumul_mass_profile, radius_profile, density_profile, 
+        new.add_shells(mass_profile, cumul_mass_profile, radius_profile, density_profile, 
             pressure_profile, temperature_profile, lum, mu_profile, composition_profile[0], 
             composition_profile[1]+composition_profile[2], composition_profile[3], 
             composition_profile[4], composition_profile[5], composition_profile[6], 
@@ -4,20 +4,25 @@
 #include <gsl/gsl_interp.h>
 #include <gsl/gsl_integration.h>
 
-gsl_interp       *interp_radius;
-gsl_interp_accel *acc_radius;
-gsl_interp       *interp_temp, *interp_m_mu, *interp_dens;
-gsl_interp_accel *acc_temp,    *acc_m_mu,    *acc_dens;
+/* interpolation tables of the model, passed to the integrand (rather
+   than kept in globals) so that merges may run in concurrent threads */
 
-int n_shells;
-double *arr_mass, *arr_radius;
-double *arr_temp, *arr_dens, *arr_m_mu;
+struct energy_params {
+  gsl_interp       *interp_radius;
+  gsl_interp_accel *acc_radius;
+  gsl_interp       *interp_temp, *interp_m_mu, *interp_dens;
+  gsl_interp_accel *acc_temp,    *acc_m_mu,    *acc_dens;
+
+  double *arr_mass, *arr_radius;
+  double *arr_temp, *arr_dens, *arr_m_mu;
+};
 
 double integrand(double mass, void *params) {
-  double radius = gsl_interp_eval(interp_radius, arr_mass, arr_radius, mass, acc_radius);
-  double temp   = gsl_interp_eval(interp_temp, arr_mass, arr_temp, mass, acc_temp);
-  double dens   = gsl_interp_eval(interp_dens, arr_mass, arr_dens, mass, acc_dens);
-  double m_mu   = gsl_interp_eval(interp_m_mu, arr_mass, arr_m_mu, mass, acc_m_mu);
+  energy_params *p = (energy_params*)params;
+  double radius = gsl_interp_eval(p->interp_radius, p->arr_mass, p->arr_radius, mass, p->acc_radius);
+  double temp   = gsl_interp_eval(p->interp_temp, p->arr_mass, p->arr_temp, mass, p->acc_temp);
+  double dens   = gsl_interp_eval(p->interp_dens, p->arr_mass, p->arr_dens, mass, p->acc_dens);
+  double m_mu   = gsl_interp_eval(p->interp_m_mu, p->arr_mass, p->arr_m_mu, mass, p->acc_m_mu);
 
   real f = -mass/radius;
   real de_therm = 1.5*uK*temp/m_mu/uM_U + 
@@ -29,56 +34,57 @@ double integrand(double mass, void *params) {
 
 real mmas::compute_stellar_energy(usm &model) {
   int gsl_status;
+  energy_params p;
   
-  n_shells = model.get_num_shells();
+  int n_shells = model.get_num_shells();
 
-  arr_mass   = new double[n_shells+1];
-  arr_radius = new double[n_shells+1];
-  arr_temp   = new double[n_shells+1];
-  arr_dens   = new double[n_shells+1];
-  arr_m_mu   = new double[n_shells+1];
+  p.arr_mass   = new double[n_shells+1];
+  p.arr_radius = new double[n_shells+1];
+  p.arr_temp   = new double[n_shells+1];
+  p.arr_dens   = new double[n_shells+1];
+  p.arr_m_mu   = new double[n_shells+1];
   for (int i = 0; i < n_shells; i++) {
     mass_shell &shell = model.get_shell(i);
-    if (i > 0 && shell.mass <= arr_mass[i-1]){
+    if (i > 0 && shell.mass <= p.arr_mass[i-1]){
         n_shells = i;
         break;
     }
-    arr_mass[i+1]   = shell.mass;
-    arr_radius[i+1] = shell.radius;
-    arr_temp[i+1]   = shell.temperature;
-    arr_dens[i+1]   = shell.density;
-    arr_m_mu[i+1]   = shell.mean_mu;
+    p.arr_mass[i+1]   = shell.mass;
+    p.arr_radius[i+1] = shell.radius;
+    p.arr_temp[i+1]   = shell.temperature;
+    p.arr_dens[i+1]   = shell.density;
+    p.arr_m_mu[i+1]   = shell.mean_mu;
 //     fprintf(stderr, "m= %lg: r= %lg, t= %lg, rho= %lg, mu= %lg\n",
 // 	    shell.mass, shell.radius, shell.temperature, shell.density, shell.mean_mu);
   }
-  arr_mass[0] = 0.0;
-  arr_radius[0] = 0.0;
-  arr_temp[0] = arr_temp[1];
-  arr_dens[0] = arr_dens[1];
-  arr_m_mu[0] = arr_m_mu[1];
+  p.arr_mass[0] = 0.0;
+  p.arr_radius[0] = 0.0;
+  p.arr_temp[0] = p.arr_temp[1];
+  p.arr_dens[0] = p.arr_dens[1];
+  p.arr_m_mu[0] = p.arr_m_mu[1];
 
 //   fprintf(stderr,"radius\n");
-  acc_radius    = gsl_interp_accel_alloc();
-  interp_radius = gsl_interp_alloc(gsl_interp_linear, n_shells+1);
-  gsl_status = gsl_interp_init(interp_radius, arr_mass, arr_radius, n_shells+1);
+  p.acc_radius    = gsl_interp_accel_alloc();
+  p.interp_radius = gsl_interp_alloc(gsl_interp_linear, n_shells+1);
+  gsl_status = gsl_interp_init(p.interp_radius, p.arr_mass, p.arr_radius, n_shells+1);
   if (gsl_status != GSL_SUCCESS) return -1e99;
   
 //   fprintf(stderr,"temp\n");
-  acc_temp    = gsl_interp_accel_alloc();
-  interp_temp = gsl_interp_alloc(gsl_interp_linear, n_shells+1);
-  gsl_status = gsl_interp_init(interp_temp, arr_mass, arr_temp, n_shells+1);
+  p.acc_temp    = gsl_interp_accel_alloc();
+  p.interp_temp = gsl_interp_alloc(gsl_interp_linear, n_shells+1);
+  gsl_status = gsl_interp_init(p.interp_temp, p.arr_mass, p.arr_temp, n_shells+1);
   if (gsl_status != GSL_SUCCESS) return -1e99;
 
 //   fprintf(stderr,"dens\n");
-  acc_dens    = gsl_interp_accel_alloc();
-  interp_dens = gsl_interp_alloc(gsl_interp_linear, n_shells+1);
-  gsl_status = gsl_interp_init(interp_dens, arr_mass, arr_dens, n_shells+1);
+  p.acc_dens    = gsl_interp_accel_alloc();
+  p.interp_dens = gsl_interp_alloc(gsl_interp_linear, n_shells+1);
+  gsl_status = gsl_interp_init(p.interp_dens, p.arr_mass, p.arr_dens, n_shells+1);
   if (gsl_status != GSL_SUCCESS) return -1e99;
  
 //   fprintf(stderr,"mu\n");
-  acc_m_mu    = gsl_interp_accel_alloc();
-  interp_m_mu = gsl_interp_alloc(gsl_interp_linear, n_shells+1);
-  gsl_status = gsl_interp_init(interp_m_mu, arr_mass, arr_m_mu, n_shells+1);
+  p.acc_m_mu    = gsl_interp_accel_alloc();
+  p.interp_m_mu = gsl_interp_alloc(gsl_interp_linear, n_shells+1);
+  gsl_status = gsl_interp_init(p.interp_m_mu, p.arr_mass, p.arr_m_mu, n_shells+1);
   if (gsl_status != GSL_SUCCESS) return -1e99;
 
 
@@ -89,6 +95,7 @@ real mmas::compute_stellar_energy(usm &model) {
   
   gsl_function F;
   F.function = &integrand;
+  F.params   = &p;
   
   double eps_rel = 1.0e-2;
   double eps_abs = 0.0;
@@ -103,19 +110,19 @@ real mmas::compute_stellar_energy(usm &model) {
   
   gsl_integration_workspace_free(w);
 		       
-  gsl_interp_accel_free(acc_radius);
-  gsl_interp_free(interp_radius);
-  gsl_interp_accel_free(acc_temp);
-  gsl_interp_free(interp_temp);
-  gsl_interp_accel_free(acc_dens);
-  gsl_interp_free(interp_dens);
-  gsl_interp_accel_free(acc_m_mu);
-  gsl_interp_free(interp_m_mu);
-  delete arr_mass;
-  delete arr_radius;
-  delete arr_temp;
-  delete arr_dens;
-  delete arr_m_mu;
+  gsl_interp_accel_free(p.acc_radius);
+  gsl_interp_free(p.interp_radius);
+  gsl_interp_accel_free(p.acc_temp);
+  gsl_interp_free(p.interp_temp);
+  gsl_interp_accel_free(p.acc_dens);
+  gsl_interp_free(p.interp_dens);
+  gsl_interp_accel_free(p.acc_m_mu);
+  gsl_interp_free(p.interp_m_mu);
+  delete[] p.arr_mass;
+  delete[] p.arr_radius;
+  delete[] p.arr_temp;
+  delete[] p.arr_dens;
+  delete[] p.arr_m_mu;
   
   
   return result;
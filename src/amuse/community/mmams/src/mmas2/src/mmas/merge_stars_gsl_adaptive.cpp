@@ -48,7 +48,9 @@ enum {NEXCEED=10, FAILED, NEGATIVE_PRESSURE};
  #
 */
 
-double p_unit, rho_unit;
+/* constant, so that merges may run in concurrent threads */
+static const double p_unit   = uG * pow(uMSUN,2.0)/pow(uRSUN,4.0);
+static const double rho_unit = uMSUN/pow(uRSUN, 3.0);
 
 struct hse_func_params {
   gslInterp *entr_A, *entr_B;
@@ -273,9 +275,6 @@ double merge_stars_eq(double p_centre, void *params) {
 }
 
 int mmas::merge_stars(double f_lost, int n_desired_shells) {
-  p_unit = uG * pow(uMSUN,2.0)/pow(uRSUN,4.0);
-  rho_unit = uMSUN/pow(uRSUN, 3.0);
-
   vector<double> Mass, entr, m_mu, id_sA;
   sort_model(*model_a, Mass, entr, m_mu, id_sA);
   for (size_t i = 0; i < entr.size(); i++) {
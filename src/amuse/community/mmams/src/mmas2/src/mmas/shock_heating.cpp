@@ -12,7 +12,7 @@
 //   }
 // }
 
-extern bool error_occurred;
+extern thread_local bool error_occurred;
 
 int mmas::shock_heating_4(usm& model, real a, real b, real c, real d) {
   real density_max = 0, pressure_max = 0, entropy_min = 1e300;
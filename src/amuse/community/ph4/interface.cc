@@ -155,6 +155,18 @@ int get_gpu(int * gpu)
     return 0;
 }
 
+int set_cpu_kernel(int cpu_kernel)
+{
+    jd->use_cpu_kernel = (cpu_kernel == 1);
+    return 0;
+}
+
+int get_cpu_kernel(int * cpu_kernel)
+{
+    *cpu_kernel = jd->use_cpu_kernel;
+    return 0;
+}
+
 int set_gpu_id(int gpu_id)
 {
     jd->gpu_id = gpu_id;
@@ -255,6 +267,26 @@ int get_total_steps(int *s) {
     return 0;
 }
 
+int set_force_time(double t) {
+    jd->force_time = t;
+    return 0;
+}
+
+int get_force_time(double *t) {
+    *t = jd->force_time;
+    return 0;
+}
+
+int set_communication_time(double t) {
+    jd->comm_time = t;
+    return 0;
+}
+
+int get_communication_time(double *t) {
+    *t = jd->comm_time;
+    return 0;
+}
+
 int set_initial_timestep_fac(double s) {
     initial_timestep_fac = s;
     return 0;
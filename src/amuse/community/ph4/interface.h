@@ -0,0 +1,160 @@
+#include "stdbool.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int get_mass(int index_of_the_particle, double * mass);
+
+int commit_particles();
+
+int get_time(double * time);
+
+int get_force_sync(int * force_sync);
+
+int set_time(double time);
+
+int set_manage_encounters(int manage_encounters);
+
+int set_mass(int index_of_the_particle, double mass);
+
+int get_index_of_first_particle(int * index_of_the_particle);
+
+int get_initial_timestep_fac(double * initial_timestep_fac);
+
+int get_id_of_updated_particle(int index_of_update, int * index_of_particle, int * kind_of_update);
+
+int get_total_radius(double * radius);
+
+int get_potential_at_point(double * eps, double * x, double * y, double * z, double * phi, int npoints);
+
+int get_initial_timestep_limit(double * initial_timestep_limit);
+
+int get_cpu_kernel(int * cpu_kernel);
+
+int new_particle(int * index_of_the_particle, double mass, double x, double y, double z, double vx, double vy, double vz, double radius, int id);
+
+int get_sync_time(double * sync_time);
+
+int get_gpu_id(int * gpu_id);
+
+int get_total_mass(double * mass);
+
+int evolve_model(double time);
+
+int set_initial_timestep_fac(double initial_timestep_fac);
+
+int set_eps2(double epsilon_squared);
+
+int get_number_of_particles_updated(int * index);
+
+int recompute_timesteps();
+
+int get_begin_time(double * time);
+
+int get_eps2(double * epsilon_squared);
+
+int get_index_of_next_particle(int index_of_the_particle, int * index_of_the_next_particle);
+
+int delete_particle(int index_of_the_particle);
+
+int get_eta(double * eta);
+
+int get_potential(int index_of_the_particle, double * potential);
+
+int synchronize_model();
+
+int get_communication_time(double * communication_time);
+
+int set_state(int index_of_the_particle, double mass, double x, double y, double z, double vx, double vy, double vz, double radius);
+
+int get_state(int index_of_the_particle, double * mass, double * x, double * y, double * z, double * vx, double * vy, double * vz, double * radius);
+
+int set_gpu(int gpu);
+
+int set_gpu_id(int gpu_id);
+
+int get_time_step(double * time_step);
+
+int recommit_particles();
+
+int set_force_time(double force_time);
+
+int get_kinetic_energy(double * kinetic_energy);
+
+int set_communication_time(double communication_time);
+
+int get_number_of_particles(int * number_of_particles);
+
+int get_force_time(double * force_time);
+
+int set_zero_step_mode(int zero_step_mode);
+
+int set_eta(double eta);
+
+int set_acceleration(int index_of_the_particle, double ax, double ay, double az);
+
+int get_center_of_mass_position(double * x, double * y, double * z);
+
+int get_particle_timestep(int index_of_the_particle, double * timestep);
+
+int set_initial_timestep_median(double initial_timestep_median);
+
+int get_center_of_mass_velocity(double * vx, double * vy, double * vz);
+
+int get_radius(int index_of_the_particle, double * radius);
+
+int get_total_steps(int * get_total_steps);
+
+int get_block_steps(int * get_block_steps);
+
+int get_gpu(int * gpu);
+
+int set_begin_time(double time);
+
+int get_binary_energy(double * binary_energy);
+
+int get_manage_encounters(int * manage_encounters);
+
+int get_zero_step_mode(int * zero_step_mode);
+
+int set_radius(int index_of_the_particle, double radius);
+
+int set_total_steps(int set_total_steps);
+
+int cleanup_code();
+
+int set_block_steps(int set_block_steps);
+
+int set_sync_time(double sync_time);
+
+int recommit_parameters();
+
+int initialize_code();
+
+int get_potential_energy(double * potential_energy);
+
+int get_gravity_at_point(double * eps, double * x, double * y, double * z, double * ax, double * ay, double * az, int npoints);
+
+int get_velocity(int index_of_the_particle, double * vx, double * vy, double * vz);
+
+int set_cpu_kernel(int cpu_kernel);
+
+int get_initial_timestep_median(double * initial_timestep_median);
+
+int set_initial_timestep_limit(double initial_timestep_limit);
+
+int get_position(int index_of_the_particle, double * x, double * y, double * z);
+
+int set_position(int index_of_the_particle, double x, double y, double z);
+
+int get_acceleration(int index_of_the_particle, double * ax, double * ay, double * az);
+
+int commit_parameters();
+
+int set_force_sync(int force_sync);
+
+int set_velocity(int index_of_the_particle, double vx, double vy, double vz);
+#ifdef __cplusplus
+}
+#endif
+
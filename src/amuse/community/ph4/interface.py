@@ -24,6 +24,16 @@ class ph4Interface(CodeInterface,
 
     include_headers = ['interface.h', 'stopcond.h']
 
+    # the particle getters only read the particle data, the worker
+    # handles array calls to these functions in parallel
+    get_state = parallel_legacy_function(GravitationalDynamicsInterface.get_state)
+    get_mass = parallel_legacy_function(GravitationalDynamicsInterface.get_mass)
+    get_radius = parallel_legacy_function(GravitationalDynamicsInterface.get_radius)
+    get_position = parallel_legacy_function(GravitationalDynamicsInterface.get_position)
+    get_velocity = parallel_legacy_function(GravitationalDynamicsInterface.get_velocity)
+    get_acceleration = parallel_legacy_function(GravitationalDynamicsInterface.get_acceleration)
+    get_potential = parallel_legacy_function(GravitationalDynamicsInterface.get_potential)
+
     MODE_GPU = 'gpu'
     MODE_CPU = 'cpu'
     
@@ -189,6 +199,28 @@ class ph4Interface(CodeInterface,
         function.result_type = 'int32'
         return function
 
+    @legacy_function
+    def set_cpu_kernel():
+        """
+        Set use_cpu_kernel.
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('cpu_kernel', dtype='int32',
+                              direction=function.IN)
+        function.result_type = 'int32'
+        return function
+
+    @legacy_function
+    def get_cpu_kernel():
+        """
+        Get use_cpu_kernel.
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('cpu_kernel', dtype='int32',
+                              direction=function.OUT)
+        function.result_type = 'int32'
+        return function
+
     @legacy_function
     def set_gpu_id():
         """
@@ -343,6 +375,50 @@ class ph4Interface(CodeInterface,
         function.result_type = 'int32'
         return function
 
+    @legacy_function
+    def set_force_time():
+        """
+        Set the value of force_time, the wall-clock time spent computing forces.
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('force_time', dtype='float64',
+                              direction=function.IN)
+        function.result_type = 'int32'
+        return function
+
+    @legacy_function
+    def get_force_time():
+        """
+        Get the value of force_time, the wall-clock time spent computing forces.
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('force_time', dtype='float64',
+                              direction=function.OUT)
+        function.result_type = 'int32'
+        return function
+
+    @legacy_function
+    def set_communication_time():
+        """
+        Set the value of communication_time, the wall-clock time spent in the force reductions.
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('communication_time', dtype='float64',
+                              direction=function.IN)
+        function.result_type = 'int32'
+        return function
+
+    @legacy_function
+    def get_communication_time():
+        """
+        Get the value of communication_time, the wall-clock time spent in the force reductions.
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('communication_time', dtype='float64',
+                              direction=function.OUT)
+        function.result_type = 'int32'
+        return function
+
     @legacy_function
     def get_number_of_particles_updated():
         """
@@ -534,6 +610,14 @@ class ph4(GravitationalDynamics,GravityFieldCode):
             default_value = 1
         )
         
+        handler.add_method_parameter(
+            "get_cpu_kernel",            # getter name in interface.cc
+            "set_cpu_kernel",            # setter name in interface.cc
+            "use_cpu_kernel",            # python parameter name
+            "use the vectorized OpenMP force kernel if no GPU is used",
+            default_value = 0
+        )
+        
         handler.add_method_parameter(
             "get_gpu_id",                # getter name in interface.cc
             "set_gpu_id",                # setter name in interface.cc
@@ -598,6 +682,22 @@ class ph4(GravitationalDynamics,GravityFieldCode):
             default_value = 0
         )
 
+        handler.add_method_parameter(
+            "get_force_time",
+            "set_force_time",
+            "force_time",
+            "wall-clock seconds spent computing forces (on process 0)",
+            default_value = 0.0
+        )
+
+        handler.add_method_parameter(
+            "get_communication_time",
+            "set_communication_time",
+            "communication_time",
+            "wall-clock seconds spent in the force reductions (on process 0)",
+            default_value = 0.0
+        )
+
         handler.add_method_parameter(
             "get_initial_timestep_fac",  # getter name in interface.cc
             "set_initial_timestep_fac",  # setter name in interface.cc
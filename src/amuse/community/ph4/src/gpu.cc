@@ -8,6 +8,7 @@
 //	void jdata::initialize_gpu()
 //	void idata::update_gpu()
 //	void idata::get_partial_acc_and_jerk_on_gpu()
+//	void idata::get_partial_acc_and_jerk_on_cpu(int ifirst, int ilast)
 //	void jdata::get_densities_on_gpu(idata& id)  (UNDER DEVELOPMENT)  MPI
 
 #include "jdata.h"
@@ -491,6 +492,150 @@ void idata::get_partial_acc_and_jerk_on_gpu(bool pot)	// default = false
 #endif
 }
 
+void idata::get_partial_acc_and_jerk_on_cpu(int ifirst, int ilast)
+					// defaults = 0, -1 (all)
+{
+    // Compute the partial forces on all i-particles due to this
+    // j-domain on the host, as an alternative "GPU" when no real GPU
+    // is available.  The results are those of
+    // idata::get_partial_acc_and_jerk(), but the predicted j-data are
+    // first copied into contiguous per-component arrays so that the
+    // inner loop vectorizes, and the i-particles are distributed over
+    // the OpenMP threads.  The j-data must already be predicted.
+    // Only i = ifirst to ilast-1 are computed (ilast < 0 means ni).
+
+    const char *in_function = "idata::get_partial_acc_and_jerk_on_cpu";
+    if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
+
+    real *lpot, *ldnn;
+    real2 lacc, ljerk;
+
+    if (jdat->mpi_size == 1) {
+        lnn = inn;
+        ldnn = idnn;
+        lpot = ipot;
+        lacc = iacc;
+        ljerk = ijerk;
+    } else {
+        lnn = pnn;
+        ldnn = pdnn;
+        lpot = ppot;
+        lacc = pacc;
+        ljerk = pjerk;
+    }
+
+    // Define the j-domains.  These only need be recomputed if nj
+    // changes.  The j buffers only grow.
+
+    static int my_nj = 0;
+    static int j_start, j_end;
+    static int nbuf = 0;
+    static real *jx, *jy, *jz, *jvx, *jvy, *jvz, *jm;
+
+    if (my_nj != jdat->nj) {
+	jdat->define_domain(j_start, j_end);
+	my_nj = jdat->nj;
+    }
+
+    int localnj = j_end - j_start;
+    if (localnj < 0) localnj = 0;
+
+    if (localnj > nbuf) {
+	if (nbuf > 0) {
+	    delete [] jx; delete [] jy; delete [] jz;
+	    delete [] jvx; delete [] jvy; delete [] jvz;
+	    delete [] jm;
+	}
+	nbuf = localnj + JBUF_INC;
+	jx = new real[nbuf]; jy = new real[nbuf]; jz = new real[nbuf];
+	jvx = new real[nbuf]; jvy = new real[nbuf]; jvz = new real[nbuf];
+	jm = new real[nbuf];
+    }
+
+    for (int j = 0; j < localnj; j++) {
+	jx[j] = jdat->pred_pos[j_start+j][0];
+	jy[j] = jdat->pred_pos[j_start+j][1];
+	jz[j] = jdat->pred_pos[j_start+j][2];
+	jvx[j] = jdat->pred_vel[j_start+j][0];
+	jvy[j] = jdat->pred_vel[j_start+j][1];
+	jvz[j] = jdat->pred_vel[j_start+j][2];
+	jm[j] = jdat->mass[j_start+j];
+    }
+
+    // Calculate the gravitational forces on the i-particles.  Each
+    // thread keeps the squared distances of the current i-particle
+    // to recover the nearest-neighbor index after the vector loop.
+
+    const real eps2 = jdat->eps2;
+    const real tiny = _TINY_;
+
+    if (ilast < 0) ilast = ni;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+	real *r2nn = new real[localnj > 0 ? localnj : 1];
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+	for (int i = ifirst; i < ilast; i++) {
+	    const real xi = ipos[i][0], yi = ipos[i][1], zi = ipos[i][2];
+	    const real vxi = ivel[i][0], vyi = ivel[i][1], vzi = ivel[i][2];
+	    real pot = 0, r2min = _INFINITY_;
+	    real ax = 0, ay = 0, az = 0, jrx = 0, jry = 0, jrz = 0;
+
+#ifdef _OPENMP
+#pragma omp simd reduction(+:pot,ax,ay,az,jrx,jry,jrz) reduction(min:r2min)
+#endif
+	    for (int j = 0; j < localnj; j++) {
+		real dx = jx[j] - xi, dy = jy[j] - yi, dz = jz[j] - zi;
+		real dvx = jvx[j] - vxi, dvy = jvy[j] - vyi,
+		     dvz = jvz[j] - vzi;
+		real r2 = dx*dx + dy*dy + dz*dz;
+		real xv = dx*dvx + dy*dvy + dz*dvz;
+		real r2i = 1/(r2+eps2+tiny);
+		real ri = sqrt(r2i);
+		real mri = jm[j]*ri;
+		real mr3i = mri*r2i;
+		real a3 = -3*xv*r2i;
+		real r2j = r2 > tiny ? r2 : _INFINITY_;
+		pot -= r2 > tiny ? mri : 0;
+		r2nn[j] = r2j;
+		r2min = r2j < r2min ? r2j : r2min;
+		ax += mr3i*dx;
+		ay += mr3i*dy;
+		az += mr3i*dz;
+		jrx += mr3i*(dvx+a3*dx);
+		jry += mr3i*(dvy+a3*dy);
+		jrz += mr3i*(dvz+a3*dz);
+	    }
+
+	    // Like the scalar loop, keep the first j at the minimum
+	    // distance as the nearest neighbor.
+
+	    if (r2min < _INFINITY_)
+		for (int j = 0; j < localnj; j++)
+		    if (r2nn[j] == r2min) {
+			lnn[i] = j_start + j;
+			break;
+		    }
+
+	    lpot[i] = pot;
+	    ldnn[i] = sqrt(r2min);
+	    lacc[i][0] = ax;
+	    lacc[i][1] = ay;
+	    lacc[i][2] = az;
+	    ljerk[i][0] = jrx;
+	    ljerk[i][1] = jry;
+	    ljerk[i][2] = jrz;
+	}
+
+	delete [] r2nn;
+    }
+}
+
 
 
 #include <vector>
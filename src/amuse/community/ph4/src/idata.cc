@@ -5,7 +5,7 @@
 //
 // Global functions:
 //
-//	void idata::get_partial_acc_and_jerk()
+//	void idata::get_partial_acc_and_jerk(int ifirst, int ilast)
 //	void idata::get_acc_and_jerk()				* MPI *
 //	void idata::predict(real t)
 //	void idata::correct(real tnext, real eta)
@@ -20,9 +20,9 @@
 //	void idata::set_list(int jlist[], int njlist)
 //	void idata::advance(real tnext, real eta)
 //
-// OpenMP acceleration in get_partial_acc_and_jerk is for the purpose
-// of illustration/experimentation.  Preferable to use GPU acceleration
-// for prediction and j-force calculation.
+// Without a GPU, jdata::use_cpu_kernel selects the vectorized OpenMP
+// kernel get_partial_acc_and_jerk_on_cpu() in gpu.cc instead of the
+// scalar loop in get_partial_acc_and_jerk().
 
 #include "jdata.h"
 #include "idata.h"
@@ -144,7 +144,8 @@ void idata::cleanup()
 // ONLY if the force calculation is done on the front end.  If a GPU
 // is used, they are never used.
 
-void idata::get_partial_acc_and_jerk()
+void idata::get_partial_acc_and_jerk(int ifirst, int ilast)
+					// defaults = 0, -1 (all)
 {
     const char *in_function = "idata::get_partial_acc_and_jerk";
     if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
@@ -159,7 +160,7 @@ void idata::get_partial_acc_and_jerk()
     // sapporo/GRAPE library calls to accomplish the same task.
     //
     // Note that all "p" lists are contiguous.  Sets pnn, pdnn, ppot,
-    // pacc, and pjerk.
+    // pacc, and pjerk for i = ifirst to ilast-1 (ilast < 0 means ni).
 
     // Avoid unnecessary reductions in the 1-process case.  These
     // pointers only need be recomputed after setup() is called, which
@@ -199,7 +200,8 @@ void idata::get_partial_acc_and_jerk()
     real r2i, ri, mri, mr3i, a3;
     real eps2 = jdat->eps2;
 
-    for (int i = 0; i < ni; i++) {
+    if (ilast < 0) ilast = ni;
+    for (int i = ifirst; i < ilast; i++) {
 	lpot[i] = 0;
 	ldnn[i] = _INFINITY_;
 	for (int k = 0; k < 3; k++) lacc[i][k] = ljerk[i][k] = 0;
@@ -233,6 +235,57 @@ void idata::get_partial_acc_and_jerk()
     }
 }
 
+// The partial pot, acc, jerk, dnn and nn of every i-particle are
+// packed into one record and combined in a single reduction.  The
+// first NSUM elements are summed; the (dnn, nn) pair takes the
+// minimum distance, with ties going to the lower index so that the
+// operation commutes.
+
+#define NSUM	7
+#define NPACK	9
+#define REDUCE_CHUNK	256	// minimum i-chunk for overlapped reductions
+
+static inline real wall_time()
+{
+#ifndef NOMPI
+    return MPI_Wtime();
+#else
+    return get_elapsed_time();
+#endif
+}
+
+#ifndef NOMPI
+
+static void sum_and_min_nn(void *invec, void *inoutvec, int *len,
+			   MPI_Datatype *datatype)
+{
+    real *in = (real *)invec, *inout = (real *)inoutvec;
+    for (int i = 0; i < *len; i++, in += NPACK, inout += NPACK) {
+	for (int k = 0; k < NSUM; k++) inout[k] += in[k];
+	if (in[NSUM] < inout[NSUM]
+	    || (in[NSUM] == inout[NSUM] && in[NSUM+1] < inout[NSUM+1])) {
+	    inout[NSUM] = in[NSUM];
+	    inout[NSUM+1] = in[NSUM+1];
+	}
+    }
+}
+
+static MPI_Datatype packed_type;
+static MPI_Op packed_op;
+static bool packed_op_defined = false;
+
+static void define_packed_op()
+{
+    if (!packed_op_defined) {
+	MPI_Type_contiguous(NPACK, MPI_DOUBLE, &packed_type);
+	MPI_Type_commit(&packed_type);
+	MPI_Op_create(sum_and_min_nn, 1, &packed_op);
+	packed_op_defined = true;
+    }
+}
+
+#endif
+
 void idata::get_acc_and_jerk()
 {
     const char *in_function = "idata::get_acc_and_jerk";
@@ -241,87 +294,121 @@ void idata::get_acc_and_jerk()
     // Compute the accs and jerks on the i-particles with respect to
     // the predicted quantities in the j system.  Every node has a
     // complete copy of the j-data, but computes only its part of the
-    // total.  Combine in process 0 to get the final result.  Sets
-    // inn, idnn, ipot, iacc, and ijerk.
+    // total.  Combine the partial results on all nodes.  Sets inn,
+    // idnn, ipot, iacc, and ijerk.
+    //
+    // Without a GPU, a large i-list is computed in chunks and the
+    // reduction of each chunk is started before the next chunk is
+    // computed, so that communication overlaps the force
+    // calculation.  The next block's j-prediction can't be
+    // overlapped, as it depends on the corrected data from this
+    // block.
+
+    int chunk = ni;
+    if (jdat->mpi_size > 1 && !jdat->use_gpu && ni >= 2*REDUCE_CHUNK) {
+	chunk = (ni+3)/4;
+	if (chunk < REDUCE_CHUNK) chunk = REDUCE_CHUNK;
+    }
 
-    if (!jdat->use_gpu) {
+    static vector<real> sendbuf, recvbuf;
+#ifndef NOMPI
+    static vector<MPI_Request> requests;
+#endif
+    if (jdat->mpi_size > 1) {
+	if ((int)sendbuf.size() < NPACK*ni) {
+	    sendbuf.resize(NPACK*ni);
+	    recvbuf.resize(NPACK*ni);
+	}
+#ifndef NOMPI
+	define_packed_op();
+	requests.clear();
+#endif
+    }
 
-	// Calculate partial accs and jerks on the front end.
+    for (int ifirst = 0; ifirst < ni; ifirst += chunk) {
 
-	get_partial_acc_and_jerk();
+	int ilast = ifirst + chunk;
+	if (ilast > ni) ilast = ni;
 
-    } else {
+	real t0 = wall_time();
 
-	// Use the GPU to compute the forces.  Note that "pred"
-	// quantities are never used.
+	if (!jdat->use_gpu) {
 
-	if (DEBUG > 1) cout << "getting acc and jerk on GPU" << endl << flush;
-	get_partial_acc_and_jerk_on_gpu();
-	if (DEBUG > 1) cout << "acc and jerk on GPU done" << endl << flush;
+	    // Calculate partial accs and jerks on the front end, with
+	    // the vectorized kernel in gpu.cc if requested.
 
-    }
+	    if (jdat->use_cpu_kernel)
+		get_partial_acc_and_jerk_on_cpu(ifirst, ilast);
+	    else
+		get_partial_acc_and_jerk(ifirst, ilast);
 
-#ifndef NOMPI
-    //cout << "idata Barrier 1 for " << jdat->mpi_rank << endl << flush;
-    //jdat->mpi_comm.Barrier();
-    MPI_Barrier(jdat->mpi_comm);
-    //cout << "idata Barrier 1a for " << jdat->mpi_rank << endl << flush;
-#endif
+	} else {
 
-    if (jdat->mpi_size > 1) {
+	    // Use the GPU to compute the forces.  Note that "pred"
+	    // quantities are never used.
 
-	// Combine partial potentials, accs, and jerks to get the totals.
-	// If size = 1, the data have already been saved in ipot, etc.
+	    if (DEBUG > 1) cout << "getting acc and jerk on GPU"
+				<< endl << flush;
+	    get_partial_acc_and_jerk_on_gpu();
+	    if (DEBUG > 1) cout << "acc and jerk on GPU done"
+				<< endl << flush;
+	}
 
-#ifndef NOMPI
-	//jdat->mpi_comm.Allreduce(ppot, ipot, ni, MPI_DOUBLE, MPI_SUM);
-	//jdat->mpi_comm.Allreduce(pacc, iacc, 3*ni, MPI_DOUBLE, MPI_SUM);
-	//jdat->mpi_comm.Allreduce(pjerk, ijerk, 3*ni, MPI_DOUBLE, MPI_SUM);
+	real t1 = wall_time();
+	jdat->force_time += t1 - t0;
 
-	MPI_Allreduce(ppot, ipot, ni, MPI_DOUBLE, MPI_SUM, jdat->mpi_comm);
-	MPI_Allreduce(pacc, iacc, 3*ni, MPI_DOUBLE, MPI_SUM, jdat->mpi_comm);
-	MPI_Allreduce(pjerk, ijerk, 3*ni, MPI_DOUBLE, MPI_SUM, jdat->mpi_comm);
-	// Update and distribute the nn pointers.  Start by determining
-	// the global nearest neighbor distances.
+	if (jdat->mpi_size > 1) {
 
-	MPI_Allreduce(pdnn, idnn, ni, MPI_DOUBLE, MPI_MIN, jdat->mpi_comm);
-#else
-    for(int i = 0; i < ni; i++)
-    {
-        ipot[i] = ppot[i];
-        for(int j = 0; j < 3; j++)
-        {
-            iacc[i][j] = pacc[i][j];
-            ijerk[i][j] = pjerk[i][j];
-        }
-    }
-#endif
-	// Currently, pnn[i] is the nearest neighbor of i in the local j
-	// domain.  Use the idnn array to decide if the local nearest
-	// neighbor is the global one.  (We are assuming here that the
-	// distances are correctly preserved by the above reduction, so
-	// only one pnn will be nonzero...)
+	    // Pack this chunk and start its reduction.  If size = 1,
+	    // the data have already been saved in ipot, etc.
 
-	for (int i = 0; i < ni; i++)
-	    if (pdnn[i] > idnn[i]) pnn[i] = 0;
+	    for (int i = ifirst; i < ilast; i++) {
+		real *p = &sendbuf[NPACK*i];
+		p[0] = ppot[i];
+		for (int k = 0; k < 3; k++) {
+		    p[1+k] = pacc[i][k];
+		    p[4+k] = pjerk[i][k];
+		}
+		p[NSUM] = pdnn[i];
+		p[NSUM+1] = pnn[i];
+	    }
 
 #ifndef NOMPI
-	//jdat->mpi_comm.Allreduce(pnn, inn, ni, MPI_INT, MPI_SUM);
-	MPI_Allreduce(pnn, inn, ni, MPI_INT, MPI_SUM, jdat->mpi_comm);
+	    MPI_Request request;
+	    MPI_Iallreduce(&sendbuf[NPACK*ifirst], &recvbuf[NPACK*ifirst],
+			   ilast-ifirst, packed_type, packed_op,
+			   jdat->mpi_comm, &request);
+	    requests.push_back(request);
 #else
-    for(int i = 0; i < ni; i++)
-    {
-        inn[i] = pnn[i];
-    }
+	    for (int l = NPACK*ifirst; l < NPACK*ilast; l++)
+		recvbuf[l] = sendbuf[l];
 #endif
+	    jdat->comm_time += wall_time() - t1;
+	}
     }
 
+    if (jdat->mpi_size > 1) {
+
+	real t0 = wall_time();
 #ifndef NOMPI
-    //cout << "idata Barrier 2 for " << jdat->mpi_rank << endl << flush;
-    //jdat->mpi_comm->Barrier();
-    MPI_Barrier(jdat->mpi_comm);
-    //cout << "idata Barrier 2a for " << jdat->mpi_rank << endl << flush;
+	MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
 #endif
+	jdat->comm_time += wall_time() - t0;
+
+	// Unpack the totals.  The global nearest neighbor is the local
+	// one with the smallest distance.
+
+	for (int i = 0; i < ni; i++) {
+	    real *p = &recvbuf[NPACK*i];
+	    ipot[i] = p[0];
+	    for (int k = 0; k < 3; k++) {
+		iacc[i][k] = p[1+k];
+		ijerk[i][k] = p[4+k];
+	    }
+	    idnn[i] = p[NSUM];
+	    inn[i] = (int)p[NSUM+1];
+	}
+    }
 }
 
 void idata::predict(real t)
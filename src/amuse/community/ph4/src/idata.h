@@ -55,7 +55,7 @@ class idata {
     void set_list_sync();
     real set_list();
     void set_list(int jlist[], int njlist);
-    void get_partial_acc_and_jerk();
+    void get_partial_acc_and_jerk(int ifirst = 0, int ilast = -1);
     void get_acc_and_jerk();
     real get_pot();
     real get_kin();
@@ -68,6 +68,7 @@ class idata {
 
     void update_gpu();
     void get_partial_acc_and_jerk_on_gpu(bool pot = false);
+    void get_partial_acc_and_jerk_on_cpu(int ifirst = 0, int ilast = -1);
 };
 
 #endif
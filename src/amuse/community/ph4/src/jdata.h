@@ -87,12 +87,15 @@ class jdata {
     bool have_gpu;			// will be true if -DGPU is compiled in
     bool use_gpu;			// true if actually using GPU
     int gpu_id;				// >= 0 if we have specified a GPU ID
+    bool use_cpu_kernel;		// vectorized host kernel if no GPU
 
     real eps2, eta;
     real rmin;				// 90 degree turnaround distance
     real dtmin;				// time step for enabling nn check
 
     real block_steps, total_steps, gpu_calls, gpu_total;
+    real force_time, comm_time;		// wall-clock seconds spent in forces
+					// and in the force reductions
     real system_time, predict_time;
     real sync_time;			// last time all particles were synced
 					// represents the internal offset time
@@ -147,8 +150,10 @@ class jdata {
 #endif
 	have_gpu = false;		// correct values will be set at
 	use_gpu = false;		// run time, in setup_gpu()
+	use_cpu_kernel = false;
 	eps2 = eta = rmin = dtmin = 0;
 	block_steps = total_steps = gpu_calls = gpu_total = 0;
+	force_time = comm_time = 0;
 	system_time = predict_time = sync_time = 0;
 	coll1 = coll2 = -1;
 	id = nn = NULL;
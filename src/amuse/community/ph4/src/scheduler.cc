@@ -8,7 +8,7 @@
 //	set/change the jdata pointer
 //	(re)initialize from a jdata structure
 //	return a list of "next" particle indices in the jdata array
-//	update after a step -- partially ordered lists
+//	update after a step -- refile the advanced blocks
 //	print the state of the scheduler
 //	check the state of the scheduler
 //
@@ -16,19 +16,143 @@
 //
 //	void scheduler::initialize()
 //	real scheduler::get_list(int *ilist, int& n) const
-//	int scheduler::find_block(real t, int i1) const
 //	void scheduler::update()
 //	void scheduler::add_particle(int j)
 //	void scheduler::remove_particle(int j)
-//	void scheduler::print_blist()
-//	void scheduler::print_bp(bool verbose)
+//	void scheduler::print_blocks(bool verbose)
 //	void scheduler::print(bool verbose)
-//	void check(bool repair, bool verbose)   (NOT IMPLEMENTED)
+//	void check(bool repair, bool verbose)
 
 #include "idata.h"
 #include "scheduler.h"
 #include <unistd.h>
 
+int scheduler::level(const int j) const
+{
+    // Return the level of the time step of particle j, such that
+    // steps in [2^-k-1, 2^-k) have level SCHED_LEVEL0 + k.
+
+    int exponent;
+    frexp(jdat->timestep[j], &exponent);
+    int l = SCHED_LEVEL0 - exponent;
+    if (l < 0) l = 0;
+    if (l >= SCHED_NLEVELS) l = SCHED_NLEVELS - 1;
+    return l;
+}
+
+void scheduler::clear()
+{
+    for (unsigned int ia = 0; ia < active.size(); ia++)
+	levels[blocks[active[ia]].level].clear();
+    blocks.clear();
+    free_blocks.clear();
+    active.clear();
+    jblk.clear();
+    jpos.clear();
+}
+
+int scheduler::new_block(int l, real t)
+{
+    // Take a block from the pool and make it active.
+
+    int b;
+    if (free_blocks.empty()) {
+	b = blocks.size();
+	blocks.push_back(jblock());
+    } else {
+	b = free_blocks.back();
+	free_blocks.pop_back();
+    }
+
+    blocks[b].level = l;
+    blocks[b].t_next = t;
+    blocks[b].jlist.clear();
+    blocks[b].iactive = active.size();
+    active.push_back(b);
+    levels[l].push_back(b);
+    return b;
+}
+
+void scheduler::release_block(int b)
+{
+    // Return an (empty) block to the pool.
+
+    int ia = blocks[b].iactive;
+    active[ia] = active.back();
+    blocks[active[ia]].iactive = ia;
+    active.pop_back();
+
+    vector<int>& lb = levels[blocks[b].level];
+    for (unsigned int il = 0; il < lb.size(); il++)
+	if (lb[il] == b) {
+	    lb[il] = lb.back();
+	    lb.pop_back();
+	    break;
+	}
+
+    blocks[b].iactive = -1;
+    free_blocks.push_back(b);
+}
+
+void scheduler::insert(int j)
+{
+    // File particle j in the block matching its level and t_next,
+    // creating the block if necessary.  Don't check whether j is
+    // already scheduled.
+
+    if (j >= (int)jblk.size()) {
+	jblk.resize(j+1, -1);
+	jpos.resize(j+1, -1);
+    }
+
+    int l = level(j);
+    real t = t_next(j);
+
+    int b = -1;
+    vector<int>& lb = levels[l];
+    for (unsigned int il = 0; il < lb.size(); il++)
+	if (blocks[lb[il]].t_next == t) {
+	    b = lb[il];
+	    break;
+	}
+    if (b < 0) b = new_block(l, t);
+
+    jblk[j] = b;
+    jpos[j] = blocks[b].jlist.size();
+    blocks[b].jlist.push_back(j);
+}
+
+bool scheduler::erase(int j)
+{
+    // Remove particle j from its block by moving the last member of
+    // the block into its place.
+
+    if (j < 0 || j >= (int)jblk.size() || jblk[j] < 0) return false;
+
+    int b = jblk[j];
+    vector<int>& jlist = blocks[b].jlist;
+    int last = jlist.back();
+    jlist[jpos[j]] = last;
+    jpos[last] = jpos[j];
+    jlist.pop_back();
+
+    jblk[j] = jpos[j] = -1;
+    if (jlist.empty()) release_block(b);
+    return true;
+}
+
+real scheduler::first_t_next() const
+{
+    // Return the earliest t_next of all blocks.  The number of active
+    // blocks is of order the number of time step levels.
+
+    real tmin = _INFINITY_;
+    for (unsigned int ia = 0; ia < active.size(); ia++)
+	if (blocks[active[ia]].t_next < tmin)
+	    tmin = blocks[active[ia]].t_next;
+    return tmin;
+}
+
 void scheduler::initialize(jdata *jd)	// (re)initialize based on the
 					// time step data in jd
 {
@@ -48,18 +172,9 @@ void scheduler::initialize(jdata *jd)	// (re)initialize based on the
 
     if (jdat) {
 	clear();		// scheduler member function
-	for (int j = 0; j < jdat->nj; j++)
-	    blist.push_back(jtime(j, t_next(j)));
-
-	blist.sort(compare);	// --> the main reason to use stl::list
-
-	li ib = blist.begin(), jb = ib;
-	bp.push_back(ib);
-	while (++ib != blist.end()) {
-	    if (t_next(ib->jindex) > t_next(jb->jindex)) bp.push_back(ib);
-	    jb = ib;
-	}
-	bp.push_back(ib);	// list runs from blist.begin() to blist.end()
+	jblk.resize(jdat->nj, -1);
+	jpos.resize(jdat->nj, -1);
+	for (int j = 0; j < jdat->nj; j++) insert(j);
     }
 }
 
@@ -68,66 +183,22 @@ real scheduler::get_list(int *ilist, int& n) const
     const char *in_function = "scheduler::get_list";
     if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
 
-    li ib;
-
-    // NOTE: ilist = NULL means just return tnext.
+    // Return the earliest t_next and, unless ilist = NULL, the list
+    // of particles in all blocks with that t_next.  Blocks on
+    // different levels generally come due together.
 
-    if (ilist)
-        for (n = 0, ib = bp[0]; ib != bp[1]; ib++) ilist[n++] = ib->jindex;
-    return bp[0]->t_next;
-}
+    real tmin = first_t_next();
 
-int scheduler::find_block(real t,
-			  int i1) const		// default = 0
-{
-    const char *in_function = "scheduler::find_block";
-    if (DEBUG > 3 && jdat->mpi_rank == 0) PRL(in_function);
-
-    // Return the starting index of the first block with t_next >= t.
-    // Start the search at block i1 = 0 or 1, depending on context.
-    // Return i1 if t is less than any t_next, and nbp-1 if t is
-    // greater than any t_next.
-    //
-    //            current/next
-    //            active list          rest of the system
-    //           t_next = time            t_next > time
-    //          ________________________________________________
-    // blist:  |_______________|________________________________|
-    //
-    //          ^               ^       ^      ...      ^        ^
-    // bp:      0               1       2      ...    nbp-2    nbp-1
-    //
-    // Bisection below assumes that there are enough blocks to start,
-    // so i1 <= i2, or bp.size() >= 3.  If the active particle list is
-    // the entire j system, then bp.size() = 2 and we have to treat
-    // this separately.
-
-    int nbp = bp.size();		// should *always* be >= 2
-    if (nbp == 2 && i1 > 0) return i1;	// special case
-
-    real t1 = t_next(bp[i1]->jindex);
-    if (t <= t1) return i1;
-
-    int i2 = nbp - 2;
-    real t2 = t_next(bp[i2]->jindex);
-    if (t == t2) return i2;
-    if (t > t2) return i2+1;	// force a new entry at the end of bp
-
-    // Now t1 < t < t2 strictly.  Use bisection to locate the
-    // desired block.
-
-    while (i2 > i1+1) {		// only way for i2 = i1 + 1 without breaking
-				// from the loop is if t1 < t < t2
-	int im = (i1+i2)/2;
-	real tm = t_next(bp[im]->jindex);
-	if (t == tm)
-	    return im;
-	else if (t < tm)
-	    i2 = im;
-	else
-	    i1 = im;
+    if (ilist) {
+	n = 0;
+	for (unsigned int ia = 0; ia < active.size(); ia++) {
+	    const jblock& block = blocks[active[ia]];
+	    if (block.t_next == tmin)
+		for (unsigned int jj = 0; jj < block.jlist.size(); jj++)
+		    ilist[n++] = block.jlist[jj];
+	}
     }
-    return i2;			// should check if t < t2 on return
+    return tmin;
 }
 
 void scheduler::update()
@@ -135,80 +206,25 @@ void scheduler::update()
     const char *in_function = "scheduler::update";
     if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
 
-    // The portion of blist from bp[0] to bp[1]-1 is assumed to
-    // have just been advanced, and is now out of order.  Merge it
-    // back into the rest of the list.
-    //
-    //------------------------------------------------------------
-    // The most efficient strategy depends on the length n of the
-    // disordered part relative to the total length N of the list.
-    //
-    // 1. We could reinsert the elements one by one.  Cost ~ n log
-    // log N, assuming len(bp) ~ log N.
-    //
-    // 2. If the disordered part is long, n ~ N, it might be
-    // faster just to sort the entire list and reestablish the
-    // pointers (reinitialize).  Cost ~ N log N + N.
-    //
-    // 3. Or it might be better to sort the disordered part, then
-    // merge the range that overlaps the >bp[1] ordered region, as
-    // in kira.  Cost ~ n log n + <n.
-    //
-    // Seems clear that (2) is never the best strategy (but beware
-    // factors of order unity...).  Looks like (3) < (2), but (3)
-    // --> (2) as n --> N, not surprisingly.  Also seems that (1)
-    // is always faster...  Go with (1) for now.
-    // ------------------------------------------------------------
-
-    // For each element from bp[0] to bp[1]-1, update its t_next,
-    // determine its new block, and insert it as the first element
-    // of that block.
-
-#if 0
-    cout << "in update..." << endl << flush;
-    for (li ib = bp[0]; ib != bp[1]; ib++) {
-	cout << ib->jindex << "  ib->t_next = " << ib->t_next
-	     << "  jdat->t_next = " << t_next(ib->jindex) << endl << flush;
-    }
-    print_blist();
-    print_bp();
-#endif
-
-    for (li ib = bp[0]; ib != bp[1]; ib++) {
-	ib->t_next = t_next(ib->jindex);
-#if 0
-	cout << ib->jindex << ":  set t_next = " << ib->t_next
-	     << endl << flush;
-#endif
-	// Return the index in array bp of the first block with t_next
-	// >= t_next(ib->jindex) after a time step.  Search only from
-	// bp[1] to the end, since bp[0] to bp[1]-1 is the current
-	// time step list, and will be removed.
-
-	int ibp = find_block(ib->t_next, 1);
-#if 0
-	cout << "    found block = " << ibp << endl << flush;
-#endif
-	// Insert *ib before bp[ibp], which may run from start to end.
-
-	li newbp = blist.insert(bp[ibp], *ib);
-
-	// Update the pointers.
-
-	if (bp[ibp] == blist.end() || ib->t_next < bp[ibp]->t_next) {
-	    bp.insert(bp.begin()+ibp, newbp);
-	} else
-	    bp[ibp] = newbp;
-    }
+    // The blocks with the earliest t_next are assumed to have just
+    // been advanced, so their members have new times and time steps.
+    // Refile them.  Cost ~ number of blocks + number of advanced
+    // particles.
+
+    real tmin = first_t_next();
 
-    // Clean up blist and bp.
+    vector<int> advanced;
+    for (unsigned int ia = 0; ia < active.size(); ia++) {
+	const jblock& block = blocks[active[ia]];
+	if (block.t_next == tmin)
+	    advanced.insert(advanced.end(),
+			    block.jlist.begin(), block.jlist.end());
+    }
 
-    blist.erase(bp[0], bp[1]);
-    bp.erase(bp.begin());
-#if 0
-    print_blist();
-    print_bp();
-#endif
+    for (unsigned int jj = 0; jj < advanced.size(); jj++) {
+	erase(advanced[jj]);
+	insert(advanced[jj]);
+    }
 }
 
 void scheduler::add_particle(int j)
@@ -216,29 +232,10 @@ void scheduler::add_particle(int j)
     const char *in_function = "scheduler::add_particle";
     if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
 
-    // Add particle j to the scheduler.  Code is essentially the same
-    // as in update().
-
-    // Identify the block to which particle belongs.
-
-    int ibp = find_block(t_next(j));
-
-#if 0
-    cout << "add_particle " << j << ": found block ";
-    PRC(ibp); PRL(bp.size());
-#endif
-
-    // Insert the particle as the first member of that block.  Don't
-    // check whether j is already in blist.
+    // Add particle j to the scheduler, replacing any previous entry.
 
-    li newbp = blist.insert(bp[ibp], jtime(j, t_next(j)));
-
-    // Update the block pointers.
-
-    if (bp[ibp] == blist.end() || t_next(j) < bp[ibp]->t_next) {
-	bp.insert(bp.begin()+ibp, newbp);
-    } else
-	bp[ibp] = newbp;
+    erase(j);
+    insert(j);
 }
 
 bool scheduler::remove_particle(int j)
@@ -248,84 +245,46 @@ bool scheduler::remove_particle(int j)
 
     // Remove particle j from the scheduler.
 
-    // Locate the particle in blist.  First, identify the block, then
-    // search linearly for j.
-
-    int ibp = find_block(t_next(j));
-    
-    for (li ib = bp[ibp]; ib != blist.end() && ib != bp[ibp+1]; ib++) {
-
-	if (ib->jindex == j) {
-
-	    // Correct pointers.
-
-	    if (ib == bp[ibp]) {
-		li jb = ib;
-		bp[ibp] = ++jb;		// can't say ib+1
-		if (bp[ibp] == bp[ibp+1]) bp.erase(bp.begin()+ibp);
-	    }
-
-	    // Remove ib.
-
-	    blist.erase(ib);
-	    return true;
-	}
-    }
+    if (erase(j)) return true;
 
     // Didn't find j.  Flag it.
 
     if (jdat->mpi_rank == 0) {
-	cout << "scheduler::remove_particle(): " << j << " not found, ";
-	PRL(ibp);
+	cout << "scheduler::remove_particle(): " << j << " not found"
+	     << endl << flush;
 	print(true);
     }
     return false;
 }
 
-void scheduler::print_blist()
-{
-    const char *in_function = "scheduler::print_blist";
-    if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
-
-    if (jdat->mpi_rank == 0) {
-	cout << "blist (size = " << blist.size() << "):" << endl << flush;
-	for (li ib = blist.begin(); ib != blist.end(); ib++)
-	    cout << "    " << ib->jindex << "  " << ib->t_next
-		 << "  " << jdat->time[ib->jindex]
-		 << "  " << jdat->timestep[ib->jindex]
-		 << endl << flush;
-    }
-}
-
-void scheduler::print_bp(bool verbose)		// default = false
+void scheduler::print_blocks(bool verbose)	// default = false
 {
-    const char *in_function = "scheduler::print_bp";
+    const char *in_function = "scheduler::print_blocks";
     if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
 
     if (jdat->mpi_rank == 0) {
 
 	int total = 0;
-	for (int kb = 0; kb < (int)bp.size()-1; kb++)
-	    for (li ib = bp[kb]; ib != bp[kb+1]; ib++) total++;
-	cout << "block pointers (size = "		   // NB last element
-	     << bp.size() << ", total = " << total << "):" //    is blist.end()
-	     << endl << flush;	
-
-	for (int kb = 0; kb < (int)bp.size()-1; kb++) {
-	    cout << "    block " << kb << ", t_next = " << bp[kb]->t_next;
-	    if (verbose)
-		cout << endl << "     ";
-	    else
-		cout << "  ";
-	    cout << flush;
-	    int nb = 0;
-	    for (li ib = bp[kb]; ib != bp[kb+1]; ib++) {
-		nb++;
-		if (verbose) cout << " " << ib->jindex;
+	for (unsigned int ia = 0; ia < active.size(); ia++)
+	    total += blocks[active[ia]].jlist.size();
+	cout << "blocks (size = "
+	     << active.size() << ", total = " << total << "):"
+	     << endl << flush;
+
+	for (int l = 0; l < SCHED_NLEVELS; l++)
+	    for (unsigned int il = 0; il < levels[l].size(); il++) {
+		const jblock& block = blocks[levels[l][il]];
+		cout << "    level " << l - SCHED_LEVEL0
+		     << ", t_next = " << block.t_next;
+		if (verbose) {
+		    cout << endl << "     ";
+		    for (unsigned int jj = 0; jj < block.jlist.size(); jj++)
+			cout << " " << block.jlist[jj];
+		    cout << "  ";
+		} else
+		    cout << "  ";
+		cout << "[nb = " << block.jlist.size() << "]" << endl << flush;
 	    }
-	    if (verbose) cout << "  ";
-	    cout << "[nb = " << nb << "]" << endl << flush;
-	}
     }
 }
 
@@ -334,12 +293,10 @@ void scheduler::print(bool verbose)		// default = false
     const char *in_function = "scheduler::print";
     if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
 
-    if (jdat->mpi_rank == 0 && verbose) {
+    if (jdat->mpi_rank == 0 && verbose)
 	cout << endl << "----------"
-	     << endl << "system time = " << jdat->system_time << ", " << flush;
-	print_blist();
-    }
-    print_bp(verbose);
+	     << endl << "system time = " << jdat->system_time << endl << flush;
+    print_blocks(verbose);
     if (jdat->mpi_rank == 0 && verbose) cout << "----------"
 					     << endl << flush;
 }
@@ -350,16 +307,38 @@ void scheduler::check(bool repair,		// default = true
     const char *in_function = "scheduler::check";
     if (DEBUG > 2 && jdat->mpi_rank == 0) PRL(in_function);
 
-    // Checks that should be carried out:
-    //	 every particle is on the list
-    //	 everything on the list is a particle
-    //	 blist is ordered
-    //	 blist jindex pointers are within the jdata range
-    //	 blist elements are ordered in t_next
-    //	 blist elements are consistent with jdata t_next
-    //	 bp pointers are correct
-    //
-    // TODO
+    // Check that every particle is in exactly one block, that the
+    // block and position pointers are consistent, and that every
+    // particle is in the block matching its current level and
+    // t_next.  Optionally rebuild the scheduler if not.
+
+    bool ok = true;
+    int total = 0;
+    for (unsigned int ia = 0; ia < active.size(); ia++) {
+	int b = active[ia];
+	const jblock& block = blocks[b];
+	total += block.jlist.size();
+	for (unsigned int jj = 0; jj < block.jlist.size(); jj++) {
+	    int j = block.jlist[jj];
+	    if (j < 0 || j >= jdat->nj || jblk[j] != b || jpos[j] != (int)jj
+		|| level(j) != block.level || t_next(j) != block.t_next) {
+		if (verbose && jdat->mpi_rank == 0) {
+		    cout << in_function << ": inconsistent entry ";
+		    PRC(j); PRC(block.level); PRL(block.t_next);
+		}
+		ok = false;
+	    }
+	}
+    }
+    if (total != jdat->nj) {
+	if (verbose && jdat->mpi_rank == 0) {
+	    cout << in_function << ": ";
+	    PRC(total); PRL(jdat->nj);
+	}
+	ok = false;
+    }
+
+    if (!ok && repair) initialize();
 }
 
 void scheduler::cleanup()
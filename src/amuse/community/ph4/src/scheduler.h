@@ -14,72 +14,79 @@
 //
 // Order of initialization: jdata, idata(jdata), scheduler(jdata).
 
-#include <list>
-#include <deque>
-#include <algorithm>
-
-struct jtime {		// really only want to compare t_next, but the list
-    int  jindex;	// compare function argument apparently can't be a
-    real t_next;	// member function of class scheduler...
-    jtime(){}
-    jtime(int j, real t): jindex(j), t_next(t) {}
-    ~jtime(){}
+#include <vector>
+
+// Time steps are powers of 2, commensurate with the particle times,
+// so all particles with the same step normally share the same t_next.
+// The scheduler keeps the particles in blocks of equal t_next, filed
+// by time step level (the exponent of the step).  There is normally
+// one block per level, but a level may hold several blocks if steps
+// are forced out of synchronization.
+
+#define SCHED_NLEVELS	2200		// covers the double exponent range
+#define SCHED_LEVEL0	1100		// level of a step in [1/2, 1)
+
+struct jblock {
+    int  level;
+    real t_next;
+    vector<int> jlist;			// contiguous j indices in the block
+    int  iactive;			// position in scheduler::active
 };
 
-inline bool compare(const jtime& j1, const jtime& j2) {
-    return j1.t_next < j2.t_next;
-}
-typedef std::list<jtime>::iterator li;
-
 class scheduler {
 public:
 
     jdata *jdat;
-    list<jtime> blist;
-    deque<li> bp;
+    vector<jblock> blocks;
+    vector<int> free_blocks;
+    vector<int> active;
+    vector<int> levels[SCHED_NLEVELS];
+    vector<int> jblk, jpos;
 
     // jdat is a pointer to the jdata structure served by the scheduler
     //
-    // blist contains indices of particles in the jdata array, sorted
-    // by t_next
+    // blocks is a pool of blocks; free_blocks lists the unused ones,
+    // and active lists the blocks currently in use, in no particular
+    // order
     //
-    // bp contains pointers (iterators) to the first element of each
-    // blist block; bp[0] is blist.begin(), for uniformity of
-    // expression
+    // levels[l] lists the active blocks whose time step has level l
     //
-    // Thus, bp[k] points to the list element at the start of block k,
-    // *bp[k] is the corresponding jtime structure, and bp[k]->jindex
-    // is the actual index into the jdata.  A drawback of this
-    // approach, apparently forced on us by the sort() argument, is
-    // that we have to keep jlist.t_next up to date -- done in
-    // update().
-
-    void clear() {
-	blist.clear();
-	bp.clear();
-    }
+    // jblk[j] is the block containing particle j (-1 if none), and
+    // jpos[j] is the position of j in that block's jlist, so that
+    // particles are added and removed in O(1) time.  Like the old
+    // list scheduler, we keep the block t_next values up to date only
+    // in update(), add_particle() and remove_particle().
+
+    void clear();
 
     real t_next(const int j) const {return jdat->time[j] + jdat->timestep[j];}
+    int level(const int j) const;
 
     void initialize(jdata *jd = NULL);
-    scheduler(jdata *jd = NULL) {initialize(jd);}
+    scheduler(jdata *jd = NULL) {jdat = NULL; initialize(jd);}
     ~scheduler() {cleanup();}
 
     // In scheduler.cc:
 
     real get_list(int *ilist, int& n) const;
-    int find_block(real t, int i1 = 0) const;
     void update();
 
     void add_particle(int j);
     bool remove_particle(int j);
 
-    void print_blist();
-    void print_bp(bool verbose = false);
+    void print_blocks(bool verbose = false);
     void print(bool verbose = false);
     void check(bool repair = true, bool verbose = false);
 
     void cleanup();
+
+  private:
+
+    real first_t_next() const;
+    int new_block(int l, real t);
+    void release_block(int b);
+    void insert(int j);
+    bool erase(int j);
 };
 
 #endif
@@ -333,6 +333,9 @@ void Communicator::join(vector<double> &x, vector<double> &y) {
   }
   MPI_Gatherv(&x[begin], number, MPI_DOUBLE, &y.front(), &all_number.front(), &all_begin.front(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
 }
+void Communicator::sum(vector<double> &x) {
+  MPI_Allreduce(MPI_IN_PLACE, &x.front(), x.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+}
 
 void Communicator::bcast(double &x, MPI_Comm comm) {
   MPI_Bcast(&x, 1, MPI_DOUBLE, 0, comm);   
@@ -376,6 +379,7 @@ void Communicator::join(vector<double> &x, vector<double> &y, MPI_Comm comm) {
   }
   MPI_Gatherv(&x[begin], number, MPI_DOUBLE, &y.front(), &all_number.front(), &all_begin.front(), MPI_DOUBLE, 0, comm);
 }
-
-
+void Communicator::sum(vector<double> &x, MPI_Comm comm) {
+  MPI_Allreduce(MPI_IN_PLACE, &x.front(), x.size(), MPI_DOUBLE, MPI_SUM, comm);
+}
 
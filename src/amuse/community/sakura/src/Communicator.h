@@ -81,12 +81,14 @@ class Communicator {
   void gather(double &x, vector<double> &y);
   void gather(vector<double> &x, vector<double> &y);
   void join(vector<double> &x, vector<double> &y);
+  void sum(vector<double> &x);
 
   void bcast(double &x, MPI_Comm comm);
   void bcast(vector<double> &x, MPI_Comm comm);
   void gather(double &x, vector<double> &y, MPI_Comm comm);
   void gather(vector<double> &x, vector<double> &y, MPI_Comm comm);
   void join(vector<double> &x, vector<double> &y, MPI_Comm comm);
+  void sum(vector<double> &x, MPI_Comm comm);
 };
 
 #endif
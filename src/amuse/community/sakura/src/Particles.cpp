@@ -49,6 +49,9 @@ Particle Particles::get_particle(int index) {
 Particle* Particles::get_pointer_to_star(int index) {
   return &particle[index];
 }
+vector<Particle>* Particles::get_pointer_to_particles() {
+  return &particle;
+}
 
 void Particles::set_data(vector<double> &data) {
   N = data.size()/7;
@@ -31,6 +31,7 @@ class Particles {
   vector<Particle> get_particles();
   Particle get_particle(int index);
   Particle* get_pointer_to_star(int index);
+  vector<Particle>* get_pointer_to_particles();
 
   void set_data(vector<double> &data);
   vector<double> get_data();
@@ -63,8 +63,7 @@ Particle* Sakura::get_pointer_to_star(int index) {
 
 void Sakura::evolve(double t, Communicator &communicator) {
   double t_begin = particles.get_t();
-  int N = particles.get_N();
-  vector<Particle> particle = particles.get_particles();
+  vector<Particle> &particle = *particles.get_pointer_to_particles();
 
   double t_end = t;
   t = t_begin;	
@@ -88,81 +87,120 @@ void Sakura::evolve(double t, Communicator &communicator) {
   }
 
   particles.set_t(t);
-  particles.set_particles(particle); 
+}
+// First pair (i,j), i<j, of unordered pair number p, with the pairs
+// numbered row by row: (0,1), (0,2), ..., (0,N-1), (1,2), ...
+static void get_pair(int N, long long p, int &i, int &j) {
+  double b = 2.0*N - 1.0;
+  i = (int)((b - sqrt(b*b - 8.0*p))/2);
+  if(i < 0) i = 0;
+  if(i > N-2) i = N-2;
+  while(i > 0 && (long long)i*(2*N-i-1)/2 > p) i--;
+  while(i < N-2 && (long long)(i+1)*(2*N-i-2)/2 <= p) i++;
+  j = (int)(p - (long long)i*(2*N-i-1)/2) + i + 1;
 }
 void Sakura::step(vector<Particle> &particle, double dt, Communicator &communicator) {
   int N = particle.size();  
 
-  double Mtot = 0;
-  double vxcm = 0;
-  double vycm = 0;
-  double vzcm = 0;
+  vector<double> m(N), x(N), y(N), z(N), vx(N), vy(N), vz(N);
   for(int i=0; i<N; i++) {
-    Mtot += particle[i].get_mass();
-    vxcm += particle[i].get_mass() * particle[i].get_vx();
-    vycm += particle[i].get_mass() * particle[i].get_vy();
-    vzcm += particle[i].get_mass() * particle[i].get_vz();
+    m[i] = particle[i].get_mass();
+    x[i] = particle[i].get_x();
+    y[i] = particle[i].get_y();
+    z[i] = particle[i].get_z();
+    vx[i] = particle[i].get_vx();
+    vy[i] = particle[i].get_vy();
+    vz[i] = particle[i].get_vz();
   }
-  vxcm /= Mtot;
-  vycm /= Mtot;
-  vzcm /= Mtot;
-
-  vector<double> mydp(6*N, 0);
-  for(int i=communicator.get_my_begin(); i<communicator.get_my_end(); i++) {
-    for(int j=0; j<N; j++) {
-      if(i != j) {
-
-	double M = particle[i].get_mass() + particle[j].get_mass();
-	double dxn = particle[j].get_x() - particle[i].get_x();
-	double dyn = particle[j].get_y() - particle[i].get_y();
-	double dzn = particle[j].get_z() - particle[i].get_z();
-	double dvxn = particle[j].get_vx() - particle[i].get_vx();
-	double dvyn = particle[j].get_vy() - particle[i].get_vy();
-	double dvzn = particle[j].get_vz() - particle[i].get_vz();
-
-        //double dr2 = dxn*dxn + dyn*dyn + dzn*dzn;
-        //double dv2 = dvxn*dvxn + dvyn*dvyn + dvzn*dvzn;
-        //if(dr2 > 10.0*dt*dt*dv2) twobody.solve_by_leapfrog(M, dxn, dyn, dzn, dvxn, dvyn, dvzn, dt);
-	//if(dr2 > 0.125*0.125) twobody.solve_by_leapfrog(M, dxn, dyn, dzn, dvxn, dvyn, dvzn, dt);
-	//else twobody.solve(M, dxn, dyn, dzn, dvxn, dvyn, dvzn, dt);
-        twobody.solve(M, dxn, dyn, dzn, dvxn, dvyn, dvzn, dt);
-
-	double mu = particle[i].get_mass()*particle[j].get_mass() / (particle[i].get_mass()+particle[j].get_mass());
-
-	double dx0 = particle[j].get_x() - particle[i].get_x();
-	double dy0 = particle[j].get_y() - particle[i].get_y();
-	double dz0 = particle[j].get_z() - particle[i].get_z();
-	double dvx0 = particle[j].get_vx() - particle[i].get_vx();
-	double dvy0 = particle[j].get_vy() - particle[i].get_vy();
-	double dvz0 = particle[j].get_vz() - particle[i].get_vz();
-
-	mydp[i*6+0] -= mu * ( (dxn-dx0) - dvx0*dt );
-	mydp[i*6+1] -= mu * ( (dyn-dy0) - dvy0*dt );
-	mydp[i*6+2] -= mu * ( (dzn-dz0) - dvz0*dt );
-	mydp[i*6+3] -= mu * ( dvxn - dvx0 );
-	mydp[i*6+4] -= mu * ( dvyn - dvy0 );
-	mydp[i*6+5] -= mu * ( dvzn - dvz0 ); 
+
+  // The two-body problems of (i,j) and (j,i) are mirror images, so
+  // every unordered pair is solved once and its correction is applied
+  // to i and, with opposite sign, to j. The pairs are split evenly
+  // over the MPI ranks and, in batches for Twobody::solve_batch, over
+  // the threads.
+  long long Npair = (long long)N*(N-1)/2;
+  long long my_begin = Npair*communicator.get_rank()/communicator.get_size();
+  long long my_end = Npair*(communicator.get_rank()+1)/communicator.get_size();
+  long long Nbatch = (my_end - my_begin + TWOBODY_BATCH - 1)/TWOBODY_BATCH;
+
+  vector<double> dp(6*N, 0);
+
+  #pragma omp parallel if(Nbatch > 1)
+  {
+    vector<double> mydp(6*N, 0);
+    int pi[TWOBODY_BATCH], pj[TWOBODY_BATCH];
+    double M[TWOBODY_BATCH];
+    double dxn[TWOBODY_BATCH], dyn[TWOBODY_BATCH], dzn[TWOBODY_BATCH];
+    double dvxn[TWOBODY_BATCH], dvyn[TWOBODY_BATCH], dvzn[TWOBODY_BATCH];
+
+    #pragma omp for schedule(dynamic)
+    for(long long b=0; b<Nbatch; b++) {
+      long long p = my_begin + b*TWOBODY_BATCH;
+      int nb = (my_end-p < TWOBODY_BATCH) ? (int)(my_end-p) : TWOBODY_BATCH;
+      int i, j;
+      get_pair(N, p, i, j);
+      for(int k=0; k<nb; k++) {
+        pi[k] = i;
+        pj[k] = j;
+        M[k] = m[i] + m[j];
+        dxn[k] = x[j] - x[i];
+        dyn[k] = y[j] - y[i];
+        dzn[k] = z[j] - z[i];
+        dvxn[k] = vx[j] - vx[i];
+        dvyn[k] = vy[j] - vy[i];
+        dvzn[k] = vz[j] - vz[i];
+        if(++j == N) {
+          i++;
+          j = i+1;
+        }
+      }
+
+      twobody.solve_batch(nb, M, dxn, dyn, dzn, dvxn, dvyn, dvzn, dt);
+
+      for(int k=0; k<nb; k++) {
+        int i = pi[k], j = pj[k];
+        double mu = m[i]*m[j] / M[k];
+
+        double dx0 = x[j] - x[i];
+        double dy0 = y[j] - y[i];
+        double dz0 = z[j] - z[i];
+        double dvx0 = vx[j] - vx[i];
+        double dvy0 = vy[j] - vy[i];
+        double dvz0 = vz[j] - vz[i];
+
+        double c[6];
+        c[0] = mu * ( (dxn[k]-dx0) - dvx0*dt );
+        c[1] = mu * ( (dyn[k]-dy0) - dvy0*dt );
+        c[2] = mu * ( (dzn[k]-dz0) - dvz0*dt );
+        c[3] = mu * ( dvxn[k] - dvx0 );
+        c[4] = mu * ( dvyn[k] - dvy0 );
+        c[5] = mu * ( dvzn[k] - dvz0 ); 
+        for(int l=0; l<6; l++) {
+          mydp[i*6+l] -= c[l];
+          mydp[j*6+l] += c[l];
+        }
       }
     }
+
+    #pragma omp critical
+    for(int l=0; l<6*N; l++) dp[l] += mydp[l];
   }
 
-  vector<double> dp(6*N, 0);
-  communicator.join(mydp, dp);
-  communicator.bcast(dp);
+  communicator.sum(dp);
 
   for(int i=0; i<N; i++) {
-    dp[i*6+0] /= particle[i].get_mass();
-    dp[i*6+1] /= particle[i].get_mass();
-    dp[i*6+2] /= particle[i].get_mass();
-    dp[i*6+3] /= particle[i].get_mass();
-    dp[i*6+4] /= particle[i].get_mass();
-    dp[i*6+5] /= particle[i].get_mass();
+    dp[i*6+0] /= m[i];
+    dp[i*6+1] /= m[i];
+    dp[i*6+2] /= m[i];
+    dp[i*6+3] /= m[i];
+    dp[i*6+4] /= m[i];
+    dp[i*6+5] /= m[i];
   }
 
   for(int i=0; i<N; i++) {
-    particle[i].add_to_x(dp[i*6+0] + (particle[i].get_vx())*dt);
-    particle[i].add_to_y(dp[i*6+1] + (particle[i].get_vy())*dt);
-    particle[i].add_to_z(dp[i*6+2] + (particle[i].get_vz())*dt);
+    particle[i].add_to_x(dp[i*6+0] + vx[i]*dt);
+    particle[i].add_to_y(dp[i*6+1] + vy[i]*dt);
+    particle[i].add_to_z(dp[i*6+2] + vz[i]*dt);
 
     particle[i].add_to_vx(dp[i*6+3]);
     particle[i].add_to_vy(dp[i*6+4]);
@@ -180,9 +218,7 @@ void Sakura::set_t(double t) {
   particles.set_t(t);
 }
 void Sakura::step(double dt, Communicator &communicator) {
-  vector<Particle> particle = particles.get_particles();
-  step(particle, dt, communicator);
-  particles.set_particles(particle);
+  step(*particles.get_pointer_to_particles(), dt, communicator);
 }
 vector<double> Sakura::get_coordinates(vector<Particle> &particle) {
   int N = particle.size();
@@ -0,0 +1,100 @@
+#include "stdbool.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int get_mass(int index_of_the_particle, double * mass);
+
+int commit_particles();
+
+int get_time(double * time);
+
+int set_mass(int index_of_the_particle, double mass);
+
+int get_index_of_first_particle(int * index_of_the_particle);
+
+int get_total_radius(double * radius);
+
+int get_total_mass(double * mass);
+
+int get_sakura_output_directory(char * * sakura_output_directory);
+
+int evolve_model(double time);
+
+int set_eps2(double epsilon_squared);
+
+int get_dt(double * dt);
+
+int get_begin_time(double * time);
+
+int set_sakura_output_directory(char * sakura_output_directory);
+
+int get_eps2(double * epsilon_squared);
+
+int get_t(double * t);
+
+int get_index_of_next_particle(int index_of_the_particle, int * index_of_the_next_particle);
+
+int delete_particle(int index_of_the_particle);
+
+int get_potential(int index_of_the_particle, double * potential);
+
+int synchronize_model();
+
+int set_state(int index_of_the_particle, double mass, double x, double y, double z, double vx, double vy, double vz, double radius);
+
+int get_state(int index_of_the_particle, double * mass, double * x, double * y, double * z, double * vx, double * vy, double * vz, double * radius);
+
+int get_time_step(double * time_step);
+
+int recommit_particles();
+
+int get_kinetic_energy(double * kinetic_energy);
+
+int get_number_of_particles(int * number_of_particles);
+
+int set_t_begin(double t_begin);
+
+int new_particle_float64(int * identity_of_the_particle, double mass, double x, double y, double z, double vx, double vy, double vz, double radius);
+
+int set_dt(double dt);
+
+int set_acceleration(int index_of_the_particle, double ax, double ay, double az);
+
+int get_center_of_mass_position(double * x, double * y, double * z);
+
+int set_t(double t);
+
+int get_center_of_mass_velocity(double * vx, double * vy, double * vz);
+
+int get_radius(int index_of_the_particle, double * radius);
+
+int set_begin_time(double time);
+
+int get_t_begin(double * t_begin);
+
+int set_radius(int index_of_the_particle, double radius);
+
+int cleanup_code();
+
+int recommit_parameters();
+
+int initialize_code();
+
+int get_potential_energy(double * potential_energy);
+
+int get_velocity(int index_of_the_particle, double * vx, double * vy, double * vz);
+
+int get_position(int index_of_the_particle, double * x, double * y, double * z);
+
+int set_position(int index_of_the_particle, double x, double y, double z);
+
+int get_acceleration(int index_of_the_particle, double * ax, double * ay, double * az);
+
+int commit_parameters();
+
+int set_velocity(int index_of_the_particle, double vx, double vy, double vz);
+#ifdef __cplusplus
+}
+#endif
+
@@ -8,6 +8,14 @@
 #include <stopcond.h>
 
 #include <map>
+#include <sstream>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#include <atomic>
+#include <thread>
+#endif
 
 static node * seba_root = 0;
 static node * seba_insertion_point = 0;
@@ -18,6 +26,7 @@ static double seba_time = 0.0;
 static stellar_type start_type = Main_Sequence;
 static binary_type binary_start_type = Detached;
 static bool is_logging_of_evolve_enabled = false;
+static int seba_number_of_threads = 0;
 
 local void addbinary(
     node *bi, real stellar_time,	// bi is binary CM
@@ -64,7 +73,8 @@ local void addbinary(
 }
 
 
-local real evolve_star_until_next_time(node* bi, const real out_time, const int n_steps) {
+local real evolve_star_until_next_time(node* bi, const real out_time, const int n_steps,
+                                       ostream& sout = cerr) {
     ofstream starev;
     if(is_logging_of_evolve_enabled) {
         starev.open("starev.data", ios::app|ios::out);
@@ -125,7 +135,7 @@ local real evolve_star_until_next_time(node* bi, const real out_time, const int
     
       
     bi->get_starbase()->evolve_element(out_time);
-    bi->get_starbase()->dump(cerr, false);
+    bi->get_starbase()->dump(sout, false);
     
     if(is_logging_of_evolve_enabled) {
         bi->get_starbase()->dump(starev, false);
@@ -710,6 +720,76 @@ int get_number_of_particles(int * number_of_particles){
     return 0;
 }
 
+#ifdef _OPENMP
+
+// The top-level nodes (single stars and binaries) evolve independently,
+// except for the random number sequence and the log files.  Nodes are
+// evolved concurrently, but a node may only enter a sequential section
+// (see enter_sequential_section in randinter.C) once all nodes before
+// it are done, so the results are identical to a serial run.
+
+static std::atomic<int> first_unfinished_node(0);
+static int current_node = 0;
+#pragma omp threadprivate(current_node)
+
+local void wait_for_turn() {
+    while (first_unfinished_node.load() < current_node)
+        std::this_thread::yield();
+}
+
+local void evolve_nodes_in_parallel(vector<nodeptr>& nodes, int n_threads,
+                                    real delta_t, real& end_time) {
+    int n_steps_per_phase = 10;
+    int n_nodes = nodes.size();
+    vector<real> actual_time(n_nodes, end_time);
+    vector<char> done(n_nodes, 0);
+    vector<ostringstream> dumps(n_nodes);
+
+    first_unfinished_node = 0;
+    set_sequential_hook(wait_for_turn);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(n_threads)
+    for (int i = 0; i < n_nodes; i++) {
+        current_node = i;
+        real out_time = seba_time;
+        do {
+            out_time = Starlab::min(out_time+delta_t, end_time);
+            actual_time[i] = evolve_star_until_next_time(nodes[i], out_time,
+                                                         n_steps_per_phase,
+                                                         dumps[i]);
+        }
+        while(actual_time[i] >= out_time && out_time < end_time);
+#pragma omp critical(seba_node_order)
+        {
+            done[i] = 1;
+            int first = first_unfinished_node.load();
+            while (first < n_nodes && done[first]) first++;
+            first_unfinished_node = first;
+        }
+    }
+    set_sequential_hook(NULL);
+
+    for (int i = 0; i < n_nodes; i++) {
+        cerr << dumps[i].str();
+        if (actual_time[i] < end_time) {
+            cerr<< "Star must have exploded at actual_time="<< actual_time[i]<<" out_time="<< end_time<<endl;
+            end_time = actual_time[i];
+        }
+    }
+}
+
+#endif
+
+int set_number_of_threads(int value){
+    if (value < 0) return -1;
+    seba_number_of_threads = value;
+    return 0;
+}
+
+int get_number_of_threads(int *value){
+    *value = seba_number_of_threads;
+    return 0;
+}
+
 int evolve_system(double end_time) {
     int n_steps = 1;
     int n_steps_per_phase = 10;
@@ -718,6 +798,21 @@ int evolve_system(double end_time) {
     nodeptr bi;
     // make a local copy of all stars
     real actual_time;
+#ifdef _OPENMP
+    int n_threads = seba_number_of_threads > 0 ? seba_number_of_threads
+                                               : omp_get_max_threads();
+    // starev.data is written at every step, so logging runs serially
+    if (n_threads > 1 && !is_logging_of_evolve_enabled) {
+        vector<nodeptr> nodes;
+        for_all_daughters(node, seba_root, bi)
+            nodes.push_back(bi);
+        if (nodes.size() > 1) {
+            evolve_nodes_in_parallel(nodes, n_threads, delta_t, end_time);
+            seba_time = end_time;
+            return 0;
+        }
+    }
+#endif
     for_all_daughters(node, seba_root, bi) {
         out_time = seba_time;
         do {
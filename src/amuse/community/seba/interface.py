@@ -428,6 +428,40 @@ class SeBaInterface(CodeInterface, se.StellarEvolutionInterface, LiteratureRefer
         """
         return function
 
+    @legacy_function
+    def get_number_of_threads():
+        """
+        Number of OpenMP threads used to evolve the stars and binaries
+        in evolve_system (0 means the OpenMP default)
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('value', dtype='int32', direction=function.OUT)
+        function.result_type = 'int32'
+        function.result_doc = """
+        0 - OK
+            the parameter was retrieved
+        -1 - ERROR
+            could not retrieve parameter
+        """
+        return function
+
+    @legacy_function
+    def set_number_of_threads():
+        """
+        Number of OpenMP threads used to evolve the stars and binaries
+        in evolve_system (0 means the OpenMP default)
+        """
+        function = LegacyFunctionSpecification()
+        function.addParameter('value', dtype='int32', direction=function.IN)
+        function.result_type = 'int32'
+        function.result_doc = """
+        0 - OK
+            the parameter was set
+        -1 - ERROR
+            could not set parameter
+        """
+        return function
+
     @legacy_function
     def get_supernova_kick_velocity():
         """
@@ -912,6 +946,14 @@ class SeBa(se.StellarEvolution):
             default_value = False
         )
 
+        handler.add_method_parameter(
+            "get_number_of_threads",
+            "set_number_of_threads",
+            "number_of_threads",
+            "number of OpenMP threads used in evolve_model, 0 for the OpenMP default; results do not depend on it",
+            default_value = 0
+        )
+
         self.stopping_conditions.define_parameters(handler)
 
 
@@ -403,6 +403,9 @@ int  get_n_rand();
 real randinter(real, real);
 real gausrand(real, real);
 
+void set_sequential_hook(void (*)());
+void enter_sequential_section();
+
 void cpu_init();
 real cpu_time();
 
@@ -0,0 +1,114 @@
+#include "stdbool.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int get_mass(int index_of_the_star, double * mass);
+
+int commit_particles();
+
+int get_time(double * time);
+
+int get_children_of_binary(int index_of_the_star, int * child1, int * child2);
+
+int merge_with_other_star(int child1, int child2);
+
+int set_supernova_kick_velocity(double v_disp);
+
+int change_mass(int index_of_the_star, double value, double dt);
+
+int get_stellar_type(int index_of_the_star, int * stellar_type);
+
+int new_particle(int * index_of_the_star, double mass);
+
+int recall_memory_one_step(int index_of_the_star);
+
+int get_temperature(int index_of_the_star, double * temperature);
+
+int get_is_logging_of_evolve_enabled(bool * value);
+
+int get_effective_radius(int index_of_the_star, double * effective_radius);
+
+int evolve_for(int index_of_the_star, double delta_t);
+
+int set_eccentricity(int index_of_the_star, double value);
+
+int set_number_of_threads(int value);
+
+int refresh_memory(int index_of_the_star);
+
+int get_envelope_mass(int index_of_the_star, double * value);
+
+int get_eccentricity(int index_of_the_star, double * value);
+
+int evolve_star(double mass, double endtime, double metal, double * resulttime, double * end_mass, double * end_radius, double * end_luminosity, double * end_temperature, double * time_step, int * stellar_type);
+
+int get_convective_envelope_mass(int index_of_the_star, double * convective_envelope_mass);
+
+int get_supernova_kick_velocity(double * v_disp);
+
+int get_time_step(int index_of_the_star, double * time_step);
+
+int get_core_radius(int index_of_the_star, double * value);
+
+int new_binary(int * index_of_the_star, double semi_major_axis, double eccentricity, int child1, int child2);
+
+int recommit_particles();
+
+int get_number_of_particles(int * number_of_particles);
+
+int get_number_of_threads(int * value);
+
+int get_luminosity(int index_of_the_star, double * luminosity);
+
+int get_age(int index_of_the_star, double * age);
+
+int set_metallicity(double metallicity);
+
+int get_radius(int index_of_the_star, double * radius);
+
+int set_semi_major_axis(int index_of_the_star, double value);
+
+int get_natal_kick_velocity(int index_of_the_star, double * natal_kick_velocity_x, double * natal_kick_velocity_y, double * natal_kick_velocity_z);
+
+int merge_the_binary(int index_of_the_binary, int child1, int child2);
+
+int get_COcore_mass(int index_of_the_star, double * value);
+
+int get_semi_major_axis(int index_of_the_star, double * value);
+
+int get_gyration_radius_sq(int index_of_the_star, double * gyration_radius_sq);
+
+int cleanup_code();
+
+int get_relative_age(int index_of_the_star, double * relative_age);
+
+int recommit_parameters();
+
+int get_relative_mass(int index_of_the_star, double * relative_mass);
+
+int initialize_code();
+
+int evolve_system(double time);
+
+int evolve_one_step(int index_of_the_star);
+
+int get_core_mass(int index_of_the_star, double * value);
+
+int delete_star(int index_of_the_star);
+
+int delete_binary(int index_of_the_particle);
+
+int set_is_logging_of_evolve_enabled(bool value);
+
+int get_metallicity(double * metallicity);
+
+int commit_parameters();
+
+int get_wind_mass_loss_rate(int index_of_the_star, double * wind_mass_loss_rate);
+
+int get_convective_envelope_radius(int index_of_the_star, double * convective_envelope_radius);
+#ifdef __cplusplus
+}
+#endif
+
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "types.h"
 #include "evolve.h"
 #include "ODE_system.h"
@@ -297,3 +298,213 @@ void extract_final_ODE_variables(ParticlesMap *particlesMap, N_Vector &y_out)
         }
     }
 }
+
+/* Sparsity of the Jacobian, following the couplings in compute_y_dot:
+ * - the spin of a body couples to its own spin and, through tides, to the orbit of its parent binary;
+ * - the orbit of a binary couples to the orbits of all binaries it is nested in or that are nested in it
+ *   (binary pairs and triplets), and, through tides, to the spins of its children.
+ * Mass and radius have prescribed rates, so their rows vanish; their columns are left out as well, since
+ * the BDF predictor already gets these linear (quadratic for the radius) variables right and the Newton
+ * corrections to them are zero.
+ * Columns that do not share any row are grouped, so that one right-hand side evaluation yields all their
+ * finite differences (Curtis, Powell & Reid 1974). */
+void set_jacobian_sparsity(ParticlesMap *particlesMap, void *data_, int N)
+{
+	UserData data;
+	data = (UserData) data_;
+    ParticlesMapIterator it_p,it_q;
+    std::map<int,int> offsets;
+    int k=0;
+    for (it_p = particlesMap->begin(); it_p != particlesMap->end(); it_p++)
+    {
+        Particle *P_p = (*it_p).second;
+        offsets[P_p->index] = k;
+        k += (P_p->is_binary == 0 ? 5 : 6);
+    }
+
+    char *sparsity = data->jacobian_sparsity;
+    int i,j,k_component;
+    for (i=0; i<N*N; i++)
+    {
+        sparsity[i] = 0;
+    }
+    for (it_p = particlesMap->begin(); it_p != particlesMap->end(); it_p++)
+    {
+        Particle *P_p = (*it_p).second;
+        int k_p = offsets[P_p->index];
+        if (P_p->is_binary == 0)
+        {
+            for (j=k_p; j<k_p+3; j++)
+            {
+                for (i=k_p; i<k_p+3; i++)
+                {
+                    sparsity[j*N + i] = 1;
+                }
+                if (particlesMap->count(P_p->parent) == 1)
+                {
+                    int k_parent = offsets[P_p->parent];
+                    for (i=k_parent; i<k_parent+6; i++)
+                    {
+                        sparsity[j*N + i] = 1;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (it_q = particlesMap->begin(); it_q != particlesMap->end(); it_q++)
+            {
+                Particle *P_q = (*it_q).second;
+                int k_q = offsets[P_q->index];
+                bool coupled = false;
+                if (P_q->is_binary == 1)
+                {
+                    coupled = (P_q == P_p) \
+                        || std::find(P_p->parents.begin(),P_p->parents.end(),P_q->index) != P_p->parents.end() \
+                        || std::find(P_q->parents.begin(),P_q->parents.end(),P_p->index) != P_q->parents.end();
+                }
+                else
+                {
+                    coupled = (P_q->index == P_p->child1 || P_q->index == P_p->child2);
+                }
+                if (coupled == false)
+                {
+                    continue;
+                }
+                for (j=k_p; j<k_p+6; j++)
+                {
+                    for (i=k_q; i<k_q+(P_q->is_binary == 0 ? 3 : 6); i++)
+                    {
+                        sparsity[j*N + i] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    /* greedy grouping of structurally orthogonal columns */
+    int *groups = data->jacobian_column_groups;
+    char *rows_in_group = (char *) calloc(N*N, sizeof(char));
+    int N_groups = 0;
+    for (j=0; j<N; j++)
+    {
+        groups[j] = -1;
+        bool empty_column = true;
+        for (i=0; i<N; i++)
+        {
+            if (sparsity[j*N + i] != 0)
+            {
+                empty_column = false;
+            }
+        }
+        if (empty_column == true)
+        {
+            continue;
+        }
+        int g;
+        for (g=0; g<=N_groups; g++)
+        {
+            bool fits = true;
+            for (i=0; i<N; i++)
+            {
+                if (sparsity[j*N + i] != 0 && rows_in_group[g*N + i] != 0)
+                {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits == true)
+            {
+                break;
+            }
+        }
+        groups[j] = g;
+        if (g == N_groups)
+        {
+            N_groups++;
+        }
+        for (i=0; i<N; i++)
+        {
+            if (sparsity[j*N + i] != 0)
+            {
+                rows_in_group[g*N + i] = 1;
+            }
+        }
+    }
+    free(rows_in_group);
+    data->N_jacobian_column_groups = N_groups;
+}
+
+/* Dense Jacobian for CVDense, by grouped forward differences; the increments are those of CVODE's own
+ * difference quotient Jacobian (cvDlsDenseDQJac). */
+int compute_jacobian(int N, realtype time, N_Vector y, N_Vector y_dot, DlsMat J, void *data_, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+	UserData data;
+	data = (UserData) data_;
+    int *groups = data->jacobian_column_groups;
+    char *sparsity = data->jacobian_sparsity;
+
+    N_Vector weights = tmp1;
+    N_Vector y_dot_perturbed = tmp2;
+    N_Vector increments = tmp3;
+
+    double h;
+    CVodeGetErrWeights(data->cvode_mem, weights);
+    CVodeGetCurrentStep(data->cvode_mem, &h);
+
+    double *y_data = NV_DATA_S(y);
+    double *y_dot_data = NV_DATA_S(y_dot);
+    double *y_dot_perturbed_data = NV_DATA_S(y_dot_perturbed);
+    double *weights_data = NV_DATA_S(weights);
+    double *increments_data = NV_DATA_S(increments);
+
+    double uround = UNIT_ROUNDOFF;
+    double srur = sqrt(uround);
+    double y_dot_norm = N_VWrmsNorm(y_dot, weights);
+    double minimum_increment = (y_dot_norm != 0.0) ? 1000.0*fabs(h)*uround*N*y_dot_norm : 1.0;
+
+    int i,j,g;
+    for (j=0; j<N; j++)
+    {
+        increments_data[j] = max(srur*fabs(y_data[j]), minimum_increment/weights_data[j]);
+    }
+
+    SetToZero(J);
+    int flag;
+    for (g=0; g<data->N_jacobian_column_groups; g++)
+    {
+        /* the perturbed components are restored from weights_data, which is no longer needed */
+        for (j=0; j<N; j++)
+        {
+            if (groups[j] == g)
+            {
+                weights_data[j] = y_data[j];
+                y_data[j] += increments_data[j];
+            }
+        }
+
+        flag = compute_y_dot(time, y, y_dot_perturbed, data_);
+
+        for (j=0; j<N; j++)
+        {
+            if (groups[j] == g)
+            {
+                y_data[j] = weights_data[j];
+                double *column = DENSE_COL(J,j);
+                for (i=0; i<N; i++)
+                {
+                    if (sparsity[j*N + i] != 0)
+                    {
+                        column[i] = (y_dot_perturbed_data[i] - y_dot_data[i])/increments_data[j];
+                    }
+                }
+            }
+        }
+        if (flag != 0)
+        {
+            break;
+        }
+    }
+
+    return flag;
+}
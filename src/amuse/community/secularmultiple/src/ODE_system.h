@@ -5,5 +5,8 @@ void write_ODE_variables_dots(ParticlesMap *particlesMap, N_Vector &y_dot);
 
 int compute_y_dot(realtype time, N_Vector y, N_Vector y_dot, void *data_);
 
+void set_jacobian_sparsity(ParticlesMap *particlesMap, void *data_, int N);
+int compute_jacobian(int N, realtype time, N_Vector y, N_Vector y_dot, DlsMat J, void *data_, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+
 void set_initial_ODE_variables(ParticlesMap *particlesMap, N_Vector &y, N_Vector &y_abs_tol,double abs_tol_spin_vec, double abs_tol_e_vec, double abs_tol_h_vec);
 void extract_final_ODE_variables(ParticlesMap *particlesMap, N_Vector &y_out);
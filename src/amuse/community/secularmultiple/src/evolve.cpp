@@ -4,6 +4,60 @@
 #include "evolve.h"
 
 
+/* CVODE state, kept between calls of evolve() for as long as the structure of the system does not change */
+static void *cvode_mem = NULL;
+static N_Vector y = NULL, y_out = NULL, y_abs_tol = NULL;
+static UserData data = NULL;
+static std::vector<int> ODE_structure;
+static double ODE_next_step = 0.0;
+
+void free_ODE_integrator()
+{
+    if (cvode_mem != NULL)
+    {
+        CVodeFree(&cvode_mem);
+        N_VDestroy_Serial(y);
+        N_VDestroy_Serial(y_out);
+        N_VDestroy_Serial(y_abs_tol);
+    }
+    if (data != NULL)
+    {
+        free(data->jacobian_column_groups);
+        free(data->jacobian_sparsity);
+        free(data);
+    }
+    cvode_mem = NULL;
+    y = y_out = y_abs_tol = NULL;
+    data = NULL;
+    ODE_structure.clear();
+    ODE_next_step = 0.0;
+}
+
+/* the ODE variables, their couplings and the root functions follow from the particles, their links and the root finding flags */
+static bool ODE_structure_has_changed(ParticlesMap *particlesMap, int N_root_finding)
+{
+    std::vector<int> structure;
+    structure.push_back(N_root_finding);
+    ParticlesMapIterator it_p;
+    for (it_p = particlesMap->begin(); it_p != particlesMap->end(); it_p++)
+    {
+        Particle *P_p = (*it_p).second;
+        structure.push_back(P_p->index);
+        structure.push_back(P_p->is_binary);
+        if (P_p->is_binary == 1)
+        {
+            structure.push_back(P_p->child1);
+            structure.push_back(P_p->child2);
+        }
+    }
+    if (structure == ODE_structure)
+    {
+        return false;
+    }
+    ODE_structure = structure;
+    return true;
+}
+
 int evolve(ParticlesMap *particlesMap, External_ParticlesMap *external_particlesMap, double start_time, double time_step, double *output_time, double *hamiltonian, int *output_flag, int *error_code)
 {
     int N_particles = particlesMap->size();
@@ -15,18 +69,6 @@ int evolve(ParticlesMap *particlesMap, External_ParticlesMap *external_particles
 
 //    printf("N_bodies %d N_binaries %d N_particles %d N_root_finding %d\n",N_bodies,N_binaries,N_particles,N_root_finding);
 
-    /*********************
-     * setup of UserData *
-     ********************/
-     
-	UserData data;
-	data = NULL;
-	data = (UserData) malloc(sizeof *data);
-	data->particlesMap = particlesMap;
-    data->external_particlesMap = external_particlesMap;
-    data->N_root_finding = N_root_finding;
-    data->start_time = start_time;
-
     /********************************
      * set ODE tolerances   *
      ********************************/
@@ -50,23 +92,38 @@ int evolve(ParticlesMap *particlesMap, External_ParticlesMap *external_particles
     /***************************
      * setup of ODE variables  *
      **************************/    
-	N_Vector y, y_out, y_abs_tol;
-	void *cvode_mem;
 	int flag;
 
-	y = y_out = y_abs_tol = NULL;
-	cvode_mem = NULL;
-
     int number_of_ODE_variables = N_bodies*5 + N_binaries*6; // spin vectors + mass + radius for each body + e & h vectors for each binary
 //    printf("N_ODE %d\n",number_of_ODE_variables);
-    
-//    data->number_of_ODE_variables = number_of_ODE_variables;
-    y = N_VNew_Serial(number_of_ODE_variables);
-	if (check_flag((void *)y, "N_VNew_Serial", 0)) return 1;
-    y_out = N_VNew_Serial(number_of_ODE_variables);
-	if (check_flag((void *)y_out, "N_VNew_Serial", 0)) return 1;
-    y_abs_tol = N_VNew_Serial(number_of_ODE_variables); 
-	if (check_flag((void *)y_abs_tol, "N_VNew_Serial", 0)) return 1;         
+
+    /* a previous integrator is re-initialised at the new initial conditions, only when the system changed a new one is set up */
+    bool warm_start = (cvode_mem != NULL) && (ODE_structure_has_changed(particlesMap,N_root_finding) == false);
+    if (warm_start == false)
+    {
+        free_ODE_integrator();
+        ODE_structure_has_changed(particlesMap,N_root_finding);
+
+        y = N_VNew_Serial(number_of_ODE_variables);
+        if (check_flag((void *)y, "N_VNew_Serial", 0)) return 1;
+        y_out = N_VNew_Serial(number_of_ODE_variables);
+        if (check_flag((void *)y_out, "N_VNew_Serial", 0)) return 1;
+        y_abs_tol = N_VNew_Serial(number_of_ODE_variables); 
+        if (check_flag((void *)y_abs_tol, "N_VNew_Serial", 0)) return 1;         
+
+        /*********************
+         * setup of UserData *
+         ********************/
+
+        data = (UserData) malloc(sizeof *data);
+        data->jacobian_column_groups = (int *) malloc(number_of_ODE_variables*sizeof(int));
+        data->jacobian_sparsity = (char *) malloc(number_of_ODE_variables*number_of_ODE_variables*sizeof(char));
+        data->N_jacobian_column_groups = 0;
+    }
+	data->particlesMap = particlesMap;
+    data->external_particlesMap = external_particlesMap;
+    data->N_root_finding = N_root_finding;
+    data->start_time = start_time;
 
     set_initial_ODE_variables(particlesMap, y, y_abs_tol,abs_tol_spin_vec,abs_tol_e_vec,abs_tol_h_vec);
 
@@ -74,49 +131,68 @@ int evolve(ParticlesMap *particlesMap, External_ParticlesMap *external_particles
      * setup of ODE integrator *
      **************************/    
 
-    /* use Backward Differentiation Formulas (BDF)
-        scheme in conjunction with Newton iteration --
-        these choices are recommended for stiff ODEs
-        in the CVODE manual                          
-    */
+    if (warm_start == true)
+    {
+        flag = CVodeReInit(cvode_mem, start_time, y);
+        if (check_flag(&flag, "CVodeReInit", 1)) return 1;
+
+        /* continue with the step size the previous integration ended with */
+        if (ODE_next_step > 0.0 && fabs(time_step) > 0.0)
+        {
+            initial_ODE_timestep = min(ODE_next_step, fabs(time_step));
+        }
+    }
+    else
+    {
+        /* use Backward Differentiation Formulas (BDF)
+            scheme in conjunction with Newton iteration --
+            these choices are recommended for stiff ODEs
+            in the CVODE manual                          
+        */
 
-    cvode_mem = CVodeCreate(CV_BDF, CV_NEWTON);
-	if (check_flag((void *)cvode_mem, "CVodeCreate", 0)) return 1;    
-    
-    /* essential initializations */
-    flag = CVodeInit(cvode_mem, compute_y_dot, start_time, y);
-	if (check_flag(&flag, "CVodeInit", 1)) return 1;    
+        cvode_mem = CVodeCreate(CV_BDF, CV_NEWTON);
+        if (check_flag((void *)cvode_mem, "CVodeCreate", 0)) return 1;    
+        data->cvode_mem = cvode_mem;
 
-	flag = CVodeSetUserData(cvode_mem, data);
-	if (check_flag(&flag, "CVodeSetUsetData", 1)) return 1;
+        /* essential initializations */
+        flag = CVodeInit(cvode_mem, compute_y_dot, start_time, y);
+        if (check_flag(&flag, "CVodeInit", 1)) return 1;    
 
-    flag = CVodeSVtolerances(cvode_mem, relative_tolerance, y_abs_tol);
-	if (check_flag(&flag, "CVodeSVtolerances", 1)) return 1;
+        flag = CVodeSetUserData(cvode_mem, data);
+        if (check_flag(&flag, "CVodeSetUsetData", 1)) return 1;
 
-	flag = CVDense(cvode_mem, number_of_ODE_variables);
-	if (check_flag(&flag, "CVDense", 1)) return 1;
+        flag = CVDense(cvode_mem, number_of_ODE_variables);
+        if (check_flag(&flag, "CVDense", 1)) return 1;
 
-	flag = CVodeSetInitStep(cvode_mem, initial_ODE_timestep);
-	if (check_flag(&flag, "CVodeSetInitStep", 1)) return 1;
+        set_jacobian_sparsity(particlesMap, data, number_of_ODE_variables);
+        flag = CVDlsSetDenseJacFn(cvode_mem, compute_jacobian);
+        if (check_flag(&flag, "CVDlsSetDenseJacFn", 1)) return 1;
 
-    /* optional initializations */
-//	flag = CVodeSetErrHandlerFn(cvode_mem, ehfun, eh_data); // error handling function
-//	if (check_flag(&flag, "CVodeSetErrHandlerFn", 1)) return;
-	  		
-	flag = CVodeSetMaxNumSteps(cvode_mem, maximum_number_of_internal_ODE_steps);
-	if (check_flag(&flag, "CVodeSetMaxNumSteps", 1)) return 1;
+        /* optional initializations */
+//        flag = CVodeSetErrHandlerFn(cvode_mem, ehfun, eh_data); // error handling function
+//        if (check_flag(&flag, "CVodeSetErrHandlerFn", 1)) return;
 
-//	flag = CVodeSetMinStep(cvode_mem, 0.1); // minimum step size
-//	if (check_flag(&flag, "CVodeSetMinStep", 1)) return 1;
+        flag = CVodeSetMaxNumSteps(cvode_mem, maximum_number_of_internal_ODE_steps);
+        if (check_flag(&flag, "CVodeSetMaxNumSteps", 1)) return 1;
 
-	flag = CVodeSetMaxHnilWarns(cvode_mem, 1);
-	if (check_flag(&flag, "CVodeSetMaxHnilWarns", 1)) return 1;
-			
-//	flag = CVodeSetStopTime(cvode_mem, MAXTIME); // maximum time
-//	if (check_flag(&flag, "CVodeSetStopTime", 1)) return 1;
+//        flag = CVodeSetMinStep(cvode_mem, 0.1); // minimum step size
+//        if (check_flag(&flag, "CVodeSetMinStep", 1)) return 1;
 
-	flag = CVodeSetMaxConvFails(cvode_mem, maximum_number_of_convergence_failures);
-	if (check_flag(&flag, "CVodeSetMaxConvFails", 1)) return 1;
+        flag = CVodeSetMaxHnilWarns(cvode_mem, 1);
+        if (check_flag(&flag, "CVodeSetMaxHnilWarns", 1)) return 1;
+
+//        flag = CVodeSetStopTime(cvode_mem, MAXTIME); // maximum time
+//        if (check_flag(&flag, "CVodeSetStopTime", 1)) return 1;
+
+        flag = CVodeSetMaxConvFails(cvode_mem, maximum_number_of_convergence_failures);
+        if (check_flag(&flag, "CVodeSetMaxConvFails", 1)) return 1;
+    }
+
+    flag = CVodeSVtolerances(cvode_mem, relative_tolerance, y_abs_tol);
+	if (check_flag(&flag, "CVodeSVtolerances", 1)) return 1;
+
+	flag = CVodeSetInitStep(cvode_mem, initial_ODE_timestep);
+	if (check_flag(&flag, "CVodeSetInitStep", 1)) return 1;
 
     /* initialization of root finding */
     int roots_found[N_root_finding];
@@ -133,6 +209,15 @@ int evolve(ParticlesMap *particlesMap, External_ParticlesMap *external_particles
 
 	flag = CVode(cvode_mem, user_end_time, y_out, &integrator_end_time, CV_NORMAL);	
 
+    if (flag >= 0)
+    {
+        CVodeGetCurrentStep(cvode_mem, &ODE_next_step);
+    }
+    else
+    {
+        ODE_next_step = 0.0;
+    }
+
     if (check_for_initial_roots(particlesMap) > 0)
     {
         flag = CV_ROOT_RETURN;
@@ -170,11 +255,6 @@ int evolve(ParticlesMap *particlesMap, External_ParticlesMap *external_particles
     update_position_vectors_external_particles(particlesMap,external_particlesMap,integrator_end_time);
 
     *hamiltonian = data->hamiltonian;
-    
-    N_VDestroy_Serial(y);
-    N_VDestroy_Serial(y_out);
-    N_VDestroy_Serial(y_abs_tol);
-    CVodeFree(&cvode_mem);
 
 	return 0;
     
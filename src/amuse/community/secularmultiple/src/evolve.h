@@ -1,6 +1,7 @@
 #include <math.h>
 #include <cstdlib>
 #include <map>
+#include <vector>
 
 #include "types.h"
 #include "../interface.h"
@@ -21,4 +22,5 @@
 
 
 int evolve(ParticlesMap *particlesMap, External_ParticlesMap *external_particlesMap, double start_time, double time_step, double *output_time, double *hamiltonian, int *output_flag, int *error_code);
+void free_ODE_integrator();
 static int check_flag(void *flagvalue, char *funcname, int opt);
@@ -516,5 +516,9 @@ typedef struct {
     double hamiltonian;
     int N_root_finding;
     double start_time;
+    void *cvode_mem;
+    int *jacobian_column_groups; /* group of each ODE variable in the Jacobian approximation, -1 if the column is not computed */
+    int N_jacobian_column_groups;
+    char *jacobian_sparsity; /* jacobian_sparsity[j*N + i] is nonzero if dy_i/dt depends on y_j */
 } *UserData;
 #endif
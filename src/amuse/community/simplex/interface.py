@@ -510,6 +510,20 @@ class SimpleXInterface(CodeInterface, CommonCodeInterface, LiteratureReferencesM
         function.addParameter('number_of_border_sites', dtype='int32', direction=function.OUT)
         function.result_type = 'int32'
         return function
+
+    @legacy_function
+    def set_incremental_triangulation():
+        function = LegacyFunctionSpecification()
+        function.addParameter('incremental_triangulation_flag', dtype='int32', direction=function.IN)
+        function.result_type = 'int32'
+        return function
+
+    @legacy_function
+    def get_incremental_triangulation():
+        function = LegacyFunctionSpecification()
+        function.addParameter('incremental_triangulation_flag', dtype='int32', direction=function.OUT)
+        function.result_type = 'int32'
+        return function
     
     @legacy_function
     def set_thermal_evolution():
@@ -727,6 +741,14 @@ class SimpleX(CommonCode):
             "Number of border sites to generate on the boundary, needs to be a large number. These sites will be placed randomly outside the problem domain and will culled to create a closed boundary", 
             default_value = 25000
         )
+
+        handler.add_method_parameter(
+            "get_incremental_triangulation",
+            "set_incremental_triangulation",
+            "incremental_triangulation_flag",
+            "if 1, only retriangulate the subboxes in which sites moved, were added or removed since the last evolve, and keep the boundary sites; if 0, retriangulate everything",
+            default_value = 0
+        )
         
     def define_methods(self, handler):
         CommonCode.define_methods(self, handler)
@@ -21,6 +21,17 @@
 
 #include <stdio.h>
 
+/* storage class of qhmem, see qh_THREADLOCAL in user.h */
+#ifndef qh_THREADLOCAL
+#if defined(__GNUC__) && !qh_QHpointer_dllimport && !qh_dllimport
+#define qh_THREADLOCAL __thread
+#define qh_THREADSAFE 1
+#else
+#define qh_THREADLOCAL
+#define qh_THREADSAFE 0
+#endif
+#endif
+
 /*-<a                             href="qh-mem.htm#TOC"
   >-------------------------------</a><a name="NOmem">-</a>
 
@@ -103,7 +114,7 @@ typedef long ptr_intT;
    contents of qhmem.
 */
 typedef struct qhmemT qhmemT;
-extern qhmemT qhmem;
+extern qh_THREADLOCAL qhmemT qhmem;
 
 #ifndef DEFsetT
 #define DEFsetT 1
@@ -138,7 +138,7 @@ int qh_argv_to_command_size(int argc, char *argv[]) {
 
 /* Global variables and constants */
 
-int qh_rand_seed= 1;  /* define as global variable instead of using qh */
+qh_THREADLOCAL int qh_rand_seed= 1;  /* define as global variable instead of using qh */
 
 #define qh_rand_a 16807
 #define qh_rand_m 2147483647
@@ -131,7 +131,7 @@ int qh_new_qhull(int dim, int numpoints, coordT *points, boolT ismalloc,
                 char *qhull_cmd, FILE *outfile, FILE *errfile) {
   int exitcode, hulldim;
   boolT new_ismalloc;
-  static boolT firstcall = True;
+  static qh_THREADLOCAL boolT firstcall = True;  /* qhmem is initialized per thread */
   coordT *new_points;
 
   if (firstcall) {
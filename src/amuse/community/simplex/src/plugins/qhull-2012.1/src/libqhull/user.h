@@ -624,6 +624,34 @@ stop after qh_JOGGLEmaxretry attempts
     qh_memfreeshort(&curlong, &totlong);  /* frees short memory and memory allocator */
 #endif
 
+/*-<a                             href="qh-user.htm#TOC"
+  >--------------------------------</a><a name="THREADLOCAL">-</a>
+
+  qh_THREADLOCAL
+    storage class of the global data structures qh_qh, qhmem and qh_qhstat
+
+  qh_THREADLOCAL = __thread   each thread has its own qh, qhmem, and qhstat
+                              threads may call qh_new_qhull concurrently
+                              default for gcc and compatible compilers
+                 = (empty)    one set of globals for all threads
+
+  qh_THREADSAFE
+    =1 if qh_THREADLOCAL gives every thread its own globals
+
+  notes:
+    also defined in mem.h, which does not include user.h
+    the address of qh_qh is different in every thread
+*/
+#ifndef qh_THREADLOCAL
+#if defined(__GNUC__) && !qh_QHpointer_dllimport && !qh_dllimport
+#define qh_THREADLOCAL __thread
+#define qh_THREADSAFE 1
+#else
+#define qh_THREADLOCAL
+#define qh_THREADSAFE 0
+#endif
+#endif
+
 /*-<a                             href="qh-user.htm#TOC"
   >--------------------------------</a><a name="QUICKhelp">-</a>
 
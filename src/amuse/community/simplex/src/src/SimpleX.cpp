@@ -73,6 +73,18 @@ SimpleX::SimpleX(const string& output_path, const string& data_path){
   //orientation of the unit sphere tesselation
   orientation_index = 0;
 
+  //sweeps over the sites are done in one slice until radiation_transport is called
+  numSlices = 1;
+  slice_size = 1;
+  threaded_sweep = 0;
+
+  //the sites index the neighbour and intensity arrays of this grid
+  Site::arrays = &site_arrays;
+
+  //by default every triangulation is done from scratch
+  incremental_triangulation = 0;
+  full_triangulation = 1;
+
   // Random number generator
   ran = gsl_rng_alloc (gsl_rng_taus);
 
@@ -741,11 +753,32 @@ void SimpleX::create_boundary(){
 
   }//for all border sites
 
+  //keep the boundary, so that the next triangulation can reuse
+  //the simplices of subboxes in which no vertices moved
+  border_vertices.clear();
+  if( incremental_triangulation ){
+    border_vertices.assign( vertices.end() - borderSites, vertices.end() );
+  }
+
   if( COMM_RANK == 0 )
     simpleXlog << "  Boundary points placed " << endl;
 
 }
 
+/**** Put the boundary of the previous triangulation back ****/
+void SimpleX::restore_boundary(){
+
+  //add the number of border sites to be added to the number of sites
+  numSites += border_vertices.size();
+
+  //the vertex ids of the boundary are unchanged, and so is vertex_id_max
+  vertices.insert( vertices.end(), border_vertices.begin(), border_vertices.end() );
+
+  if( COMM_RANK == 0 )
+    simpleXlog << "  Boundary points of previous triangulation restored " << endl;
+
+}
+
 
 
 /****  Create octree of vertices  ****/
@@ -990,7 +1023,8 @@ bool SimpleX::inDomain(const float& x, const float& y, const float& z, const uns
 /****  Compute triangulation  ****/
 //compute triangulation of every subbox separately and check whether the
 //triangulation is valid, i.e. whether the boundaries around the subbox
-//are sufficiently large
+//are sufficiently large. The subboxes are triangulated on OpenMP threads
+//if qhull keeps its globals in thread-local storage (qh_THREADSAFE)
 void SimpleX::compute_triangulation(){
 
 
@@ -1023,16 +1057,75 @@ void SimpleX::compute_triangulation(){
   //compute correct starting subbox by substracting number of subboxes-1
   start_number -= subboxes_on_proc-1;
 
-  //hilbert number of subbox
-  unsigned long this_subbox = (unsigned long) start_number;
-
   simplices.clear();
 
+  //in incremental mode the simplices of subboxes that did not change are reused.
+  //They are stored by vertex id, so find the place of every vertex id in the 
+  //vertices vector
+  vector< unsigned long long int > vertex_place;
+  if( incremental_triangulation ){
+    vertex_place.assign( computeMaxId() + 1, vertices.size() );
+    for( unsigned long long int q=0; q<vertices.size(); q++ ){
+      vertex_place[ vertices[q].get_vertex_id() ] = q;
+    }
+    //make sure there is room to store the simplices of every subbox
+    if( subbox_simplices.size() != subboxes_on_proc ){
+      subbox_simplices.assign( subboxes_on_proc, vector< Simpl >() );
+      subbox_bounds.assign( 6*subboxes_on_proc, 0.0 );
+      subbox_changed.clear();
+    }
+  }
+  //number of subboxes of which the simplices were reused
+  unsigned int reused_subboxes = 0;
+
+  //the subboxes are triangulated independently, every thread with its own 
+  //qhull globals. The simplices are merged in Hilbert order afterwards, so 
+  //the result does not depend on the number of threads
+  vector< vector< Simpl > > simplices_per_subbox( subboxes_on_proc );
+  //flags for subboxes that could not be triangulated
+  vector< int > failed_subbox( subboxes_on_proc, 0 );
+  int num_subboxes_local = (int) subboxes_on_proc;
+
   //loop over number of subboxes on this proc and triangulate and check for correct triangulation per subbox
-  for( unsigned int i=0; i<subboxes_on_proc; i++ ){
+#pragma omp parallel for schedule(dynamic,1) reduction(+:reused_subboxes) if(qh_THREADSAFE)
+  for( int i=0; i<num_subboxes_local; i++ ){
+
+    //hilbert number of subbox
+    unsigned long this_subbox = (unsigned long) start_number + i;
+
+    //vector to hold the simplices of this subbox
+    vector< Simpl >& simplices_subbox = simplices_per_subbox[i];
+
+    //if no vertex moved inside the region that was triangulated for this
+    //subbox, the simplices of the previous triangulation are still correct
+    if( incremental_triangulation && i < (int) subbox_changed.size() && !subbox_changed[i] ){
+
+      simplices_subbox = subbox_simplices[i];
 
-    //vector to hold the simplices on this proc
-    vector< Simpl > simplices_subbox;
+      //convert vertex ids to places in the vertices vector
+      bool found = 1;
+      for( SIMPL_ITERATOR it=simplices_subbox.begin(); found && it!=simplices_subbox.end(); it++ ){
+	unsigned long long int ids[4] = { it->get_id1(), it->get_id2(), it->get_id3(), it->get_id4() };
+	for( short int p=0; p<dimension+1; p++ ){
+	  if( ids[p] >= vertex_place.size() || vertex_place[ ids[p] ] >= vertices.size() ){
+	    found = 0;
+	  }else{
+	    ids[p] = vertex_place[ ids[p] ];
+	  }
+	}
+	it->set_id1( ids[0] );
+	it->set_id2( ids[1] );
+	it->set_id3( ids[2] );
+	it->set_id4( ids[3] );
+      }
+
+      //if one of the vertices no longer exists, retriangulate
+      if( found ){
+	reused_subboxes++;
+	continue;
+      }
+
+    }
 
     //flag that determines whether triangulation can be trusted
     bool correct = 0;
@@ -1094,8 +1187,10 @@ void SimpleX::compute_triangulation(){
       //change the abort to extension of the borders!
       //if( in_box.size() <= (unsigned int) dimension ){ 
       if( in_subbox <= (unsigned int) dimension ){ 
+#pragma omp critical (triangulation_error)
 	cerr << "Too few points in subbox to do tessellation." << endl;
-	MPI_Abort(MPI_COMM_WORLD,  -1 );
+	failed_subbox[i] = 1;
+	break;
       }
 
       //minimum and maximum coordinates of subbox without the boundary
@@ -1438,11 +1533,16 @@ void SimpleX::compute_triangulation(){
           y_min < (0.0 - borderBox) || y_max > (1.0 + borderBox) || 
 	  z_min < (0.0 - borderBox) || z_max > (1.0 + borderBox) ){
 
-	cerr << endl << "  (" << COMM_RANK << ") Boundary chosen around unity domain does not contain enough points, exiting" << endl;
-	cerr << "  (" << COMM_RANK << ")   box: (" << x_min << ", " << x_max << ")  (" 
-	     << y_min << ", " << y_max << ")  (" << z_min << ", " << z_max << ")" << endl;
+#pragma omp critical (triangulation_error)
+	{
+	  cerr << endl << "  (" << COMM_RANK << ") Boundary chosen around unity domain does not contain enough points, exiting" << endl;
+	  cerr << "  (" << COMM_RANK << ")   box: (" << x_min << ", " << x_max << ")  (" 
+	       << y_min << ", " << y_max << ")  (" << z_min << ", " << z_max << ")" << endl;
+	}
 
-	MPI_Abort(MPI_COMM_WORLD,  -1 );
+	//stop after freeing the qhull memory
+	failed_subbox[i] = 1;
+	correct = 1;
 
       }
 
@@ -1473,16 +1573,116 @@ void SimpleX::compute_triangulation(){
 
     }//while triangulation is not correct
 
-    simplices.insert( simplices.end(), simplices_subbox.begin(), simplices_subbox.end() );
-    simplices_subbox.clear();
+    if( failed_subbox[i] ){
+      continue;
+    }
+
+    //store the simplices by vertex id, together with the region that was 
+    //triangulated, for the next incremental triangulation
+    if( incremental_triangulation ){
+      subbox_simplices[i] = simplices_subbox;
+      for( SIMPL_ITERATOR it=subbox_simplices[i].begin(); it!=subbox_simplices[i].end(); it++ ){
+	it->set_id1( vertices[ it->get_id1() ].get_vertex_id() );
+	it->set_id2( vertices[ it->get_id2() ].get_vertex_id() );
+	it->set_id3( vertices[ it->get_id3() ].get_vertex_id() );
+	it->set_id4( vertices[ it->get_id4() ].get_vertex_id() );
+      }
+      subbox_bounds[6*i]   = x_min;
+      subbox_bounds[6*i+1] = x_max;
+      subbox_bounds[6*i+2] = y_min;
+      subbox_bounds[6*i+3] = y_max;
+      subbox_bounds[6*i+4] = z_min;
+      subbox_bounds[6*i+5] = z_max;
+    }
 
-    //if all went well, increase subbox number and triangulate the next
-    this_subbox++;
   }//for all subboxes on this proc
 
+  //stop if one of the subboxes could not be triangulated
+  for( unsigned int i=0; i<subboxes_on_proc; i++ ){
+    if( failed_subbox[i] ){
+      MPI_Abort(MPI_COMM_WORLD,  -1 );
+    }
+  }
+
+  //merge the simplices of all subboxes in Hilbert order
+  for( unsigned int i=0; i<subboxes_on_proc; i++ ){
+    simplices.insert( simplices.end(), simplices_per_subbox[i].begin(), simplices_per_subbox[i].end() );
+    vector< Simpl >().swap( simplices_per_subbox[i] );
+  }
+
+  //all changes are now part of the triangulation
+  moved_positions.clear();
+  subbox_changed.clear();
+  //without incremental triangulation the stored simplices are not kept up to date
+  full_triangulation = !incremental_triangulation;
 
   if( COMM_RANK == 0 ){
     simpleXlog << "  Triangulation computed " << endl;
+    if( incremental_triangulation ){
+      simpleXlog << "    Reused the simplices of " << reused_subboxes << " of " 
+		 << subboxes_on_proc << " subboxes " << endl;
+    }
+  }
+
+}
+
+
+/****  Find the subboxes that need to be retriangulated  ****/
+void SimpleX::find_changed_subboxes(){
+
+  //number of subboxes on this proc
+  unsigned int subboxes_on_proc = 0;
+  for(unsigned int i=0; i<dom_dec.size(); i++){
+    if(dom_dec[i] == COMM_RANK){
+      subboxes_on_proc++;
+    }
+  }
+
+  //by default all subboxes are retriangulated
+  subbox_changed.assign( subboxes_on_proc, 1 );
+
+  //gather the positions that changed on all procs
+  int num_local = (int) moved_positions.size();
+  vector< int > num_moved( COMM_SIZE, 0 );
+  MPI_Allgather( &num_local, 1, MPI_INT, &num_moved[0], 1, MPI_INT, MPI_COMM_WORLD );
+
+  vector< int > offset( COMM_SIZE, 0 );
+  for( unsigned int p=1; p<COMM_SIZE; p++ ){
+    offset[p] = offset[p-1] + num_moved[p-1];
+  }
+  //one extra entry, so that neither vector is empty
+  moved_positions.push_back( 0.0 );
+  vector< float > positions( offset[COMM_SIZE-1] + num_moved[COMM_SIZE-1] + 1, 0.0 );
+  MPI_Allgatherv( &moved_positions[0], num_local, MPI_FLOAT, 
+		  &positions[0], &num_moved[0], &offset[0], MPI_FLOAT, MPI_COMM_WORLD );
+  moved_positions.pop_back();
+  unsigned long int num_positions = ( positions.size() - 1 )/3;
+
+  //without stored simplices every subbox has to be triangulated
+  if( subbox_simplices.size() != subboxes_on_proc || subbox_bounds.size() != 6*subboxes_on_proc ){
+    return;
+  }
+
+  //a subbox changed if a moved vertex lies inside the region that was triangulated
+  unsigned int num_changed = 0;
+  for( unsigned int i=0; i<subboxes_on_proc; i++ ){
+    bool changed = 0;
+    for( unsigned long int q=0; !changed && q<num_positions; q++ ){
+      if( positions[3*q]   >= subbox_bounds[6*i]   && positions[3*q]   <= subbox_bounds[6*i+1] &&
+	  positions[3*q+1] >= subbox_bounds[6*i+2] && positions[3*q+1] <= subbox_bounds[6*i+3] &&
+	  positions[3*q+2] >= subbox_bounds[6*i+4] && positions[3*q+2] <= subbox_bounds[6*i+5] ){
+	changed = 1;
+      }
+    }
+    subbox_changed[i] = changed;
+    if( changed ){
+      num_changed++;
+    }
+  }
+
+  if( COMM_RANK == 0 ){
+    simpleXlog << "  " << num_positions << " vertex positions changed, " << num_changed 
+	       << " of " << subboxes_on_proc << " subboxes will be retriangulated " << endl;
   }
 
 }
@@ -1803,20 +2003,7 @@ void SimpleX::compute_site_properties(){
   //calculate the mean Delaunay length of every site
   calculate_line_lengths();
 
-  //create the intensity arrays, in the case of diffuse transport just one value, in the case of 
-  //ballistic transport the number of HEALPIX directions
-  for( SITE_ITERATOR it=sites.begin();it!=sites.end();it++ ){
-
-    //in case of ballistic transport, intensity has size of number of neighbours;
-    //in case of direction conserving transport, intensity has 
-    //the size of the tesselation of the unit sphere
-    numPixels = ( it->get_ballistic() ) ? it->get_numNeigh() : number_of_directions;
-
-    //create the intensity arrays
-    it->create_intensityIn( numFreq, numPixels );
-    it->create_intensityOut( numFreq, numPixels );
-
-  }
+  //the intensity arrays were created and set to zero in compute_neighbours()
 
   //write the time it took to triangulate the points to log file
   double t1 = MPI_Wtime();
@@ -1966,11 +2153,23 @@ void SimpleX::compute_neighbours(){
 
   }//for all simplices
 
-  //create neighbour array in Sites
+  //compute the offsets of every site in the neighbour and intensity arrays
+  unsigned long long int numNeighbours = 0;
+  unsigned long long int totalPixels = 0;
   unsigned int i=0;
   for( vector< Site >::iterator it=sites.begin(); it!=sites.end(); it++, i++){
     it->set_numNeigh( neighVec[i].size() );
-    it->create_neighId();
+    it->set_offsets( numNeighbours, totalPixels );
+    numNeighbours += it->get_numNeigh();
+    totalPixels += site_pixels( *it );
+  }
+
+  //create the neighbour, straight, outgoing and intensity arrays for all sites at once
+  site_arrays.create( numNeighbours, totalPixels, numFreq );
+
+  //fill the neighbour array
+  i=0;
+  for( vector< Site >::iterator it=sites.begin(); it!=sites.end(); it++, i++){
     unsigned int j=0;
     for( ItrT = neighVec[i].begin(); ItrT!=neighVec[i].end(); ItrT++,j++){
       it->set_neighId( j, *ItrT );
@@ -1989,6 +2188,19 @@ void SimpleX::compute_neighbours(){
 
 }
 
+/****  Number of intensity entries of a site  ****/
+unsigned int SimpleX::site_pixels( const Site& site ) const{
+
+  if( ballisticTransport ){
+    return site.get_numNeigh();
+  }else if( dirConsTransport ){
+    return number_of_directions;
+  }
+
+  return ( site.get_numNeigh() > number_of_directions ) ? site.get_numNeigh() : number_of_directions;
+
+}
+
 /****  Compute site volumes  ****/
 // Compute the volume of the voronoi cell around each vertex from the volumes 
 // of the simplices that the vertex is part of
@@ -2061,7 +2273,7 @@ void SimpleX::calculate_straight(){
     if( it->get_process() == COMM_RANK && !it->get_border() ){
 
       //create the straight vector in this site
-      it->create_straight();
+      it->clear_straight();
 
       //loop over all neighbours to calculate the d most straightforward
       for( unsigned int j=0; j<it->get_numNeigh(); j++ ){
@@ -2188,10 +2400,6 @@ void SimpleX::match_neighbours(){
     //only consider vertices on this proc and inside simulation domain
     if( it->get_process() == COMM_RANK && !it->get_border() && it->get_ballistic() ){
 
-      //make sure outgoing is empty before creating it
-      it->delete_outgoing();
-      it->create_outgoing( it->get_numNeigh() );
-
       //loop over all neighbours of this site
       for(unsigned int j=0; j<it->get_numNeigh(); j++){
 	//check if site has bee nfound
@@ -2352,10 +2560,6 @@ void SimpleX::compute_solid_angles( const bool& rotate ){
     //only consider vertices on this proc and inside simulation domain
     if( it->get_process() == COMM_RANK && !it->get_border() && !it->get_ballistic() ){
 
-      //make sure outgoin is empty before creating it
-      it->delete_outgoing();
-      it->create_outgoing(numPixels);
-
       //fill the outgoing vector with temporary values
       for(unsigned int m = 0; m<numPixels; m++){
 	it->set_outgoing( m, numPixels_ref+1);
@@ -2469,11 +2673,6 @@ void SimpleX::compute_solid_angles( const bool& rotate ){
     //only consider sites on this proc and inside simulation domain
     if( it->get_process() == COMM_RANK && !it->get_border() && !it->get_ballistic() ){
 
-      //make sure outgoing is empty
-      it->delete_outgoing();
-      //create the outgoing vector with numPixels entries
-      it->create_outgoing(numPixels);
-
       //array to store neighbour vectors
       float **vectorNeigh;
       //array to store the length of the neighbour vectors
@@ -2780,24 +2979,28 @@ void SimpleX::store_intensities(){
 
       //resize the site_intensities vector
       site_intensities.insert( site_intensities.end(), numFreq*numPixels, 0.0 );
+      //start of this site in site_intensities
+      unsigned long int start = site_intensities.size() - numFreq*numPixels;
 
-      //loop over directions
-      for( unsigned int j=0; j<numPixels; j++ ){
-  //loop over frequencies
-        for(short int f=0; f<numFreq; f++){
+      //loop over frequencies
+      for(short int f=0; f<numFreq; f++){
 
-    //position of this direction in array
-          unsigned int pos = f + j*numFreq + site_intensities.size() - numFreq*numPixels;
+        //the intensities of this frequency are contiguous in the site arrays
+        float* intensityIn = it->get_intensityIn(f);
+        float* intensityOut = it->get_intensityOut(f);
 
-    //add all intensity to site_intensities in correct place
-          site_intensities[pos] += it->get_intensityIn(f,j) + it->get_intensityOut(f,j);
+        //loop over directions
+        for( unsigned int j=0; j<numPixels; j++ ){
 
-    //now that they are stored, set them to zero
-          it->set_intensityOut(f,j,0.0);
-          it->set_intensityIn(f,j,0.0);
+          //add all intensity to site_intensities in correct place
+          site_intensities[ start + f + j*numFreq ] += intensityIn[j] + intensityOut[j];
 
-        }//for all freq
-      }//for all pixels
+          //now that they are stored, set them to zero
+          intensityOut[j] = 0.0;
+          intensityIn[j] = 0.0;
+
+        }//for all pixels
+      }//for all freq
     }//if
   }//for all sites
 
@@ -3687,6 +3890,99 @@ void SimpleX::return_ballistic_intensities(){
 
 #endif
 
+/****  Store the intensities of ballistic sites per neighbour  ****/
+//In incremental triangulation most sites keep their neighbours, these
+//sites can get their intensities back without interpolation
+void SimpleX::store_neighbour_intensities( const vector<unsigned long int>& sites_to_store ){
+
+  neigh_intens_ids.clear();
+  neigh_intens_offsets.clear();
+  neigh_intens_neigh.clear();
+  neigh_intens.clear();
+
+  neigh_intens_offsets.push_back( 0 );
+
+  for( unsigned long int i=0; i<sites_to_store.size(); i++ ){
+
+    Site& site = sites[ sites_to_store[i] ];
+
+    neigh_intens_ids.push_back( site.get_vertex_id() );
+
+    //vertex ids of the neighbours, in the order of the intensities
+    for( unsigned int j=0; j<site.get_numNeigh(); j++ ){
+      neigh_intens_neigh.push_back( sites[ site.get_neighId(j) ].get_vertex_id() );
+    }
+    neigh_intens_offsets.push_back( neigh_intens_neigh.size() );
+
+    //all intensity is outgoing, as in store_intensities()
+    for( short int f=0; f<numFreq; f++ ){
+      const float* intensityIn = site.get_intensityIn(f);
+      const float* intensityOut = site.get_intensityOut(f);
+      for( unsigned int j=0; j<site.get_numNeigh(); j++ ){
+	neigh_intens.push_back( intensityIn[j] + intensityOut[j] );
+      }
+    }
+
+  }//for all sites to store
+
+}
+
+/****  Return the intensities stored per neighbour  ****/
+//Sites that are still ballistic and have the same neighbours in the same
+//order get the intensities they had before the triangulation, replacing
+//the ones interpolated by return_ballistic_intensities()
+void SimpleX::return_neighbour_intensities(){
+
+  unsigned long int numReturned = 0;
+
+  for( unsigned long int i=0; i<neigh_intens_ids.size(); i++ ){
+
+    //find the site with this vertex id
+    Site tmp;
+    tmp.set_vertex_id( neigh_intens_ids[i] );
+    SITE_ITERATOR it = lower_bound( sites.begin(), sites.end(), tmp, compare_vertex_id_site );
+    if( it == sites.end() || it->get_vertex_id() != neigh_intens_ids[i] ||
+	it->get_process() != COMM_RANK || it->get_border() || !it->get_ballistic() ){
+      continue;
+    }
+
+    //check that the neighbours are unchanged
+    unsigned long int start = neigh_intens_offsets[i];
+    unsigned int numNeigh = neigh_intens_offsets[i+1] - start;
+    bool same = ( numNeigh == it->get_numNeigh() );
+    for( unsigned int j=0; same && j<numNeigh; j++ ){
+      if( sites[ it->get_neighId(j) ].get_vertex_id() != neigh_intens_neigh[ start + j ] ){
+	same = 0;
+      }
+    }
+    if( !same ){
+      continue;
+    }
+
+    for( short int f=0; f<numFreq; f++ ){
+      float* intensityIn = it->get_intensityIn(f);
+      float* intensityOut = it->get_intensityOut(f);
+      for( unsigned int j=0; j<numNeigh; j++ ){
+	intensityOut[j] = neigh_intens[ start*numFreq + f*numNeigh + j ];
+	intensityIn[j] = 0.0;
+      }
+    }
+    numReturned++;
+
+  }//for all stored sites
+
+  if( COMM_RANK == 0 ){
+    simpleXlog << "  Returned the intensities of " << numReturned << " of " << neigh_intens_ids.size() 
+	       << " ballistic sites without interpolation " << endl;
+  }
+
+  neigh_intens_ids.clear();
+  neigh_intens_offsets.clear();
+  neigh_intens_neigh.clear();
+  neigh_intens.clear();
+
+}
+
 
 /****  Check which sites are ballistic and which not  ****/
 //Only used in case of combined transport
@@ -3795,21 +4091,11 @@ void SimpleX::check_ballistic_sites(){
 	    }//for all freq
 	  }//for all pixels
 
-	  //delete the intensity arrays
-	  it->delete_intensityOut(numFreq);
-	  it->delete_intensityIn(numFreq);
-
-	  //create new intensity arrays with correct size
-	  it->create_intensityIn( numFreq, it->get_numNeigh() );
-	  it->create_intensityOut( numFreq, it->get_numNeigh() );
-
+	  //empty the intensity arrays, they have room for both transport types
+	  it->clear_intensities( numFreq, site_pixels( *it ) );
 
 	  //match the neighbours of this site
 
-	  //make sure outgoing is empty before creating it
-	  it->delete_outgoing();
-	  it->create_outgoing( it->get_numNeigh() );
-
 	  //loop over all neighbours of this site
 	  for(unsigned int j=0; j<it->get_numNeigh(); j++){
 	    //check if site has bee nfound
@@ -3858,11 +4144,7 @@ void SimpleX::check_ballistic_sites(){
 
     unsigned long int site_id = sites_to_store[i];
 
-    sites[ site_id ].delete_intensityOut(numFreq);
-    sites[ site_id ].delete_intensityIn(numFreq);
-
-    sites[ site_id ].create_intensityOut( numFreq, number_of_directions );
-    sites[ site_id ].create_intensityIn( numFreq, number_of_directions );
+    sites[ site_id ].clear_intensities( numFreq, site_pixels( sites[ site_id ] ) );
 
   }
 
@@ -4376,7 +4658,7 @@ void SimpleX::send_neighbour_properties(){
     unsigned int index = send_list[i];
     //only create the straight array in case the site is ballistic
     if( sites[index].get_ballistic() ){
-      sites[ index ].create_straight();
+      sites[ index ].clear_straight();
     }
   }
 
@@ -4630,19 +4912,22 @@ void SimpleX::send_intensities(){
       //index in the sites vector
       unsigned int index = send_list[i];
 
-      //loop over all directions
-
       //in case of ballistic transport, intensity has size of number of neighbours;
       //in case of direction conserving transport, intensity has 
       //the size of the tesselation of the unit sphere
       numPixels = ( sites[index].get_ballistic() ) ? sites[index].get_numNeigh() : number_of_directions;
 
+      //loop over frequencies
+      for(short int f=0; f<numFreq;f++){
 
-      for( unsigned int j=0; j<numPixels; j++ ){
-	//loop over frequencies
-	for(short int f=0; f<numFreq;f++){
+	//the intensities of this frequency are contiguous in the site arrays
+	float* intensityIn = sites[index].get_intensityIn(f);
+	float* intensityOut = sites[index].get_intensityOut(f);
+
+	//loop over all directions
+	for( unsigned int j=0; j<numPixels; j++ ){
 	  //if the site holds intensity, it needs to be send 
-	  if( sites[index].get_intensityIn( f,j ) > 0.0 || sites[index].get_intensityOut( f,j ) > 0.0  ){
+	  if( intensityIn[j] > 0.0 || intensityOut[j] > 0.0  ){
 
 	    //assign the relevant properties that need to be send 
 	    //to ensure fast communication
@@ -4670,25 +4955,25 @@ void SimpleX::send_intensities(){
 	    //frequency bin
 	    temp.set_freq_bin(f);
 	    //incoming intensity
-	    temp.set_intensityIn( sites[index].get_intensityIn( f,j ) );
+	    temp.set_intensityIn( intensityIn[j] );
 	    //ougoing intensity
-	    temp.set_intensityOut( sites[index].get_intensityOut( f,j ) );
+	    temp.set_intensityOut( intensityOut[j] );
 
 	    //store the information in vector
 	    sites_to_send.push_back(temp);
 
 	    //photons will be on other proc, so remove them here 
 	    //to conserve photons
-	    sites[index].set_intensityIn( f,j, 0.0 ); 
-	    sites[index].set_intensityOut( f,j, 0.0 );
+	    intensityIn[j] = 0.0; 
+	    intensityOut[j] = 0.0;
 
 	    //keep track of the number of sites to send to
 	    //which proc
 	    nsend_local[ sites[index].get_process() ]++;
 
 	  }//if site holds intensity
-	}//for all freq
-      }//for all pixels/neighbours
+	}//for all pixels/neighbours
+      }//for all freq
 
       i++;
 
@@ -5341,17 +5626,11 @@ void SimpleX::send_site_ballistics( const vector< unsigned long int >& sites_to_
 
 	    site_it->set_ballistic(1);
 
-	    //delete the intensity arrays
-	    site_it->delete_intensityOut(numFreq);
-	    site_it->delete_intensityIn(numFreq);
-
-	    //create new intensity arrays with correct size
-	    site_it->create_intensityIn( numFreq, site_it->get_numNeigh() );
-	    site_it->create_intensityOut( numFreq, site_it->get_numNeigh() );
+	    //empty the intensity arrays, they have room for both transport types
+	    site_it->clear_intensities( numFreq, site_pixels( *site_it ) );
 
-	    //create new straight array
-	    site_it->delete_straight();
-	    site_it->create_straight();
+	    //empty the straight array
+	    site_it->clear_straight();
 
 
 	  }//if site not visited yet
@@ -5374,16 +5653,8 @@ void SimpleX::send_site_ballistics( const vector< unsigned long int >& sites_to_
 	  //if received site is not ballistic, change size of intensity vector
 	  site_it->set_ballistic( 0 );
 
-	  //delete the intensity arrays
-	  site_it->delete_intensityOut(numFreq);
-	  site_it->delete_intensityIn(numFreq);
-
-	  //create new intensity arrays with correct size
-	  site_it->create_intensityIn( numFreq, number_of_directions );
-	  site_it->create_intensityOut( numFreq, number_of_directions );
-
-	  //straight array no longer needed
-	  //site_it->delete_straight();
+	  //empty the intensity arrays, they have room for both transport types
+	  site_it->clear_intensities( numFreq, site_pixels( *site_it ) );
 
 	  found = 1;
 
@@ -6851,8 +7122,6 @@ double SimpleX::update_temperature( Site& site, const vector<double>& N_ion, con
 //Calculate the 
 vector<double> SimpleX::solve_rate_equation( Site& site ){
 
-  static int count = 0;
-  
   //calculate number density and optical depth at beginning of time step
   double n_H = ( (double) site.get_n_HI() + (double) site.get_n_HII() ) * UNIT_D;
 
@@ -6877,7 +7146,7 @@ vector<double> SimpleX::solve_rate_equation( Site& site ){
   //in case of ballistic transport, intensity has size of number of neighbours;
   //in case of direction conserving transport, intensity has 
   //the size of the tesselation of the unit sphere
-  numPixels = ( site.get_ballistic() ) ? site.get_numNeigh() : number_of_directions;
+  unsigned int numPixels = ( site.get_ballistic() ) ? site.get_numNeigh() : number_of_directions;
 
 
   for( unsigned int j=0; j < numPixels; j++) {
@@ -7288,8 +7557,6 @@ vector<double> SimpleX::solve_rate_equation( Site& site ){
 	}//if photoionsation equilibrium
       }//for all steps
 
-      count++;
-
       //calculate the number of outgoing photons after the subcycling
       for(short int f=0; f<numFreq; f++){
 
@@ -7383,7 +7650,7 @@ void SimpleX::source_transport( Site& site ){
       //loop over frequencies
       for(short int f=0; f<numFreq; f++){
         double inten = (double) site.get_flux(f) * UNIT_T/site.get_numNeigh();
-        sites[ site.get_neighId(j) ].addRadiationDiffOut( f, site.get_outgoing(j), (float) inten ); 
+        deposit_intensityOut( site.get_neighId(j), f, site.get_outgoing(j), (float) inten ); 
       }
     }
     //total_inten += (double) it->get_flux() * UNIT_T * UNIT_I;
@@ -7391,7 +7658,7 @@ void SimpleX::source_transport( Site& site ){
   }else{
     //in case of direction conserving transport and combined transport, intensity has 
     //the size of the tesselation of the unit sphere
-    numPixels = number_of_directions;
+    unsigned int numPixels = number_of_directions;
     for( unsigned int m=0; m<numPixels; m++ ){
       //unsigned int m = 0;
       //double inten = (double) it->get_flux()* UNIT_T;
@@ -7410,7 +7677,7 @@ void SimpleX::source_transport( Site& site ){
 	    //loop over frequencies
             for(short int f=0; f<numFreq; f++){
               double inten = (double) site.get_flux(f) * UNIT_T/numPixels;
-              sites[neigh].addRadiationDiffOut( f, j, (float) inten );
+              deposit_intensityOut( neigh, f, j, (float) inten );
             }
           } 
         }
@@ -7423,7 +7690,7 @@ void SimpleX::source_transport( Site& site ){
 	//add the radiation in the same direction bin
         for(short int f=0; f<numFreq; f++){
           double inten = (double) site.get_flux(f) * UNIT_T/numPixels;
-          sites[ neigh ].addRadiationDiffOut( f, m, (float) inten ); 
+          deposit_intensityOut( neigh, f, m, (float) inten ); 
         }
       }
 
@@ -7448,7 +7715,7 @@ void SimpleX::diffuse_transport( Site& site, vector<double>& N_out_total ){
 	//loop over frequencies
         for(short int f=0; f<numFreq; f++){
           double inten = N_out_total[f]/site.get_numNeigh();
-          sites[ neigh ].addRadiationDiffIn( f, site.get_outgoing(j), (float) inten ); 
+          deposit_intensityIn( neigh, f, site.get_outgoing(j), (float) inten ); 
         }
 
       }else{
@@ -7514,7 +7781,7 @@ void SimpleX::diffuse_transport( Site& site, vector<double>& N_out_total ){
           for(short int f=0; f<numFreq;f++){
 	    //intensity to send out
             double inten = N_out_total[f]/site.get_numNeigh();
-            sites[ neigh ].addRadiationDiffIn( f,  dir_to_use[n], (float) inten/dir_to_use.size() );
+            deposit_intensityIn( neigh, f,  dir_to_use[n], (float) inten/dir_to_use.size() );
           }
         }//for all neighbours to use
         dir_to_use.clear();
@@ -7526,7 +7793,7 @@ void SimpleX::diffuse_transport( Site& site, vector<double>& N_out_total ){
   }else{
     //in case of direction conserving transport and combined transport, intensity has 
     //the size of the tesselation of the unit sphere
-    numPixels = number_of_directions;
+    unsigned int numPixels = number_of_directions;
     for( unsigned int m=0; m<numPixels; m++ ){
       //unsigned int m = 0;
       //double inten = (double) it->get_flux()* UNIT_T;
@@ -7546,7 +7813,7 @@ void SimpleX::diffuse_transport( Site& site, vector<double>& N_out_total ){
             for(short int f=0; f<numFreq; f++){
 	      //double inten = (double) site.get_flux(f) * UNIT_T/numPixels;
               double inten = (double) N_out_total[f]/numPixels;
-              sites[neigh].addRadiationDiffIn( f, j, (float) inten );
+              deposit_intensityIn( neigh, f, j, (float) inten );
             }
           } 
         }
@@ -7560,7 +7827,7 @@ void SimpleX::diffuse_transport( Site& site, vector<double>& N_out_total ){
         for(short int f=0; f<numFreq; f++){
 	  //double inten = (double) site.get_flux(f) * UNIT_T/numPixels;
           double inten = (double) N_out_total[f]/numPixels;
-          sites[ neigh ].addRadiationDiffIn( f, m, (float) inten ); 
+          deposit_intensityIn( neigh, f, m, (float) inten ); 
         }
       }
 
@@ -7576,7 +7843,7 @@ void SimpleX::non_diffuse_transport( Site& site, vector<double>& N_out_total ) {
   //in case of ballistic transport, intensity has size of number of neighbours;
   //in case of direction conserving transport, intensity has 
   //the size of the tesselation of the unit sphere
-  numPixels = ( site.get_ballistic() )? site.get_numNeigh() : number_of_directions;
+  unsigned int numPixels = ( site.get_ballistic() )? site.get_numNeigh() : number_of_directions;
 
   //determine N_in_total
   vector<double> N_in_total(numFreq, 0.0);
@@ -7618,7 +7885,7 @@ void SimpleX::non_diffuse_transport( Site& site, vector<double>& N_out_total ) {
 	      //intensity to send out, get correct part from all added intensities
               double inten = (N_in_total[f] > 0.0) ? N_out_total[f] * ( (double) site.get_intensityOut( f,j ) / N_in_total[f] ) : 0.0;
               inten /= double(site.get_numStraight( j ));
-              sites[ neigh ].addRadiationDiffIn( f, neighIdLoc, (float) inten );
+              deposit_intensityIn( neigh, f, neighIdLoc, (float) inten );
             }
 
           }else{
@@ -7685,7 +7952,7 @@ void SimpleX::non_diffuse_transport( Site& site, vector<double>& N_out_total ) {
 		//intensity to send out, get correct part from all added intensities
                 double inten = (N_in_total[f] > 0.0) ? N_out_total[f] * ( (double) site.get_intensityOut( f,j ) / N_in_total[f] ) : 0.0;
                 inten /= double(site.get_numStraight( j ));
-                sites[ neigh ].addRadiationDiffIn( f,  dir_to_use[n], (float) inten/dir_to_use.size() );
+                deposit_intensityIn( neigh, f,  dir_to_use[n], (float) inten/dir_to_use.size() );
               }
             }//for all neighbours to use
             dir_to_use.clear();
@@ -7723,7 +7990,7 @@ void SimpleX::non_diffuse_transport( Site& site, vector<double>& N_out_total ) {
                   for(short int f=0; f<numFreq;f++){
                     double inten = (N_in_total[f] > 0.0) ? N_out_total[f] * ( (double) site.get_intensityOut( f,j ) / N_in_total[f] ) : 0.0;
                     inten /= double(site.get_numStraight( site.get_outgoing(j) ));
-                    sites[neigh].addRadiationDiffIn( f, n, (float) inten );
+                    deposit_intensityIn( neigh, f, n, (float) inten );
                   }//for all freq
                 } 
               }
@@ -7737,7 +8004,7 @@ void SimpleX::non_diffuse_transport( Site& site, vector<double>& N_out_total ) {
               for(short int f=0; f<numFreq;f++){
                 double inten = (N_in_total[f] > 0.0) ? N_out_total[f] * ( (double) site.get_intensityOut( f,j ) / N_in_total[f] ) : 0.0;
                 inten /= double(site.get_numStraight( site.get_outgoing(j) ));
-                sites[neigh].addRadiationDiffIn( f, j, (float) inten );
+                deposit_intensityIn( neigh, f, j, (float) inten );
               }//for all freq
 
             }//if neighbour is ballistic
@@ -7830,7 +8097,7 @@ void SimpleX::non_diffuse_transport( Site& site, vector<double>& N_out_total ) {
                   for(short int f=0; f<numFreq;f++){
                     double inten = (N_in_total[f] > 0.0) ? N_out_total[f] * ( (double) site.get_intensityOut( f,j ) / N_in_total[f] ) : 0.0;
                     inten /= double(num_straight);
-                    sites[neigh].addRadiationDiffIn( f, n, (float) inten );
+                    deposit_intensityIn( neigh, f, n, (float) inten );
                   }
                 } 
               }
@@ -7844,7 +8111,7 @@ void SimpleX::non_diffuse_transport( Site& site, vector<double>& N_out_total ) {
               for(short int f=0; f<numFreq;f++){
                 double inten = (N_in_total[f] > 0.0) ? N_out_total[f] * ( (double) site.get_intensityOut( f,j ) / N_in_total[f] ) : 0.0;
                 inten /= double(num_straight);
-                sites[neigh].addRadiationDiffIn( f, j, (float) inten );
+                deposit_intensityIn( neigh, f, j, (float) inten );
               }
             }//if neighbour is ballistic
           }//for all straight
@@ -7876,6 +8143,61 @@ void SimpleX::non_diffuse_transport( Site& site, vector<double>& N_out_total ) {
 
 
 
+//add intensity to the ingoing intensity of a site. In a threaded sweep
+//the intensity is stored per slice of the sending and of the receiving
+//site, so no two threads write to the same site
+void SimpleX::deposit_intensityIn( const unsigned long long int& site_id, const short int& f, const unsigned int& id, const float& inten ){
+
+#ifdef _OPENMP
+  if( threaded_sweep ){
+    depositsIn[ sweep_slice[ omp_get_thread_num() ] ][ site_id/slice_size ].push_back( Deposit_Intensity( site_id, f, id, inten ) );
+    return;
+  }
+#endif
+
+  sites[ site_id ].addRadiationDiffIn( f, id, inten );
+
+}
+
+//add intensity to the outgoing intensity of a site, see deposit_intensityIn()
+void SimpleX::deposit_intensityOut( const unsigned long long int& site_id, const short int& f, const unsigned int& id, const float& inten ){
+
+#ifdef _OPENMP
+  if( threaded_sweep ){
+    depositsOut[ sweep_slice[ omp_get_thread_num() ] ][ site_id/slice_size ].push_back( Deposit_Intensity( site_id, f, id, inten ) );
+    return;
+  }
+#endif
+
+  sites[ site_id ].addRadiationDiffOut( f, id, inten );
+
+}
+
+//add the intensities stored during a threaded sweep to the sites.
+//Every receiving slice takes the stored intensities in the order of
+//the sending slices. These hold increasing site indices, so every site 
+//receives its intensities in the same order as in a sweep by one 
+//thread, and the result does not depend on the number of threads
+void SimpleX::apply_deposits( vector< vector< vector< Deposit_Intensity > > >& deposits, const bool& out ){
+
+#pragma omp parallel for schedule(static,1) num_threads(numSlices)
+  for( int slice=0; slice<(int)numSlices; slice++ ){
+    for( unsigned int from=0; from<numSlices; from++ ){
+      vector< Deposit_Intensity >& list = deposits[from][slice];
+      for( vector< Deposit_Intensity >::iterator it=list.begin(); it!=list.end(); it++ ){
+        if(out){
+          sites[ it->get_site_id() ].addRadiationDiffOut( it->get_freq_bin(), it->get_id(), it->get_intensity() );
+        }else{
+          sites[ it->get_site_id() ].addRadiationDiffIn( it->get_freq_bin(), it->get_id(), it->get_intensity() );
+        }
+      }
+      //keep the memory for the next sweep
+      list.clear();
+    }
+  }
+
+}
+
 void SimpleX::radiation_transport( const unsigned int& run ){
 
   double t0 = MPI_Wtime();
@@ -7901,6 +8223,22 @@ void SimpleX::radiation_transport( const unsigned int& run ){
     }
   }//if run
 
+  //the sites are divided in contiguous slices, one for every thread
+  numSlices = 1;
+#ifdef _OPENMP
+  numSlices = omp_get_max_threads();
+#endif
+  unsigned long int numSites_local = sites.size();
+  slice_size = ( numSites_local + numSlices - 1 )/numSlices;
+  if( slice_size == 0 ){
+    slice_size = 1;
+  }
+  if( numSlices > 1 && depositsIn.size() != numSlices ){
+    sweep_slice.assign( numSlices, 0 );
+    depositsIn.assign( numSlices, vector< vector< Deposit_Intensity > >( numSlices ) );
+    depositsOut.assign( numSlices, vector< vector< Deposit_Intensity > >( numSlices ) );
+  }
+
   // if( COMM_RANK == 0)
   //   cerr << endl; 
 
@@ -7915,11 +8253,26 @@ void SimpleX::radiation_transport( const unsigned int& run ){
 
     //Do all sources
     //double total_inten = 0.0;
-    for( SITE_ITERATOR it=sites.begin(); it!=sites.end(); it++ ){
-      if( it->get_source() ){
-        source_transport( *it );
-      }//if flux
-    }//for all sites
+    threaded_sweep = ( numSlices > 1 );
+#pragma omp parallel for schedule(static,1) num_threads(numSlices)
+    for( int slice=0; slice<(int)numSlices; slice++ ){
+#ifdef _OPENMP
+      if( threaded_sweep ){
+        sweep_slice[ omp_get_thread_num() ] = slice;
+      }
+#endif
+      SITE_ITERATOR begin = sites.begin() + min( slice*slice_size, numSites_local );
+      SITE_ITERATOR end = sites.begin() + min( (slice+1)*slice_size, numSites_local );
+      for( SITE_ITERATOR it=begin; it!=end; it++ ){
+        if( it->get_source() ){
+          source_transport( *it );
+        }//if flux
+      }//for all sites
+    }//for all slices
+    threaded_sweep = 0;
+    if( numSlices > 1 ){
+      apply_deposits( depositsOut, 1 );
+    }
 
     //double source_flux;
     //MPI_Allreduce(&total_inten,&source_flux,1,MPI_DOUBLE,MPI_SUM, MPI_COMM_WORLD );
@@ -7941,38 +8294,57 @@ void SimpleX::radiation_transport( const unsigned int& run ){
     //   cerr << " (" << COMM_RANK << ") Total number of photons sent: " << source_flux << " total recombinations: " << recombinations << endl;
     // }
 
-    //redistribute the photons
-    for( SITE_ITERATOR it=sites.begin(); it!=sites.end(); it++ ){
-      if( !it->get_border() && it->get_process() == COMM_RANK ) {
-
-        //solve the rate equation to determine ionisations and recombinations
-        vector<double> N_out = solve_rate_equation( *it );
-
-        if(!diffuseTransport){
-          //transport photons with ballistic transport or DCT
-          non_diffuse_transport( *it, N_out );
-        } else {
-          //transport photons diffusely
-          diffuse_transport( *it, N_out );
-        }
+    //redistribute the photons, every thread does the sites in its own slice,
+    //the intensity sent to other sites is added after all threads are done
+    threaded_sweep = ( numSlices > 1 );
+#pragma omp parallel for schedule(static,1) num_threads(numSlices)
+    for( int slice=0; slice<(int)numSlices; slice++ ){
+#ifdef _OPENMP
+      if( threaded_sweep ){
+        sweep_slice[ omp_get_thread_num() ] = slice;
+      }
+#endif
+      SITE_ITERATOR begin = sites.begin() + min( slice*slice_size, numSites_local );
+      SITE_ITERATOR end = sites.begin() + min( (slice+1)*slice_size, numSites_local );
+      for( SITE_ITERATOR it=begin; it!=end; it++ ){
+        if( !it->get_border() && it->get_process() == COMM_RANK ) {
+
+          //solve the rate equation to determine ionisations and recombinations
+          vector<double> N_out = solve_rate_equation( *it );
+
+          if(!diffuseTransport){
+            //transport photons with ballistic transport or DCT
+            non_diffuse_transport( *it, N_out );
+          } else {
+            //transport photons diffusely
+            diffuse_transport( *it, N_out );
+          }
 
-      }//if not in border   
-    }//for all sites
+        }//if not in border   
+      }//for all sites
+    }//for all slices
+    threaded_sweep = 0;
+    if( numSlices > 1 ){
+      apply_deposits( depositsIn, 0 );
+    }
 
     double total_diffuse_proc=0.0;
-    for( SITE_ITERATOR it=sites.begin(); it!=sites.end(); it++ ){
+#pragma omp parallel for schedule(static) num_threads(numSlices)
+    for( long int i=0; i<(long int)numSites_local; i++ ){
+
+      Site& site = sites[i];
 
       //in case of ballistic transport, intensity has size of number of neighbours;
       //in case of direction conserving transport, intensity has 
       //the size of the tesselation of the unit sphere
-      numPixels = ( it->get_ballistic() ) ? it->get_numNeigh() : number_of_directions;
+      unsigned int numPixels = ( site.get_ballistic() ) ? site.get_numNeigh() : number_of_directions;
 
       for( unsigned int j=0; j<numPixels; j++ ) { 
         for(short int f=0; f<numFreq; f++){
 	        //double inten = (double) it->get_intensityIn(j) + (double) it->get_intensityOut(j);
 	        //float inten = it->get_intensityIn(f,j);
-          it->set_intensityOut( f, j, it->get_intensityIn(f,j) );
-          it->set_intensityIn( f, j, 0.0 );
+          site.set_intensityOut( f, j, site.get_intensityIn(f,j) );
+          site.set_intensityIn( f, j, 0.0 );
 
         }
         //total_diffuse_proc += (double) it->get_intensityOut(0,j);
@@ -8453,14 +8825,11 @@ void SimpleX::clear_temporary(){
   for( SITE_ITERATOR it=sites.begin(); it!=sites.end(); it++ ){
 
     it->delete_flux();
-    it->delete_straight();
-    it->delete_neighId();
-    it->delete_intensityIn(numFreq);
-    it->delete_intensityOut(numFreq);
-    it->delete_outgoing();
 
   }//for all sites
 
+  site_arrays.clear();
+
   simplices.clear();
   send_list.clear();
 
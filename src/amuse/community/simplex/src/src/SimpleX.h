@@ -44,6 +44,10 @@ along with SimpleX.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifndef NOMPI
 #include "mpi.h"
 #endif
@@ -120,6 +124,12 @@ class SimpleX{
     //! Number of points in the boundary is variable borderSites.
     void create_boundary();
 
+    //! Put the boundary of the previous triangulation back in the vertices vector
+
+    //! Used for incremental triangulation, so that the subboxes
+    //! that did not change can keep their simplices
+    void restore_boundary();
+
 
     //!Create octree containing all vertices
 
@@ -149,6 +159,14 @@ class SimpleX{
     //! to avoid memory issues when this number would be increased
     void compute_triangulation();
 
+    //! Determine which subboxes on this proc have to be retriangulated
+
+    //! A subbox is retriangulated if one of the vertices that moved, 
+    //! was added or was removed since the previous triangulation lies
+    //! (before or after the move) inside the region that was triangulated
+    //! for that subbox. The simplices of all other subboxes are reused.
+    void find_changed_subboxes();
+
     //! Create the sites array on which radiative transfer is performed
 
     //! From the list of simplices the vertices relevant for this proc are selected and
@@ -186,6 +204,13 @@ class SimpleX{
     //! in the computational domain
     void compute_neighbours();
 
+    //! Number of intensity entries reserved for a site
+
+    //! Ballistic sites need one entry per neighbour, direction conserving sites
+    //! one per direction bin. In combined transport sites can switch, so they
+    //! get room for both.
+    unsigned int site_pixels( const Site& site ) const;
+
 
     //! Compute the volume of the Voronoi cell
 
@@ -243,6 +268,16 @@ class SimpleX{
     //! Return the intensities to ballistic sites
     void return_ballistic_intensities();
 
+    //! Store the intensities of ballistic sites per neighbour
+
+    //! Used for incremental triangulation. Sites whose neighbours are the
+    //! same after the triangulation get these intensities back unchanged,
+    //! instead of the ones interpolated on the unit sphere tesselation
+    void store_neighbour_intensities( const vector< unsigned long int >& sites_to_store );
+
+    //! Return the intensities stored per neighbour to sites with unchanged neighbours
+    void return_neighbour_intensities();
+
     //! Check which sites are ballistic and which not
     //! according to user specified switch
 
@@ -379,6 +414,15 @@ class SimpleX{
     //! Redistribute intensity: actual radiative transport
     void non_diffuse_transport( Site& site, vector<double>& N_out_total );
 
+    //! Add intensity to the ingoing intensity array of a site, or store it if the sweep is threaded
+    void deposit_intensityIn( const unsigned long long int& site_id, const short int& f, const unsigned int& id, const float& inten );
+
+    //! Add intensity to the outgoing intensity array of a site, or store it if the sweep is threaded
+    void deposit_intensityOut( const unsigned long long int& site_id, const short int& f, const unsigned int& id, const float& inten );
+
+    //! Add the intensities stored by the threads to the sites
+    void apply_deposits( vector< vector< vector< Deposit_Intensity > > >& deposits, const bool& out );
+
     //! Call to do radiative transfer
     void radiation_transport( const unsigned int& run );
 
@@ -421,6 +465,9 @@ class SimpleX{
     //! List of sites for doing radiative transfer
     vector< Site > sites;
 
+    //! Neighbour and intensity arrays of all sites, the sites hold offsets into these
+    Site_Arrays site_arrays;
+
     //! Vector holding the domain decomposition
     vector< unsigned int > dom_dec;
 
@@ -442,6 +489,26 @@ class SimpleX{
 
     //! List of simplices that results from the QHull call
     vector< Simpl > simplices;
+
+    //! Simplices of every subbox on this proc from the previous triangulation, by vertex id
+    vector< vector< Simpl > > subbox_simplices;
+    //! Region that was triangulated for every subbox on this proc (x, y and z minimum and maximum)
+    vector< double > subbox_bounds;
+    //! Subboxes on this proc that need to be retriangulated
+    vector< bool > subbox_changed;
+    //! Old and new coordinates of vertices that moved since the previous triangulation
+    vector< float > moved_positions;
+    //! Boundary vertices of the previous triangulation (master proc only)
+    vector< Vertex > border_vertices;
+
+    //! Vertex ids of the ballistic sites whose intensities were stored per neighbour
+    vector< unsigned long long int > neigh_intens_ids;
+    //! Offsets of these sites in neigh_intens_neigh
+    vector< unsigned long int > neigh_intens_offsets;
+    //! Vertex ids of the neighbours of these sites
+    vector< unsigned long long int > neigh_intens_neigh;
+    //! Intensities of these sites, per site numFreq blocks of numNeigh entries
+    vector< float > neigh_intens;
     //! Temporary list of neutral number densities that are read in
     vector< float > temp_n_HI_list;
     //! Temporary list of ionised number densities that are read in
@@ -542,6 +609,14 @@ class SimpleX{
     unsigned int*** maps;          //!< Array to hold the mappings between direction bins
     unsigned int number_of_directions; //!< Number of discretizations of the unit sphere for DCT
     unsigned int number_of_orientations;//!< Number of random rotations of the DCT discretization
+    unsigned int numSlices;        //!< Number of contiguous slices of sites, one for every OpenMP thread
+    unsigned long int slice_size;  //!< Number of sites in a slice
+    bool threaded_sweep;           //!< Store intensity sent to other sites instead of adding it?
+    bool incremental_triangulation; //!< Only retriangulate subboxes in which vertices moved?
+    bool full_triangulation;       //!< Retriangulate all subboxes at the next triangulation?
+    vector< unsigned int > sweep_slice; //!< Slice that each thread is sweeping
+    vector< vector< vector< Deposit_Intensity > > > depositsIn;  //!< Intensities for intensityIn per sending and receiving slice
+    vector< vector< vector< Deposit_Intensity > > > depositsOut; //!< Intensities for intensityOut per sending and receiving slice
 };
 
 #endif
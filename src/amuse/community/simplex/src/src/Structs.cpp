@@ -176,10 +176,8 @@ Site::Site(){
     source = 0;
 
     flux = NULL; 
-    neighId = NULL;
-    intensityIn = NULL;
-    intensityOut = NULL;
-    outgoing = NULL;  
+    neigh_offset = 0;
+    pixel_offset = 0;
 
 }
 
@@ -236,17 +234,60 @@ Site& Site::operator=(const Site_Update& p2){
 
 void Site::addRadiationDiffIn(const short int& f, const unsigned int& id, const double& intensity) {
 
-  double intensity_old = (double) intensityIn[f][id];
-  double intensity_new = intensity_old + intensity;
-  intensityIn[f][id] = (float) intensity_new;
+  float& inten = arrays->intensityIn[ f*arrays->get_numPixels() + pixel_offset + id ];
+  double intensity_new = (double) inten + intensity;
+  inten = (float) intensity_new;
 
 }
 
 void Site::addRadiationDiffOut(const short int& f, const unsigned int& id, const double& intensity) {
 
-  double intensity_old = (double) intensityOut[f][id];
-  double intensity_new = intensity_old + intensity;
-  intensityOut[f][id] = (float) intensity_new;
+  float& inten = arrays->intensityOut[ f*arrays->get_numPixels() + pixel_offset + id ];
+  double intensity_new = (double) inten + intensity;
+  inten = (float) intensity_new;
+
+}
+
+void Site::clear_intensities( const short int& numFreq, const unsigned int& numPixels ){
+
+  for( short int f=0; f<numFreq; f++ ){
+    float* in = get_intensityIn(f);
+    float* out = get_intensityOut(f);
+    for( unsigned int j=0; j<numPixels; j++ ){
+      in[j] = 0.0;
+      out[j] = 0.0;
+    }
+  }
+
+}
+
+Site_Arrays* Site::arrays = NULL;
+
+void Site_Arrays::create( const unsigned long long int& numNeighbours, const unsigned long long int& numPixels_, const short int& numFreq_ ){
+
+  numPixels = numPixels_;
+  numFreq = numFreq_;
+
+  neighId.assign( numNeighbours, 0 );
+  straight.assign( numNeighbours*MAX_STRAIGHT, 0 );
+  numStraight.assign( numNeighbours, 0 );
+  outgoing.assign( numPixels, 0 );
+  intensityIn.assign( numPixels*numFreq, 0.0 );
+  intensityOut.assign( numPixels*numFreq, 0.0 );
+
+}
+
+void Site_Arrays::clear(){
+
+  numPixels = 0;
+  numFreq = 0;
+
+  vector< unsigned int >().swap( neighId );
+  vector< unsigned char >().swap( straight );
+  vector< unsigned char >().swap( numStraight );
+  vector< unsigned char >().swap( outgoing );
+  vector< float >().swap( intensityIn );
+  vector< float >().swap( intensityOut );
 
 }
 
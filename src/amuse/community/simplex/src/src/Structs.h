@@ -144,6 +144,45 @@ class Simpl{
 
 };
 
+//! Maximum number of straightest neighbours stored per neighbour (the dimension)
+#define MAX_STRAIGHT 3
+
+//! Class that holds the neighbour and intensity arrays of all sites
+
+//! The arrays of all sites are stored back to back (compressed sparse row),
+//! a site only holds the offsets of its entries. Neighbour id's and straightest
+//! neighbours are indexed by neighbour offset, outgoing directions and intensities
+//! by pixel offset. Intensities are stored per frequency bin:
+//! intensityIn[ f*numPixels + pixel offset + j ]
+class Site_Arrays{
+
+ public:
+
+  Site_Arrays(){ numPixels = 0; numFreq = 0; }
+  ~Site_Arrays(){};
+
+  //! allocate the arrays for numNeighbours neighbour entries and numPixels_ pixels per frequency
+  void create( const unsigned long long int& numNeighbours, const unsigned long long int& numPixels_, const short int& numFreq_ );
+  //! free all arrays
+  void clear();
+
+  //! total number of pixels per frequency bin
+  const unsigned long long int& get_numPixels() const{ return numPixels; }
+
+  vector< unsigned int > neighId;      //!< Id's of the neighbours of all sites
+  vector< unsigned char > straight;    //!< MAX_STRAIGHT straightest neighbours per neighbour entry
+  vector< unsigned char > numStraight; //!< Number of straightest neighbours per neighbour entry
+  vector< unsigned char > outgoing;    //!< Neighbour associated with every direction
+  vector< float > intensityIn;         //!< Incoming intensities of all sites
+  vector< float > intensityOut;        //!< Outgoing intensities of all sites
+
+ private:
+
+  unsigned long long int numPixels;    //!< Number of pixels per frequency bin
+  short int numFreq;                   //!< Number of frequency bins
+
+};
+
 //! Class that holds information needed to do radiation transport between vertices
 class Site : public Vertex {
 
@@ -248,100 +287,60 @@ class Site : public Vertex {
   //! get the flux in the site
   const float& get_flux(const short int& f) const{ return flux[f]; }
 
-  //! delete the neighId array
-  void delete_neighId(){
-    if(neighId){
-      delete [] neighId;
-      neighId = NULL;
-    }
+  //! set the offsets of the neighbour and pixel entries of this site in the site arrays
+  void set_offsets( const unsigned long long int& neigh_off, const unsigned long long int& pixel_off ){ 
+    neigh_offset = neigh_off; 
+    pixel_offset = pixel_off; 
   }
-  //! create the neighId array
-  void create_neighId(){ neighId = new unsigned int[numNeigh]; }
+  //! get the offset of the neighbour entries in the site arrays
+  const unsigned long long int& get_neigh_offset() const{ return neigh_offset; }
+  //! get the offset of the pixel entries in the site arrays
+  const unsigned long long int& get_pixel_offset() const{ return pixel_offset; }
+
   //! store the id's of neighbours of site
-  void set_neighId(const unsigned int& j, const unsigned int& id){ neighId[j]=id; }
+  void set_neighId(const unsigned int& j, const unsigned int& id){ arrays->neighId[ neigh_offset + j ] = id; }
   //! get the id of neighbour of site
-  const unsigned int& get_neighId(const unsigned int& i) const{ return neighId[i]; }
-
-  //! create straight array
-  void create_straight(){
-    straight.resize( numNeigh );
-  } 
-  //! delete straight array
-  void delete_straight(){
-    straight.clear();
+  const unsigned int& get_neighId(const unsigned int& i) const{ return arrays->neighId[ neigh_offset + i ]; }
+
+  //! empty the straight lists of all neighbours
+  void clear_straight(){
+    for( unsigned int j=0; j<numNeigh; j++ ){
+      arrays->numStraight[ neigh_offset + j ] = 0;
+    }
   }
   //! assign the id's of straightest neighbours to straight array
-  void add_straight( const unsigned int& _neigh, const unsigned int& _neighNr ){ straight[ _neigh ].push_back( _neighNr);}
-  //! remove id's of straightest neighbours to straight array
-  void remove_straight( const unsigned int& _neigh, const unsigned int& _neighNr ){ straight[ _neigh ].erase( straight[ _neigh ].begin() + _neighNr );}
-  //! get the id's of the most straight neighbours of the site
-  const unsigned int& get_straight(const unsigned int& j, const short int& i) const{ return straight[j][i]; }
-  //! get the length of the straight vector
-  short int get_numStraight(const unsigned char& i) { return (short) straight[i].size(); }
-
-  //! delete the intensityIn array 
-  void delete_intensityIn(const short int numFreq){
-    if(intensityIn){
-      for(short int f=0; f<numFreq;f++){
-        delete [] intensityIn[f];
-      }
-      delete [] intensityIn;
-      intensityIn = NULL;
+  void add_straight( const unsigned int& _neigh, const unsigned int& _neighNr ){ 
+    unsigned char& n = arrays->numStraight[ neigh_offset + _neigh ];
+    if( n < MAX_STRAIGHT ){
+      arrays->straight[ (neigh_offset + _neigh)*MAX_STRAIGHT + n ] = (unsigned char) _neighNr;
+      n++;
     }
   }
-  //! create the Intensity array
-  void create_intensityIn( const short int& numFreq, const unsigned int& directions ){ 
-    intensityIn = new float*[numFreq];
-    for(short int f=0;f<numFreq;f++){
-      intensityIn[f] = new float[directions];
-      for( unsigned int j=0; j<directions; j++ ){
-        intensityIn[f][j] = 0.0;
-      }
-    }
-  }  
+  //! get the id's of the most straight neighbours of the site
+  unsigned int get_straight(const unsigned int& j, const short int& i) const{ return arrays->straight[ (neigh_offset + j)*MAX_STRAIGHT + i ]; }
+  //! get the length of the straight vector
+  short int get_numStraight(const unsigned char& i) const{ return (short) arrays->numStraight[ neigh_offset + i ]; }
+
+  //! set the first numPixels intensities of all frequencies to zero
+  void clear_intensities( const short int& numFreq, const unsigned int& numPixels );
   //! store
-  void set_intensityIn(const short int& f, const unsigned int& j, const float& in){ intensityIn[f][j]=in; }
+  void set_intensityIn(const short int& f, const unsigned int& j, const float& in){ arrays->intensityIn[ f*arrays->get_numPixels() + pixel_offset + j ] = in; }
   //! get the id of neighbour of site
-  const float& get_intensityIn(const short int& f, const unsigned int& i) const{ return intensityIn[f][i]; }
-
-  //! delete the intensityIn array 
-  void delete_intensityOut(const short int& numFreq){
-    if(intensityOut){
-      for(short int f=0; f<numFreq; f++){
-        delete [] intensityOut[f];
-      }
-      delete [] intensityOut;
-      intensityOut = NULL;
-    }
-  }
-  //! create the IntensityOut array
-  void create_intensityOut( const short int& numFreq, const unsigned int& directions ){ 
-    intensityOut = new float*[numFreq];
-    for(short int f=0; f<numFreq; f++){
-      intensityOut[f] = new float[directions]; 
-      for( unsigned int j=0; j<directions; j++ ){
-        intensityOut[f][j] = 0.0;
-      }
-    }
-  }  
+  const float& get_intensityIn(const short int& f, const unsigned int& i) const{ return arrays->intensityIn[ f*arrays->get_numPixels() + pixel_offset + i ]; }
+  //! get pointer to the incoming intensities of frequency f
+  float* get_intensityIn( const short int& f ){ return &arrays->intensityIn[ f*arrays->get_numPixels() + pixel_offset ]; }
+
   //! store
-  void set_intensityOut(const short int& f, const unsigned int& j, const float& out){ intensityOut[f][j]=out; }
+  void set_intensityOut(const short int& f, const unsigned int& j, const float& out){ arrays->intensityOut[ f*arrays->get_numPixels() + pixel_offset + j ] = out; }
   //! get the id of neighbour of site
-  const float& get_intensityOut(const short int& f, const unsigned int& i) const{ return intensityOut[f][i]; }
+  const float& get_intensityOut(const short int& f, const unsigned int& i) const{ return arrays->intensityOut[ f*arrays->get_numPixels() + pixel_offset + i ]; }
+  //! get pointer to the outgoing intensities of frequency f
+  float* get_intensityOut( const short int& f ){ return &arrays->intensityOut[ f*arrays->get_numPixels() + pixel_offset ]; }
 
-  //! delete the outgoing vector 
-  void delete_outgoing(){
-    if(outgoing){
-      delete [] outgoing;
-      outgoing = NULL;
-    }
-  }
-  //! create the outgoing vector
-  void create_outgoing( const unsigned int& directions ){ outgoing = new unsigned char[directions]; }  
   //! set outgoing directions for solid angles
-  void set_outgoing( const unsigned int& entry, const unsigned char& value ){ outgoing[entry] = value; }
+  void set_outgoing( const unsigned int& entry, const unsigned char& value ){ arrays->outgoing[ pixel_offset + entry ] = value; }
   //! get outgoing directions for solid angles
-  unsigned char& get_outgoing( const unsigned int& entry ){ return outgoing[entry]; }
+  unsigned char& get_outgoing( const unsigned int& entry ){ return arrays->outgoing[ pixel_offset + entry ]; }
 
   //! add the intensity from neighbour in ingoing intensity array
   void addRadiationDiffIn(const short int& f, const unsigned int& id, const double& intensity);
@@ -366,13 +365,12 @@ class Site : public Vertex {
 
   float* flux;                      //!< Flux of the site in case its a source
 
-  unsigned int* neighId;                     //!< vector holding id's of the neighbours of the vertex
-  vector< vector< unsigned int > > straight; //!< Straightest neighbours
-  float** intensityIn;                       //!< Array of incoming intensities
-  float** intensityOut;                      //!< Array of outgoing intensities
-  unsigned char* outgoing;                   //!< Array of numbers associating the angular direction (48 in total) with a vertex
+  unsigned long long int neigh_offset; //!< Offset of the neighbour entries in the site arrays
+  unsigned long long int pixel_offset; //!< Offset of the intensity and outgoing entries in the site arrays
 
  public:
+  static Site_Arrays* arrays;          //!< Neighbour and intensity arrays of all sites
+
   Site& operator=(const Vertex& p2); 
   Site& operator=(const Site_Update& p2); 
 
@@ -508,6 +506,33 @@ class Send_Neigh{
 
 };
 
+//! Class that holds intensity sent to a site from an OpenMP thread,
+//! it is added to the site after the sweep
+class Deposit_Intensity{
+
+ public:
+
+  Deposit_Intensity( const unsigned long long int& _site_id, const short int& _freq_bin,
+		     const unsigned int& _id, const float& _intensity ) :
+    site_id(_site_id), id(_id), freq_bin(_freq_bin), intensity(_intensity) {};
+  ~Deposit_Intensity(){};
+
+  //! site that receives the intensity
+  const unsigned long long int& get_site_id() const{ return site_id; }
+  //! direction bin or neighbour entry in the intensity array
+  const unsigned int& get_id() const{ return id; }
+  const short int& get_freq_bin() const{ return freq_bin; }
+  const float& get_intensity() const{ return intensity; }
+
+ private:
+
+  unsigned long long int site_id;
+  unsigned int id;
+  short int freq_bin;
+  float intensity;
+
+};
+
 //! Class that holds information of updated sites
 class Site_Update{
 
@@ -175,6 +175,10 @@ int AMUSE_SimpleX::add_site(long *id, double x,double y,double z,double rho,
     
     sites.push_back( tempSite );
     numSites++;
+
+    //the new id might be one of the boundary vertices, so the next 
+    //triangulation can't be incremental
+    full_triangulation = 1;
     
     // cerr << " Add site " << tempSite.get_vertex_id() << " x: " << tempSite.get_x() << " y: " << tempSite.get_y() << " z: " << tempSite.get_z() 
     //      << " n_HI: " << tempSite.get_n_HI() << " n_HII: " << tempSite.get_n_HII() << endl;
@@ -199,6 +203,7 @@ int AMUSE_SimpleX::remove_site(long id) {
    if(p->get_vertex_id() == (unsigned long long int) id){
      if (p->get_process() == COMM_RANK){
        p->set_neigh_dist(-1.);
+       mark_moved( p->get_x(), p->get_y(), p->get_z() );
        return 1;
      }
    }  
@@ -327,6 +332,27 @@ int AMUSE_SimpleX::initialize(double current_time) {
   
 }
 
+//keep track of the vertex positions that changed since the previous triangulation
+void AMUSE_SimpleX::mark_moved(const float& x, const float& y, const float& z){
+
+  if( incremental_triangulation ){
+    moved_positions.push_back( x );
+    moved_positions.push_back( y );
+    moved_positions.push_back( z );
+  }
+
+}
+
+//a site is moved to a new position, both its old and its new position are changed
+void AMUSE_SimpleX::mark_moved(const Site& site, const double& x, const double& y, const double& z){
+
+  if( site.get_x() != (float) x || site.get_y() != (float) y || site.get_z() != (float) z ){
+    mark_moved( site.get_x(), site.get_y(), site.get_z() );
+    mark_moved( (float) x, (float) y, (float) z );
+  }
+
+}
+
 //set up a simulation
 int AMUSE_SimpleX::setup_simplex(){
 
@@ -406,9 +432,23 @@ int AMUSE_SimpleX::reinitialize(){
     //store the intensities in big array
     store_intensities();
 
+    //in incremental mode, only subboxes in which vertices moved are
+    //retriangulated. This needs the boundary of the previous triangulation,
+    //which can't be used if sites were added, their ids might clash
+    int local_full = (int) full_triangulation;
+    int full = 1;
+    MPI_Allreduce( &local_full, &full, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD );
+    bool incremental = incremental_triangulation && !full;
+
     //in this case, also store the ballistic intensities
     vector< unsigned long int > sites_to_store = get_ballistic_sites_to_store();
 
+    //most sites keep their neighbours in incremental mode,
+    //so keep their intensities as they are
+    if( incremental ){
+      store_neighbour_intensities( sites_to_store );
+    }
+
     store_ballistic_intensities( sites_to_store );
     sites_to_store.clear();
 
@@ -441,7 +481,11 @@ int AMUSE_SimpleX::reinitialize(){
     if(COMM_RANK == 0){
 
       //set boundary around unity domain
-      create_boundary();
+      if( incremental ){
+        restore_boundary();
+      }else{
+        create_boundary();
+      }
       
       // Sort the vertices
       sort( vertices.begin(), vertices.end(), compare_vertex_id_vertex );
@@ -478,6 +522,11 @@ int AMUSE_SimpleX::reinitialize(){
       send_site_intensities();
     }
             
+    //find the subboxes that changed since the previous triangulation
+    if( incremental ){
+      find_changed_subboxes();
+    }
+
     //compute the triangulation
     compute_triangulation();
 
@@ -493,6 +542,10 @@ int AMUSE_SimpleX::reinitialize(){
     compute_site_properties();
     
     compute_physics( 1 );
+
+    if( incremental ){
+      return_neighbour_intensities();
+    }
     
     remove_border_simplices();
       
@@ -611,10 +664,13 @@ int AMUSE_SimpleX::get_mean_intensity(int id, double *mean_intensity){
         //the size of the tesselation of the unit sphere
         numPixels = ( p->get_ballistic() ) ? p->get_numNeigh() : number_of_directions;
         
-        for(unsigned int i=0; i<numPixels; i++){
-          short int start = (rec_rad) ? 1 : 0;
-          for(short int f=start;f<numFreq;f++){
-            meanIntensity += p->get_intensityOut(f,i) + p->get_intensityIn(f,i);
+        short int start = (rec_rad) ? 1 : 0;
+        for(short int f=start;f<numFreq;f++){
+          //the intensities of a frequency are contiguous in the site arrays
+          const float* intensityIn = p->get_intensityIn(f);
+          const float* intensityOut = p->get_intensityOut(f);
+          for(unsigned int i=0; i<numPixels; i++){
+            meanIntensity += intensityOut[i] + intensityIn[i];
           }
         }
         *mean_intensity = meanIntensity;
@@ -638,9 +694,10 @@ int AMUSE_SimpleX::get_diffuse_intensity(int id, double *diffuse_intensity){
         double diffuseIntensity = 0.0;
         numPixels = ( p->get_ballistic() ) ? p->get_numNeigh() : number_of_directions;
         
+        const float* intensityIn = p->get_intensityIn(0);
+        const float* intensityOut = p->get_intensityOut(0);
         for(unsigned int i=0; i<numPixels; i++){
-          short int f = 0;
-          diffuseIntensity += p->get_intensityOut(f,i) + p->get_intensityIn(f,i);
+          diffuseIntensity += intensityOut[i] + intensityIn[i];
         }
         *diffuse_intensity = diffuseIntensity;
         return 1;
@@ -727,6 +784,7 @@ int AMUSE_SimpleX::set_site(int id, double x, double y, double z, double rho,
     tmp.set_vertex_id((unsigned long long) id);
     p = lower_bound(sites.begin(), sites.end(), tmp, compare_vertex_id_site);
     if(p->get_vertex_id() == (unsigned long long int)id){
+        mark_moved( *p, x, y, z );
         p->set_x(x);
         p->set_y(y);
         p->set_z(z);
@@ -757,6 +815,7 @@ int AMUSE_SimpleX::set_position(int id, double x, double y, double z){
     tmp.set_vertex_id((unsigned long long) id);
     p = lower_bound(sites.begin(), sites.end(), tmp, compare_vertex_id_site);
     if(p->get_vertex_id() == (unsigned long long int)id){
+        mark_moved( *p, x, y, z );
         p->set_x(x);
         p->set_y(y);
         p->set_z(z);
@@ -1252,6 +1311,14 @@ int get_number_of_border_sites(int *ts){
   return SimpleXGrid->get_numBorderSites(ts);
 }
 
+int set_incremental_triangulation(int ts){
+  return SimpleXGrid->set_incremental_triangulation(ts);
+}
+
+int get_incremental_triangulation(int *ts){
+  return SimpleXGrid->get_incremental_triangulation(ts);
+}
+
 
 int set_thermal_evolution(int ts){
   return (*SimpleXGrid).set_heat_cool(ts);
@@ -75,11 +75,15 @@ class AMUSE_SimpleX : public SimpleX {
   
   int set_numBorderSites(int ts){ borderSites=ts;return 0;}
   int get_numBorderSites(int *ts){ *ts=borderSites;return 0;}
+  int set_incremental_triangulation(int ts){ incremental_triangulation=ts;return 0;}
+  int get_incremental_triangulation(int *ts){ *ts=incremental_triangulation;return 0;}
 
 
  private:
 
   void read_parameters();
+  void mark_moved(const float& x, const float& y, const float& z);
+  void mark_moved(const Site& site, const double& x, const double& y, const double& z);
   double total_time;     
   int syncflag; 
 };
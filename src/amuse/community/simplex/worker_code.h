@@ -0,0 +1,120 @@
+#include "stdbool.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int set_hilbert_order(int hilbert_order);
+
+int commit_particles();
+
+int get_time(double * time);
+
+int set_time(double time);
+
+int get_incremental_triangulation(int * incremental_triangulation_flag);
+
+int get_collisional_ionization(int * collisional_ionisation_flag);
+
+int new_particle(int * index_of_the_particle, double x, double y, double z, double rho, double flux, double xion, double u, double metallicity);
+
+int get_recombination_radiation(int * recombination_radiation_flag);
+
+int set_timestep(double timestep);
+
+int get_mean_intensity(int index_of_the_particle, double * Js);
+
+int get_blackbody_spectrum(int * blackbody_spectrum_flag);
+
+int set_flux(int index_of_the_particle, double flux);
+
+int evolve_model(double time);
+
+int get_timestep(double * timestep);
+
+int get_source_Teff(double * sourceTeff);
+
+int set_blackbody_spectrum(int blackbody_spectrum_flag);
+
+int get_flux(int index_of_the_particle, double * flux);
+
+int get_diffuse_intensity(int index_of_the_particle, double * Jd);
+
+int get_metal_cooling(int * metal_cooling_flag);
+
+int get_thermal_evolution(int * thermal_evolution_flag);
+
+int set_incremental_triangulation(int incremental_triangulation_flag);
+
+int set_number_of_border_sites(int number_of_border_sites);
+
+int set_source_Teff(double sourceTeff);
+
+int delete_particle(int index_of_the_particle);
+
+int set_recombination_radiation(int recombination_radiation_flag);
+
+int get_simplex_data_directory(char * * data_directory);
+
+int set_ionisation(int index_of_the_particle, double xion);
+
+int get_box_size(double * box_size);
+
+int set_simplex_output_directory(char * output_path);
+
+int set_state(int index_of_the_particle, double x, double y, double z, double rho, double flux, double xion, double u, double metallicity);
+
+int get_state(int index_of_the_particle, double * x, double * y, double * z, double * rho, double * flux, double * xion, double * u, double * metallicity);
+
+int set_number_frequency_bins(int number_of_freq_bins);
+
+int recommit_particles();
+
+int set_box_size(double box_size);
+
+int set_internal_energy(int index_of_the_particle, double u);
+
+int get_internal_energy(int index_of_the_particle, double * u);
+
+int set_metal_cooling(int metal_cooling_flag);
+
+int set_density(int index_of_the_particle, double rho);
+
+int set_metallicity(int index_of_the_particle, double metallicity);
+
+int get_ionisation(int index_of_the_particle, double * xion);
+
+int get_dinternal_energy_dt(int index_of_the_particle, double * du_dt);
+
+int set_simplex_data_directory(char * data_directory);
+
+int set_dinternal_energy_dt(int index_of_the_particle, double du_dt);
+
+int get_number_of_border_sites(int * number_of_border_sites);
+
+int get_density(int index_of_the_particle, double * rho);
+
+int get_number_frequency_bins(int * number_of_freq_bins);
+
+int cleanup_code();
+
+int get_hilbert_order(int * hilbert_order);
+
+int recommit_parameters();
+
+int initialize_code();
+
+int set_collisional_ionization(int collisional_ionisation_flag);
+
+int set_thermal_evolution(int thermal_evolution_flag);
+
+int get_position(int index_of_the_particle, double * x, double * y, double * z);
+
+int set_position(int index_of_the_particle, double x, double y, double z);
+
+int get_metallicity(int index_of_the_particle, double * metallicity);
+
+int commit_parameters();
+#ifdef __cplusplus
+}
+#endif
+
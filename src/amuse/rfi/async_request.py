@@ -1,4 +1,5 @@
 import select
+import random
 import operator
 
 from . import channel
@@ -276,6 +277,109 @@ class baseOperatorASyncRequest(DependentASyncRequest):
             return self._operator(first)
         return self._operator(first,second)
 
+class ASyncBatchRequest(AbstractASyncRequest):
+    """
+    Collects asynchronous calls to the same code, the calls are send
+    to the code in one message when the first result is needed. The
+    batch is send after the previous request of the code is finished.
+    """
+    def __init__(self, channel, previous=None):
+        self.channel = channel
+        self.previous = previous
+        self.calls = []
+        self.request = None
+        self.result_handlers = []
+        self._result_index = None
+
+    def add_call(self, function_id, dtype_to_arguments, handle_as_array):
+        if not self.can_add_call():
+            raise Exception("cannot add a call to a batch that is already send")
+        index = len(self.calls)
+        self.calls.append((function_id, dtype_to_arguments, handle_as_array))
+        return ASyncBatchedCallRequest(self, index)
+
+    def can_add_call(self):
+        return self.request is None
+
+    def send(self):
+        if self.request is None:
+            if self.previous is not None:
+                self.previous.waitall()
+                self.previous = None
+            call_id = random.randint(0, 1000)
+            self.channel.send_batch(call_id, self.calls)
+            self.request = self.channel.nonblocking_recv_batch(call_id, self.calls)
+            for h in self.result_handlers:
+                self.request.add_result_handler(*h)
+        return self.request
+
+    @property
+    def is_finished(self):
+        if self.request is None:
+            return False
+        return self.request.is_finished
+
+    @property
+    def is_result_set(self):
+        if self.request is None:
+            return False
+        return self.request.is_result_set
+
+    def wait(self):
+        self.send().wait()
+
+    def is_result_available(self):
+        return self.send().is_result_available()
+
+    def result(self):
+        return self.send().result()
+
+    def add_result_handler(self, function, args = ()):
+        if self.request is None:
+            self.result_handlers.append([function,args])
+        else:
+            self.request.add_result_handler(function,args)
+
+    def is_mpi_request(self):
+        return self.send().is_mpi_request()
+
+    def is_socket_request(self):
+        return self.send().is_socket_request()
+
+    def waits_for(self):
+        if self.is_finished:
+            return None
+        return self.send()
+
+class ASyncBatchedCallRequest(DependentASyncRequest):
+    """
+    Request for the result of one call in a batch
+    """
+    def __init__(self, batch, index):
+        self._result_index=None
+        self.request=None
+        self.parent=batch
+        self.index=index
+        self.result_handlers = []
+
+        def handler(arg):
+            results=arg()
+            if self.index < len(results):
+                self.request=FakeASyncRequest(results[self.index])
+                for h in self.result_handlers:
+                    self.request.add_result_handler(*h)
+            return results
+
+        batch.add_result_handler(handler)
+
+    @property
+    def batch(self):
+        return self.parent
+
+    @property
+    def results(self):
+        return [self.result()]
+
 class ASyncRequest(AbstractASyncRequest):
         
     def __init__(self, request, message, comm, header):
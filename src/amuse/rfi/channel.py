@@ -12,6 +12,8 @@ import time
 
 import socket
 import array
+import mmap
+import tempfile
 import logging
 import shlex
 
@@ -380,6 +382,10 @@ class ClientSideMPIMessage(MPIMessage):
 
 MAPPING = {}
 
+# function id of a message with several calls, see handle_batch in the
+# generated C code
+BATCH_FUNCTION_ID = -2
+
 def pack_array(array, length, dtype):
     if dtype == 'string':
         if length == 1 and len(array) > 0 and isinstance(array[0], str):
@@ -744,7 +750,62 @@ Please do a 'make clean; make' in the root directory.
     
     def is_polling_supported(self):
         return False
-        
+    
+    def is_batching_supported(self):
+        return False
+    
+    def pack_batch(self, calls):
+        """
+        Packs the arguments of several calls into one message. The integers
+        start with the number of calls and a header for every call (function
+        id, call count and the number of values of every type), the
+        arguments of the calls follow in order.
+        """
+        headers = [len(calls)]
+        arrays = {}
+        call_count = 0
+        for function_id, dtype_to_arguments, handle_as_array in calls:
+            count = self.determine_length_from_data(dtype_to_arguments)
+            headers.extend((function_id, count))
+            for dtype, attrname in AbstractMessage().dtype_to_message_attribute():
+                if dtype in dtype_to_arguments:
+                    array = pack_array(dtype_to_arguments[dtype], count, dtype)
+                else:
+                    array = []
+                headers.append(len(array))
+                arrays.setdefault(dtype, []).append(array)
+            call_count += count
+        
+        arrays['int32'].insert(0, headers)
+        dtype_to_arguments = {}
+        for dtype, values in arrays.items():
+            if dtype == 'string':
+                dtype_to_arguments[dtype] = [x for array in values for x in array]
+            else:
+                dtype_to_arguments[dtype] = numpy.concatenate(values).astype(dtype)
+        return call_count, dtype_to_arguments
+    
+    def unpack_batch(self, message, calls):
+        """
+        Splits the reply of a batch into the results of the calls.
+        """
+        ints = message.ints
+        number_of_replies = ints[0]
+        offsets = [1 + len(calls) * 8, 0, 0, 0, 0, 0]
+        results = []
+        for i, (function_id, dtype_to_arguments, handle_as_array) in enumerate(calls[:number_of_replies]):
+            header = ints[1 + i * 8:1 + (i + 1) * 8]
+            count = header[1]
+            dtype_to_result = {}
+            for j, (dtype, attrname) in enumerate(message.dtype_to_message_attribute()):
+                values = getattr(message, attrname)[offsets[j]:offsets[j] + header[j + 2]]
+                offsets[j] += header[j + 2]
+                if count > 1 or handle_as_array:
+                    dtype_to_result[dtype] = unpack_array(values, count, dtype)
+                else:
+                    dtype_to_result[dtype] = values
+            results.append(dtype_to_result)
+        return results
     
     def determine_length_from_data(self, dtype_to_arguments):
         def get_length(type_and_values):
@@ -1503,6 +1564,12 @@ class SocketMessage(AbstractMessage):
         
         # logger.debug("receiving message")
         
+        flags, header = self.receive_header(socket)
+        self.receive_content(socket, header)
+        
+        # logger.debug("message received")
+        
+    def receive_header(self, socket):
         header_bytes = self._receive_all(44, socket)
         
         flags = numpy.frombuffer(header_bytes, dtype="b", count=4, offset=0)
@@ -1528,6 +1595,9 @@ class SocketMessage(AbstractMessage):
         # number of calls in this message
         self.call_count = header[3]
         
+        return flags, header
+        
+    def receive_content(self, socket, header):
         # number of X's in TOTAL
         number_of_ints = header[4]
         number_of_longs = header[5]
@@ -1545,8 +1615,6 @@ class SocketMessage(AbstractMessage):
         self.strings = self.receive_strings(socket, number_of_strings)
         self.encoded_units = self.receive_doubles(socket, number_of_units)
         
-        # logger.debug("message received")
-        
 
     def receive_ints(self, socket, count):
         if count > 0:
@@ -1623,7 +1691,7 @@ class SocketMessage(AbstractMessage):
             strings = []
             begin = 0
             for size in lengths:
-                strings.append(data_bytes[begin:begin + size].decode('utf-8'))
+                strings.append(bytes(data_bytes[begin:begin + size]).decode('utf-8'))
                 begin = begin + size + 1
 
             return strings
@@ -1636,7 +1704,20 @@ class SocketMessage(AbstractMessage):
     
     def send(self, socket):
         
-        flags = numpy.array([self.big_endian, self.error, len(self.encoded_units) > 0, False], dtype="b")
+        self.send_header(socket)
+
+        self.send_ints(socket, self.ints)
+        self.send_longs(socket, self.longs)
+        self.send_floats(socket, self.floats)
+        self.send_doubles(socket, self.doubles)
+        self.send_booleans(socket, self.booleans)
+        self.send_strings(socket, self.strings)
+        self.send_doubles(socket, self.encoded_units)
+        
+        # logger.debug("message send")
+    
+    def send_header(self, socket, content_in_shared_memory=False):
+        flags = numpy.array([self.big_endian, self.error, len(self.encoded_units) > 0, content_in_shared_memory], dtype="b")
 
         header = numpy.array([
             self.call_id,
@@ -1657,16 +1738,6 @@ class SocketMessage(AbstractMessage):
 
         socket.sendall(header.tostring())
 
-        self.send_ints(socket, self.ints)
-        self.send_longs(socket, self.longs)
-        self.send_floats(socket, self.floats)
-        self.send_doubles(socket, self.doubles)
-        self.send_booleans(socket, self.booleans)
-        self.send_strings(socket, self.strings)
-        self.send_doubles(socket, self.encoded_units)
-        
-        # logger.debug("message send")
-    
 
     def send_doubles(self, socket, array):
         if len(array) > 0:
@@ -1737,6 +1808,13 @@ class SocketChannel(AbstractMessageChannel):
     
     
 
+    def new_message(self, *args, **kwargs):
+        return SocketMessage(*args, **kwargs)
+    
+    def worker_arguments(self):
+        """Extra arguments appended to the command line of the worker"""
+        return []
+
     @option(sections=("channel",))
     def mpiexec(self):
         """mpiexec with arguments"""
@@ -1836,6 +1914,8 @@ class SocketChannel(AbstractMessageChannel):
         
             #do not initialize MPI inside worker executable
             arguments.append('false')
+        
+        arguments.extend(self.worker_arguments())
             
         logger.debug("starting process with command `%s`, arguments `%s` and environment '%s'", command, arguments, os.environ)
         self.process = Popen(arguments, executable=command, stdin=PIPE, stdout=None, stderr=None, close_fds=True)
@@ -1932,7 +2012,7 @@ class SocketChannel(AbstractMessageChannel):
         if call_count > self.max_message_length:
             self.split_message(call_id, function_id, call_count, dtype_to_arguments, encoded_units)
         else:
-            message = SocketMessage(call_id, function_id, call_count, dtype_to_arguments, encoded_units = encoded_units)
+            message = self.new_message(call_id, function_id, call_count, dtype_to_arguments, encoded_units = encoded_units)
             message.send(self.socket)
 
             self._is_inuse = True
@@ -1950,7 +2030,7 @@ class SocketChannel(AbstractMessageChannel):
             return x
         
         
-        message = SocketMessage()
+        message = self.new_message()
         
         message.receive(self.socket)
 
@@ -1976,7 +2056,7 @@ class SocketChannel(AbstractMessageChannel):
 
 
     def nonblocking_recv_message(self, call_id, function_id, handle_as_array, has_units=False):
-        request = SocketMessage().nonblocking_receive(self.socket)
+        request = self.new_message().nonblocking_receive(self.socket)
     
         def handle_result(function):
             self._is_inuse = False
@@ -2014,7 +2094,188 @@ class SocketChannel(AbstractMessageChannel):
         The MPI channel will split long messages into blocks of size max_message_length.
         """     
         return 1000000
+    
+    def is_batching_supported(self):
+        return True
+    
+    def send_batch(self, call_id, calls):
+        if self.is_inuse():
+            raise exceptions.CodeException("You've tried to send a message to a code that is already handling a message, this is not correct")
+        if self.socket is None:
+            raise exceptions.CodeException("You've tried to send a message to a code that is not running")
+        
+        call_count, dtype_to_arguments = self.pack_batch(calls)
+        message = self.new_message(call_id, BATCH_FUNCTION_ID, call_count)
+        for dtype, attrname in message.dtype_to_message_attribute():
+            setattr(message, attrname, dtype_to_arguments[dtype])
+        message.send(self.socket)
+        
+        self._is_inuse = True
+    
+    def nonblocking_recv_batch(self, call_id, calls):
+        request = self.new_message().nonblocking_receive(self.socket)
+    
+        def handle_result(function):
+            self._is_inuse = False
+    
+            message = function()
 
+            if message.error:
+                # the error message of the failed call is the last string
+                error_message=message.strings[-1] if len(message.strings)>0 else "no error message"
+                if message.call_id != call_id or message.function_id != BATCH_FUNCTION_ID:
+                    self.stop() 
+                    error_message+=" - code probably died, sorry."
+                raise exceptions.CodeException("Error in (asynchronous) communication with worker: " + error_message)
+        
+            if message.call_id != call_id:
+                self.stop()
+                raise exceptions.CodeException('Received reply for call id {0} but expected {1}'.format(message.call_id, call_id))
+    
+            if message.function_id != BATCH_FUNCTION_ID:
+                self.stop()
+                raise exceptions.CodeException('Received reply for function id {0} but expected a batch'.format(message.function_id))
+                
+            return self.unpack_batch(message, calls)
+
+        request.add_result_handler(handle_result)
+    
+        return request
+
+
+class SharedMemoryMessage(SocketMessage):
+    """
+    Message with the header send over the socket and the data
+    arrays stored in memory shared with the worker. Requests are
+    stored in the first half of the shared memory and replies in
+    the second half, each array starts on an 8 byte boundary. 
+    Messages that do not fit are send over the socket.
+    """
+    
+    def __init__(self, shared_memory, *args, **kwargs):
+        SocketMessage.__init__(self, *args, **kwargs)
+        self.shared_memory = shared_memory
+        self.shared_memory_offset = None
+    
+    def align(self, offset):
+        return (offset + 7) & ~7
+    
+    def data_arrays(self):
+        lengths = numpy.array([len(s) for s in self.strings], dtype='int32')
+        if len(self.strings) > 0:
+            chars = (chr(0).join(self.strings)+chr(0)).encode("utf-8")
+            if len(chars) != lengths.sum()+len(lengths):
+                raise Exception("send_strings size mismatch {0} vs {1}".format( len(chars) , lengths.sum()+len(lengths) ))
+        else:
+            chars = b""
+        
+        return [
+            numpy.asarray(self.ints, dtype='int32'),
+            numpy.asarray(self.longs, dtype='int64'),
+            numpy.asarray(self.floats, dtype='f4'),
+            numpy.asarray(self.doubles, dtype='f8'),
+            numpy.asarray(self.booleans, dtype='b'),
+            lengths,
+            numpy.frombuffer(chars, dtype='uint8'),
+            numpy.asarray(self.encoded_units, dtype='f8'),
+        ]
+    
+    def send(self, socket):
+        arrays = self.data_arrays()
+        
+        total = 0
+        for x in arrays:
+            total = self.align(total + x.nbytes)
+        
+        if total > len(self.shared_memory) // 2:
+            SocketMessage.send(self, socket)
+            return
+            
+        offset = 0
+        for x in arrays:
+            self.shared_memory[offset:offset + x.nbytes] = x.view('uint8')
+            offset = self.align(offset + x.nbytes)
+        
+        self.send_header(socket, content_in_shared_memory=True)
+    
+    def receive(self, socket):
+        self.shared_memory_offset = None
+        
+        flags, header = self.receive_header(socket)
+        
+        if flags[3]:
+            self.shared_memory_offset = len(self.shared_memory) // 2
+            
+        self.receive_content(socket, header)
+    
+    def _receive_all(self, nbytes, thesocket):
+        if self.shared_memory_offset is None:
+            return SocketMessage._receive_all(self, nbytes, thesocket)
+        
+        begin = self.shared_memory_offset
+        self.shared_memory_offset = self.align(begin + nbytes)
+        return self.shared_memory[begin:begin + nbytes]
+    
+class SharedMemoryChannel(SocketChannel):
+    """
+    Channel to a worker on the local machine, the data arrays
+    of the messages are exchanged through shared memory and the
+    socket is only used to signal that a message is available.
+    Only supported by workers generated with the C code generator.
+    """
+    
+    def __init__(self, name_of_the_worker, legacy_interface_type=None, interpreter_executable=None, **options):
+        SocketChannel.__init__(self, name_of_the_worker, legacy_interface_type, interpreter_executable, **options)
+        
+        self.shared_memory = None
+        self.shared_memory_filename = None
+    
+    @option(type="int", sections=("channel",))
+    def shared_memory_size(self):
+        """
+        Size in bytes of the memory shared with the worker, half of it is used
+        for the requests and half for the replies. Messages that do not fit
+        are send over the socket.
+        """
+        return 2 ** 25
+    
+    @option(sections=("channel",))
+    def shared_memory_directory(self):
+        """Directory to create the shared memory file in, should be memory backed (tmpfs)"""
+        if os.path.isdir('/dev/shm'):
+            return '/dev/shm'
+        return tempfile.gettempdir()
+    
+    def new_message(self, *args, **kwargs):
+        return SharedMemoryMessage(self.shared_memory, *args, **kwargs)
+    
+    def worker_arguments(self):
+        return [self.shared_memory_filename]
+    
+    def start(self):
+        file_descriptor, self.shared_memory_filename = tempfile.mkstemp(prefix='amuse_', dir=self.shared_memory_directory)
+        try:
+            if hasattr(os, 'posix_fallocate'):
+                os.posix_fallocate(file_descriptor, 0, self.shared_memory_size)
+            else:
+                os.ftruncate(file_descriptor, self.shared_memory_size)
+            memory = mmap.mmap(file_descriptor, self.shared_memory_size)
+        finally:
+            os.close(file_descriptor)
+            
+        self.shared_memory = numpy.ndarray((self.shared_memory_size,), dtype='uint8', buffer=memory)
+        
+        try:
+            SocketChannel.start(self)
+        finally:
+            # the worker maps the file before connecting, so the file 
+            # can be removed as soon as it is started
+            os.remove(self.shared_memory_filename)
+    
+    def stop(self):
+        SocketChannel.stop(self)
+        
+        self.shared_memory = None
 
 class OutputHandler(threading.Thread):
     
@@ -27,8 +27,11 @@ from amuse.rfi.channel import MpiChannel
 from amuse.rfi.channel import MultiprocessingMPIChannel
 from amuse.rfi.channel import DistributedChannel
 from amuse.rfi.channel import SocketChannel
+from amuse.rfi.channel import SharedMemoryChannel
 from amuse.rfi.channel import is_mpd_running
 from amuse.rfi.async_request import DependentASyncRequest
+from amuse.rfi.async_request import ASyncBatchRequest
+from amuse.rfi.async_request import ASyncBatchedCallRequest
 
 try:
     from amuse import config
@@ -152,8 +155,38 @@ class CodeFunction(object):
         
         return request
 
+    def _batched_async_request(self, *arguments_list, **keyword_arguments):
+        dtype_to_values = self.converted_keyword_and_list_arguments( arguments_list, keyword_arguments)
+        
+        handle_as_array = self.must_handle_as_array(dtype_to_values)
+        
+        previous = self.interface.async_request
+        if isinstance(previous, ASyncBatchedCallRequest) and previous.batch.can_add_call():
+            batch = previous.batch
+        else:
+            batch = ASyncBatchRequest(self.interface.channel, previous)
+        
+        request = batch.add_call(self.specification.id, dtype_to_values, handle_as_array)
+        
+        def handle_result(function):
+            try:
+                dtype_to_result = function()
+            except Exception as ex:
+                raise exceptions.CodeException("Exception when calling legacy code '{0}', exception was '{1}'".format(self.specification.name, ex))
+            result=self.converted_results(dtype_to_result, handle_as_array)
+            return result
+            
+        request.add_result_handler(handle_result)
+        
+        return request
+    
+    def must_batch_asynchronous_call(self):
+        return self.interface.batch_asynchronous_calls and self.interface.channel.is_batching_supported()
+    
     def asynchronous(self, *arguments_list, **keyword_arguments):
-        if self.interface.async_request is not None:
+        if self.must_batch_asynchronous_call():
+            request=self._batched_async_request(*arguments_list, **keyword_arguments)
+        elif self.interface.async_request is not None:
             def factory():
               return self._async_request(*arguments_list, **keyword_arguments)
             request=DependentASyncRequest( self.interface.async_request, factory) 
@@ -377,6 +410,34 @@ class legacy_function(object):
         
         raise Exception("No working crc32 implementation found!")
 
+def parallel_legacy_function(function):
+    """Returns a copy of a legacy function, for which the C worker
+    calls the code for all elements of an array in parallel (using
+    OpenMP). Only use this for functions that can be called from
+    several threads at once, like getters that only read the
+    particle data.
+    
+    >>> class LegacyExample(object):
+    ...     @legacy_function
+    ...     def get_mass():
+    ...          specification = LegacyFunctionSpecification()
+    ...          specification.can_handle_array = True
+    ...          return specification
+    ...
+    >>> class ParallelLegacyExample(LegacyExample):
+    ...     get_mass = parallel_legacy_function(LegacyExample.get_mass)
+    ...
+    >>> ParallelLegacyExample.get_mass.specification.can_handle_array_in_parallel
+    True
+    """
+    def specification_function():
+        result = function.specification_function()
+        result.can_handle_array_in_parallel = True
+        return result
+    specification_function.__name__ = function.specification_function.__name__
+    specification_function.__doc__ = function.specification_function.__doc__
+    return legacy_function(specification_function)
+
 def derive_dtype_unit_and_default(value):
     if value is None:
         return None,None,None
@@ -566,6 +627,7 @@ class LegacyFunctionSpecification(object):
         self.dtype_to_input_parameters = {}
         self.dtype_to_output_parameters = {}
         self.can_handle_array = False
+        self.can_handle_array_in_parallel = False
         self.must_handle_array = False
         self.has_units = False
         self.result_doc = ''
@@ -908,12 +970,22 @@ class CodeInterface(OptionalAttributes):
     def stop(self):
         self._stop()
     
-    @option(choices=['mpi','remote','distributed', 'sockets', 'local'], sections=("channel",))
+    @option(choices=['mpi','remote','distributed', 'sockets', 'shared_memory', 'local'], sections=("channel",))
     def channel_type(self):
         return 'mpi'
     
 
 
+    @option(type="boolean", sections=("channel",))
+    def batch_asynchronous_calls(self):
+        """
+        Send successive asynchronous calls to the code in one message,
+        the message is send when the first result is needed. Only
+        supported by C and C++ workers on the sockets and shared_memory
+        channels, on other channels the calls are send one by one.
+        """
+        return False
+
     @option(type="boolean", sections=("channel",))
     def initialize_mpi(self):
         """Is MPI initialized in the code or not. Defaults to True if MPI is available"""
@@ -963,6 +1035,8 @@ class CodeInterface(OptionalAttributes):
             return DistributedChannel
         elif self.channel_type == 'sockets':
             return SocketChannel
+        elif self.channel_type == 'shared_memory':
+            return SharedMemoryChannel
         elif self.channel_type == 'local':
             return LocalChannel
         else:
@@ -1209,6 +1283,9 @@ class CodeFunctionWithUnits(CodeFunction):
         
         return result
     
+    def must_batch_asynchronous_call(self):
+        return False
+    
     def _async_request(self, *arguments_list, **keyword_arguments):
         dtype_to_values, units = self.converted_keyword_and_list_arguments( arguments_list, keyword_arguments)
         encoded_units = self.convert_input_units_to_floats(units)
@@ -40,6 +40,9 @@ HEADER_CODE_STRING = """
 	#include <unistd.h>
 	#include <netinet/tcp.h>
   #include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
 #endif
 #if _POSIX_VERSION >= 1
 #ifndef _POSIX_C_SOURCE
@@ -51,6 +54,7 @@ HEADER_CODE_STRING = """
 
 CONSTANTS_AND_GLOBAL_VARIABLES_STRING = """
 static int ERROR_FLAG = 256;
+static int SHARED_MEMORY_FLAG = 16777216;
 static int HEADER_SIZE = 11; //integers
 
 static int HEADER_FLAGS = 0;
@@ -65,6 +69,10 @@ static int HEADER_BOOLEAN_COUNT = 8;
 static int HEADER_STRING_COUNT = 9;
 static int HEADER_UNITS_COUNT = 10;
 
+/* function id of a message with several calls, see handle_batch */
+static int BATCH_FUNCTION_ID = -2;
+static int BATCH_HEADER_SIZE = 8; //integers
+
 static bool TRUE_BYTE = 1;
 static bool FALSE_BYTE = 0;
 
@@ -72,6 +80,14 @@ static bool mpiIntercom = false;
 
 static int socketfd = 0;
 
+/* memory shared with the python side, when a message has the
+   SHARED_MEMORY_FLAG set the header is send over the socket and the
+   arrays are stored in the segment (requests in the first half, 
+   replies in the second half) */
+static char * shared_memory = 0;
+static size_t shared_memory_size = 0;
+static size_t shared_memory_offset = 0;
+
 static int * header_in;
 static int * header_out;
 
@@ -242,6 +258,120 @@ int mpi_recv_header(MPI_Comm & parent)
 """
 
 FOOTER_CODE_STRING = """
+/* a batch contains several calls in one message, the call count of
+   the message is the sum of the call counts of all calls. the integer
+   array starts with the number of calls followed by a header for every
+   call (function id, call count and the number of integers, longs,
+   floats, doubles, booleans and strings), the arguments of the calls
+   follow in order. the reply has the same layout, the calls after a
+   call that failed are not handled */
+bool handle_batch() {
+  int function_id = header_in[HEADER_FUNCTION_ID];
+  int call_count = header_in[HEADER_CALL_COUNT];
+  int number_of_calls = ints_in[0];
+  int * call_headers = ints_in + 1;
+  int * reply_headers = ints_out + 1;
+  int totals[6] = {1 + number_of_calls * BATCH_HEADER_SIZE, 0, 0, 0, 0, 0};
+  int number_of_replies = 0;
+  bool result = true;
+  
+  int * ints_in_start = ints_in;
+  int * ints_out_start = ints_out;
+  long long int * longs_in_start = longs_in;
+  long long int * longs_out_start = longs_out;
+  float * floats_in_start = floats_in;
+  float * floats_out_start = floats_out;
+  double * doubles_in_start = doubles_in;
+  double * doubles_out_start = doubles_out;
+  bool * booleans_in_start = booleans_in;
+  bool * booleans_out_start = booleans_out;
+  char ** strings_in_start = strings_in;
+  char ** strings_out_start = strings_out;
+  
+  ints_in += totals[0];
+  ints_out += totals[0];
+  
+  for (int i = 0; i < number_of_calls; i++) {
+    int * call_header = call_headers + i * BATCH_HEADER_SIZE;
+    int * reply_header = reply_headers + i * BATCH_HEADER_SIZE;
+    
+    if (call_header[0] == BATCH_FUNCTION_ID) {
+      fprintf(stderr, "a batch cannot contain another batch\\n");
+      header_out[HEADER_FLAGS] = header_out[HEADER_FLAGS] | ERROR_FLAG;
+      break;
+    }
+    
+    header_in[HEADER_FUNCTION_ID] = call_header[0];
+    header_in[HEADER_CALL_COUNT] = call_header[1];
+    header_out[HEADER_INTEGER_COUNT] = 0;
+    header_out[HEADER_LONG_COUNT] = 0;
+    header_out[HEADER_FLOAT_COUNT] = 0;
+    header_out[HEADER_DOUBLE_COUNT] = 0;
+    header_out[HEADER_BOOLEAN_COUNT] = 0;
+    header_out[HEADER_STRING_COUNT] = 0;
+    
+    result = handle_call();
+    
+    reply_header[0] = call_header[0];
+    reply_header[1] = call_header[1];
+    reply_header[2] = header_out[HEADER_INTEGER_COUNT];
+    reply_header[3] = header_out[HEADER_LONG_COUNT];
+    reply_header[4] = header_out[HEADER_FLOAT_COUNT];
+    reply_header[5] = header_out[HEADER_DOUBLE_COUNT];
+    reply_header[6] = header_out[HEADER_BOOLEAN_COUNT];
+    reply_header[7] = header_out[HEADER_STRING_COUNT];
+    number_of_replies++;
+    
+    ints_in += call_header[2];
+    longs_in += call_header[3];
+    floats_in += call_header[4];
+    doubles_in += call_header[5];
+    booleans_in += call_header[6];
+    strings_in += call_header[7];
+    
+    ints_out += reply_header[2];
+    longs_out += reply_header[3];
+    floats_out += reply_header[4];
+    doubles_out += reply_header[5];
+    booleans_out += reply_header[6];
+    strings_out += reply_header[7];
+    
+    for (int j = 0; j < 6; j++) {
+      totals[j] += reply_header[j + 2];
+    }
+    
+    if (!result || (header_out[HEADER_FLAGS] & ERROR_FLAG)) {
+      break;
+    }
+  }
+  
+  ints_in = ints_in_start;
+  ints_out = ints_out_start;
+  longs_in = longs_in_start;
+  longs_out = longs_out_start;
+  floats_in = floats_in_start;
+  floats_out = floats_out_start;
+  doubles_in = doubles_in_start;
+  doubles_out = doubles_out_start;
+  booleans_in = booleans_in_start;
+  booleans_out = booleans_out_start;
+  strings_in = strings_in_start;
+  strings_out = strings_out_start;
+  
+  ints_out[0] = number_of_replies;
+  
+  header_in[HEADER_FUNCTION_ID] = function_id;
+  header_in[HEADER_CALL_COUNT] = call_count;
+  header_out[HEADER_INTEGER_COUNT] = totals[0];
+  header_out[HEADER_LONG_COUNT] = totals[1];
+  header_out[HEADER_FLOAT_COUNT] = totals[2];
+  header_out[HEADER_DOUBLE_COUNT] = totals[3];
+  header_out[HEADER_BOOLEAN_COUNT] = totals[4];
+  header_out[HEADER_STRING_COUNT] = totals[5];
+  
+  return result;
+}
+
 void onexit_mpi(void) {
 #ifndef NOMPI
     int flag = 0;
@@ -284,6 +414,10 @@ void onexit_sockets(void) {
 	closesocket(socketfd);
 #else
 	close(socketfd);
+	if (shared_memory) {
+		munmap(shared_memory, shared_memory_size);
+		shared_memory = 0;
+	}
 #endif
 }
 
@@ -342,44 +476,267 @@ void receive_array_sockets(void *buffer, int length, int file_descriptor, int ra
     }
 }
 
+void open_shared_memory(char * filename) {
+#ifdef WIN32
+    fprintf(stderr, "shared memory channel not supported on windows\\n");
+    exit(1);
+#else
+    struct stat file_info;
+    int file_descriptor = open(filename, O_RDWR);
+
+    if (file_descriptor == -1 || fstat(file_descriptor, &file_info) == -1) {
+        perror("could not open shared memory");
+        exit(1);
+    }
+
+    shared_memory_size = file_info.st_size;
+    shared_memory = (char *) mmap(0, shared_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+
+    if (shared_memory == MAP_FAILED) {
+        perror("could not map shared memory");
+        exit(1);
+    }
+#endif
+}
+
+/* arrays in the shared memory start on an 8 byte boundary */
+size_t shared_memory_align(size_t offset) {
+    return (offset + 7) & ~((size_t) 7);
+}
+
+void receive_array(void *buffer, int length, int rank) {
+    if (rank != 0) {
+        return;
+    }
+
+    if (header_in[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+        memcpy(buffer, shared_memory + shared_memory_offset, length);
+        shared_memory_offset = shared_memory_align(shared_memory_offset + length);
+    } else {
+        receive_array_sockets(buffer, length, socketfd, rank);
+    }
+}
+
+void send_array(void *buffer, int length, int rank) {
+    if (rank != 0) {
+        return;
+    }
+
+    if (header_out[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+        memcpy(shared_memory + shared_memory_offset, buffer, length);
+        shared_memory_offset = shared_memory_align(shared_memory_offset + length);
+    } else {
+        send_array_sockets(buffer, length, socketfd, rank);
+    }
+}
+
+bool reply_fits_in_shared_memory() {
+    size_t total = 0;
+
+    if (!shared_memory) {
+        return false;
+    }
+
+    total += shared_memory_align(header_out[HEADER_INTEGER_COUNT] * sizeof(int));
+    total += shared_memory_align(header_out[HEADER_LONG_COUNT] * sizeof(long long int));
+    total += shared_memory_align(header_out[HEADER_FLOAT_COUNT] * sizeof(float));
+    total += shared_memory_align(header_out[HEADER_DOUBLE_COUNT] * sizeof(double));
+    total += shared_memory_align(header_out[HEADER_BOOLEAN_COUNT] * sizeof(bool));
+    total += shared_memory_align(header_out[HEADER_STRING_COUNT] * sizeof(int));
+    for (int i = 0; i < header_out[HEADER_STRING_COUNT]; i++) {
+        total += strlen(strings_out[i]) + 1;
+    }
+
+    return total <= shared_memory_size / 2;
+}
+
+/* all argument arrays are stored in one block of memory, each array
+   starts on a cache line. blocks of 2MB or more are mapped so that
+   the kernel can back them with huge pages */
+static char * arena = 0;
+static size_t arena_size = 0;
+static bool arena_is_mapped = false;
+
+size_t arena_align(size_t size) {
+    return (size + 63) & ~((size_t) 63);
+}
+
+void * arena_array(size_t * offset, size_t size) {
+    void * result = arena + *offset;
+    *offset += arena_align(size);
+    return result;
+}
+
 void new_arrays(int max_call_count) {
-  ints_in = new int[ max_call_count * MAX_INTS_IN];
-  ints_out = new int[ max_call_count * MAX_INTS_OUT];
+  /* room for the headers of a batch */
+  int max_ints_in = MAX_INTS_IN + BATCH_HEADER_SIZE + 1;
+  int max_ints_out = MAX_INTS_OUT + BATCH_HEADER_SIZE + 1;
+  /* room for the error message of an unknown function */
+  int max_strings_out = MAX_STRINGS_OUT > 0 ? MAX_STRINGS_OUT : 1;
+  size_t offset = 0;
+  
+  arena_size = 0;
+  arena_size += arena_align(max_call_count * max_ints_in * sizeof(int));
+  arena_size += arena_align(max_call_count * max_ints_out * sizeof(int));
+  arena_size += arena_align(max_call_count * MAX_LONGS_IN * sizeof(long long int));
+  arena_size += arena_align(max_call_count * MAX_LONGS_OUT * sizeof(long long int));
+  arena_size += arena_align(max_call_count * MAX_FLOATS_IN * sizeof(float));
+  arena_size += arena_align(max_call_count * MAX_FLOATS_OUT * sizeof(float));
+  arena_size += arena_align(max_call_count * MAX_DOUBLES_IN * sizeof(double));
+  arena_size += arena_align(max_call_count * MAX_DOUBLES_OUT * sizeof(double));
+  arena_size += arena_align(max_call_count * MAX_BOOLEANS_IN * sizeof(bool));
+  arena_size += arena_align(max_call_count * MAX_BOOLEANS_OUT * sizeof(bool));
+  arena_size += arena_align(max_call_count * MAX_STRINGS_IN * sizeof(int));
+  arena_size += arena_align(max_call_count * max_strings_out * sizeof(int));
+  arena_size += arena_align(max_call_count * MAX_STRINGS_IN * sizeof(char *));
+  arena_size += arena_align(max_call_count * max_strings_out * sizeof(char *));
+  
+  arena = 0;
+  arena_is_mapped = false;
+#if !defined(WIN32) && defined(MAP_ANONYMOUS)
+  if (arena_size >= 2097152) {
+    void * block = mmap(0, arena_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+      madvise(block, arena_size, MADV_HUGEPAGE);
+#endif
+      arena = (char *) block;
+      arena_is_mapped = true;
+    }
+  }
+#endif
+  if (!arena) {
+    arena = (char *) malloc(arena_size > 0 ? arena_size : 1);
+    if (!arena) {
+      fprintf(stderr, "could not allocate %lu bytes for the arguments\\n", (unsigned long) arena_size);
+      exit(1);
+    }
+  }
+  
+  ints_in = (int *) arena_array(&offset, max_call_count * max_ints_in * sizeof(int));
+  ints_out = (int *) arena_array(&offset, max_call_count * max_ints_out * sizeof(int));
 
-  longs_in = new long long int[ max_call_count * MAX_LONGS_IN];
-  longs_out = new long long int[ max_call_count * MAX_LONGS_OUT];
+  longs_in = (long long int *) arena_array(&offset, max_call_count * MAX_LONGS_IN * sizeof(long long int));
+  longs_out = (long long int *) arena_array(&offset, max_call_count * MAX_LONGS_OUT * sizeof(long long int));
 
-  floats_in = new float[ max_call_count * MAX_FLOATS_IN];
-  floats_out = new float[ max_call_count * MAX_FLOATS_OUT];
+  floats_in = (float *) arena_array(&offset, max_call_count * MAX_FLOATS_IN * sizeof(float));
+  floats_out = (float *) arena_array(&offset, max_call_count * MAX_FLOATS_OUT * sizeof(float));
 
-  doubles_in = new double[ max_call_count * MAX_DOUBLES_IN];
-  doubles_out = new double[ max_call_count * MAX_DOUBLES_OUT];
+  doubles_in = (double *) arena_array(&offset, max_call_count * MAX_DOUBLES_IN * sizeof(double));
+  doubles_out = (double *) arena_array(&offset, max_call_count * MAX_DOUBLES_OUT * sizeof(double));
   
-  booleans_in = new bool[ max_call_count * MAX_BOOLEANS_IN];
-  booleans_out = new bool[ max_call_count * MAX_BOOLEANS_OUT];
+  booleans_in = (bool *) arena_array(&offset, max_call_count * MAX_BOOLEANS_IN * sizeof(bool));
+  booleans_out = (bool *) arena_array(&offset, max_call_count * MAX_BOOLEANS_OUT * sizeof(bool));
   
-  string_sizes_in = new int[ max_call_count * MAX_STRINGS_IN];
-  string_sizes_out = new int[ max_call_count * MAX_STRINGS_OUT];
+  string_sizes_in = (int *) arena_array(&offset, max_call_count * MAX_STRINGS_IN * sizeof(int));
+  string_sizes_out = (int *) arena_array(&offset, max_call_count * max_strings_out * sizeof(int));
 
-  strings_in = new char *[ max_call_count * MAX_STRINGS_IN];
-  strings_out = new char *[ max_call_count * MAX_STRINGS_OUT];
+  strings_in = (char **) arena_array(&offset, max_call_count * MAX_STRINGS_IN * sizeof(char *));
+  strings_out = (char **) arena_array(&offset, max_call_count * max_strings_out * sizeof(char *));
 }
 
 void delete_arrays() {
-  delete[] ints_in;
-  delete[] ints_out;
-  delete[] longs_in;
-  delete[] longs_out;
-  delete[] floats_in;
-  delete[] floats_out;
-  delete[] doubles_in;
-  delete[] doubles_out;
-  delete[] booleans_in;
-  delete[] booleans_out;
-  delete[] string_sizes_in;
-  delete[] string_sizes_out;
-  delete[] strings_in;
-  delete[] strings_out;
+#if !defined(WIN32) && defined(MAP_ANONYMOUS)
+  if (arena_is_mapped) {
+    munmap(arena, arena_size);
+  } else {
+    free(arena);
+  }
+#else
+  free(arena);
+#endif
+  arena = 0;
+  arena_size = 0;
+}
+
+/* grows max_call_count geometrically, so that alternating small and
+   large calls do not reallocate the arrays every time */
+int grow_arrays(int call_count, int max_call_count) {
+  int new_max_call_count = 2 * max_call_count;
+  
+  if (new_max_call_count < call_count) {
+    new_max_call_count = call_count;
+  }
+  
+  delete_arrays();
+  new_arrays(new_max_call_count);
+  
+  return new_max_call_count;
+}
+
+/* the string data is kept between calls and only grows */
+static size_t characters_in_size = 0;
+static size_t characters_out_size = 0;
+
+void reserve_characters(char ** buffer, size_t * size, size_t needed) {
+  if (needed <= *size) {
+    return;
+  }
+  
+  size_t new_size = 2 * (*size);
+  if (new_size < needed) {
+    new_size = needed;
+  }
+  
+  free(*buffer);
+  *buffer = (char *) malloc(new_size);
+  if (!*buffer) {
+    fprintf(stderr, "could not allocate %lu bytes for the strings\\n", (unsigned long) new_size);
+    exit(1);
+  }
+  *size = new_size;
+}
+
+char * receive_characters(int total_string_size, int rank) {
+  if (rank == 0 && (header_in[HEADER_FLAGS] & SHARED_MEMORY_FLAG)) {
+    /* strings are used in place */
+    char * result = shared_memory + shared_memory_offset;
+    shared_memory_offset = shared_memory_align(shared_memory_offset + total_string_size);
+    return result;
+  }
+  
+  reserve_characters(&characters_in, &characters_in_size, total_string_size);
+  receive_array(characters_in, total_string_size, rank);
+  return characters_in;
+}
+
+/* sets the string sizes of the output strings and returns the total
+   number of bytes needed to store them, including the zero bytes */
+size_t compute_string_sizes_out() {
+  size_t total = 0;
+  
+  for (int i = 0; i < header_out[HEADER_STRING_COUNT]; i++) {
+    string_sizes_out[i] = strlen(strings_out[i]);
+    total += string_sizes_out[i] + 1;
+  }
+  
+  return total;
+}
+
+void pack_strings_out(char * buffer) {
+  size_t offset = 0;
+  
+  for (int i = 0; i < header_out[HEADER_STRING_COUNT]; i++) {
+    memcpy(buffer + offset, strings_out[i], string_sizes_out[i] + 1);
+    offset += string_sizes_out[i] + 1;
+  }
+}
+
+void send_strings(int rank) {
+  size_t total = compute_string_sizes_out();
+
+  send_array(string_sizes_out, header_out[HEADER_STRING_COUNT] * sizeof(int), rank);
+  
+  if (header_out[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+    /* pack directly in the shared memory */
+    pack_strings_out(shared_memory + shared_memory_offset);
+    shared_memory_offset = shared_memory_align(shared_memory_offset + total);
+  } else {
+    reserve_characters(&characters_out, &characters_out_size, total);
+    pack_strings_out(characters_out);
+    send_array_sockets(characters_out, total, socketfd, rank);
+  }
 }
 
 #if !defined(NOMPI) && _POSIX_VERSION >= 1
@@ -470,9 +827,7 @@ void run_mpi(int argc, char *argv[]) {
     int call_count = header_in[HEADER_CALL_COUNT];
 
     if (call_count > max_call_count) {
-      delete_arrays();
-      max_call_count = call_count + 255;
-      new_arrays(max_call_count);
+      max_call_count = grow_arrays(call_count, max_call_count);
     }
     
     if(header_in[HEADER_INTEGER_COUNT] > 0) {
@@ -503,7 +858,7 @@ void run_mpi(int argc, char *argv[]) {
         total_string_size += string_sizes_in[i] + 1;
       }
       
-      characters_in = new char[total_string_size];
+      reserve_characters(&characters_in, &characters_in_size, total_string_size);
       MPI_Bcast(characters_in, total_string_size, MPI_CHARACTER, 0, parent);
 
       int offset = 0;
@@ -552,39 +907,21 @@ void run_mpi(int argc, char *argv[]) {
         MPI_Send(booleans_out, header_out[HEADER_BOOLEAN_COUNT], MPI_C_BOOL, 0, 999, parent);
       }
       if(header_out[HEADER_STRING_COUNT] > 0) {
-        int offset = 0;
-        for( int i = 0; i < header_out[HEADER_STRING_COUNT] ; i++) {
-          
-          int length = strlen(strings_out[i]);
-          string_sizes_out[i] = length;
-          offset += length + 1;
-        }
+        size_t total = compute_string_sizes_out();
         
-        characters_out = new char[offset + 1];
-        offset = 0;
+        reserve_characters(&characters_out, &characters_out_size, total);
+        pack_strings_out(characters_out);
         
-        for( int i = 0; i < header_out[HEADER_STRING_COUNT]  ; i++) {
-          strcpy(characters_out+offset, strings_out[i]);
-          offset += string_sizes_out[i] + 1;
-        }
         MPI_Send(string_sizes_out, header_out[HEADER_STRING_COUNT], MPI_INTEGER, 0, 999, parent);
-        MPI_Send(characters_out, offset, MPI_BYTE, 0, 999, parent);
+        MPI_Send(characters_out, total, MPI_BYTE, 0, 999, parent);
       }
     
     }
-    
-    if (characters_in) { 
-        delete[] characters_in;
-        characters_in = 0;
-    }
-    
-    if (characters_out) {
-        delete[] characters_out;
-        characters_out = 0;
-    }
     //fprintf(stderr, "call done\\n");
   }
   delete_arrays();
+  free(characters_in);
+  free(characters_out);
   
     for(int i = 0; i < lastid + 1; i++) {
         MPI_Comm_disconnect(&communicators[i]);
@@ -598,7 +935,7 @@ void run_mpi(int argc, char *argv[]) {
 #endif
 }
 
-void run_sockets_mpi(int argc, char *argv[], int port, char *host) {
+void run_sockets_mpi(int argc, char *argv[], int port, char *host, char *shared_memory_filename) {
 #ifndef NOMPI
  bool must_run_loop = true;
   int max_call_count = 10;
@@ -616,6 +953,9 @@ void run_sockets_mpi(int argc, char *argv[], int port, char *host) {
   if (rank == 0) {  
     //fprintf(stderr, "C worker: running in sockets+mpi mode\\n");
   
+    if (shared_memory_filename) {
+      open_shared_memory(shared_memory_filename);
+    }
    
     socketfd = socket(AF_INET, SOCK_STREAM, 0);
     
@@ -658,6 +998,7 @@ void run_sockets_mpi(int argc, char *argv[], int port, char *host) {
   while(must_run_loop) {
     //fprintf(stderr, "sockets_mpi: receiving header\\n");
     receive_array_sockets(header_in, HEADER_SIZE * sizeof(int), socketfd, rank);
+    shared_memory_offset = 0;
     MPI_Bcast(header_in, HEADER_SIZE, MPI_INT, 0, MPI_COMM_WORLD);
     
     //fprintf(stderr, "C sockets_mpi worker code: got header %d %d %d %d %d %d %d %d %d %d\\n", header_in[0], header_in[1], header_in[2], header_in[3], header_in[4], header_in[5], header_in[6], header_in[7], header_in[8], header_in[9]);
@@ -665,38 +1006,36 @@ void run_sockets_mpi(int argc, char *argv[], int port, char *host) {
     int call_count = header_in[HEADER_CALL_COUNT];
 
     if (call_count > max_call_count) {
-      delete_arrays();
-      max_call_count = call_count + 255;
-      new_arrays(max_call_count);
+      max_call_count = grow_arrays(call_count, max_call_count);
     }
     
     if (header_in[HEADER_INTEGER_COUNT] > 0) {
-      receive_array_sockets(ints_in, header_in[HEADER_INTEGER_COUNT] * sizeof(int), socketfd, rank);
+      receive_array(ints_in, header_in[HEADER_INTEGER_COUNT] * sizeof(int), rank);
       MPI_Bcast(ints_in, header_in[HEADER_INTEGER_COUNT], MPI_INTEGER, 0, MPI_COMM_WORLD);
     }
      
     if (header_in[HEADER_LONG_COUNT] > 0) {
-      receive_array_sockets(longs_in, header_in[HEADER_LONG_COUNT] * sizeof(long long int), socketfd, rank);
+      receive_array(longs_in, header_in[HEADER_LONG_COUNT] * sizeof(long long int), rank);
       MPI_Bcast(longs_in, header_in[HEADER_LONG_COUNT], MPI_LONG_LONG_INT, 0, MPI_COMM_WORLD);
     }
     
     if(header_in[HEADER_FLOAT_COUNT] > 0) {
-      receive_array_sockets(floats_in, header_in[HEADER_FLOAT_COUNT] * sizeof(float), socketfd, rank);
+      receive_array(floats_in, header_in[HEADER_FLOAT_COUNT] * sizeof(float), rank);
       MPI_Bcast(floats_in, header_in[HEADER_FLOAT_COUNT], MPI_FLOAT, 0, MPI_COMM_WORLD);
     }
     
     if(header_in[HEADER_DOUBLE_COUNT] > 0) {
-      receive_array_sockets(doubles_in, header_in[HEADER_DOUBLE_COUNT] * sizeof(double), socketfd, rank);
+      receive_array(doubles_in, header_in[HEADER_DOUBLE_COUNT] * sizeof(double), rank);
       MPI_Bcast(doubles_in, header_in[HEADER_DOUBLE_COUNT], MPI_DOUBLE, 0, MPI_COMM_WORLD);
     }
     
     if(header_in[HEADER_BOOLEAN_COUNT] > 0) {
-      receive_array_sockets(booleans_in, header_in[HEADER_BOOLEAN_COUNT] * sizeof(bool), socketfd , rank);
+      receive_array(booleans_in, header_in[HEADER_BOOLEAN_COUNT] * sizeof(bool), rank);
       MPI_Bcast(booleans_in, header_in[HEADER_BOOLEAN_COUNT], MPI_C_BOOL, 0, MPI_COMM_WORLD);
     }
     
     if(header_in[HEADER_STRING_COUNT] > 0) {
-      receive_array_sockets(string_sizes_in, header_in[HEADER_STRING_COUNT] * sizeof(int), socketfd, rank);
+      receive_array(string_sizes_in, header_in[HEADER_STRING_COUNT] * sizeof(int), rank);
       MPI_Bcast(string_sizes_in, header_in[HEADER_STRING_COUNT], MPI_INT, 0, MPI_COMM_WORLD);
       
       int total_string_size = 0;
@@ -704,13 +1043,12 @@ void run_sockets_mpi(int argc, char *argv[], int port, char *host) {
         total_string_size += string_sizes_in[i] + 1;
       }
       
-      characters_in = new char[total_string_size];
-      receive_array_sockets(characters_in, total_string_size, socketfd, rank);
-      MPI_Bcast(characters_in, total_string_size, MPI_CHARACTER, 0, MPI_COMM_WORLD);
+      char * characters = receive_characters(total_string_size, rank);
+      MPI_Bcast(characters, total_string_size, MPI_CHARACTER, 0, MPI_COMM_WORLD);
 
       int offset = 0;
       for (int i = 0 ; i <  header_in[HEADER_STRING_COUNT];i++) {
-          strings_in[i] = characters_in + offset;
+          strings_in[i] = characters + offset;
           offset += string_sizes_in[i] + 1;
       } 
     }
@@ -737,61 +1075,47 @@ void run_sockets_mpi(int argc, char *argv[], int port, char *host) {
     
     if (rank == 0) {
 
-      send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
+      if (reply_fits_in_shared_memory()) {
+        header_out[HEADER_FLAGS] = header_out[HEADER_FLAGS] | SHARED_MEMORY_FLAG;
+        shared_memory_offset = shared_memory_size / 2;
+      } else {
+        send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
+      }
           
       if(header_out[HEADER_INTEGER_COUNT] > 0) {
-        send_array_sockets(ints_out, header_out[HEADER_INTEGER_COUNT] * sizeof(int), socketfd, 0);
+        send_array(ints_out, header_out[HEADER_INTEGER_COUNT] * sizeof(int), 0);
       }
           
       if(header_out[HEADER_LONG_COUNT] > 0) {
-        send_array_sockets(longs_out, header_out[HEADER_LONG_COUNT] * sizeof(long long int), socketfd, 0);
+        send_array(longs_out, header_out[HEADER_LONG_COUNT] * sizeof(long long int), 0);
       }
           
       if(header_out[HEADER_FLOAT_COUNT] > 0) {
-        send_array_sockets(floats_out, header_out[HEADER_FLOAT_COUNT] * sizeof(float), socketfd, 0);
+        send_array(floats_out, header_out[HEADER_FLOAT_COUNT] * sizeof(float), 0);
       }
           
       if(header_out[HEADER_DOUBLE_COUNT] > 0) {
-        send_array_sockets(doubles_out, header_out[HEADER_DOUBLE_COUNT] * sizeof(double), socketfd, 0);
+        send_array(doubles_out, header_out[HEADER_DOUBLE_COUNT] * sizeof(double), 0);
       }
           
       if(header_out[HEADER_BOOLEAN_COUNT] > 0) {
-        send_array_sockets(booleans_out, header_out[HEADER_BOOLEAN_COUNT] * sizeof(bool), socketfd, 0);
+        send_array(booleans_out, header_out[HEADER_BOOLEAN_COUNT] * sizeof(bool), 0);
       }
           
       if(header_out[HEADER_STRING_COUNT] > 0) {
-        int offset = 0;
-        for( int i = 0; i < header_out[HEADER_STRING_COUNT] ; i++) {          
-          int length = strlen(strings_out[i]);
-          string_sizes_out[i] = length;
-          offset += length + 1;
-        }
-        
-        characters_out = new char[offset + 1];
-        offset = 0;
-        
-        for( int i = 0; i < header_out[HEADER_STRING_COUNT]  ; i++) {
-          strcpy(characters_out+offset, strings_out[i]);
-          offset += string_sizes_out[i] + 1;
-        }
-        
-        send_array_sockets(string_sizes_out, header_out[HEADER_STRING_COUNT] * sizeof(int), socketfd, 0);
-        send_array_sockets(characters_out, offset * sizeof(char), socketfd, 0);
+        send_strings(0);
+      }
+      
+      if (header_out[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+        send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
       }
         
       //fprintf(stderr, "sockets_mpicall done\\n");
     }
-    if (characters_in) { 
-        delete[] characters_in;
-        characters_in = 0;
-    }
-    
-    if (characters_out) {
-        delete[] characters_out;
-        characters_out = 0;
-    }
   }
   delete_arrays();
+  free(characters_in);
+  free(characters_out);
   
   if (rank == 0) {
   
@@ -811,7 +1135,7 @@ void run_sockets_mpi(int argc, char *argv[], int port, char *host) {
 #endif
 }
 
-void run_sockets(int port, char *host) {
+void run_sockets(int port, char *host, char *shared_memory_filename) {
   bool must_run_loop = true;
   int max_call_count = 10;
   struct sockaddr_in serv_addr;
@@ -832,6 +1156,10 @@ void run_sockets(int port, char *host) {
   mpiIntercom = false;
 
   //fprintf(stderr, "C worker: running in sockets mode\\n");
+  
+  if (shared_memory_filename) {
+    open_shared_memory(shared_memory_filename);
+  }
    
   socketfd = socket(AF_INET, SOCK_STREAM, 0);
     
@@ -871,50 +1199,48 @@ void run_sockets(int port, char *host) {
   while(must_run_loop) {
     //fprintf(stderr, "sockets: receiving header\\n");
     receive_array_sockets(header_in, HEADER_SIZE * sizeof(int), socketfd, 0);
+    shared_memory_offset = 0;
     //fprintf(stderr, "C sockets worker code: got header %d %d %d %d %d %d %d %d %d %d\\n", header_in[0], header_in[1], header_in[2], header_in[3], header_in[4], header_in[5], header_in[6], header_in[7], header_in[8], header_in[9]);
     
     int call_count = header_in[HEADER_CALL_COUNT];
 
     if (call_count > max_call_count) {
-      delete_arrays();
-      max_call_count = call_count + 255;
-      new_arrays(max_call_count);
+      max_call_count = grow_arrays(call_count, max_call_count);
     }
     
     if (header_in[HEADER_INTEGER_COUNT] > 0) {
-      receive_array_sockets(ints_in, header_in[HEADER_INTEGER_COUNT] * sizeof(int), socketfd, 0);
+      receive_array(ints_in, header_in[HEADER_INTEGER_COUNT] * sizeof(int), 0);
     }
      
     if (header_in[HEADER_LONG_COUNT] > 0) {
-      receive_array_sockets(longs_in, header_in[HEADER_LONG_COUNT] * sizeof(long long int), socketfd, 0);
+      receive_array(longs_in, header_in[HEADER_LONG_COUNT] * sizeof(long long int), 0);
     }
     
     if(header_in[HEADER_FLOAT_COUNT] > 0) {
-      receive_array_sockets(floats_in, header_in[HEADER_FLOAT_COUNT] * sizeof(float), socketfd, 0);
+      receive_array(floats_in, header_in[HEADER_FLOAT_COUNT] * sizeof(float), 0);
     }
     
     if(header_in[HEADER_DOUBLE_COUNT] > 0) {
-      receive_array_sockets(doubles_in, header_in[HEADER_DOUBLE_COUNT] * sizeof(double), socketfd, 0);
+      receive_array(doubles_in, header_in[HEADER_DOUBLE_COUNT] * sizeof(double), 0);
     }
     
     if(header_in[HEADER_BOOLEAN_COUNT] > 0) {
-      receive_array_sockets(booleans_in, header_in[HEADER_BOOLEAN_COUNT] * sizeof(bool), socketfd , 0);
+      receive_array(booleans_in, header_in[HEADER_BOOLEAN_COUNT] * sizeof(bool), 0);
     }
     
     if(header_in[HEADER_STRING_COUNT] > 0) {
-      receive_array_sockets(string_sizes_in, header_in[HEADER_STRING_COUNT] * sizeof(int), socketfd, 0);
+      receive_array(string_sizes_in, header_in[HEADER_STRING_COUNT] * sizeof(int), 0);
       
       int total_string_size = 0;
       for (int i = 0; i < header_in[HEADER_STRING_COUNT];i++) {
         total_string_size += string_sizes_in[i] + 1;
       }
       
-      characters_in = new char[total_string_size];
-      receive_array_sockets(characters_in, total_string_size, socketfd, 0);
+      char * characters = receive_characters(total_string_size, 0);
 
       int offset = 0;
       for (int i = 0 ; i <  header_in[HEADER_STRING_COUNT];i++) {
-          strings_in[i] = characters_in + offset;
+          strings_in[i] = characters + offset;
           offset += string_sizes_in[i] + 1;
       } 
     }
@@ -938,60 +1264,45 @@ void run_sockets(int port, char *host) {
     
     //fprintf(stderr, "c worker sockets: call handled\\n");
 
-    send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
+    if (reply_fits_in_shared_memory()) {
+      header_out[HEADER_FLAGS] = header_out[HEADER_FLAGS] | SHARED_MEMORY_FLAG;
+      shared_memory_offset = shared_memory_size / 2;
+    } else {
+      send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
+    }
       
     if(header_out[HEADER_INTEGER_COUNT] > 0) {
-      send_array_sockets(ints_out, header_out[HEADER_INTEGER_COUNT] * sizeof(int), socketfd, 0);
+      send_array(ints_out, header_out[HEADER_INTEGER_COUNT] * sizeof(int), 0);
     }
       
     if(header_out[HEADER_LONG_COUNT] > 0) {
-      send_array_sockets(longs_out, header_out[HEADER_LONG_COUNT] * sizeof(long long int), socketfd, 0);
+      send_array(longs_out, header_out[HEADER_LONG_COUNT] * sizeof(long long int), 0);
     }
       
     if(header_out[HEADER_FLOAT_COUNT] > 0) {
-      send_array_sockets(floats_out, header_out[HEADER_FLOAT_COUNT] * sizeof(float), socketfd, 0);
+      send_array(floats_out, header_out[HEADER_FLOAT_COUNT] * sizeof(float), 0);
     }
       
     if(header_out[HEADER_DOUBLE_COUNT] > 0) {
-      send_array_sockets(doubles_out, header_out[HEADER_DOUBLE_COUNT] * sizeof(double), socketfd, 0);
+      send_array(doubles_out, header_out[HEADER_DOUBLE_COUNT] * sizeof(double), 0);
     }
       
     if(header_out[HEADER_BOOLEAN_COUNT] > 0) {
-        send_array_sockets(booleans_out, header_out[HEADER_BOOLEAN_COUNT] * sizeof(bool), socketfd, 0);
+        send_array(booleans_out, header_out[HEADER_BOOLEAN_COUNT] * sizeof(bool), 0);
     }
       
     if(header_out[HEADER_STRING_COUNT] > 0) {
-        int offset = 0;
-        for( int i = 0; i < header_out[HEADER_STRING_COUNT] ; i++) {          
-          int length = strlen(strings_out[i]);
-          string_sizes_out[i] = length;
-          offset += length + 1;
-        }
-        
-        characters_out = new char[offset + 1];
-        offset = 0;
-        
-        for( int i = 0; i < header_out[HEADER_STRING_COUNT]  ; i++) {
-          strcpy(characters_out+offset, strings_out[i]);
-          offset += string_sizes_out[i] + 1;
-        }
-        
-        send_array_sockets(string_sizes_out, header_out[HEADER_STRING_COUNT] * sizeof(int), socketfd, 0);
-        send_array_sockets(characters_out, offset * sizeof(char), socketfd, 0);
+      send_strings(0);
     }
     
-    if (characters_in) { 
-        delete[] characters_in;
-        characters_in = 0;
+    if (header_out[HEADER_FLAGS] & SHARED_MEMORY_FLAG) {
+      send_array_sockets(header_out, HEADER_SIZE * sizeof(int), socketfd, 0);
     }
-    
-    if (characters_out) {
-        delete[] characters_out;
-        characters_out = 0;
-    }    
     //fprintf(stderr, "call done\\n");
   }
   delete_arrays();
+  free(characters_in);
+  free(characters_out);
   
 #ifdef WIN32
 	closesocket(socketfd);
@@ -1005,6 +1316,7 @@ int main(int argc, char *argv[]) {
   int port;
   bool use_mpi;
   char *host;
+  char *shared_memory_filename = 0;
   
   //for(int i = 0 ; i < argc; i++) {
   //  fprintf(stderr, "argument %d is %s\\n", i, argv[i]);
@@ -1012,28 +1324,32 @@ int main(int argc, char *argv[]) {
 
   if (argc == 1) {
     run_mpi(argc, argv);
-  } else if (argc == 4) {
+  } else if (argc == 4 || argc == 5) {
     port = atoi(argv[1]);
     host = argv[2];
     
+    if (argc == 5) {
+      shared_memory_filename = argv[4];
+    }
+    
     if (strcmp(argv[3], "true") == 0) {
       use_mpi = true;
     } else if (strcmp(argv[3], "false") == 0) {
       use_mpi = false;
     } else {
       fprintf(stderr, "mpi enabled setting must be either 'true' or 'false', not %s\\n", argv[2]);
-      fprintf(stderr, "usage: %s [PORT HOST MPI_ENABLED]\\n", argv[0]);
+      fprintf(stderr, "usage: %s [PORT HOST MPI_ENABLED [SHARED_MEMORY_FILE]]\\n", argv[0]);
       exit(1);
     }    
     
     if (use_mpi) {
-      run_sockets_mpi(argc, argv, port, host);
+      run_sockets_mpi(argc, argv, port, host, shared_memory_filename);
     } else {
-      run_sockets(port, host);
+      run_sockets(port, host, shared_memory_filename);
     }
   } else {
-    fprintf(stderr, "%s need either 0 or 4 arguments, not %d\\n", argv[0], argc);
-    fprintf(stderr, "usage: %s [PORT HOST MPI_ENABLED]\\n", argv[0]);
+    fprintf(stderr, "%s need either 0, 4 or 5 arguments, not %d\\n", argv[0], argc);
+    fprintf(stderr, "usage: %s [PORT HOST MPI_ENABLED [SHARED_MEMORY_FILE]]\\n", argv[0]);
     exit(1);
   }
 
@@ -1065,6 +1381,8 @@ class GenerateACStringOfAFunctionSpecification(MakeCCodeString):
         if self.specification.must_handle_array:
             pass
         elif self.specification.can_handle_array:
+            if self.specification.can_handle_array_in_parallel:
+                self.output_parallel_for()
             self.out.lf() + 'for (int i = 0 ; i < call_count; i++){'
             self.out.indent()
  
@@ -1090,6 +1408,11 @@ class GenerateACStringOfAFunctionSpecification(MakeCCodeString):
         self.out.dedent()
         self._result = self.out.string
     
+    def output_parallel_for(self):
+        self.out.lf() + '#ifdef _OPENMP'
+        self.out.lf() + '#pragma omp parallel for if(call_count > 1)'
+        self.out.lf() + '#endif'
+    
     def index_string(self, index, must_copy_in_to_out=False):
         if self.specification.must_handle_array and not must_copy_in_to_out:
             if index == 0:
@@ -1308,11 +1631,16 @@ class GenerateACSourcecodeStringFromASpecificationClass\
             self.out.lf()
             
     def output_handle_call(self):
+        self.out.lf().lf() + 'bool handle_batch();'
         self.out.lf().lf() + 'bool handle_call() {'
         self.out.indent()
         
         self.out.lf() + 'int call_count = header_in[HEADER_CALL_COUNT];'
         
+        self.out.lf().lf() + 'if (header_in[HEADER_FUNCTION_ID] == BATCH_FUNCTION_ID) {'
+        self.out.indent().lf() + 'return handle_batch();'
+        self.out.dedent().lf() + '}'
+        
         self.out.lf().lf() + 'switch(header_in[HEADER_FUNCTION_ID]) {'
         self.out.indent()
         self.out.lf() + 'case 0:'
@@ -208,6 +208,21 @@ class TestBrutusInterface(TestWithMPI):
         instance.stop()
         
 
+    def test9(self):
+        print("Test BrutusInterface arithmetic for the word length")
+        instance = self.new_instance_of_an_optional_code(BrutusInterface)
+        instance.initialize_code()
+        self.assertEqual([1, 0], list(instance.get_use_multi_prec().values()))
+        for word_length, size in [(56, 2), (104, 2), (105, 3), (200, 4), (256, 0)]:
+            self.assertEqual(0, instance.set_word_length(word_length))
+            self.assertEqual([size, 0], list(instance.get_multi_prec_size().values()))
+        self.assertEqual(0, instance.set_use_multi_prec(0))
+        self.assertEqual(0, instance.set_word_length(64))
+        self.assertEqual([0, 0], list(instance.get_multi_prec_size().values()))
+        self.assertEqual(0, instance.cleanup_code())
+        instance.stop()
+
+
 class TestBrutus(TestWithMPI):
     
     def new_sun_earth_system(self):
@@ -409,4 +424,22 @@ class TestBrutus(TestWithMPI):
         self.assertTrue((Loss_mp <= 0.0000007) and (Loss_mp > 0.0000006))
     
 
-
+    def test6(self):
+        print("Testing Brutus evolve_model, double-double against mpreal")
+        particles = Particles(3)
+        particles.mass = [3, 4, 5] | nbody_system.mass
+        particles.position = [[1, 3, 0], [-2, -1, 0], [1, -1, 0]] | nbody_system.length
+        particles.velocity = [0, 0, 0] | nbody_system.speed
+        particles.radius = 0 | nbody_system.length
+
+        positions = []
+        for use_multi_prec in [True, False]:
+            instance = self.new_instance_of_an_optional_code(Brutus)
+            instance.parameters.bs_tolerance = 1e-20
+            instance.parameters.word_length = 100
+            instance.parameters.use_multi_prec = use_multi_prec
+            instance.particles.add_particles(particles)
+            instance.evolve_model(1.0 | nbody_system.time)
+            positions.append(instance.particles.position)
+            instance.stop()
+        self.assertAlmostRelativeEqual(positions[0], positions[1], 14)
@@ -386,6 +386,35 @@ class TestFastKick(TestWithMPI):
         instance.particles.mass = 2 | mass
         self.assertAlmostRelativeEqual(instance.particles.mass, 2 | mass)
 
+    def test14(self):
+        print("Test FastKick octree (opening_angle > 0) against direct summation")
+        numpy.random.seed(12345)
+        plummer = new_plummer_model(2000)
+        points = new_plummer_model(100)
+
+        instance = self.new_fastkick_instance()
+        self.assertEqual(instance.parameters.opening_angle, 0.0)
+        instance.parameters.epsilon_squared = 0.0001 | nbody_system.length**2
+        instance.particles.add_particles(plummer)
+        potential0 = instance.get_potential_at_point(0*points.x, points.x, points.y, points.z)
+        ax0, ay0, az0 = instance.get_gravity_at_point(0*points.x, points.x, points.y, points.z)
+        energy0 = instance.potential_energy
+
+        for theta in [0.3, 0.6]:
+            instance.parameters.opening_angle = theta
+            self.assertEqual(instance.parameters.opening_angle, theta)
+            potential = instance.get_potential_at_point(0*points.x, points.x, points.y, points.z)
+            ax, ay, az = instance.get_gravity_at_point(0*points.x, points.x, points.y, points.z)
+            error = ((ax-ax0)**2 + (ay-ay0)**2 + (az-az0)**2).sqrt() / (ax0**2 + ay0**2 + az0**2).sqrt()
+            self.assertTrue(numpy.median(error) < 0.002)
+            self.assertAlmostRelativeEqual(potential, potential0, 3)
+            self.assertAlmostRelativeEqual(instance.potential_energy, energy0, 4)
+
+        instance.parameters.opening_angle = 0.0
+        potential = instance.get_potential_at_point(0*points.x, points.x, points.y, points.z)
+        self.assertEqual(potential, potential0)
+        instance.stop()
+
 class TestFastKickGPU(TestFastKick):
 
     mode = "gpu"
@@ -778,3 +778,56 @@ class TestHuayno(TestWithMPI):
         instance.stop()
         
 
+
+    def test30(self):
+        numpy.random.seed(12345)
+        particles = plummer.new_plummer_model(300)
+
+        instance = Huayno()
+        instance.parameters.inttype_parameter = Huayno.inttypes.SHARED10
+        instance.particles.add_particles(particles)
+        instance.evolve_model(0.015625 | nbody_system.time)
+        expected_positions = instance.particles.position
+        instance.stop()
+
+        # above 256 particles the connected components come from the grid search
+        for itype in ["CC", "CC_KEPLER"]:
+            instance = Huayno()
+            instance.parameters.inttype_parameter = getattr(Huayno.inttypes, itype)
+            instance.particles.add_particles(particles)
+            E0 = instance.kinetic_energy + instance.potential_energy
+            instance.evolve_model(0.015625 | nbody_system.time)
+            E1 = instance.kinetic_energy + instance.potential_energy
+            self.assertAlmostRelativeEqual(E0, E1, 4)
+            self.assertAlmostEqual(instance.particles.position, expected_positions, 3)
+            instance.stop()
+
+    def test31(self):
+        numpy.random.seed(12345)
+        particles = plummer.new_plummer_model(1000)
+
+        instance = Huayno()
+        self.assertEqual(instance.parameters.opening_angle, 0.0)
+        self.assertEqual(instance.parameters.tree_work_limit, 1000000)
+        instance.parameters.inttype_parameter = Huayno.inttypes.HOLD_DKD
+        instance.particles.add_particles(particles)
+        E0 = instance.kinetic_energy + instance.potential_energy
+        instance.evolve_model(0.0078125 | nbody_system.time)
+        E1 = instance.kinetic_energy + instance.potential_energy
+        expected_positions = instance.particles.position
+        ttot, ktot_direct, dtot, tstot, kstot, dstot = instance.get_evolve_statistics()
+        instance.stop()
+
+        # the outer kicks of the split use the tree, inner levels stay direct
+        instance = Huayno()
+        instance.parameters.inttype_parameter = Huayno.inttypes.HOLD_DKD
+        instance.parameters.opening_angle = 0.5
+        instance.parameters.tree_work_limit = 100000
+        instance.particles.add_particles(particles)
+        self.assertAlmostRelativeEqual(instance.kinetic_energy + instance.potential_energy, E0, 3)
+        instance.evolve_model(0.0078125 | nbody_system.time)
+        self.assertAlmostRelativeEqual(instance.kinetic_energy + instance.potential_energy, E1, 3)
+        self.assertAlmostEqual(instance.particles.position, expected_positions, 4)
+        ttot, ktot_tree, dtot, tstot, kstot, dstot = instance.get_evolve_statistics()
+        self.assertTrue(ktot_tree < ktot_direct)
+        instance.stop()
@@ -0,0 +1,101 @@
+import numpy
+
+from amuse.test.amusetest import TestWithMPI
+from amuse.units import nbody_system
+
+from amuse.community.kepler.interface import Kepler, KeplerInterface
+
+class TestKeplerPropagateOrbits(TestWithMPI):
+
+    def new_orbits(self, n):
+        numpy.random.seed(123)
+        mass = numpy.random.uniform(0.5, 2.0, n)
+        pos = numpy.random.normal(size = (n, 3))
+        vel = numpy.random.normal(size = (n, 3)) * numpy.sqrt(mass)[:,None]
+        dt = numpy.random.uniform(-20.0, 20.0, n)
+        return mass, pos, vel, dt
+
+    def test1(self):
+        # bound and unbound orbits, forwards and backwards in time,
+        # against initialize_from_dyn + transform_to_time (the f and g
+        # functions lose some digits on nearly radial unbound orbits)
+        n = 150
+        mass, pos, vel, dt = self.new_orbits(n)
+        instance = Kepler()
+        instance.initialize_code()
+        result = instance.propagate_orbits(mass | nbody_system.mass,
+            pos[:,0] | nbody_system.length, pos[:,1] | nbody_system.length,
+            pos[:,2] | nbody_system.length, vel[:,0] | nbody_system.speed,
+            vel[:,1] | nbody_system.speed, vel[:,2] | nbody_system.speed,
+            dt | nbody_system.time)
+        self.assertEqual(len(result), 6)
+
+        for i in range(n):
+            instance.initialize_from_dyn(mass[i] | nbody_system.mass,
+                *(list(pos[i] | nbody_system.length)
+                  + list(vel[i] | nbody_system.speed)))
+            instance.transform_to_time(dt[i] | nbody_system.time)
+            r = instance.get_separation_vector()
+            v = instance.get_velocity_vector()
+            scale_r = max(abs(x.number) for x in r) | nbody_system.length
+            scale_v = max(abs(x.number) for x in v) | nbody_system.speed
+            for k in range(3):
+                self.assertAlmostRelativeEquals(result[k][i] + scale_r,
+                                                r[k] + scale_r, 9)
+                self.assertAlmostRelativeEquals(result[3+k][i] + scale_v,
+                                                v[k] + scale_v, 9)
+        instance.stop()
+
+    def test2(self):
+        # elements in the standard orientation, against
+        # initialize_from_elements + transform_to_time
+        numpy.random.seed(456)
+        n = 60
+        mass = numpy.random.uniform(0.5, 2.0, n)
+        semi = numpy.random.uniform(0.5, 2.0, n)
+        ecc = numpy.random.uniform(0.0, 2.0, n)
+        mean_anomaly = numpy.random.uniform(-3.0, 3.0, n)
+        dt = numpy.random.uniform(-10.0, 10.0, n)
+        instance = Kepler()
+        instance.initialize_code()
+        result = instance.propagate_orbits_from_elements(
+            mass | nbody_system.mass, semi | nbody_system.length, ecc,
+            mean_anomaly, dt | nbody_system.time)
+
+        for i in range(n):
+            instance.initialize_from_elements(mass[i] | nbody_system.mass,
+                semi[i] | nbody_system.length, ecc[i], mean_anomaly[i])
+            instance.transform_to_time(dt[i] | nbody_system.time)
+            r = instance.get_separation_vector()
+            v = instance.get_velocity_vector()
+            scale_r = max(abs(x.number) for x in r) | nbody_system.length
+            scale_v = max(abs(x.number) for x in v) | nbody_system.speed
+            for k in range(3):
+                self.assertAlmostRelativeEquals(result[k][i] + scale_r,
+                                                r[k] + scale_r, 10)
+                self.assertAlmostRelativeEquals(result[3+k][i] + scale_v,
+                                                v[k] + scale_v, 10)
+        instance.stop()
+
+    def test3(self):
+        # a full period brings a bound orbit back; invalid orbits are
+        # flagged and left unchanged
+        instance = KeplerInterface()
+        instance.initialize_code()
+        period = 2 * numpy.pi
+        result = instance.propagate_orbits([1.0, 1.0, 0.0],
+            [1.0, 1.0, 1.0], [0.0, 0.0, 0.0], [0.0, 0.0, 0.0],
+            [0.0, 0.0, 0.0], [1.0, 1.2, 1.0], [0.0, 0.0, 0.0],
+            [period, 0.0, 1.0])
+        self.assertEqual(result['__result'], -2)
+        self.assertAlmostEqual(result['x1'], [1.0, 1.0, 1.0], 12)
+        self.assertAlmostEqual(result['y1'], [0.0, 0.0, 0.0], 12)
+        self.assertAlmostEqual(result['vy1'], [1.0, 1.2, 1.0], 12)
+
+        result = instance.propagate_orbits_from_elements([1.0, 1.0],
+            [1.0, 1.0], [0.5, 1.0], [0.0, 0.0], [100 * period, 0.0])
+        self.assertEqual(result['__result'], -2)
+        self.assertAlmostEqual(result['x'], [0.5, 0.0], 10)
+        self.assertAlmostEqual(result['vy'], [3**0.5, 0.0], 10)
+        instance.cleanup_code()
+        instance.stop()
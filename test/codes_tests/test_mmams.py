@@ -191,6 +191,67 @@ class TestMMAMSInterface(TestWithMPI):
         self.assertEqual(do_shock_heating_flag, 0)
         instance.stop()
     
+    def test6(self):
+        print("Test 6: add all shells of several particles in one call")
+        instance = MMAMSInterface(**default_options)
+        self.assertEqual(instance.initialize_code(), 0)
+        self.assertEqual(instance.commit_parameters(), 0)
+        id, error = instance.new_particle([2.0, 3.0])
+        self.assertEqual(error, [0, 0])
+        
+        ones = numpy.ones(5)
+        error = instance.add_shells([0, 0, 0, 1, 1], [1.0, 1.0, 1.0, 1.0, 2.0], 
+            [1.0, 2.0, 2.0, 1.0, 3.0], [1.0, 2.0, 2.0, 1.0, 2.0], 4*ones, 5*ones, 6*ones, 
+            -6*ones, 7*ones, 0.7*ones, 0.28*ones, 0.0*ones, 0.0*ones, 0.02*ones, 
+            0.0*ones, 0.0*ones, 0.0*ones, 0.0*ones)
+        self.assertEqual(error, 0)
+        number_of_shells, error = instance.get_number_of_zones([0, 1])
+        self.assertEqual(error, [0, 0])
+        self.assertEqual(number_of_shells, [2, 2])
+        mass = instance.get_stellar_model_element([0, 1, 0, 1], [0, 0, 1, 1])['cumul_mass']
+        self.assertEqual(mass, [1.0, 2.0, 1.0, 3.0])
+        
+        error = instance.add_shells([0, 5], [1.0, 1.0], [3.0, 1.0], [3.0, 1.0], 
+            [4.0, 4.0], [5.0, 5.0], [6.0, 6.0], [-6.0, -6.0], [7.0, 7.0], [0.7, 0.7], 
+            [0.28, 0.28], [0.0, 0.0], [0.0, 0.0], [0.02, 0.02], [0.0, 0.0], 
+            [0.0, 0.0], [0.0, 0.0], [0.0, 0.0])
+        self.assertEqual(error, -3)
+        number_of_shells, error = instance.get_number_of_zones(0)
+        self.assertEqual(number_of_shells, 2)
+        instance.stop()
+    
+    def slowtest7(self):
+        print("Test 7: merge several pairs in one call")
+        instance = MMAMSInterface(**default_options)
+        self.assertEqual(instance.initialize_code(), 0)
+        self.assertEqual(instance.set_dump_mixed_flag(0), 0)
+        self.assertEqual(instance.commit_parameters(), 0)
+        for i in range(3):
+            for filename in ['primary.usm', 'secondary.usm']:
+                id, error = instance.read_usm(os.path.join(instance.data_directory, filename))
+                self.assertEqual(error, 0)
+        
+        self.assertEqual(instance.merge_many([0, 4], [1, 99])["__result"], -3)
+        self.assertEqual(instance.get_number_of_particles()[0], 6)
+        
+        id, error = instance.merge_two_stars(0, 1)
+        self.assertEqual(id, 6)
+        ids, error = instance.merge_many([2, 4], [3, 5])
+        self.assertEqual(error, 0)
+        self.assertEqual(ids, [7, 8])
+        
+        number_of_shells, error = instance.get_number_of_zones([6, 7, 8])
+        self.assertEqual(error, [0, 0, 0])
+        self.assertEqual(number_of_shells[1], number_of_shells[0])
+        self.assertEqual(number_of_shells[2], number_of_shells[0])
+        indices = [0, 5000, number_of_shells[0]-1]
+        for id in [7, 8]:
+            expected = instance.get_stellar_model_element(indices, [6]*3)
+            result = instance.get_stellar_model_element(indices, [id]*3)
+            for name in ['cumul_mass', 'radius', 'temperature', 'H1']:
+                self.assertEqual(result[name], expected[name])
+        instance.stop()
+    
 
 class TestMMAMS(TestWithMPI):
     
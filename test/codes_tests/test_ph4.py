@@ -1149,3 +1149,50 @@ class TestPH4(TestWithMPI):
         instance.particles.remove_particle(particles[0])
         instance.evolve_model(0.2 | nbody_system.time)
         self.assertEqual(len(instance.particles), 1)
+
+    def test29(self):
+        particles = new_plummer_model(500, do_scale=True)
+        particles.radius = 0 | nbody_system.length
+        
+        results = []
+        for use_cpu_kernel in [0, 1]:
+            instance = ph4()
+            instance.parameters.epsilon_squared = 0.0001 | nbody_system.length**2
+            instance.parameters.use_cpu_kernel = use_cpu_kernel
+            self.assertEqual(instance.parameters.use_cpu_kernel, use_cpu_kernel)
+            instance.particles.add_particles(particles)
+            instance.evolve_model(0.0625 | nbody_system.time)
+            results.append((
+                instance.particles.position,
+                instance.particles.velocity,
+                instance.potential_energy
+            ))
+            instance.stop()
+        
+        self.assertAlmostRelativeEquals(results[0][0], results[1][0], 8)
+        self.assertAlmostRelativeEquals(results[0][1], results[1][1], 8)
+        self.assertAlmostRelativeEquals(results[0][2], results[1][2], 10)
+
+    def test30(self):
+        particles = new_plummer_model(1200, do_scale=True)
+        particles.radius = 0 | nbody_system.length
+        
+        results = []
+        for number_of_workers in [1, 2]:
+            instance = ph4(number_of_workers=number_of_workers)
+            instance.parameters.epsilon_squared = 0.0001 | nbody_system.length**2
+            instance.particles.add_particles(particles)
+            instance.evolve_model(0.0078125 | nbody_system.time)
+            results.append((
+                instance.particles.position,
+                instance.potential_energy
+            ))
+            self.assertTrue(instance.parameters.force_time > 0)
+            if number_of_workers > 1:
+                self.assertTrue(instance.parameters.communication_time > 0)
+            else:
+                self.assertEqual(instance.parameters.communication_time, 0)
+            instance.stop()
+        
+        self.assertAlmostRelativeEquals(results[0][0], results[1][0], 10)
+        self.assertAlmostRelativeEquals(results[0][1], results[1][1], 10)
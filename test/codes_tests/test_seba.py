@@ -698,3 +698,39 @@ class TestSeBa(TestWithMPI):
         self.assertAlmostRelativeEqual(instance.particles[1].mass, 1.22632 | units.MSun, 4)
         self.assertAlmostRelativeEqual(instance.particles[2].mass, 0.5 | units.MSun, 4)
 
+
+    def test15(self):
+        """ Test that evolving the stars on several threads gives the serial results """
+        numpy.random.seed(15)
+        masses = numpy.random.uniform(8.0, 30.0, 24) | units.MSun
+        results = []
+        for number_of_threads in [1, 4]:
+            instance = self.new_instance_of_an_optional_code(SeBa)
+            instance.parameters.number_of_threads = number_of_threads
+            self.assertEqual(instance.parameters.number_of_threads, number_of_threads)
+
+            stars = Particles(mass = masses)
+            instance.particles.add_particles(stars)
+            binaries = Particles(4)
+            binaries.semi_major_axis = [100.0, 200.0, 500.0, 1000.0] | units.RSun
+            binaries.eccentricity = 0.1
+            for i, binary in enumerate(binaries):
+                binary.child1 = stars[16 + 2 * i]
+                binary.child2 = stars[17 + 2 * i]
+            instance.binaries.add_particles(binaries)
+
+            for t in [5, 10, 20, 40] | units.Myr:
+                instance.evolve_model(t)
+            results.append((
+                instance.particles.mass,
+                instance.particles.radius,
+                instance.particles.stellar_type,
+                instance.particles.age,
+                instance.binaries.semi_major_axis,
+                instance.binaries.eccentricity,
+            ))
+            instance.stop()
+
+        self.assertTrue((results[0][2].value_in(units.stellar_type) >= 13).any())
+        for serial, parallel in zip(*results):
+            self.assertEqual(serial, parallel)
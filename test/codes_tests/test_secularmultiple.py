@@ -808,6 +808,43 @@ class TestSecularMultiple(TestWithMPI):
 
             pyplot.show()
 
+    def test9(self):
+        """
+        test repeated calls of evolve_model, which re-use the ODE integrator, and a change of structure in between
+        """
+        particles = create_nested_multiple(3,[1.0|units.MSun, 1.0|units.MJupiter, 40.0|units.MJupiter], [6.0|units.AU,100.0|units.AU], [0.001,0.6], [0.0001,65.0*numpy.pi/180.0],[45.0*numpy.pi/180.0,0.0001],[0.01,0.01])
+        binaries = particles[particles.is_binary]
+        tend = 0.2 | units.Myr
+
+        code = SecularMultiple(redirection='none')
+        code.particles.add_particles(particles)
+        particles.new_channel_to(code.particles).copy()
+        code.evolve_model(tend)
+        code.particles.new_channel_to(particles).copy()
+        e_single_call = binaries.eccentricity
+        code.stop()
+
+        particles = create_nested_multiple(3,[1.0|units.MSun, 1.0|units.MJupiter, 40.0|units.MJupiter], [6.0|units.AU,100.0|units.AU], [0.001,0.6], [0.0001,65.0*numpy.pi/180.0],[45.0*numpy.pi/180.0,0.0001],[0.01,0.01])
+        binaries = particles[particles.is_binary]
+        code = SecularMultiple(redirection='none')
+        code.particles.add_particles(particles)
+        particles.new_channel_to(code.particles).copy()
+        t = 0.0 | units.Myr
+        dt = 1.0e-2 | units.Myr
+        while (t<tend*(1.0-1.0e-10)):
+            t+=dt
+            code.evolve_model(t)
+        code.particles.new_channel_to(particles).copy()
+        self.assertAlmostRelativeEquals(e_single_call, binaries.eccentricity, 6)
+
+        binaries.check_for_minimum_periapse_distance = True
+        binaries.check_for_minimum_periapse_distance_value = 1.0e-3 | units.AU
+        particles.new_channel_to(code.particles).copy()
+        code.evolve_model(t+dt)
+        self.assertEqual(code.flag, 0)
+        self.assertAlmostRelativeEquals(code.model_time, t+dt, 8)
+        code.stop()
+
 if __name__ in ('__main__','__plot__'):
     testSecularMultiple = TestSecularMultiple()
 
@@ -829,3 +866,5 @@ if __name__ in ('__main__','__plot__'):
         testSecularMultiple.test7()
     if cmd_options["test"] == 8:
         testSecularMultiple.test8()
+    if cmd_options["test"] == 9:
+        testSecularMultiple.test9()
@@ -396,7 +396,49 @@ class TestSimpleX(TestWithMPI):
         radiative.evolve_model(t_end)
         self.assertAlmostRelativeEquals( 0.0750819123073, radiative.particles.xion.mean(), 1)
         radiative.stop()
-        
+
+    def test13(self):
+        print("Test 13: incremental retriangulation after moving a few sites")
+        numpy.random.seed(123)
+        rho=1.0 | (units.amu/units.cm**3)
+        internal_energy = (9. |units.kms)**2
+
+        source=Particle()
+        source.position = (0, 0, 0) |units.parsec
+        source.flux = (100|units.LSun)/(20. | units.eV)
+        source.rho = rho
+        source.xion = 0.0
+        source.u = internal_energy
+
+        ism = ism_cube(1000, 5|units.parsec, rho, internal_energy).result
+        ism.rho = rho
+        ism.flux = 0. | units.s**-1
+        ism.xion = 0.0
+        moved = ism[::400]
+        # move towards the centre, so that the sites stay inside the box
+        offset = -numpy.sign(moved.position.value_in(units.parsec)) * \
+            numpy.random.uniform(0., 0.05, (len(moved), 3)) | units.parsec
+
+        xion = []
+        for flag in [0, 1]:
+            radiative = SimpleX()
+            radiative.parameters.box_size=10.01 | units.parsec
+            radiative.parameters.timestep=0.001 | units.Myr
+            radiative.parameters.incremental_triangulation_flag = flag
+            self.assertEqual(radiative.parameters.incremental_triangulation_flag, flag)
+            radiative.particles.add_particle(source)
+            radiative.particles.add_particles(ism)
+            radiative.evolve_model(0.005 | units.Myr)
+
+            moved.position += offset
+            moved.new_channel_to(radiative.particles).copy_attributes(["x","y","z"])
+            moved.position -= offset
+            radiative.evolve_model(0.01 | units.Myr)
+            xion.append(radiative.particles.xion.mean())
+            radiative.stop()
+        self.assertTrue(xion[1] > 0.)
+        self.assertAlmostRelativeEquals(xion[0], xion[1], 1)
+
 class TestSimpleXSplitSet(TestWithMPI):
 
     def test1(self):
@@ -0,0 +1,102 @@
+import numpy
+
+from amuse.test.amusetest import TestWithMPI
+from amuse.test import compile_tools
+from amuse.rfi.tools import create_c
+from amuse.rfi.core import *
+from amuse import config
+
+codestring = """
+#include <math.h>
+
+int get_square(int index, double * value) {
+    *value = (double) index * (double) index;
+    if(index < 0) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
+
+int get_root(int index, double * value) {
+    *value = sqrt((double) index);
+    return 0;
+}
+"""
+
+class ForTestingInterface(CodeInterface):
+    include_headers = ['worker_code.h']
+
+    def __init__(self, exefile, **options):
+        CodeInterface.__init__(self, exefile, **options)
+
+    @legacy_function
+    def get_square():
+        function = LegacyFunctionSpecification()
+        function.addParameter('index', dtype='int32', direction=function.IN)
+        function.addParameter('value', dtype='float64', direction=function.OUT)
+        function.result_type = 'int32'
+        function.can_handle_array = True
+        function.can_handle_array_in_parallel = True
+        return function
+
+    @legacy_function
+    def get_root():
+        function = LegacyFunctionSpecification()
+        function.addParameter('index', dtype='int32', direction=function.IN)
+        function.addParameter('value', dtype='float64', direction=function.OUT)
+        function.result_type = 'int32'
+        function.can_handle_array = True
+        return function
+
+class ForTestingParallelInterface(ForTestingInterface):
+    get_root = parallel_legacy_function(ForTestingInterface.get_root)
+
+
+class TestCOpenMPImplementationInterface(TestWithMPI):
+
+    @classmethod
+    def setup_class(cls):
+        print("building...")
+        cls.check_can_compile_modules()
+        extra_args = config.openmp.cflags.split() if config.openmp.is_enabled else []
+        try:
+            cls.exefile = compile_tools.build_worker(codestring, cls.get_path_to_results(),
+                ForTestingInterface, extra_args = extra_args)
+        except Exception as ex:
+            print(ex)
+            raise
+        print("done")
+
+    def test1(self):
+        uc = create_c.GenerateACSourcecodeStringFromASpecificationClass()
+        uc.specification_class = ForTestingInterface
+        uc.needs_mpi = False
+        code = uc.result
+        self.assertEqual(code.count("#pragma omp parallel for"), 1)
+
+        uc = create_c.GenerateACSourcecodeStringFromASpecificationClass()
+        uc.specification_class = ForTestingParallelInterface
+        uc.needs_mpi = False
+        code = uc.result
+        self.assertEqual(code.count("#pragma omp parallel for"), 2)
+        self.assertTrue(ForTestingParallelInterface.get_root.specification.can_handle_array_in_parallel)
+        self.assertFalse(ForTestingInterface.get_root.specification.can_handle_array_in_parallel)
+        self.assertEqual(ForTestingParallelInterface.get_root.specification.id, ForTestingInterface.get_root.specification.id)
+
+    def test2(self):
+        instance = ForTestingInterface(self.exefile)
+        value, error = instance.get_square(numpy.arange(100000))
+        instance.stop()
+        self.assertEqual(error, [0] * 100000)
+        self.assertEqual(value, numpy.arange(100000.0) ** 2)
+
+    def test3(self):
+        instance = ForTestingInterface(self.exefile)
+        value, error = instance.get_square([2, -1, 3])
+        self.assertEqual(error, [0, -1, 0])
+        self.assertEqual(value, [4.0, 1.0, 9.0])
+        value, error = instance.get_square(5)
+        self.assertEqual(error, 0)
+        self.assertEqual(value, 25.0)
+        instance.stop()
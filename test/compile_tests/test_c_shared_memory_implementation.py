@@ -0,0 +1,75 @@
+from amuse.support.interface import InCodeComponentImplementation
+
+from amuse.test.amusetest import TestWithMPI
+from amuse.support import exceptions
+from amuse.support import options
+
+import os
+import numpy
+from amuse.rfi import channel
+from amuse.rfi.core import *
+
+from . import test_c_implementation
+from . import test_c_sockets_implementation
+
+class TestCSharedMemoryImplementationInterface(test_c_implementation.TestCImplementationInterface):
+
+    @classmethod
+    def setup_class(cls):
+        test_c_sockets_implementation.TestCSocketsImplementationInterface.check_not_in_mpiexec()
+        super(TestCSharedMemoryImplementationInterface, cls).setup_class()
+        #set shared memory channel as default channel
+        options.GlobalOptions.instance().override_value_for_option("channel_type", "shared_memory")
+
+    @classmethod
+    def teardown_class(cls):
+        del options.GlobalOptions.instance().overriden_options["channel_type"]
+
+    def test22(self):
+        self.skip("this test uses mpi internals, skip here")
+
+    def test29(self):
+        self.skip("this test uses mpi internals, skip here")
+
+    def test40(self):
+        instance = test_c_implementation.ForTestingInterface(self.exefile)
+        self.assertTrue(isinstance(instance.channel, channel.SharedMemoryChannel))
+        self.assertFalse(os.path.exists(instance.channel.shared_memory_filename))
+
+        out, error = instance.echo_double(numpy.arange(1000.0))
+        self.assertEqual(error, [0]*1000)
+        self.assertEqual(out, numpy.arange(1000.0))
+
+        out1, out2, error = instance.echo_strings(["abc", "def"], ["ghi", "jkl"])
+        self.assertEqual(out1, ["ghi", "jkl"])
+        self.assertEqual(out2, ["abc", "def"])
+        instance.stop()
+
+    def test41(self):
+        # messages larger than the shared memory are send over the socket
+        instance = test_c_implementation.ForTestingInterface(self.exefile, shared_memory_size = 4096)
+
+        out, error = instance.echo_int(numpy.arange(100))
+        self.assertEqual(error, [0]*100)
+        self.assertEqual(out, numpy.arange(100))
+
+        out, error = instance.echo_int(numpy.arange(10000))
+        self.assertEqual(error, [0]*10000)
+        self.assertEqual(out, numpy.arange(10000))
+
+        out, error = instance.echo_string(["abc"]*1000)
+        self.assertEqual(out, ["abc"]*1000)
+        instance.stop()
+
+    def test42(self):
+        # batches of asynchronous calls are send through the shared memory
+        instance = test_c_implementation.ForTestingInterface(self.exefile, batch_asynchronous_calls = True)
+        request1 = instance.echo_double.asynchronous(numpy.arange(1000.0))
+        request2 = instance.echo_string.asynchronous(["abc"]*10)
+        self.assertTrue(request1.batch is request2.batch)
+
+        out, error = request2.result()
+        self.assertEqual(out, ["abc"]*10)
+        out, error = request1.result()
+        self.assertEqual(out, numpy.arange(1000.0))
+        instance.stop()
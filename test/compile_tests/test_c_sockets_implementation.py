@@ -6,6 +6,7 @@ from amuse.support import options
 
 import os
 import time
+import numpy
 from amuse.units import nbody_system
 from amuse.units import units
 from amuse import datamodel
@@ -34,6 +35,44 @@ class TestCSocketsImplementationInterface(test_c_implementation.TestCImplementat
     def test29(self):
         self.skip("this test uses mpi internals, skip here")
     
+    def test40(self):
+        # asynchronous calls are send in one message
+        instance = test_c_implementation.ForTestingInterface(self.exefile, batch_asynchronous_calls = True)
+        request1 = instance.echo_int.asynchronous(numpy.arange(10))
+        request2 = instance.echo_double.asynchronous(2.5)
+        request3 = instance.echo_strings.asynchronous(["abc", "def"], ["ghi", "jkl"])
+        request4 = instance.echo_logical.asynchronous([True, False])
+        self.assertTrue(request1.batch is request4.batch)
+        self.assertFalse(request1.batch.is_finished)
+        
+        out, error = request2.result()
+        self.assertEqual(out, 2.5)
+        self.assertEqual(error, 0)
+        out, error = request1.result()
+        self.assertEqual(out, numpy.arange(10))
+        self.assertEqual(error, [0]*10)
+        out1, out2, error = request3.result()
+        self.assertEqual(out1, ["ghi", "jkl"])
+        self.assertEqual(out2, ["abc", "def"])
+        out, error = request4.result()
+        self.assertEqual(out, [True, False])
+        
+        # a new batch is started after a batch is send
+        request5 = instance.echo_int.asynchronous(5)
+        self.assertFalse(request5.batch is request1.batch)
+        out, error = instance.echo_int(6)
+        self.assertEqual(request5.result()["int_out"], 5)
+        self.assertEqual(out, 6)
+        instance.stop()
+    
+    def test41(self):
+        instance = test_c_implementation.ForTestingInterface(self.exefile, batch_asynchronous_calls = True)
+        requests = [instance.echo_int.asynchronous(i) for i in range(100)]
+        pool = requests[0].join(requests[-1])
+        pool.waitall()
+        self.assertEqual([x.result()["int_out"] for x in requests], list(range(100)))
+        instance.stop()
+    
     @classmethod                 
     def check_not_in_mpiexec(cls):
         """